@@ -48,6 +48,85 @@
 # - <output-directory>/assets/sounds/volume-up.h
 # - <output-directory>/assets/sounds/volume-down.h
 #
+# The generation mode is selected using the MLK_BCC_MODE cache variable which
+# can be one of:
+#
+# - embed: use the C23 #embed directive,
+# - incbin: use the assembler .incbin directive (GCC and Clang only),
+# - hex: generate a textual array (slowest but works everywhere),
+# - auto: (default) pick the first available mode in the above order.
+#
+# Both embed and incbin modes only write a small stub referencing the asset
+# absolute path, the compiler reads the file itself which is much faster than
+# parsing a huge list of bytes.
+#
+
+set(MLK_BCC_MODE "auto" CACHE STRING "mlk-bcc generation mode (auto, embed, incbin, hex)")
+set_property(CACHE MLK_BCC_MODE PROPERTY STRINGS auto embed incbin hex)
+
+#
+# Probe sources are written as-is because they contain C and assembler escape
+# sequences that would be evaluated by CMake otherwise.
+#
+function(_mlk_bcc_probe var source)
+	if (DEFINED ${var})
+		return()
+	endif ()
+
+	set(_dir ${CMAKE_BINARY_DIR}/CMakeFiles/mlk-bcc)
+	string(REPLACE "@PROBE@" "${_dir}/probe.bin" source "${source}")
+	file(WRITE ${_dir}/probe.bin "mlk")
+	file(WRITE ${_dir}/${var}.c "${source}")
+	try_compile(${var} SOURCES ${_dir}/${var}.c)
+	set(${var} ${${var}} CACHE INTERNAL "")
+endfunction()
+
+function(_mlk_bcc_detect)
+	if (NOT MLK_BCC_MODE STREQUAL "auto")
+		set(_MLK_BCC_MODE ${MLK_BCC_MODE} CACHE INTERNAL "")
+		return()
+	endif ()
+
+	_mlk_bcc_probe(MLK_BCC_HAVE_EMBED [[
+static const unsigned char data[] = {
+#embed "@PROBE@"
+};
+
+int main(void) { return sizeof (data) != 3; }
+]])
+
+	if (NOT MSVC)
+		_mlk_bcc_probe(MLK_BCC_HAVE_INCBIN [[
+__asm__(
+#if defined(__APPLE__)
+	".const_data\n"
+#else
+	".section .rodata\n"
+#endif
+	"mlk_bcc_probe:\n"
+	".incbin \"@PROBE@\"\n"
+	".text\n"
+);
+
+extern const unsigned char data[3] __asm__("mlk_bcc_probe");
+
+int main(void) { return data[0] != 'm'; }
+]])
+	endif ()
+
+	if (MLK_BCC_HAVE_EMBED)
+		set(_MLK_BCC_MODE embed CACHE INTERNAL "")
+	elseif (MLK_BCC_HAVE_INCBIN)
+		set(_MLK_BCC_MODE incbin CACHE INTERNAL "")
+	else ()
+		set(_MLK_BCC_MODE hex CACHE INTERNAL "")
+	endif ()
+
+	message(STATUS "mlk-bcc mode: ${_MLK_BCC_MODE}")
+endfunction()
+
+_mlk_bcc_detect()
+
 macro(mlk_bcc)
 	set(options "CONST;NUL;STATIC")
 	set(oneValueArgs "OUTPUT_DIRECTORY;OUTPUTS_VAR")
@@ -68,6 +147,11 @@ macro(mlk_bcc)
 	endif ()
 
 	foreach (a ${_bcc_ASSETS})
+		set(_bcc_args -m ${_MLK_BCC_MODE})
+
+		# The embed and incbin modes reference the file from the output.
+		get_filename_component(a ${a} ABSOLUTE)
+
 		# Determine output parent directory name.
 		get_filename_component(_bcc_dirname ${a} DIRECTORY)
 		get_filename_component(_bcc_dirname ${_bcc_dirname} NAME)
@@ -112,3 +196,55 @@ macro(mlk_bcc)
 		PREFIX build/assets
 	)
 endmacro()
+
+#
+# mlk_bcc_directory(
+#   NAME name
+#   DIRECTORY directory
+#   OUTPUTS_VAR variable
+#   [OUTPUT_DIRECTORY directory]
+# )
+#
+# Embed a whole directory into a single header using the mlk-bcc directory
+# mode.
+#
+# The file <output-directory>/<name>.h is generated and defines the
+# <name>_data array containing every file and the <name>_entries table to be
+# used with mlk/core/vfs-blob.h. The OUTPUT_DIRECTORY defaults to
+# ${CMAKE_CURRENT_BINARY_DIR}/assets if unset.
+#
+function(mlk_bcc_directory)
+	set(options "")
+	set(oneValueArgs "DIRECTORY;NAME;OUTPUT_DIRECTORY;OUTPUTS_VAR")
+	set(multiValueArgs "")
+
+	cmake_parse_arguments(_bcc "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+	if (NOT _bcc_NAME)
+		message(FATAL_ERROR "Missing NAME")
+	elseif (NOT _bcc_DIRECTORY)
+		message(FATAL_ERROR "Missing DIRECTORY")
+	elseif (NOT _bcc_OUTPUTS_VAR)
+		message(FATAL_ERROR "Missing OUTPUTS_VAR")
+	endif ()
+
+	if (NOT _bcc_OUTPUT_DIRECTORY)
+		set(_bcc_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/assets)
+	endif ()
+
+	get_filename_component(_bcc_directory ${_bcc_DIRECTORY} ABSOLUTE)
+	file(GLOB_RECURSE _bcc_files CONFIGURE_DEPENDS ${_bcc_directory}/*)
+	set(_bcc_output_file ${_bcc_OUTPUT_DIRECTORY}/${_bcc_NAME}.h)
+
+	add_custom_command(
+		OUTPUT ${_bcc_output_file}
+		COMMAND
+			${CMAKE_COMMAND} -E make_directory ${_bcc_OUTPUT_DIRECTORY}
+		COMMAND
+			$<TARGET_FILE:mlk::mlk-bcc> -d -cs -m ${_MLK_BCC_MODE} ${_bcc_directory} ${_bcc_NAME} > ${_bcc_output_file}
+		COMMENT "Generating asset directory ${_bcc_NAME}"
+		DEPENDS $<TARGET_FILE:mlk::mlk-bcc> ${_bcc_files}
+	)
+
+	set(${_bcc_OUTPUTS_VAR} ${${_bcc_OUTPUTS_VAR}} ${_bcc_output_file} PARENT_SCOPE)
+endfunction()
@@ -16,8 +16,15 @@
 # OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #
 
+set(MLK_MAP_BINARY Off CACHE BOOL "Compile maps into the binary format")
+
 function(mlk_map input output)
-	set(cmd COMMAND $<TARGET_FILE:mlk::mlk-map> < ${input} > ${output})
+	if (MLK_MAP_BINARY)
+		set(cmd COMMAND $<TARGET_FILE:mlk::mlk-map> -b < ${input} > ${output})
+	else ()
+		set(cmd COMMAND $<TARGET_FILE:mlk::mlk-map> < ${input} > ${output})
+	endif ()
+
 	get_filename_component(filename ${output} NAME)
 
 	add_custom_command(
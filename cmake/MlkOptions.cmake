@@ -21,6 +21,7 @@ mlk_option(EXAMPLES On BOOL "Enable examples")
 mlk_option(NLS On BOOL "Enable NLS support")
 mlk_option(TESTS On BOOL "Enable unit tests")
 mlk_option(TESTS_GRAPHICAL On BOOL "Enable unit tests that requires graphical context")
+mlk_option(TSAN Off BOOL "Build everything with ThreadSanitizer")
 mlk_option(CMAKEDIR "${CMAKE_INSTALL_LIBDIR}/cmake" STRING "Destination for CMake files")
 mlk_option(JAVASCRIPT On BOOL "Enable Javascript bindings")
 mlk_option(ZIP On BOOL "Enable zip file support in VFS")
@@ -0,0 +1,74 @@
+#
+# CMakeLists.txt -- CMake build system for Molko's Engine
+#
+# Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+#
+# Permission to use, copy, modify, and/or distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+#
+
+#
+# mlk_pack(
+#   OUTPUT file
+#   DIRECTORY directory
+#   ASSETS files...
+#   [COMPRESS]
+# )
+#
+# Create an asset pack using mlk-pack utility.
+#
+# Every asset must be given relative to DIRECTORY and is stored under that
+# relative name in the pack, which is also the name to use with
+# mlk_vfs_pack_open.
+#
+# Example:
+#
+# mlk_pack(
+#   OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/data.pack
+#   DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/assets
+#   ASSETS sprites/john.png sounds/step.wav
+#   COMPRESS
+# )
+#
+function(mlk_pack)
+	set(options "COMPRESS")
+	set(oneValueArgs "DIRECTORY;OUTPUT")
+	set(multiValueArgs "ASSETS")
+
+	cmake_parse_arguments(_pack "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+	if (NOT _pack_OUTPUT)
+		message(FATAL_ERROR "Missing OUTPUT")
+	elseif (NOT _pack_DIRECTORY)
+		message(FATAL_ERROR "Missing DIRECTORY")
+	elseif (NOT _pack_ASSETS)
+		message(FATAL_ERROR "Missing ASSETS")
+	endif ()
+
+	if (_pack_COMPRESS)
+		list(APPEND _pack_args -z)
+	endif ()
+
+	foreach (a ${_pack_ASSETS})
+		list(APPEND _pack_depends ${_pack_DIRECTORY}/${a})
+	endforeach ()
+
+	get_filename_component(filename ${_pack_OUTPUT} NAME)
+
+	add_custom_command(
+		OUTPUT ${_pack_OUTPUT}
+		COMMAND
+			$<TARGET_FILE:mlk::mlk-pack> ${_pack_args} -C ${_pack_DIRECTORY} ${_pack_OUTPUT} ${_pack_ASSETS}
+		COMMENT "Generating pack ${filename}"
+		DEPENDS $<TARGET_FILE:mlk::mlk-pack> ${_pack_depends}
+	)
+endfunction()
@@ -0,0 +1,66 @@
+#
+# CMakeLists.txt -- CMake build system for Molko's Engine
+#
+# Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+#
+# Permission to use, copy, modify, and/or distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+#
+#
+# mlk_rawtex(
+#   INPUT file
+#   OUTPUT file
+#   [COMPRESS]
+# )
+#
+# Convert an image into a pre-decoded texture using mlk-rawtex utility.
+#
+# The output can be loaded with any mlk_image_open* function instead of the
+# original image, it is larger on disk but does not need to be decoded at
+# runtime.
+#
+# Example:
+#
+# mlk_rawtex(
+#   INPUT ${CMAKE_CURRENT_SOURCE_DIR}/assets/sprites/john.png
+#   OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/assets/sprites/john.tex
+#   COMPRESS
+# )
+#
+function(mlk_rawtex)
+	set(options "COMPRESS")
+	set(oneValueArgs "INPUT;OUTPUT")
+
+	cmake_parse_arguments(_rawtex "${options}" "${oneValueArgs}" "" ${ARGN})
+
+	if (NOT _rawtex_INPUT)
+		message(FATAL_ERROR "Missing INPUT")
+	elseif (NOT _rawtex_OUTPUT)
+		message(FATAL_ERROR "Missing OUTPUT")
+	endif ()
+
+	if (_rawtex_COMPRESS)
+		list(APPEND _rawtex_args -z)
+	endif ()
+
+	get_filename_component(filename ${_rawtex_OUTPUT} NAME)
+	get_filename_component(directory ${_rawtex_OUTPUT} DIRECTORY)
+	file(MAKE_DIRECTORY ${directory})
+
+	add_custom_command(
+		OUTPUT ${_rawtex_OUTPUT}
+		COMMAND
+			$<TARGET_FILE:mlk::mlk-rawtex> ${_rawtex_args} ${_rawtex_INPUT} ${_rawtex_OUTPUT}
+		COMMENT "Generating texture ${filename}"
+		DEPENDS $<TARGET_FILE:mlk::mlk-rawtex> ${_rawtex_INPUT}
+	)
+endfunction()
@@ -49,13 +49,13 @@ chest_handle(struct mlk_action *self, const union mlk_event *ev)
 	if (ev->type != MLK_EVENT_CLICKDOWN)
 		return;
 
-	cw = mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CHEST].cellw;
-	ch = mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CHEST].cellh;
+	cw = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CHEST)->cellw;
+	ch = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CHEST)->cellh;
 
 	if (!mlk_maths_is_boxed(ev->click.x, ev->click.y, chest->x, chest->y, cw, ch))
 		return;
 
-	mlk_sound_play(&mlk_registry_sounds[MLK_REGISTRY_SOUND_OPEN_CHEST]);
+	mlk_sound_play(mlk_registry_sound(MLK_REGISTRY_SOUND_OPEN_CHEST));
 	mlk_animation_start(&chest->animation);
 
 	chest->state = CHEST_STATE_OPENING;
@@ -125,7 +125,7 @@ chest_restart(struct chest *chest)
 
 	chest->state = CHEST_STATE_CLOSED;
 
-	chest->animation.sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CHEST];
+	chest->animation.sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CHEST);
 	chest->animation.delay = CHEST_DELAY;
 
 	chest->action.handle = chest_handle;
@@ -203,8 +203,8 @@ sequence_entry(struct mlk_coro *)
 static void
 sequence_init(void)
 {
-	const unsigned int cw = mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CHEST].cellw;
-	const unsigned int ch = mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CHEST].cellh;
+	const unsigned int cw = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CHEST)->cellw;
+	const unsigned int ch = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CHEST)->cellh;
 	struct chest *chest = &sequence.chest;
 
 	/* Initialize chest and add it to the action stack. */
@@ -41,11 +41,9 @@ static struct mlk_label label = {
 };
 
 static struct mlk_animation explosion = {
-	.sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_EXPLOSION],
 	.delay  = 25
 };
 static struct mlk_animation loop = {
-	.sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CAT_RUNNING],
 	.delay  = 1000 / 16,
 	.flags  = MLK_ANIMATION_FLAGS_LOOP
 };
@@ -56,6 +54,9 @@ init(void)
 {
 	if (mlk_example_init("example-animation") < 0)
 		mlk_panic();
+
+	explosion.sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_EXPLOSION);
+	loop.sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CAT_RUNNING);
 }
 
 static void
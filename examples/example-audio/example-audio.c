@@ -54,8 +54,8 @@ init(void)
 	if (mlk_example_init("example-audio") < 0)
 		mlk_panic();
 
-	sound = &mlk_registry_sounds[MLK_REGISTRY_SOUND_FIRE];
-	music = &mlk_registry_music[MLK_REGISTRY_MUSIC_ROMANCE];
+	sound = mlk_registry_sound(MLK_REGISTRY_SOUND_FIRE);
+	music = mlk_registry_music(MLK_REGISTRY_MUSIC_ROMANCE);
 }
 
 static void
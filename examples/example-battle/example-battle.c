@@ -133,9 +133,8 @@ init(void)
 		mlk_panicf("mlk_example_init: %s", mlk_err_string(err));
 
 	/* Set cursor in default theme. */
-	mlk_registry_init();
 #if 0
-	mlk_theme_default()->sprites[MLK_THEME_SPRITE_CURSOR] = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_CURSOR];
+	mlk_theme_default()->sprites[MLK_THEME_SPRITE_CURSOR] = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_CURSOR);
 #endif
 }
 
@@ -152,9 +151,6 @@ static struct {
 			.name = "Black Cat",
 			.level = 6,
 			.reset = black_cat_reset,
-			.sprites = {
-				[CHARACTER_SPRITE_NORMAL] = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_BLACK_CAT],
-			},
 			.exec = black_cat_strat
 		},
 		.entity = {
@@ -170,10 +166,6 @@ static struct {
 			.hp = 120,
 			.mp = 50,
 			.reset = adventurer_reset,
-			.sprites = {
-				[CHARACTER_SPRITE_NORMAL] = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_JOHN_WALK],
-				[CHARACTER_SPRITE_SWORD] = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_JOHN_SWORD],
-			},
 			.spells = {
 				&mlk_spell_fire
 			}
@@ -218,13 +210,18 @@ prepare_to_fight(void)
 	bt.enemies = entities_enemies;
 	bt.enemiesz = MLK_UTIL_SIZE(entities_enemies);
 
+	/* Sprites are loaded on first access, they can't be set statically. */
+	entities[0].ch.sprites[CHARACTER_SPRITE_NORMAL] = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_BLACK_CAT);
+	entities[1].ch.sprites[CHARACTER_SPRITE_NORMAL] = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_JOHN_WALK);
+	entities[1].ch.sprites[CHARACTER_SPRITE_SWORD] = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_JOHN_SWORD);
+
 	/* Black cat is near the previous monster. */
 	entities_team[0] = &entities[1].entity;
 	entities_enemies[0] = &entities[0].entity;
 	entities_enemies[0]->x = 500;
 	entities_enemies[0]->y = 100;
 
-	bt.background = &mlk_registry_images[MLK_REGISTRY_IMAGE_BATTLE_BACKGROUND];
+	bt.background = mlk_registry_image(MLK_REGISTRY_IMAGE_BATTLE_BACKGROUND);
 	bt.bar = &bar;
 	bt.actions = &action_stack;
 	bt.effects = &drawable_stack;
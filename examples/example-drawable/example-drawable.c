@@ -74,8 +74,8 @@ init(void)
 	if (mlk_example_init("example-drawable") < 0)
 		mlk_panic();
 
-	explosion_tex = &mlk_registry_textures[MLK_REGISTRY_TEXTURE_EXPLOSION];
-	explosion_sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_EXPLOSION];
+	explosion_tex = mlk_registry_texture(MLK_REGISTRY_TEXTURE_EXPLOSION);
+	explosion_sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_EXPLOSION);
 }
 
 static int
@@ -84,12 +84,12 @@ static struct {
 
 static const struct {
 	const char *basename;
-	struct mlk_texture *texture;
+	enum mlk_registry_texture texture;
 } table_textures[] = {
-	{ "world.png",                  &mlk_registry_textures[MLK_REGISTRY_TEXTURE_WORLD] },
-	{ "animation-water.png",        &mlk_registry_textures[MLK_REGISTRY_TEXTURE_WATER] },
-	{ "john.png",                   &mlk_registry_textures[MLK_REGISTRY_TEXTURE_JOHN]  },
-	{ NULL,                         NULL                                               }
+	{ "world.png",                  MLK_REGISTRY_TEXTURE_WORLD },
+	{ "animation-water.png",        MLK_REGISTRY_TEXTURE_WATER },
+	{ "john.png",                   MLK_REGISTRY_TEXTURE_JOHN },
+	{ NULL,                         0 }
 };
 
 static struct mlk_texture *
@@ -103,7 +103,7 @@ find_texture(const char *ident)
 
 	for (size_t i = 0; table_textures[i].basename != NULL; ++i)
 		if (strcmp(table_textures[i].basename, filename) == 0)
-			return table_textures[i].texture;
+			return mlk_registry_texture(table_textures[i].texture);
 
 	return NULL;
 }
@@ -48,7 +48,7 @@ init(void)
 	if (mlk_example_init("example-notify") < 0)
 		mlk_panic();
 
-	icon = &mlk_registry_textures[MLK_REGISTRY_TEXTURE_SWORD];
+	icon = mlk_registry_texture(MLK_REGISTRY_TEXTURE_SWORD);
 }
 
 static void
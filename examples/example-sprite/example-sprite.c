@@ -64,7 +64,7 @@ init(void)
 	if (mlk_example_init("example-sprite") < 0)
 		mlk_panic();
 
-	sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_PEOPLE];
+	sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_PEOPLE);
 }
 
 static void
@@ -62,11 +62,11 @@ static size_t animationsz;
 
 static const struct {
 	const char *basename;
-	struct mlk_texture *texture;
+	enum mlk_registry_texture texture;
 } table_textures[] = {
-	{ "world.png",                  &mlk_registry_textures[MLK_REGISTRY_TEXTURE_WORLD] },
-	{ "animation-water.png",        &mlk_registry_textures[MLK_REGISTRY_TEXTURE_WATER] },
-	{ NULL,                         NULL                                               }
+	{ "world.png",                  MLK_REGISTRY_TEXTURE_WORLD },
+	{ "animation-water.png",        MLK_REGISTRY_TEXTURE_WATER },
+	{ NULL,                         0 }
 };
 
 static struct mlk_texture *
@@ -83,7 +83,7 @@ new_texture(struct mlk_tileset_loader *loader, struct mlk_tileset *tileset, cons
 
 	for (size_t i = 0; table_textures[i].basename != NULL; ++i)
 		if (strcmp(table_textures[i].basename, filename) == 0)
-			return table_textures[i].texture;
+			return mlk_registry_texture(table_textures[i].texture);
 
 	return NULL;
 }
@@ -275,13 +275,13 @@ handle(const union mlk_event *ev)
 		mlk_game_quit();
 	if (mlk_button_handle(&ui.buttons.hello, ev))
 		mlk_notify(
-		    &mlk_registry_textures[MLK_REGISTRY_TEXTURE_SWORD],
+		    mlk_registry_texture(MLK_REGISTRY_TEXTURE_SWORD),
 		    "Hello",
 		    "Hello world!"
 		);
 	if (mlk_button_handle(&ui.buttons.download, ev))
 		mlk_notify(
-		    &mlk_registry_textures[MLK_REGISTRY_TEXTURE_SWORD],
+		    mlk_registry_texture(MLK_REGISTRY_TEXTURE_SWORD),
 		    "Complete",
 		    "16GB of RAM successfully downloaded!"
 		);
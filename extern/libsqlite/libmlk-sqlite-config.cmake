@@ -16,4 +16,8 @@
 # OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #
 
+include(CMakeFindDependencyMacro)
+
+find_dependency(Threads)
+
 include("${CMAKE_CURRENT_LIST_DIR}/libmlk-sqlite-targets.cmake")
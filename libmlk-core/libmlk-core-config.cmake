@@ -19,6 +19,7 @@
 include(CMakeFindDependencyMacro)
 
 find_dependency(libmlk-util)
+find_dependency(libmlk-utlist)
 find_dependency(Intl)
 find_dependency(ZIP)
 
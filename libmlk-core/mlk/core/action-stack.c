@@ -21,17 +21,57 @@
 
 #include "action-stack.h"
 #include "action.h"
+#include "alloc.h"
 #include "core_p.h"
 #include "err.h"
 
+/* Initial capacity of growable stacks, doubled when full. */
+#define CAPACITY 8
+
 #define FOREACH(st, iter) \
-	for (size_t i = 0; i < (st)->actionsz && ((iter) = (st)->actions[i], 1); ++i)
+	for (size_t i = 0; i < (st)->length && ((iter) = (st)->actions[i], 1); ++i)
+
+static void
+append(struct mlk_action_stack *st, struct mlk_action *act)
+{
+	if (st->length == st->actionsz) {
+		st->actionsz = st->actionsz ? st->actionsz * 2 : CAPACITY;
+
+		if (st->actions)
+			st->actions = mlk_alloc_resize(st->actions, st->actionsz);
+		else
+			st->actions = mlk_alloc_new(st->actionsz, sizeof (*st->actions));
+	}
+
+	st->actions[st->length++] = act;
+}
+
+static void
+compact(struct mlk_action_stack *st)
+{
+	size_t length = 0;
+
+	/* Growable stacks keep order, fixed ones only trim the tail. */
+	if (st->grow) {
+		for (size_t i = 0; i < st->length; ++i)
+			if (st->actions[i])
+				st->actions[length++] = st->actions[i];
+	} else {
+		for (length = st->length; length && !st->actions[length - 1]; --length)
+			continue;
+	}
+
+	st->length = length;
+}
 
 void
 mlk_action_stack_init(struct mlk_action_stack *st)
 {
 	assert(st);
 
+	st->grow = st->actions == NULL;
+	st->length = 0;
+
 	for (size_t i = 0; i < st->actionsz; ++i)
 		st->actions[i] = NULL;
 }
@@ -42,13 +82,26 @@ mlk_action_stack_add(struct mlk_action_stack *st, struct mlk_action *act)
 	assert(st);
 	assert(act);
 
-	for (size_t i = 0; i < st->actionsz; ++i) {
+	if (!st->actions)
+		st->grow = 1;
+
+	if (st->grow) {
+		append(st, act);
+		return 0;
+	}
+
+	for (size_t i = 0; i < st->length; ++i) {
 		if (!st->actions[i]) {
 			st->actions[i] = act;
 			return 0;
 		}
 	}
 
+	if (st->length < st->actionsz) {
+		st->actions[st->length++] = act;
+		return 0;
+	}
+
 	return mlk_errf(_("no space in action stack"));
 }
 
@@ -98,7 +151,11 @@ mlk_action_stack_update(struct mlk_action_stack *st, unsigned int ticks)
 
 	struct mlk_action *act;
 
-	for (size_t i = 0; i < st->actionsz; ++i) {
+	/*
+	 * Actions added meanwhile are appended and updated in this loop as
+	 * well, the array may also be reallocated.
+	 */
+	for (size_t i = 0; i < st->length; ++i) {
 		act = st->actions[i];
 
 		if (act && mlk_action_update(act, ticks)) {
@@ -108,6 +165,8 @@ mlk_action_stack_update(struct mlk_action_stack *st, unsigned int ticks)
 		}
 	}
 
+	compact(st);
+
 	/*
 	 * We process all actions again in case the user modified the stack
 	 * within their update function.
@@ -141,6 +200,14 @@ mlk_action_stack_finish(struct mlk_action_stack *st)
 		}
 	}
 
-	for (size_t i = 0; i < st->actionsz; ++i)
-		st->actions[i] = NULL;
+	if (st->grow) {
+		mlk_alloc_free(st->actions);
+		st->actions = NULL;
+		st->actionsz = 0;
+	} else {
+		for (size_t i = 0; i < st->actionsz; ++i)
+			st->actions[i] = NULL;
+	}
+
+	st->length = 0;
 }
@@ -28,6 +28,19 @@
  * The purpose of this module is to help managing several actions at once.
  * Actions are automatically removed from the stack if the corresponding update
  * member function returns non-zero after completion.
+ *
+ * The stack either uses a fixed array provided by the user (see
+ * ::MLK_ACTION_STACK_DECL) or, if ::mlk_action_stack::actions is NULL, an
+ * array allocated and grown as needed which is released by
+ * ::mlk_action_stack_finish. A growable stack keeps its actions contiguous in
+ * insertion order: new actions are appended and the slots of completed ones
+ * are compacted once ::mlk_action_stack_update has run them all.
+ *
+ * ```c
+ * struct mlk_action_stack stack = {0};
+ *
+ * mlk_action_stack_add(&stack, &effect->action);
+ * ```
  */
 
 #include <stddef.h>
@@ -59,7 +72,7 @@ struct mlk_action_stack {
 	/**
 	 * (read-write, borrowed)
 	 *
-	 * Array of non-owning actions to run.
+	 * Array of non-owning actions to run, NULL for a growable stack.
 	 */
 	struct mlk_action **actions;
 
@@ -72,6 +85,18 @@ struct mlk_action_stack {
 	 *          dimension.
 	 */
 	size_t actionsz;
+
+	/**
+	 * (read-only)
+	 *
+	 * Number of slots in use from the beginning of the array, completed
+	 * actions may leave NULL slots within this range in fixed stacks.
+	 */
+	size_t length;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	int grow;
+	/** \endcond MLK_PRIVATE_DECLS */
 };
 
 #if defined(__cplusplus)
@@ -82,7 +107,7 @@ extern "C" {
  * Initialize the action stack structure.
  *
  * This function will set all pointers in the ::mlk_action_stack::actions to
- * NULL.
+ * NULL, if the array is NULL the stack is growable.
  *
  * \pre stack != NULL
  * \param stack the action stack
@@ -94,7 +119,8 @@ mlk_action_stack_init(struct mlk_action_stack *stack);
  * Try to append a new action into the stack if one slot in the
  * ::mlk_action_stack::actions is NULL
  *
- * The action is inserted as-is and ownership is left to the caller.
+ * The action is inserted as-is and ownership is left to the caller. A growable
+ * stack always appends the action, enlarging the array if required.
  *
  * \pre stack != NULL
  * \param stack the action stack
@@ -160,6 +186,9 @@ mlk_action_stack_draw(const struct mlk_action_stack *stack);
 /**
  * Invoke ::mlk_action_finish on all actions left.
  *
+ * The array of a growable stack is released, the stack can be used again
+ * afterwards.
+ *
  * \pre stack != NULL
  * \param stack the action stack
  */
@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -140,12 +141,11 @@ reallocate(void *ptr, size_t n, int zero)
 
 	struct block *b = blockat(ptr);
 	size_t osize = b->n * b->w;
-	size_t nsize = (b->n + n) * b->w;
+	size_t nsize;
 
-#if !defined(NDEBUG)
-	assert(SIZE_MAX - osize >= nsize);
-#endif
+	assert(n <= (SIZE_MAX - BLKSIZE) / b->w);
 
+	nsize = n * b->w;
 	b = funcs->realloc(b, BLKSIZE + nsize);
 	b->n = n;
 
@@ -158,11 +158,15 @@ reallocate(void *ptr, size_t n, int zero)
 static inline void *
 expand(void *ptr, size_t n, int zero)
 {
+	assert(ptr);
+
 	struct block *b = blockat(ptr);
 
-	if (n <= b->n)
+	if (n == 0)
 		return ptr;
 
+	assert(n <= SIZE_MAX - b->n);
+
 	return reallocate(ptr, b->n + n, zero);
 }
 
@@ -199,7 +203,7 @@ mlk_alloc_resize0(void *ptr, size_t n)
 void *
 mlk_alloc_expand(void *ptr, size_t n)
 {
-	return reallocate(ptr, n, 0);
+	return expand(ptr, n, 0);
 }
 
 void *
@@ -203,7 +203,7 @@ mlk_alloc_new0(size_t n, size_t w);
  * \pre ptr != NULL
  * \pre n > 0
  * \param ptr the pointer to reallocate
- * \param n the new size
+ * \param n the new number of items
  * \return whatever the allocator returned to rearrange the pointer memory
  */
 void *
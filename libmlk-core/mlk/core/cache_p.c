@@ -0,0 +1,153 @@
+/*
+ * cache_p.c -- reference counted hash table shared by resource caches
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+
+#include <utlist.h>
+
+#include "alloc.h"
+#include "cache_p.h"
+
+static inline struct mlk__cache_entry **
+bucket(struct mlk__cache *cache, uint64_t hash)
+{
+	return &cache->buckets[hash & (cache->bucketsz - 1)];
+}
+
+static void
+grow(struct mlk__cache *cache)
+{
+	struct mlk__cache_entry **buckets, *entry, *chain;
+	size_t bucketsz;
+
+	buckets = cache->buckets;
+	bucketsz = cache->bucketsz;
+
+	cache->bucketsz = bucketsz ? bucketsz * 2 : 64;
+	cache->buckets = mlk_alloc_new0(cache->bucketsz, sizeof (*cache->buckets));
+
+	for (size_t i = 0; i < bucketsz; ++i) {
+		for (entry = buckets[i]; entry; entry = chain) {
+			chain = entry->chain;
+			LL_PREPEND2(*bucket(cache, entry->hash), entry, chain);
+		}
+	}
+
+	mlk_alloc_free(buckets);
+}
+
+static void
+discard(struct mlk__cache *cache, struct mlk__cache_entry *entry)
+{
+	mlk__cache_charge(cache, entry, 0);
+	LL_DELETE2(*bucket(cache, entry->hash), entry, chain);
+
+	/* Don't keep the table around once every entry is gone. */
+	if (--cache->entriesz == 0) {
+		mlk_alloc_free(cache->buckets);
+		cache->buckets = NULL;
+		cache->bucketsz = 0;
+	}
+
+	if (cache->evict)
+		cache->evict(entry);
+}
+
+void
+mlk__cache_insert(struct mlk__cache *cache, struct mlk__cache_entry *entry)
+{
+	assert(cache);
+	assert(entry);
+
+	/* Keep chains short, at most one entry per bucket on average. */
+	if (cache->entriesz >= cache->bucketsz)
+		grow(cache);
+
+	entry->refs = 1;
+	LL_PREPEND2(*bucket(cache, entry->hash), entry, chain);
+	cache->entriesz++;
+}
+
+void
+mlk__cache_ref(struct mlk__cache *cache, struct mlk__cache_entry *entry)
+{
+	assert(cache);
+	assert(entry);
+
+	if (entry->refs++ == 0)
+		DL_DELETE(cache->lru, entry);
+}
+
+void
+mlk__cache_unref(struct mlk__cache *cache, struct mlk__cache_entry *entry, int keep)
+{
+	assert(cache);
+	assert(entry);
+	assert(entry->refs);
+
+	if (--entry->refs)
+		return;
+
+	if (keep) {
+		DL_APPEND(cache->lru, entry);
+		mlk__cache_collect(cache);
+	} else
+		discard(cache, entry);
+}
+
+void
+mlk__cache_charge(struct mlk__cache *cache, struct mlk__cache_entry *entry, size_t cost)
+{
+	assert(cache);
+	assert(entry);
+	assert(cache->usage >= entry->cost);
+
+	cache->usage = cache->usage - entry->cost + cost;
+	entry->cost = cost;
+}
+
+void
+mlk__cache_collect(struct mlk__cache *cache)
+{
+	assert(cache);
+
+	struct mlk__cache_entry *entry;
+
+	if (!cache->budget)
+		return;
+
+	while (cache->usage > cache->budget && (entry = cache->lru)) {
+		DL_DELETE(cache->lru, entry);
+		discard(cache, entry);
+	}
+}
+
+void
+mlk__cache_finish(struct mlk__cache *cache)
+{
+	assert(cache);
+
+	struct mlk__cache_entry *entry;
+
+	cache->lru = NULL;
+
+	/* The table is freed along with the last entry. */
+	for (size_t i = 0; cache->buckets && i < cache->bucketsz; ++i)
+		while (cache->buckets && (entry = cache->buckets[i]))
+			discard(cache, entry);
+}
@@ -0,0 +1,108 @@
+/*
+ * cache_p.h -- reference counted hash table shared by resource caches
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_CACHE_P_H
+#define MLK_CORE_CACHE_P_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Entry embedded in the cached object, the owner computes the hash and
+ * compares its own key while walking a chain from mlk__cache_bucket.
+ */
+struct mlk__cache_entry {
+	uint64_t hash;
+	unsigned int refs;
+	size_t cost;
+
+	/* Hash table chain. */
+	struct mlk__cache_entry *chain;
+
+	/* Unreferenced entries, least recently used first. */
+	struct mlk__cache_entry *prev;
+	struct mlk__cache_entry *next;
+};
+
+/*
+ * Chained hash table of reference counted entries. Unreferenced entries that
+ * are kept stay in a LRU list and are evicted once the sum of all costs goes
+ * over the budget, a budget of 0 keeps them forever.
+ *
+ * The evict function is called for every entry leaving the cache, once it is
+ * already unlinked so that it can free the object.
+ */
+struct mlk__cache {
+	size_t budget;
+	size_t usage;
+	struct mlk__cache_entry **buckets;
+	size_t bucketsz;
+	size_t entriesz;
+	struct mlk__cache_entry *lru;
+	void (*evict)(struct mlk__cache_entry *);
+};
+
+/*
+ * Return the first entry of the chain that may contain the given hash.
+ */
+static inline struct mlk__cache_entry *
+mlk__cache_bucket(const struct mlk__cache *cache, uint64_t hash)
+{
+	return cache->buckets ? cache->buckets[hash & (cache->bucketsz - 1)] : NULL;
+}
+
+/*
+ * Add a new entry with its hash already set, it starts with one reference.
+ */
+void
+mlk__cache_insert(struct mlk__cache *, struct mlk__cache_entry *);
+
+/*
+ * Add a reference, taking the entry back from the LRU list if it was unused.
+ */
+void
+mlk__cache_ref(struct mlk__cache *, struct mlk__cache_entry *);
+
+/*
+ * Drop a reference. Once unused, the entry is kept in the LRU list if keep is
+ * set or evicted immediately otherwise.
+ */
+void
+mlk__cache_unref(struct mlk__cache *, struct mlk__cache_entry *, int);
+
+/*
+ * Update the cost of the entry, mlk__cache_collect must be called afterwards
+ * to honor the budget.
+ */
+void
+mlk__cache_charge(struct mlk__cache *, struct mlk__cache_entry *, size_t);
+
+/*
+ * Evict unused entries, least recently used first, until the usage fits in
+ * the budget.
+ */
+void
+mlk__cache_collect(struct mlk__cache *);
+
+/*
+ * Evict every entry, referenced or not.
+ */
+void
+mlk__cache_finish(struct mlk__cache *);
+
+#endif /* !MLK_CORE_CACHE_P_H */
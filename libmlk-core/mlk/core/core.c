@@ -21,7 +21,6 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
-#include <time.h>
 
 #include <libintl.h>
 
@@ -36,8 +35,6 @@ mlk_core_init(const char *organization, const char *name)
 
 	int err;
 
-	srand(time(NULL));
-
 #if defined(MLK_WITH_NLS)
 	bindtextdomain("libmlk-core", mlk_sys_dir(MLK_SYS_DIR_LOCALES));
 #endif
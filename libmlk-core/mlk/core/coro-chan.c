@@ -0,0 +1,243 @@
+/*
+ * coro-chan.c -- bounded channels between coroutines
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <utlist.h>
+
+#include "alloc.h"
+#include "coro-chan.h"
+#include "coro.h"
+#include "coro_p.h"
+#include "err.h"
+
+/*
+ * A coroutine waiting in mlk_coro_chan_select registers one wait per
+ * operation in the sender or receiver list of its channel, they all live on
+ * the coroutine stack. The first peer that acts on any of those channels
+ * unregisters every wait before waking the coroutine up so that a next
+ * operation wakes another waiter rather than this one again.
+ */
+struct select;
+
+struct mlk_coro_chan_wait {
+	struct select *select;
+	struct mlk_coro_chan *chan;
+	enum mlk_coro_chan_dir dir;
+	struct mlk_coro_chan_wait *prev;
+	struct mlk_coro_chan_wait *next;
+};
+
+struct select {
+	struct mlk_coro *coro;
+	struct mlk_coro_chan_wait waits[MLK_CORO_CHAN_SELECT_MAX];
+	size_t waitsz;
+};
+
+static inline struct mlk_coro_chan_wait **
+waiters(struct mlk_coro_chan *chan, enum mlk_coro_chan_dir dir)
+{
+	return dir == MLK_CORO_CHAN_SEND ? &chan->senders : &chan->receivers;
+}
+
+static void
+unregister(void *data)
+{
+	struct select *sel = data;
+	struct mlk_coro_chan_wait *wait;
+
+	for (size_t i = 0; i < sel->waitsz; ++i) {
+		wait = &sel->waits[i];
+		DL_DELETE(*waiters(wait->chan, wait->dir), wait);
+	}
+
+	sel->waitsz = 0;
+}
+
+static void
+wake_one(struct mlk_coro_chan_wait **list)
+{
+	struct select *sel;
+
+	if (*list) {
+		sel = (*list)->select;
+		unregister(sel);
+		mlk__coro_wake(sel->coro);
+	}
+}
+
+static void
+wake_all(struct mlk_coro_chan_wait **list)
+{
+	while (*list)
+		wake_one(list);
+}
+
+void
+mlk_coro_chan_init(struct mlk_coro_chan *chan, size_t elemsz, size_t capacity)
+{
+	assert(chan);
+	assert(elemsz);
+	assert(capacity);
+
+	memset(chan, 0, sizeof (*chan));
+	chan->elemsz = elemsz;
+	chan->capacity = capacity;
+	chan->values = mlk_alloc_new(capacity, elemsz);
+}
+
+int
+mlk_coro_chan_send(struct mlk_coro_chan *chan, const void *data)
+{
+	assert(chan);
+	assert(data);
+
+	struct mlk_coro_chan_op op = {
+		.chan = chan,
+		.dir = MLK_CORO_CHAN_SEND,
+		.data = (void *)data
+	};
+
+	return mlk_coro_chan_select(&op, 1) < 0 ? -1 : 0;
+}
+
+int
+mlk_coro_chan_recv(struct mlk_coro_chan *chan, void *data)
+{
+	assert(chan);
+	assert(data);
+
+	struct mlk_coro_chan_op op = {
+		.chan = chan,
+		.dir = MLK_CORO_CHAN_RECV,
+		.data = data
+	};
+
+	return mlk_coro_chan_select(&op, 1) < 0 ? -1 : 0;
+}
+
+int
+mlk_coro_chan_try_send(struct mlk_coro_chan *chan, const void *data)
+{
+	assert(chan);
+	assert(data);
+
+	size_t tail;
+
+	if (chan->closed || chan->length == chan->capacity)
+		return 0;
+
+	tail = (chan->head + chan->length) % chan->capacity;
+	memcpy(chan->values + tail * chan->elemsz, data, chan->elemsz);
+	chan->length++;
+	wake_one(&chan->receivers);
+
+	return 1;
+}
+
+int
+mlk_coro_chan_try_recv(struct mlk_coro_chan *chan, void *data)
+{
+	assert(chan);
+	assert(data);
+
+	if (!chan->length)
+		return 0;
+
+	memcpy(data, chan->values + chan->head * chan->elemsz, chan->elemsz);
+	chan->head = (chan->head + 1) % chan->capacity;
+	chan->length--;
+	wake_one(&chan->senders);
+
+	return 1;
+}
+
+int
+mlk_coro_chan_select(struct mlk_coro_chan_op *ops, size_t opsz)
+{
+	assert(ops);
+	assert(opsz > 0 && opsz <= MLK_CORO_CHAN_SELECT_MAX);
+
+	struct select sel = {0};
+	struct mlk_coro_chan_wait *wait;
+	struct mlk_coro_chan_op *op;
+	size_t open;
+
+	for (;;) {
+		open = 0;
+
+		for (size_t i = 0; i < opsz; ++i) {
+			op = &ops[i];
+
+			if (op->dir == MLK_CORO_CHAN_SEND) {
+				if (op->chan->closed)
+					continue;
+				if (mlk_coro_chan_try_send(op->chan, op->data))
+					return (int)i;
+			} else {
+				if (mlk_coro_chan_try_recv(op->chan, op->data))
+					return (int)i;
+				if (op->chan->closed)
+					continue;
+			}
+
+			open++;
+		}
+
+		if (!open)
+			return mlk_errf("channel closed");
+
+		/* Nothing possible yet, wait on every open channel. */
+		sel.coro = mlk_coro_self();
+
+		for (size_t i = 0; i < opsz; ++i) {
+			if (ops[i].chan->closed)
+				continue;
+
+			wait = &sel.waits[sel.waitsz++];
+			wait->select = &sel;
+			wait->chan = ops[i].chan;
+			wait->dir = ops[i].dir;
+			DL_APPEND(*waiters(wait->chan, wait->dir), wait);
+		}
+
+		/* Waits are unregistered by the peer waking us up. */
+		mlk__coro_park(unregister, &sel);
+	}
+}
+
+void
+mlk_coro_chan_close(struct mlk_coro_chan *chan)
+{
+	assert(chan);
+
+	chan->closed = 1;
+	wake_all(&chan->senders);
+	wake_all(&chan->receivers);
+}
+
+void
+mlk_coro_chan_finish(struct mlk_coro_chan *chan)
+{
+	assert(chan);
+	assert(!chan->senders && !chan->receivers);
+
+	mlk_alloc_free(chan->values);
+	memset(chan, 0, sizeof (*chan));
+}
@@ -0,0 +1,285 @@
+/*
+ * coro-chan.h -- bounded channels between coroutines
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_CORO_CHAN_H
+#define MLK_CORE_CORO_CHAN_H
+
+/**
+ * \file mlk/core/coro-chan.h
+ * \brief Bounded channels between coroutines.
+ *
+ * A channel is a fixed capacity queue of values of the same size used to pass
+ * messages between scheduled coroutines (see ::mlk_coro_run).
+ *
+ * Sending to a full channel or receiving from an empty one parks the calling
+ * coroutine: it is not resumed by ::mlk_coro_schedule until a peer receives
+ * or sends a value, instead of being resumed every frame to check again as
+ * with ::mlk_coro_push and ::mlk_coro_pull.
+ *
+ * Example of a producer and a consumer:
+ *
+ * ```c
+ * static struct mlk_coro_chan chan;
+ *
+ * static void
+ * producer(struct mlk_coro *self)
+ * {
+ * 	for (int i = 0; i < 100; ++i)
+ * 		mlk_coro_chan_send(&chan, &i);
+ *
+ * 	mlk_coro_chan_close(&chan);
+ * }
+ *
+ * static void
+ * consumer(struct mlk_coro *self)
+ * {
+ * 	int value;
+ *
+ * 	while (mlk_coro_chan_recv(&chan, &value) == 0)
+ * 		printf("%d\n", value);
+ * }
+ *
+ * MLK_CORO_CHAN_INIT(&chan, int, 8);
+ * ```
+ *
+ * Several channels can be waited on at once using ::mlk_coro_chan_select.
+ *
+ * The non-blocking ::mlk_coro_chan_try_send and ::mlk_coro_chan_try_recv can
+ * be used outside of coroutines, for instance to feed a channel from the game
+ * state update function.
+ *
+ * \note Coroutines woken up by a channel operation are resumed on the next
+ *       call to ::mlk_coro_schedule like any other scheduled coroutine.
+ */
+
+#include <stddef.h>
+
+struct mlk_coro_chan_wait;
+
+/**
+ * Maximum number of operations given to ::mlk_coro_chan_select.
+ */
+#define MLK_CORO_CHAN_SELECT_MAX 16
+
+/**
+ * Convenient macro to initialize a channel of values of the given type.
+ */
+#define MLK_CORO_CHAN_INIT(Chan, Type, Capacity) \
+	mlk_coro_chan_init((Chan), sizeof (Type), (Capacity))
+
+/**
+ * \struct mlk_coro_chan
+ * \brief Bounded channel.
+ */
+struct mlk_coro_chan {
+	/**
+	 * (read-only)
+	 *
+	 * Size of one value.
+	 */
+	size_t elemsz;
+
+	/**
+	 * (read-only)
+	 *
+	 * Maximum number of values queued.
+	 */
+	size_t capacity;
+
+	/**
+	 * (read-only)
+	 *
+	 * Number of values currently queued.
+	 */
+	size_t length;
+
+	/**
+	 * (read-only)
+	 *
+	 * Non-zero once closed.
+	 */
+	int closed;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	unsigned char *values;
+	size_t head;
+	struct mlk_coro_chan_wait *senders;
+	struct mlk_coro_chan_wait *receivers;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+/**
+ * \enum mlk_coro_chan_dir
+ * \brief Operation kind for ::mlk_coro_chan_select.
+ */
+enum mlk_coro_chan_dir {
+	/**
+	 * Send the value pointed to by ::mlk_coro_chan_op::data.
+	 */
+	MLK_CORO_CHAN_SEND,
+
+	/**
+	 * Receive a value into ::mlk_coro_chan_op::data.
+	 */
+	MLK_CORO_CHAN_RECV
+};
+
+/**
+ * \struct mlk_coro_chan_op
+ * \brief Operation for ::mlk_coro_chan_select.
+ */
+struct mlk_coro_chan_op {
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * Channel to operate on.
+	 */
+	struct mlk_coro_chan *chan;
+
+	/**
+	 * (read-write)
+	 *
+	 * Operation kind.
+	 */
+	enum mlk_coro_chan_dir dir;
+
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * Value to send or location where to receive it.
+	 */
+	void *data;
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Initialize the channel.
+ *
+ * \pre chan != NULL
+ * \pre elemsz > 0
+ * \pre capacity > 0
+ * \param chan the channel to initialize
+ * \param elemsz the size of one value
+ * \param capacity the maximum number of values queued
+ */
+void
+mlk_coro_chan_init(struct mlk_coro_chan *chan, size_t elemsz, size_t capacity);
+
+/**
+ * Send a value, parking the calling coroutine while the channel is full.
+ *
+ * \pre must be called from a scheduled coroutine
+ * \pre chan != NULL
+ * \pre data != NULL
+ * \param chan the channel
+ * \param data the value to copy (::mlk_coro_chan::elemsz bytes)
+ * \return 0 on success or -1 if the channel is closed
+ */
+int
+mlk_coro_chan_send(struct mlk_coro_chan *chan, const void *data);
+
+/**
+ * Receive a value, parking the calling coroutine while the channel is empty.
+ *
+ * Values queued before the channel was closed are still received.
+ *
+ * \pre must be called from a scheduled coroutine
+ * \pre chan != NULL
+ * \pre data != NULL
+ * \param chan the channel
+ * \param data the destination (::mlk_coro_chan::elemsz bytes)
+ * \return 0 on success or -1 if the channel is closed and empty
+ */
+int
+mlk_coro_chan_recv(struct mlk_coro_chan *chan, void *data);
+
+/**
+ * Send a value only if the channel is open and not full.
+ *
+ * This function can be called from anywhere in the main thread.
+ *
+ * \pre chan != NULL
+ * \pre data != NULL
+ * \param chan the channel
+ * \param data the value to copy
+ * \return non-zero if the value was sent
+ */
+int
+mlk_coro_chan_try_send(struct mlk_coro_chan *chan, const void *data);
+
+/**
+ * Receive a value only if one is available.
+ *
+ * This function can be called from anywhere in the main thread.
+ *
+ * \pre chan != NULL
+ * \pre data != NULL
+ * \param chan the channel
+ * \param data the destination
+ * \return non-zero if a value was received
+ */
+int
+mlk_coro_chan_try_recv(struct mlk_coro_chan *chan, void *data);
+
+/**
+ * Wait until one of the operations can complete and perform it.
+ *
+ * When several operations are possible, the first one in the array is
+ * chosen. Operations on closed channels are ignored, except receiving values
+ * still queued.
+ *
+ * \pre must be called from a scheduled coroutine
+ * \pre ops != NULL
+ * \pre opsz > 0 && opsz <= ::MLK_CORO_CHAN_SELECT_MAX
+ * \param ops the operations
+ * \param opsz the number of operations
+ * \return the index of the operation performed or -1 if every channel is closed
+ */
+int
+mlk_coro_chan_select(struct mlk_coro_chan_op *ops, size_t opsz);
+
+/**
+ * Close the channel.
+ *
+ * Every coroutine waiting on the channel is woken up, pending and further
+ * sends fail while receivers can still get the values queued.
+ *
+ * \pre chan != NULL
+ * \param chan the channel
+ */
+void
+mlk_coro_chan_close(struct mlk_coro_chan *chan);
+
+/**
+ * Cleanup the channel, values still queued are discarded.
+ *
+ * \pre chan != NULL
+ * \pre no coroutine must be waiting on the channel
+ * \param chan the channel
+ */
+void
+mlk_coro_chan_finish(struct mlk_coro_chan *chan);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_CORO_CHAN_H */
@@ -16,11 +16,42 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include "sysconfig.h"
+
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(MLK_HAVE_MMAP) && defined(MLK_HAVE_SYS_MMAN_H)
+#       include <sys/mman.h>
+#       include <unistd.h>
+#       define GUARD
+#endif
+
+#include <utlist.h>
+
+/*
+ * A coroutine destroyed while suspended never returns from its frames, their
+ * redzones stay poisoned and must be cleared before the stack is reused.
+ */
+#if defined(__SANITIZE_ADDRESS__)
+#       define ASAN
+#elif defined(__has_feature)
+#       if __has_feature(address_sanitizer)
+#               define ASAN
+#       endif
+#endif
+
+#if defined(ASAN)
+#       include <sanitizer/asan_interface.h>
+#       define UNPOISON(p, n) ASAN_UNPOISON_MEMORY_REGION((p), (n))
+#else
+#       define UNPOISON(p, n)
+#endif
+
 #include "alloc.h"
 #include "coro.h"
+#include "coro_p.h"
 #include "panic.h"
 
 #define MCO_ALLOC(Size) mlk_alloc_new(1, (Size))
@@ -101,7 +132,7 @@ do {
 
 #define MLK_YIELD(Coro)                                                         \
 do {                                                                            \
-        mco_yield(NULL);                                                        \
+        mco_yield((Coro)->mco_coro);                                            \
 } while (0)
 
 #define MLK_PUSH(Into, Data, Size)                                              \
@@ -116,6 +147,130 @@ do {
 
 #endif
 
+enum state {
+	STATE_NONE,
+	STATE_READY,
+	STATE_RUNNING,
+	STATE_SLEEPING,
+	STATE_WAITING,
+	STATE_PARKED
+};
+
+static struct {
+	struct mlk_coro *ready;
+} sched;
+
+/*
+ * Stack size classes are powers of two from 32KiB to 4MiB, larger stacks are
+ * allocated on demand.
+ */
+#define CLASS_MIN       15
+#define CLASS_LAST      8
+#define CLASS_SIZE(c)   ((size_t)1 << (CLASS_MIN + (c)))
+
+/* Free stack, the link is stored in the unused memory itself. */
+struct block {
+	struct block *next;
+};
+
+struct class {
+	struct block *blocks;
+	size_t blocksz;
+};
+
+static struct {
+	int guard;
+	struct class classes[CLASS_LAST];
+} pool;
+
+static inline int
+class_of(size_t size)
+{
+	for (int c = 0; c < CLASS_LAST; ++c)
+		if (size <= CLASS_SIZE(c))
+			return c;
+
+	return -1;
+}
+
+#if defined(GUARD)
+
+static void *
+guard_alloc(size_t size)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t total = page + ((size + page - 1) & ~(page - 1));
+	unsigned char *base;
+
+	if ((base = mmap(NULL, total, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+		return NULL;
+
+	/* The stack grows downwards, toward the lowest page. */
+	if (mprotect(base, page, PROT_NONE) < 0) {
+		munmap(base, total);
+		return NULL;
+	}
+
+	return base + page;
+}
+
+static void
+guard_free(void *ptr, size_t size)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t total = page + ((size + page - 1) & ~(page - 1));
+
+	munmap((unsigned char *)ptr - page, total);
+}
+
+#endif
+
+static void *
+stack_alloc(size_t size, void *data)
+{
+	struct class *class = data;
+	struct block *block;
+
+#if defined(GUARD)
+	if (data == &pool.guard)
+		return guard_alloc(size);
+#endif
+
+	if (class && (block = class->blocks)) {
+		class->blocks = block->next;
+		class->blocksz--;
+		UNPOISON(block, size);
+
+		return block;
+	}
+
+	return mlk_alloc_new(1, size);
+}
+
+static void
+stack_free(void *ptr, size_t size, void *data)
+{
+	struct class *class = data;
+	struct block *block = ptr;
+
+#if defined(GUARD)
+	if (data == &pool.guard) {
+		guard_free(ptr, size);
+		return;
+	}
+#else
+	(void)size;
+#endif
+
+	if (class && class->blocksz < MLK_CORO_POOL_MAX) {
+		block->next = class->blocks;
+		class->blocks = block;
+		class->blocksz++;
+	} else
+		mlk_alloc_free(ptr);
+}
+
 static void
 mlk_coro_wrap_entry(struct mco_coro *self)
 {
@@ -124,6 +279,94 @@ mlk_coro_wrap_entry(struct mco_coro *self)
 	coro->entry(coro);
 }
 
+static void
+create(struct mlk_coro *coro)
+{
+	enum mco_result rc;
+	size_t size;
+	int c;
+
+	size = coro->stack_size ? coro->stack_size : MCO_DEFAULT_STACK_SIZE;
+
+	if ((c = class_of(size)) >= 0)
+		size = CLASS_SIZE(c);
+
+	coro->mco_desc = mco_desc_init(mlk_coro_wrap_entry, size);
+	coro->mco_desc.user_data = coro;
+	coro->mco_desc.alloc_cb = stack_alloc;
+	coro->mco_desc.dealloc_cb = stack_free;
+
+	if (pool.guard)
+		coro->mco_desc.allocator_data = &pool.guard;
+	else if (c >= 0)
+		coro->mco_desc.allocator_data = &pool.classes[c];
+
+	if ((rc = mco_create(&coro->mco_coro, &coro->mco_desc)) != MCO_SUCCESS)
+		mlk_panicf("mco_create: %d", rc);
+
+	coro->state = STATE_NONE;
+	coro->timer = (const struct mlk_timer) {};
+	coro->waiters = NULL;
+	coro->list = NULL;
+	coro->cancel = NULL;
+	coro->cancel_data = NULL;
+}
+
+static inline void
+enqueue(struct mlk_coro **list, struct mlk_coro *coro, enum state state)
+{
+	DL_APPEND(*list, coro);
+	coro->list = list;
+	coro->state = state;
+}
+
+static inline void
+dequeue(struct mlk_coro *coro)
+{
+	if (coro->list) {
+		DL_DELETE(*coro->list, coro);
+		coro->list = NULL;
+	}
+
+	coro->state = STATE_NONE;
+}
+
+static size_t
+wake_all(struct mlk_coro **list)
+{
+	struct mlk_coro *coro;
+	size_t count = 0;
+
+	while ((coro = *list)) {
+		dequeue(coro);
+		enqueue(&sched.ready, coro, STATE_READY);
+		count++;
+	}
+
+	return count;
+}
+
+static inline void
+suspend(struct mlk_coro **list, enum state state)
+{
+	struct mlk_coro *self = mlk_coro_self();
+
+	assert(self);
+
+	/* Not necessarily scheduled yet, it becomes so once woken up. */
+	dequeue(self);
+	enqueue(list, self, state);
+	MLK_YIELD(self);
+}
+
+static void
+wakeup(struct mlk_timer *timer)
+{
+	struct mlk_coro *coro = timer->data;
+
+	enqueue(&sched.ready, coro, STATE_READY);
+}
+
 void
 mlk_coro_init(struct mlk_coro *coro)
 {
@@ -175,14 +418,7 @@ mlk_coro_spawn(struct mlk_coro *coro)
 	assert(coro);
 	assert(coro->entry);
 
-	enum mco_result rc;
-
-	coro->mco_desc = mco_desc_init(mlk_coro_wrap_entry, coro->stack_size);
-	coro->mco_desc.user_data = coro;
-
-	if ((rc = mco_create(&coro->mco_coro, &coro->mco_desc)) != MCO_SUCCESS)
-		mlk_panicf("mco_create: %d", rc);
-
+	create(coro);
 	mco_resume(coro->mco_coro);
 }
 
@@ -250,6 +486,13 @@ mlk_coro_destroy(struct mlk_coro *coro)
 	if (!coro->mco_coro)
 		return;
 
+	if (coro->state == STATE_PARKED && coro->cancel)
+		coro->cancel(coro->cancel_data);
+
+	mlk_timer_cancel(&coro->timer);
+	dequeue(coro);
+	wake_all(&coro->waiters);
+
 	mco_destroy(coro->mco_coro);
 	coro->mco_coro = NULL;
 	coro->mco_desc = (const struct mco_desc) {};
@@ -257,3 +500,136 @@ mlk_coro_destroy(struct mlk_coro *coro)
 	if (coro->finalizer)
 		coro->finalizer(coro);
 }
+
+void
+mlk_coro_run(struct mlk_coro *coro)
+{
+	assert(coro);
+	assert(coro->entry);
+
+	create(coro);
+	enqueue(&sched.ready, coro, STATE_READY);
+}
+
+void
+mlk_coro_sleep(unsigned int ms)
+{
+	struct mlk_coro *self = mlk_coro_self();
+
+	assert(self);
+
+	/* Not in any list, the timer makes it ready again. */
+	self->timer.fire = wakeup;
+	self->timer.data = self;
+	mlk_timer_schedule(&self->timer, ms);
+
+	dequeue(self);
+	self->state = STATE_SLEEPING;
+	MLK_YIELD(self);
+}
+
+void
+mlk_coro_await(struct mlk_coro *coro)
+{
+	assert(coro);
+	assert(coro != mlk_coro_self());
+
+	if (!coro->mco_coro || mco_status(coro->mco_coro) == MCO_DEAD)
+		return;
+
+	suspend(&coro->waiters, STATE_WAITING);
+}
+
+void
+mlk_coro_event_wait(struct mlk_coro_event *ev)
+{
+	assert(ev);
+
+	suspend(&ev->waiters, STATE_WAITING);
+}
+
+size_t
+mlk_coro_event_signal(struct mlk_coro_event *ev)
+{
+	assert(ev);
+
+	return wake_all(&ev->waiters);
+}
+
+void
+mlk__coro_park(void (*cancel)(void *), void *data)
+{
+	struct mlk_coro *self = mlk_coro_self();
+
+	assert(self);
+
+	dequeue(self);
+	self->state = STATE_PARKED;
+	self->cancel = cancel;
+	self->cancel_data = data;
+	MLK_YIELD(self);
+
+	self->cancel = NULL;
+	self->cancel_data = NULL;
+}
+
+void
+mlk__coro_wake(struct mlk_coro *coro)
+{
+	assert(coro);
+
+	if (coro->state == STATE_PARKED)
+		enqueue(&sched.ready, coro, STATE_READY);
+}
+
+size_t
+mlk_coro_schedule(void)
+{
+	struct mlk_coro *coro, *iter;
+	size_t count = 0, max = 0;
+
+	/*
+	 * Only resume coroutines that were ready on entry, those woken up
+	 * in the meantime wait for the next frame.
+	 */
+	DL_COUNT(sched.ready, iter, max);
+
+	for (; count < max && (coro = sched.ready); ++count) {
+		dequeue(coro);
+		coro->state = STATE_RUNNING;
+		MLK_RESUME(coro);
+
+		if (mco_status(coro->mco_coro) == MCO_DEAD)
+			mlk_coro_destroy(coro);
+		else if (coro->state == STATE_RUNNING)
+			enqueue(&sched.ready, coro, STATE_READY);
+	}
+
+	return count;
+}
+
+void
+mlk_coro_pool_guard(int enable)
+{
+#if defined(GUARD)
+	pool.guard = enable;
+#else
+	(void)enable;
+#endif
+}
+
+void
+mlk_coro_pool_clear(void)
+{
+	struct block *block, *next;
+
+	for (int c = 0; c < CLASS_LAST; ++c) {
+		for (block = pool.classes[c].blocks; block; block = next) {
+			next = block->next;
+			mlk_alloc_free(block);
+		}
+
+		pool.classes[c].blocks = NULL;
+		pool.classes[c].blocksz = 0;
+	}
+}
@@ -47,10 +47,97 @@
  *
  * None of those functions resume any other coroutines and is up to the caller
  * to resume its coroutines in the order required.
+ *
+ * # Scheduler
+ *
+ * Instead of resuming coroutines by hand, they can be started with
+ * ::mlk_coro_run and are then resumed by ::mlk_coro_schedule which is called
+ * once per frame by ::mlk_game_loop.
+ *
+ * A scheduled coroutine is resumed once per frame as long as it only calls
+ * ::mlk_coro_yield. It can also suspend itself until a delay has elapsed using
+ * ::mlk_coro_sleep, until an event is signaled using ::mlk_coro_event_wait or
+ * until another coroutine terminates using ::mlk_coro_await. Coroutines waiting
+ * this way cost nothing until they are woken up, sleeping ones use a
+ * ::mlk_timer which makes the coroutine runnable once it fires.
+ *
+ * Scheduled coroutines are destroyed by the scheduler once their entry
+ * function returns, the finalizer can be used to release them.
+ *
+ * ```c
+ * static struct mlk_coro_event opened;
+ *
+ * static void
+ * guard(struct mlk_coro *self)
+ * {
+ * 	for (;;) {
+ * 		walk_left();
+ * 		mlk_coro_sleep(2000);
+ * 		walk_right();
+ * 		mlk_coro_sleep(2000);
+ * 	}
+ * }
+ *
+ * static void
+ * door(struct mlk_coro *self)
+ * {
+ * 	mlk_coro_event_wait(&opened);
+ * 	play_door_sound();
+ * }
+ *
+ * static struct mlk_coro coros[] = {
+ * 	{ .name = "guard", .entry = guard },
+ * 	{ .name = "door", .entry = door }
+ * };
+ *
+ * mlk_coro_run(&coros[0]);
+ * mlk_coro_run(&coros[1]);
+ *
+ * // Later, from the game or another coroutine.
+ * mlk_coro_event_signal(&opened);
+ * ```
+ *
+ * Scheduled coroutines can exchange values without polling using the bounded
+ * channels from mlk/core/coro-chan.h.
+ *
+ * The scheduler is not thread safe and must only be used from the main thread.
+ *
+ * # Stacks
+ *
+ * Each coroutine owns a stack whose size is given as a hint using
+ * ::mlk_coro::stack_size. Sizes are rounded up to a power of two size class
+ * and stacks of destroyed coroutines are kept per class to be reused by the
+ * next coroutines created, up to ::MLK_CORO_POOL_MAX stacks per class. This
+ * makes short-lived coroutines cheap to create, ::mlk_coro_pool_clear
+ * releases the cached stacks.
+ *
+ * When debugging a stack overflow, ::mlk_coro_pool_guard can be used to
+ * allocate stacks with an inaccessible page below them so that an overflow
+ * crashes immediately rather than corrupting memory. Only the small coroutine
+ * header and storage sit between the stack and the guard page.
  */
 
+#include <stdint.h>
+
 #include <mlk/extern/minicoro.h>
 
+#include "timer.h"
+
+/**
+ * Stack size hint for coroutines that do little work.
+ */
+#define MLK_CORO_STACK_SMALL 32768
+
+/**
+ * Stack size hint for coroutines that need deep call chains.
+ */
+#define MLK_CORO_STACK_LARGE 1048576
+
+/**
+ * Maximum number of stacks kept per size class.
+ */
+#define MLK_CORO_POOL_MAX 32
+
 /**
  * \struct mlk_coro
  * \brief Coroutine object.
@@ -64,6 +151,13 @@ struct mlk_coro {
 	 */
 	const char *name;
 
+	/**
+	 * (init, optional)
+	 *
+	 * Stack size hint in bytes, 0 selects the minicoro default. The value
+	 * is rounded up to the stack size class, see ::MLK_CORO_STACK_SMALL
+	 * and ::MLK_CORO_STACK_LARGE.
+	 */
 	size_t stack_size;
 
 	/**
@@ -88,32 +182,32 @@ struct mlk_coro {
 	 */
 	void (*finalizer)(struct mlk_coro *self);
 
-#if 0
-	/**
-	 * (read-write)
-	 *
-	 * Next coroutine in list.
-	 */
-	struct mlk_coro *next;
+	/* private */
+	struct mco_coro *mco_coro;
+	struct mco_desc  mco_desc;
 
-	/**
-	 * (read-write)
-	 *
-	 * Previous coroutine in list.
-	 */
+	/* Scheduler state, the coroutine is in at most one list at a time. */
+	int state;
+	struct mlk_timer timer;
+	struct mlk_coro *waiters;
+	struct mlk_coro **list;
+	struct mlk_coro *next;
 	struct mlk_coro *prev;
 
-	/**
-	 * (read-write)
-	 *
-	 * Parent list owned.
-	 */
-	struct mlk_coro *parent;
-#endif
+	/* Called if destroyed while parked, see coro_p.h. */
+	void (*cancel)(void *);
+	void *cancel_data;
+};
 
+/**
+ * \struct mlk_coro_event
+ * \brief Event scheduled coroutines can wait on.
+ *
+ * The structure must be zero initialized.
+ */
+struct mlk_coro_event {
 	/* private */
-	struct mco_coro *mco_coro;
-	struct mco_desc  mco_desc;
+	struct mlk_coro *waiters;
 };
 
 #if defined(__cplusplus)
@@ -217,6 +311,9 @@ mlk_coro_queue(struct mlk_coro *into, const void *data, size_t size);
 /**
  * Destroy the coroutine and cleanup internal resources.
  *
+ * If the coroutine was scheduled, it is removed from the scheduler and
+ * coroutines waiting for it using ::mlk_coro_await are woken up.
+ *
  * No-op if already destroyed.
  *
  * \pre The coroutine must not be active.
@@ -224,6 +321,96 @@ mlk_coro_queue(struct mlk_coro *into, const void *data, size_t size);
 void
 mlk_coro_destroy(struct mlk_coro *coro);
 
+/**
+ * Create the coroutine and add it to the scheduler, it will run for the first
+ * time on the next call to ::mlk_coro_schedule.
+ *
+ * \pre coro != NULL
+ * \pre coro->entry != NULL
+ * \param coro the coroutine to run
+ */
+void
+mlk_coro_run(struct mlk_coro *coro);
+
+/**
+ * Suspend the calling coroutine for the given duration.
+ *
+ * The delay is measured by ::mlk_timer_dispatch, the coroutine is resumed by
+ * the first ::mlk_coro_schedule call after the delay has elapsed. A delay of 0
+ * resumes it on the next frame.
+ *
+ * \pre must be called from a coroutine
+ * \param ms the delay in milliseconds
+ */
+void
+mlk_coro_sleep(unsigned int ms);
+
+/**
+ * Suspend the calling coroutine until the given one terminates.
+ *
+ * Return immediately if the coroutine has already terminated or was never
+ * created.
+ *
+ * \pre must be called from a coroutine
+ * \pre coro != NULL
+ * \param coro the coroutine to wait for
+ */
+void
+mlk_coro_await(struct mlk_coro *coro);
+
+/**
+ * Suspend the calling coroutine until the event is signaled.
+ *
+ * \pre must be called from a coroutine
+ * \pre ev != NULL
+ * \param ev the event
+ */
+void
+mlk_coro_event_wait(struct mlk_coro_event *ev);
+
+/**
+ * Wake up every coroutine waiting on the event, they are resumed by the next
+ * call to ::mlk_coro_schedule.
+ *
+ * \pre ev != NULL
+ * \param ev the event
+ * \return the number of coroutines woken up
+ */
+size_t
+mlk_coro_event_signal(struct mlk_coro_event *ev);
+
+/**
+ * Resume every runnable coroutine once.
+ *
+ * Coroutines made runnable while this function executes (e.g. by an event
+ * signaled from another coroutine) are resumed on the next call.
+ *
+ * This function is called by ::mlk_game_loop right after
+ * ::mlk_timer_dispatch, sleeping coroutines whose delay has elapsed are
+ * therefore resumed in the same frame.
+ *
+ * \return the number of coroutines resumed
+ */
+size_t
+mlk_coro_schedule(void);
+
+/**
+ * Enable or disable guard pages for stacks allocated afterwards.
+ *
+ * Guarded stacks are never pooled. This function does nothing on systems
+ * without memory protection support.
+ *
+ * \param enable non-zero to enable
+ */
+void
+mlk_coro_pool_guard(int enable);
+
+/**
+ * Release every cached stack.
+ */
+void
+mlk_coro_pool_clear(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,40 @@
+/*
+ * coro_p.h -- private coroutine scheduler hooks
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_CORO_P_H
+#define MLK_CORE_CORO_P_H
+
+struct mlk_coro;
+
+/*
+ * Suspend the calling coroutine outside of any scheduler list until
+ * mlk__coro_wake is called. The cancel function is invoked with data if the
+ * coroutine is destroyed in the meantime so that the caller can unregister
+ * it from its own wait lists.
+ */
+void
+mlk__coro_park(void (*)(void *), void *);
+
+/*
+ * Make a parked coroutine runnable on the next mlk_coro_schedule call, no-op
+ * if it is not parked.
+ */
+void
+mlk__coro_wake(struct mlk_coro *);
+
+#endif /* !MLK_CORE_CORO_P_H */
@@ -19,19 +19,59 @@
 #include <assert.h>
 #include <string.h>
 
+#include "alloc.h"
 #include "core_p.h"
 #include "drawable.h"
 #include "drawable-stack.h"
 #include "err.h"
 
+/* Initial capacity of growable stacks, doubled when full. */
+#define CAPACITY 8
+
 #define DRAWABLE_FOREACH(st, iter) \
-	for (size_t i = 0; i < (st)->objectsz && ((iter) = (st)->objects[i], 1); ++i)
+	for (size_t i = 0; i < (st)->length && ((iter) = (st)->objects[i], 1); ++i)
+
+static void
+append(struct mlk_drawable_stack *st, struct mlk_drawable *dw)
+{
+	if (st->length == st->objectsz) {
+		st->objectsz = st->objectsz ? st->objectsz * 2 : CAPACITY;
+
+		if (st->objects)
+			st->objects = mlk_alloc_resize(st->objects, st->objectsz);
+		else
+			st->objects = mlk_alloc_new(st->objectsz, sizeof (*st->objects));
+	}
+
+	st->objects[st->length++] = dw;
+}
+
+static void
+compact(struct mlk_drawable_stack *st)
+{
+	size_t length = 0;
+
+	/* Growable stacks keep order, fixed ones only trim the tail. */
+	if (st->grow) {
+		for (size_t i = 0; i < st->length; ++i)
+			if (st->objects[i])
+				st->objects[length++] = st->objects[i];
+	} else {
+		for (length = st->length; length && !st->objects[length - 1]; --length)
+			continue;
+	}
+
+	st->length = length;
+}
 
 void
 mlk_drawable_stack_init(struct mlk_drawable_stack *st)
 {
 	assert(st);
 
+	st->grow = st->objects == NULL;
+	st->length = 0;
+
 	for (size_t i = 0; i < st->objectsz; ++i)
 		st->objects[i] = NULL;
 }
@@ -42,13 +82,26 @@ mlk_drawable_stack_add(struct mlk_drawable_stack *st, struct mlk_drawable *dw)
 	assert(st);
 	assert(dw);
 
-	for (size_t i = 0; i < st->objectsz; ++i) {
+	if (!st->objects)
+		st->grow = 1;
+
+	if (st->grow) {
+		append(st, dw);
+		return 0;
+	}
+
+	for (size_t i = 0; i < st->length; ++i) {
 		if (!st->objects[i]) {
 			st->objects[i] = dw;
 			return 0;
 		}
 	}
 
+	if (st->length < st->objectsz) {
+		st->objects[st->length++] = dw;
+		return 0;
+	}
+
 	return mlk_errf(_("no space in drawable stack"));
 }
 
@@ -73,7 +126,11 @@ mlk_drawable_stack_update(struct mlk_drawable_stack *st, unsigned int ticks)
 
 	struct mlk_drawable *dw;
 
-	for (size_t i = 0; i < st->objectsz; ++i) {
+	/*
+	 * Drawables added meanwhile are appended and updated in this loop as
+	 * well, the array may also be reallocated.
+	 */
+	for (size_t i = 0; i < st->length; ++i) {
 		dw = st->objects[i];
 
 		if (dw && mlk_drawable_update(dw, ticks)) {
@@ -83,6 +140,8 @@ mlk_drawable_stack_update(struct mlk_drawable_stack *st, unsigned int ticks)
 		}
 	}
 
+	compact(st);
+
 	/*
 	 * We process the array again in case a drawable added a new drawable
 	 * within the update function.
@@ -116,6 +175,14 @@ mlk_drawable_stack_finish(struct mlk_drawable_stack *st)
 		}
 	}
 
-	for (size_t i = 0; i < st->objectsz; ++i)
-		st->objects[i] = NULL;
+	if (st->grow) {
+		mlk_alloc_free(st->objects);
+		st->objects = NULL;
+		st->objectsz = 0;
+	} else {
+		for (size_t i = 0; i < st->objectsz; ++i)
+			st->objects[i] = NULL;
+	}
+
+	st->length = 0;
 }
@@ -22,6 +22,13 @@
 /**
  * \file mlk/core/drawable-stack.h
  * \brief Convenient stack of drawable objects
+ *
+ * The stack either uses a fixed array provided by the user (see
+ * ::MLK_DRAWABLE_STACK_DECL) or, if ::mlk_drawable_stack::objects is NULL, an
+ * array allocated and grown as needed which is released by
+ * ::mlk_drawable_stack_finish. A growable stack keeps its drawables
+ * contiguous in insertion order, the slots of completed ones are compacted
+ * once ::mlk_drawable_stack_update has run them all.
  */
 
 #include <stddef.h>
@@ -49,7 +56,7 @@ struct mlk_drawable_stack {
 	/**
 	 * (read-write, borrowed)
 	 *
-	 * Array of non-owning drawables to draw.
+	 * Array of non-owning drawables to draw, NULL for a growable stack.
 	 */
 	struct mlk_drawable **objects;
 
@@ -62,6 +69,18 @@ struct mlk_drawable_stack {
 	 *          dimension.
 	 */
 	size_t objectsz;
+
+	/**
+	 * (read-only)
+	 *
+	 * Number of slots in use from the beginning of the array, completed
+	 * drawables may leave NULL slots within this range in fixed stacks.
+	 */
+	size_t length;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	int grow;
+	/** \endcond MLK_PRIVATE_DECLS */
 };
 
 #if defined(__cplusplus)
@@ -72,7 +91,7 @@ extern "C" {
  * Initialize the drawable stack.
  *
  * This function will set all pointers in the ::mlk_drawable_stack::objects to
- * NULL.
+ * NULL, if the array is NULL the stack is growable.
  *
  * \pre stack != NULL
  * \param stack the drawable stack
@@ -84,7 +103,8 @@ mlk_drawable_stack_init(struct mlk_drawable_stack *stack);
  * Try to append a new drawable into the stack if one slot in the
  * ::mlk_drawable_stack::objects is NULL
  *
- * The object is inserted as-is and ownership is left to the caller.
+ * The object is inserted as-is and ownership is left to the caller. A growable
+ * stack always appends the object, enlarging the array if required.
  *
  * \pre stack != NULL
  * \param stack the drawable stack
@@ -127,6 +147,9 @@ mlk_drawable_stack_draw(struct mlk_drawable_stack *stack);
 /**
  * Invoke ::mlk_drawable_finish on all drawables left.
  *
+ * The array of a growable stack is released, the stack can be used again
+ * afterwards.
+ *
  * \pre stack != NULL
  * \param stack the drawable stack
  */
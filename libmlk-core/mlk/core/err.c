@@ -24,10 +24,9 @@
 #include "core_p.h"
 #include "err.h"
 
-#define ERR_MAX         128
 #define DEFAULT_ERR     _("no error")
 
-static MLK_THREAD_LOCAL char err[ERR_MAX];
+static MLK_THREAD_LOCAL char err[MLK_ERR_MAX];
 
 int
 mlk_errf(const char *fmt, ...)
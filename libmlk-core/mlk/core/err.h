@@ -36,6 +36,11 @@
 
 #include <stdarg.h>
 
+/**
+ * Maximum length of an error string, including the NUL terminator.
+ */
+#define MLK_ERR_MAX 128
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -16,202 +16,211 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <assert.h>
 #include <string.h>
 
 #include <SDL3/SDL.h>
 
 #include "event.h"
+#include "util.h"
+
+/*
+ * Printable keys use their character as keycode while others have
+ * SDLK_SCANCODE_MASK set along with their scancode, both kinds are stored
+ * in the same table indexed directly by the keycode.
+ */
+#define KEY_ASCII 128
+#define KEY_INDEX(k) \
+	(((k) & SDLK_SCANCODE_MASK) ? KEY_ASCII + ((k) & ~SDLK_SCANCODE_MASK) : (k))
 
 /* Maintain with enum key constants in key.h */
-static const struct {
-	SDL_Keycode key;
-	enum mlk_key value;
-} keymap[] = {
-	{ SDLK_RETURN,          MLK_KEY_ENTER                   },
-	{ SDLK_ESCAPE,          MLK_KEY_ESCAPE                  },
-	{ SDLK_BACKSPACE,       MLK_KEY_BACKSPACE               },
-	{ SDLK_TAB,             MLK_KEY_TAB                     },
-	{ SDLK_SPACE,           MLK_KEY_SPACE                   },
-	{ SDLK_EXCLAIM,         MLK_KEY_EXCLAIM                 },
-	{ SDLK_DBLAPOSTROPHE,   MLK_KEY_DOUBLE_QUOTE            },
-	{ SDLK_HASH,            MLK_KEY_HASH                    },
-	{ SDLK_PERCENT,         MLK_KEY_PERCENT                 },
-	{ SDLK_DOLLAR,          MLK_KEY_DOLLAR                  },
-	{ SDLK_AMPERSAND,       MLK_KEY_AMPERSAND               },
-	{ SDLK_APOSTROPHE,      MLK_KEY_QUOTE                   },
-	{ SDLK_LEFTPAREN,       MLK_KEY_LPAREN                  },
-	{ SDLK_RIGHTPAREN,      MLK_KEY_RPAREN                  },
-	{ SDLK_ASTERISK,        MLK_KEY_ASTERISK                },
-	{ SDLK_PLUS,            MLK_KEY_PLUS                    },
-	{ SDLK_COMMA,           MLK_KEY_COMMA                   },
-	{ SDLK_MINUS,           MLK_KEY_MINUS                   },
-	{ SDLK_PERIOD,          MLK_KEY_PERIOD                  },
-	{ SDLK_SLASH,           MLK_KEY_SLASH                   },
-	{ SDLK_0,               MLK_KEY_0                       },
-	{ SDLK_1,               MLK_KEY_1                       },
-	{ SDLK_2,               MLK_KEY_2                       },
-	{ SDLK_3,               MLK_KEY_3                       },
-	{ SDLK_4,               MLK_KEY_4                       },
-	{ SDLK_5,               MLK_KEY_5                       },
-	{ SDLK_6,               MLK_KEY_6                       },
-	{ SDLK_7,               MLK_KEY_7                       },
-	{ SDLK_8,               MLK_KEY_8                       },
-	{ SDLK_9,               MLK_KEY_9                       },
-	{ SDLK_COLON,           MLK_KEY_COLON                   },
-	{ SDLK_SEMICOLON,       MLK_KEY_SEMICOLON               },
-	{ SDLK_LESS,            MLK_KEY_LESS                    },
-	{ SDLK_EQUALS,          MLK_KEY_EQUALS                  },
-	{ SDLK_GREATER,         MLK_KEY_GREATER                 },
-	{ SDLK_QUESTION,        MLK_KEY_QUESTION                },
-	{ SDLK_AT,              MLK_KEY_AT                      },
-	{ SDLK_LEFTBRACKET,     MLK_KEY_LBRACKET                },
-	{ SDLK_BACKSLASH,       MLK_KEY_BACKSLASH               },
-	{ SDLK_RIGHTBRACKET,    MLK_KEY_RBRACKET                },
-	{ SDLK_CARET,           MLK_KEY_CARET                   },
-	{ SDLK_UNDERSCORE,      MLK_KEY_UNDERSCORE              },
-	{ SDLK_GRAVE,           MLK_KEY_BACKQUOTE               },
-	{ SDLK_A,               MLK_KEY_A                       },
-	{ SDLK_B,               MLK_KEY_B                       },
-	{ SDLK_C,               MLK_KEY_C                       },
-	{ SDLK_D,               MLK_KEY_D                       },
-	{ SDLK_E,               MLK_KEY_E                       },
-	{ SDLK_F,               MLK_KEY_F                       },
-	{ SDLK_G,               MLK_KEY_G                       },
-	{ SDLK_H,               MLK_KEY_H                       },
-	{ SDLK_I,               MLK_KEY_I                       },
-	{ SDLK_J,               MLK_KEY_J                       },
-	{ SDLK_K,               MLK_KEY_K                       },
-	{ SDLK_L,               MLK_KEY_L                       },
-	{ SDLK_M,               MLK_KEY_M                       },
-	{ SDLK_N,               MLK_KEY_N                       },
-	{ SDLK_O,               MLK_KEY_O                       },
-	{ SDLK_P,               MLK_KEY_P                       },
-	{ SDLK_Q,               MLK_KEY_Q                       },
-	{ SDLK_R,               MLK_KEY_R                       },
-	{ SDLK_S,               MLK_KEY_S                       },
-	{ SDLK_T,               MLK_KEY_T                       },
-	{ SDLK_U,               MLK_KEY_U                       },
-	{ SDLK_V,               MLK_KEY_V                       },
-	{ SDLK_W,               MLK_KEY_W                       },
-	{ SDLK_X,               MLK_KEY_X                       },
-	{ SDLK_Y,               MLK_KEY_Y                       },
-	{ SDLK_Z,               MLK_KEY_Z                       },
-	{ SDLK_CAPSLOCK,        MLK_KEY_CAPSLOCK                },
-	{ SDLK_F1,              MLK_KEY_F1                      },
-	{ SDLK_F2,              MLK_KEY_F2                      },
-	{ SDLK_F3,              MLK_KEY_F3                      },
-	{ SDLK_F4,              MLK_KEY_F4                      },
-	{ SDLK_F5,              MLK_KEY_F5                      },
-	{ SDLK_F6,              MLK_KEY_F6                      },
-	{ SDLK_F7,              MLK_KEY_F7                      },
-	{ SDLK_F8,              MLK_KEY_F8                      },
-	{ SDLK_F9,              MLK_KEY_F9                      },
-	{ SDLK_F10,             MLK_KEY_F10                     },
-	{ SDLK_F11,             MLK_KEY_F11                     },
-	{ SDLK_F12,             MLK_KEY_F12                     },
-	{ SDLK_F13,             MLK_KEY_F13                     },
-	{ SDLK_F14,             MLK_KEY_F14                     },
-	{ SDLK_F15,             MLK_KEY_F15                     },
-	{ SDLK_F16,             MLK_KEY_F16                     },
-	{ SDLK_F17,             MLK_KEY_F17                     },
-	{ SDLK_F18,             MLK_KEY_F18                     },
-	{ SDLK_F19,             MLK_KEY_F19                     },
-	{ SDLK_F20,             MLK_KEY_F20                     },
-	{ SDLK_F21,             MLK_KEY_F21                     },
-	{ SDLK_F22,             MLK_KEY_F22                     },
-	{ SDLK_F23,             MLK_KEY_F23                     },
-	{ SDLK_F24,             MLK_KEY_F24                     },
-	{ SDLK_PRINTSCREEN,     MLK_KEY_PRINTSCREEN             },
-	{ SDLK_SCROLLLOCK,      MLK_KEY_SCROLL_LOCK             },
-	{ SDLK_PAUSE,           MLK_KEY_PAUSE                   },
-	{ SDLK_INSERT,          MLK_KEY_INSERT                  },
-	{ SDLK_HOME,            MLK_KEY_HOME                    },
-	{ SDLK_PAGEUP,          MLK_KEY_PAGEUP                  },
-	{ SDLK_DELETE,          MLK_KEY_DELETE                  },
-	{ SDLK_END,             MLK_KEY_END                     },
-	{ SDLK_PAGEDOWN,        MLK_KEY_PAGEDOWN                },
-	{ SDLK_RIGHT,           MLK_KEY_RIGHT                   },
-	{ SDLK_LEFT,            MLK_KEY_LEFT                    },
-	{ SDLK_DOWN,            MLK_KEY_DOWN                    },
-	{ SDLK_UP,              MLK_KEY_UP                      },
-	{ SDLK_KP_DIVIDE,       MLK_KEY_KP_DIVIDE               },
-	{ SDLK_KP_MULTIPLY,     MLK_KEY_KP_MULTIPLY             },
-	{ SDLK_KP_MINUS,        MLK_KEY_KP_MINUS                },
-	{ SDLK_KP_PLUS,         MLK_KEY_KP_PLUS                 },
-	{ SDLK_KP_ENTER,        MLK_KEY_KP_ENTER                },
-	{ SDLK_KP_1,            MLK_KEY_KP_1                    },
-	{ SDLK_KP_2,            MLK_KEY_KP_2                    },
-	{ SDLK_KP_3,            MLK_KEY_KP_3                    },
-	{ SDLK_KP_4,            MLK_KEY_KP_4                    },
-	{ SDLK_KP_5,            MLK_KEY_KP_5                    },
-	{ SDLK_KP_6,            MLK_KEY_KP_6                    },
-	{ SDLK_KP_7,            MLK_KEY_KP_7                    },
-	{ SDLK_KP_8,            MLK_KEY_KP_8                    },
-	{ SDLK_KP_9,            MLK_KEY_KP_9                    },
-	{ SDLK_KP_0,            MLK_KEY_KP_0                    },
-	{ SDLK_KP_PERIOD,       MLK_KEY_KP_PERIOD               },
-	{ SDLK_KP_COMMA,        MLK_KEY_KP_COMMA                },
-	{ SDLK_MENU,            MLK_KEY_MENU                    },
-	{ SDLK_MUTE,            MLK_KEY_MUTE                    },
-	{ SDLK_VOLUMEUP,        MLK_KEY_VOLUME_UP               },
-	{ SDLK_VOLUMEDOWN,      MLK_KEY_VOLUME_DOWN             },
-	{ SDLK_LCTRL,           MLK_KEY_LCTRL                   },
-	{ SDLK_LSHIFT,          MLK_KEY_LSHIFT                  },
-	{ SDLK_LALT,            MLK_KEY_LALT                    },
-	{ SDLK_LGUI,            MLK_KEY_LSUPER                  },
-	{ SDLK_RCTRL,           MLK_KEY_RCTRL                   },
-	{ SDLK_RSHIFT,          MLK_KEY_RSHIFT                  },
-	{ SDLK_RALT,            MLK_KEY_RALT                    },
-	{ SDLK_RGUI,            MLK_KEY_RSUPER                  },
-	{ 0,                    -1                              }
+static const enum mlk_key keymap[KEY_ASCII + SDL_SCANCODE_COUNT] = {
+	[KEY_INDEX(SDLK_RETURN)]        = MLK_KEY_ENTER,
+	[KEY_INDEX(SDLK_ESCAPE)]        = MLK_KEY_ESCAPE,
+	[KEY_INDEX(SDLK_BACKSPACE)]     = MLK_KEY_BACKSPACE,
+	[KEY_INDEX(SDLK_TAB)]           = MLK_KEY_TAB,
+	[KEY_INDEX(SDLK_SPACE)]         = MLK_KEY_SPACE,
+	[KEY_INDEX(SDLK_EXCLAIM)]       = MLK_KEY_EXCLAIM,
+	[KEY_INDEX(SDLK_DBLAPOSTROPHE)] = MLK_KEY_DOUBLE_QUOTE,
+	[KEY_INDEX(SDLK_HASH)]          = MLK_KEY_HASH,
+	[KEY_INDEX(SDLK_PERCENT)]       = MLK_KEY_PERCENT,
+	[KEY_INDEX(SDLK_DOLLAR)]        = MLK_KEY_DOLLAR,
+	[KEY_INDEX(SDLK_AMPERSAND)]     = MLK_KEY_AMPERSAND,
+	[KEY_INDEX(SDLK_APOSTROPHE)]    = MLK_KEY_QUOTE,
+	[KEY_INDEX(SDLK_LEFTPAREN)]     = MLK_KEY_LPAREN,
+	[KEY_INDEX(SDLK_RIGHTPAREN)]    = MLK_KEY_RPAREN,
+	[KEY_INDEX(SDLK_ASTERISK)]      = MLK_KEY_ASTERISK,
+	[KEY_INDEX(SDLK_PLUS)]          = MLK_KEY_PLUS,
+	[KEY_INDEX(SDLK_COMMA)]         = MLK_KEY_COMMA,
+	[KEY_INDEX(SDLK_MINUS)]         = MLK_KEY_MINUS,
+	[KEY_INDEX(SDLK_PERIOD)]        = MLK_KEY_PERIOD,
+	[KEY_INDEX(SDLK_SLASH)]         = MLK_KEY_SLASH,
+	[KEY_INDEX(SDLK_0)]             = MLK_KEY_0,
+	[KEY_INDEX(SDLK_1)]             = MLK_KEY_1,
+	[KEY_INDEX(SDLK_2)]             = MLK_KEY_2,
+	[KEY_INDEX(SDLK_3)]             = MLK_KEY_3,
+	[KEY_INDEX(SDLK_4)]             = MLK_KEY_4,
+	[KEY_INDEX(SDLK_5)]             = MLK_KEY_5,
+	[KEY_INDEX(SDLK_6)]             = MLK_KEY_6,
+	[KEY_INDEX(SDLK_7)]             = MLK_KEY_7,
+	[KEY_INDEX(SDLK_8)]             = MLK_KEY_8,
+	[KEY_INDEX(SDLK_9)]             = MLK_KEY_9,
+	[KEY_INDEX(SDLK_COLON)]         = MLK_KEY_COLON,
+	[KEY_INDEX(SDLK_SEMICOLON)]     = MLK_KEY_SEMICOLON,
+	[KEY_INDEX(SDLK_LESS)]          = MLK_KEY_LESS,
+	[KEY_INDEX(SDLK_EQUALS)]        = MLK_KEY_EQUALS,
+	[KEY_INDEX(SDLK_GREATER)]       = MLK_KEY_GREATER,
+	[KEY_INDEX(SDLK_QUESTION)]      = MLK_KEY_QUESTION,
+	[KEY_INDEX(SDLK_AT)]            = MLK_KEY_AT,
+	[KEY_INDEX(SDLK_LEFTBRACKET)]   = MLK_KEY_LBRACKET,
+	[KEY_INDEX(SDLK_BACKSLASH)]     = MLK_KEY_BACKSLASH,
+	[KEY_INDEX(SDLK_RIGHTBRACKET)]  = MLK_KEY_RBRACKET,
+	[KEY_INDEX(SDLK_CARET)]         = MLK_KEY_CARET,
+	[KEY_INDEX(SDLK_UNDERSCORE)]    = MLK_KEY_UNDERSCORE,
+	[KEY_INDEX(SDLK_GRAVE)]         = MLK_KEY_BACKQUOTE,
+	[KEY_INDEX(SDLK_A)]             = MLK_KEY_A,
+	[KEY_INDEX(SDLK_B)]             = MLK_KEY_B,
+	[KEY_INDEX(SDLK_C)]             = MLK_KEY_C,
+	[KEY_INDEX(SDLK_D)]             = MLK_KEY_D,
+	[KEY_INDEX(SDLK_E)]             = MLK_KEY_E,
+	[KEY_INDEX(SDLK_F)]             = MLK_KEY_F,
+	[KEY_INDEX(SDLK_G)]             = MLK_KEY_G,
+	[KEY_INDEX(SDLK_H)]             = MLK_KEY_H,
+	[KEY_INDEX(SDLK_I)]             = MLK_KEY_I,
+	[KEY_INDEX(SDLK_J)]             = MLK_KEY_J,
+	[KEY_INDEX(SDLK_K)]             = MLK_KEY_K,
+	[KEY_INDEX(SDLK_L)]             = MLK_KEY_L,
+	[KEY_INDEX(SDLK_M)]             = MLK_KEY_M,
+	[KEY_INDEX(SDLK_N)]             = MLK_KEY_N,
+	[KEY_INDEX(SDLK_O)]             = MLK_KEY_O,
+	[KEY_INDEX(SDLK_P)]             = MLK_KEY_P,
+	[KEY_INDEX(SDLK_Q)]             = MLK_KEY_Q,
+	[KEY_INDEX(SDLK_R)]             = MLK_KEY_R,
+	[KEY_INDEX(SDLK_S)]             = MLK_KEY_S,
+	[KEY_INDEX(SDLK_T)]             = MLK_KEY_T,
+	[KEY_INDEX(SDLK_U)]             = MLK_KEY_U,
+	[KEY_INDEX(SDLK_V)]             = MLK_KEY_V,
+	[KEY_INDEX(SDLK_W)]             = MLK_KEY_W,
+	[KEY_INDEX(SDLK_X)]             = MLK_KEY_X,
+	[KEY_INDEX(SDLK_Y)]             = MLK_KEY_Y,
+	[KEY_INDEX(SDLK_Z)]             = MLK_KEY_Z,
+	[KEY_INDEX(SDLK_CAPSLOCK)]      = MLK_KEY_CAPSLOCK,
+	[KEY_INDEX(SDLK_F1)]            = MLK_KEY_F1,
+	[KEY_INDEX(SDLK_F2)]            = MLK_KEY_F2,
+	[KEY_INDEX(SDLK_F3)]            = MLK_KEY_F3,
+	[KEY_INDEX(SDLK_F4)]            = MLK_KEY_F4,
+	[KEY_INDEX(SDLK_F5)]            = MLK_KEY_F5,
+	[KEY_INDEX(SDLK_F6)]            = MLK_KEY_F6,
+	[KEY_INDEX(SDLK_F7)]            = MLK_KEY_F7,
+	[KEY_INDEX(SDLK_F8)]            = MLK_KEY_F8,
+	[KEY_INDEX(SDLK_F9)]            = MLK_KEY_F9,
+	[KEY_INDEX(SDLK_F10)]           = MLK_KEY_F10,
+	[KEY_INDEX(SDLK_F11)]           = MLK_KEY_F11,
+	[KEY_INDEX(SDLK_F12)]           = MLK_KEY_F12,
+	[KEY_INDEX(SDLK_F13)]           = MLK_KEY_F13,
+	[KEY_INDEX(SDLK_F14)]           = MLK_KEY_F14,
+	[KEY_INDEX(SDLK_F15)]           = MLK_KEY_F15,
+	[KEY_INDEX(SDLK_F16)]           = MLK_KEY_F16,
+	[KEY_INDEX(SDLK_F17)]           = MLK_KEY_F17,
+	[KEY_INDEX(SDLK_F18)]           = MLK_KEY_F18,
+	[KEY_INDEX(SDLK_F19)]           = MLK_KEY_F19,
+	[KEY_INDEX(SDLK_F20)]           = MLK_KEY_F20,
+	[KEY_INDEX(SDLK_F21)]           = MLK_KEY_F21,
+	[KEY_INDEX(SDLK_F22)]           = MLK_KEY_F22,
+	[KEY_INDEX(SDLK_F23)]           = MLK_KEY_F23,
+	[KEY_INDEX(SDLK_F24)]           = MLK_KEY_F24,
+	[KEY_INDEX(SDLK_PRINTSCREEN)]   = MLK_KEY_PRINTSCREEN,
+	[KEY_INDEX(SDLK_SCROLLLOCK)]    = MLK_KEY_SCROLL_LOCK,
+	[KEY_INDEX(SDLK_PAUSE)]         = MLK_KEY_PAUSE,
+	[KEY_INDEX(SDLK_INSERT)]        = MLK_KEY_INSERT,
+	[KEY_INDEX(SDLK_HOME)]          = MLK_KEY_HOME,
+	[KEY_INDEX(SDLK_PAGEUP)]        = MLK_KEY_PAGEUP,
+	[KEY_INDEX(SDLK_DELETE)]        = MLK_KEY_DELETE,
+	[KEY_INDEX(SDLK_END)]           = MLK_KEY_END,
+	[KEY_INDEX(SDLK_PAGEDOWN)]      = MLK_KEY_PAGEDOWN,
+	[KEY_INDEX(SDLK_RIGHT)]         = MLK_KEY_RIGHT,
+	[KEY_INDEX(SDLK_LEFT)]          = MLK_KEY_LEFT,
+	[KEY_INDEX(SDLK_DOWN)]          = MLK_KEY_DOWN,
+	[KEY_INDEX(SDLK_UP)]            = MLK_KEY_UP,
+	[KEY_INDEX(SDLK_KP_DIVIDE)]     = MLK_KEY_KP_DIVIDE,
+	[KEY_INDEX(SDLK_KP_MULTIPLY)]   = MLK_KEY_KP_MULTIPLY,
+	[KEY_INDEX(SDLK_KP_MINUS)]      = MLK_KEY_KP_MINUS,
+	[KEY_INDEX(SDLK_KP_PLUS)]       = MLK_KEY_KP_PLUS,
+	[KEY_INDEX(SDLK_KP_ENTER)]      = MLK_KEY_KP_ENTER,
+	[KEY_INDEX(SDLK_KP_1)]          = MLK_KEY_KP_1,
+	[KEY_INDEX(SDLK_KP_2)]          = MLK_KEY_KP_2,
+	[KEY_INDEX(SDLK_KP_3)]          = MLK_KEY_KP_3,
+	[KEY_INDEX(SDLK_KP_4)]          = MLK_KEY_KP_4,
+	[KEY_INDEX(SDLK_KP_5)]          = MLK_KEY_KP_5,
+	[KEY_INDEX(SDLK_KP_6)]          = MLK_KEY_KP_6,
+	[KEY_INDEX(SDLK_KP_7)]          = MLK_KEY_KP_7,
+	[KEY_INDEX(SDLK_KP_8)]          = MLK_KEY_KP_8,
+	[KEY_INDEX(SDLK_KP_9)]          = MLK_KEY_KP_9,
+	[KEY_INDEX(SDLK_KP_0)]          = MLK_KEY_KP_0,
+	[KEY_INDEX(SDLK_KP_PERIOD)]     = MLK_KEY_KP_PERIOD,
+	[KEY_INDEX(SDLK_KP_COMMA)]      = MLK_KEY_KP_COMMA,
+	[KEY_INDEX(SDLK_MENU)]          = MLK_KEY_MENU,
+	[KEY_INDEX(SDLK_MUTE)]          = MLK_KEY_MUTE,
+	[KEY_INDEX(SDLK_VOLUMEUP)]      = MLK_KEY_VOLUME_UP,
+	[KEY_INDEX(SDLK_VOLUMEDOWN)]    = MLK_KEY_VOLUME_DOWN,
+	[KEY_INDEX(SDLK_LCTRL)]         = MLK_KEY_LCTRL,
+	[KEY_INDEX(SDLK_LSHIFT)]        = MLK_KEY_LSHIFT,
+	[KEY_INDEX(SDLK_LALT)]          = MLK_KEY_LALT,
+	[KEY_INDEX(SDLK_LGUI)]          = MLK_KEY_LSUPER,
+	[KEY_INDEX(SDLK_RCTRL)]         = MLK_KEY_RCTRL,
+	[KEY_INDEX(SDLK_RSHIFT)]        = MLK_KEY_RSHIFT,
+	[KEY_INDEX(SDLK_RALT)]          = MLK_KEY_RALT,
+	[KEY_INDEX(SDLK_RGUI)]          = MLK_KEY_RSUPER,
 };
 
 /* Maintain with enum mouse_button constants in mouse.h */
-static const struct {
-	int key;
-	enum mlk_mouse_button value;
-} buttons[] = {
-	{ SDL_BUTTON_LEFT,      MLK_MOUSE_BUTTON_LEFT   },
-	{ SDL_BUTTON_MIDDLE,    MLK_MOUSE_BUTTON_MIDDLE },
-	{ SDL_BUTTON_RIGHT,     MLK_MOUSE_BUTTON_RIGHT  },
-	{ -1,                   MLK_MOUSE_BUTTON_NONE   }
+static const enum mlk_mouse_button buttons[] = {
+	[SDL_BUTTON_LEFT]   = MLK_MOUSE_BUTTON_LEFT,
+	[SDL_BUTTON_MIDDLE] = MLK_MOUSE_BUTTON_MIDDLE,
+	[SDL_BUTTON_RIGHT]  = MLK_MOUSE_BUTTON_RIGHT,
 };
 
 /* Maintain with enum mlk_gamepad_button in gamepad.h */
-static const struct {
-	int button;
-	enum mlk_gamepad_button value;
-} pads[] = {
-	{ SDL_GAMEPAD_BUTTON_LABEL_A,           MLK_GAMEPAD_BUTTON_A            },
-	{ SDL_GAMEPAD_BUTTON_LABEL_B,           MLK_GAMEPAD_BUTTON_B            },
-	{ SDL_GAMEPAD_BUTTON_LABEL_X,           MLK_GAMEPAD_BUTTON_X            },
-	{ SDL_GAMEPAD_BUTTON_LABEL_Y,           MLK_GAMEPAD_BUTTON_Y            },
-	{ SDL_GAMEPAD_BUTTON_BACK,              MLK_GAMEPAD_BUTTON_BACK         },
-	{ SDL_GAMEPAD_BUTTON_GUIDE,             MLK_GAMEPAD_BUTTON_LOGO         },
-	{ SDL_GAMEPAD_BUTTON_START,             MLK_GAMEPAD_BUTTON_START        },
-	{ SDL_GAMEPAD_BUTTON_LEFT_STICK,        MLK_GAMEPAD_BUTTON_LTHUMB       },
-	{ SDL_GAMEPAD_BUTTON_RIGHT_STICK,       MLK_GAMEPAD_BUTTON_RTHUMB       },
-	{ SDL_GAMEPAD_BUTTON_LEFT_SHOULDER,     MLK_GAMEPAD_BUTTON_LSHOULDER    },
-	{ SDL_GAMEPAD_BUTTON_RIGHT_SHOULDER,    MLK_GAMEPAD_BUTTON_RSHOULDER    },
-	{ SDL_GAMEPAD_BUTTON_DPAD_UP,           MLK_GAMEPAD_BUTTON_UP           },
-	{ SDL_GAMEPAD_BUTTON_DPAD_DOWN,         MLK_GAMEPAD_BUTTON_DOWN         },
-	{ SDL_GAMEPAD_BUTTON_DPAD_LEFT,         MLK_GAMEPAD_BUTTON_LEFT         },
-	{ SDL_GAMEPAD_BUTTON_DPAD_RIGHT,        MLK_GAMEPAD_BUTTON_RIGHT        },
-	{ -1,                                   MLK_GAMEPAD_BUTTON_UNKNOWN      }
+static const enum mlk_gamepad_button pads[SDL_GAMEPAD_BUTTON_COUNT] = {
+	[SDL_GAMEPAD_BUTTON_SOUTH]          = MLK_GAMEPAD_BUTTON_A,
+	[SDL_GAMEPAD_BUTTON_EAST]           = MLK_GAMEPAD_BUTTON_B,
+	[SDL_GAMEPAD_BUTTON_WEST]           = MLK_GAMEPAD_BUTTON_X,
+	[SDL_GAMEPAD_BUTTON_NORTH]          = MLK_GAMEPAD_BUTTON_Y,
+	[SDL_GAMEPAD_BUTTON_BACK]           = MLK_GAMEPAD_BUTTON_BACK,
+	[SDL_GAMEPAD_BUTTON_GUIDE]          = MLK_GAMEPAD_BUTTON_LOGO,
+	[SDL_GAMEPAD_BUTTON_START]          = MLK_GAMEPAD_BUTTON_START,
+	[SDL_GAMEPAD_BUTTON_LEFT_STICK]     = MLK_GAMEPAD_BUTTON_LTHUMB,
+	[SDL_GAMEPAD_BUTTON_RIGHT_STICK]    = MLK_GAMEPAD_BUTTON_RTHUMB,
+	[SDL_GAMEPAD_BUTTON_LEFT_SHOULDER]  = MLK_GAMEPAD_BUTTON_LSHOULDER,
+	[SDL_GAMEPAD_BUTTON_RIGHT_SHOULDER] = MLK_GAMEPAD_BUTTON_RSHOULDER,
+	[SDL_GAMEPAD_BUTTON_DPAD_UP]        = MLK_GAMEPAD_BUTTON_UP,
+	[SDL_GAMEPAD_BUTTON_DPAD_DOWN]      = MLK_GAMEPAD_BUTTON_DOWN,
+	[SDL_GAMEPAD_BUTTON_DPAD_LEFT]      = MLK_GAMEPAD_BUTTON_LEFT,
+	[SDL_GAMEPAD_BUTTON_DPAD_RIGHT]     = MLK_GAMEPAD_BUTTON_RIGHT,
+};
+
+/* Maintain with enum mlk_gamepad_axis in gamepad.h */
+static const enum mlk_gamepad_axis axises[SDL_GAMEPAD_AXIS_COUNT] = {
+	[SDL_GAMEPAD_AXIS_LEFTX]         = MLK_GAMEPAD_AXIS_LX,
+	[SDL_GAMEPAD_AXIS_LEFTY]         = MLK_GAMEPAD_AXIS_LY,
+	[SDL_GAMEPAD_AXIS_RIGHTX]        = MLK_GAMEPAD_AXIS_RX,
+	[SDL_GAMEPAD_AXIS_RIGHTY]        = MLK_GAMEPAD_AXIS_RY,
+	[SDL_GAMEPAD_AXIS_LEFT_TRIGGER]  = MLK_GAMEPAD_AXIS_LTRIGGER,
+	[SDL_GAMEPAD_AXIS_RIGHT_TRIGGER] = MLK_GAMEPAD_AXIS_RTRIGGER,
 };
 
 static void
 convert_key(const SDL_Event *event, union mlk_event *ev)
 {
+	SDL_Keycode key = event->key.key;
+
 	ev->type = event->type == SDL_EVENT_KEY_DOWN ? MLK_EVENT_KEYDOWN : MLK_EVENT_KEYUP;
 	ev->key.key = MLK_KEY_UNKNOWN;
 
-	for (size_t i = 0; keymap[i].key != 0; ++i) {
-		if (keymap[i].key == event->key.key) {
-			ev->key.key = keymap[i].value;
-			break;
-		}
-	}
+	/* Unicode characters beyond ASCII are not mapped. */
+	if ((key & SDLK_SCANCODE_MASK) || key < KEY_ASCII)
+		if (KEY_INDEX(key) < MLK_UTIL_SIZE(keymap))
+			ev->key.key = keymap[KEY_INDEX(key)];
 }
 
 static void
@@ -239,58 +248,35 @@ convert_click(const SDL_Event *event, union mlk_event *ev)
 	ev->click.y = event->button.y;
 	ev->click.clicks = event->button.clicks;
 
-	for (size_t i = 0; buttons[i].value != MLK_MOUSE_BUTTON_NONE; ++i) {
-		if (buttons[i].key == event->button.button) {
-			ev->click.button = buttons[i].value;
-			break;
-		}
-	}
+	if (event->button.button < MLK_UTIL_SIZE(buttons))
+		ev->click.button = buttons[event->button.button];
 }
 
 static void
 convert_button(const SDL_Event *event, union mlk_event *ev)
 {
 	ev->type = event->type == SDL_EVENT_GAMEPAD_BUTTON_DOWN ? MLK_EVENT_BUTTONDOWN : MLK_EVENT_BUTTONUP;
+	ev->button.button = MLK_GAMEPAD_BUTTON_UNKNOWN;
 
-	for (size_t i = 0; pads[i].value != MLK_GAMEPAD_BUTTON_UNKNOWN; ++i) {
-		if (pads[i].button == event->gbutton.button) {
-			ev->button.button = pads[i].value;
-			break;
-		}
-	}
+	if (event->gbutton.button < MLK_UTIL_SIZE(pads))
+		ev->button.button = pads[event->gbutton.button];
 }
 
-static const struct {
-	int axis;
-	enum mlk_gamepad_axis value;
-} axises[] = {
-	{ SDL_GAMEPAD_AXIS_LEFTX,               MLK_GAMEPAD_AXIS_LX             },
-	{ SDL_GAMEPAD_AXIS_LEFTY,               MLK_GAMEPAD_AXIS_LY             },
-	{ SDL_GAMEPAD_AXIS_RIGHTX,              MLK_GAMEPAD_AXIS_RX             },
-	{ SDL_GAMEPAD_AXIS_RIGHTY,              MLK_GAMEPAD_AXIS_RY             },
-	{ SDL_GAMEPAD_AXIS_LEFT_TRIGGER,        MLK_GAMEPAD_AXIS_LTRIGGER       },
-	{ SDL_GAMEPAD_AXIS_RIGHT_TRIGGER,       MLK_GAMEPAD_AXIS_RTRIGGER       },
-	{ -1,                                   MLK_GAMEPAD_AXIS_UNKNOWN        }
-};
-
 static void
 convert_axis(const SDL_Event *event, union mlk_event *ev)
 {
 	ev->type = MLK_EVENT_AXIS;
+	ev->axis.axis = MLK_GAMEPAD_AXIS_UNKNOWN;
 	ev->axis.value = event->gaxis.value;
 
-	for (size_t i = 0; axises[i].value != MLK_GAMEPAD_AXIS_UNKNOWN; ++i) {
-		if (axises[i].axis == event->gaxis.axis) {
-			ev->axis.axis = axises[i].value;
-			break;
-		}
-	}
+	if (event->gaxis.axis < MLK_UTIL_SIZE(axises))
+		ev->axis.axis = axises[event->gaxis.axis];
 }
 
 static void
 convert_gamepad(const SDL_Event *event, union mlk_event *ev)
 {
-	ev->type = SDL_EVENT_GAMEPAD_ADDED ? MLK_EVENT_GAMEPAD_ATTACH : MLK_EVENT_GAMEPAD_DETACH;
+	ev->type = event->type == SDL_EVENT_GAMEPAD_ADDED ? MLK_EVENT_GAMEPAD_ATTACH : MLK_EVENT_GAMEPAD_DETACH;
 	ev->gamepad.index = event->gdevice.which;
 }
 
@@ -311,58 +297,101 @@ convert_theme(union mlk_event *ev)
 	mlk_window.theme_effective = ev->theme.theme;
 }
 
+/*
+ * Translate the SDL event, returns 0 if it is not one we want to report.
+ */
+static int
+convert(const SDL_Event *event, union mlk_event *ev)
+{
+	memset(ev, 0, sizeof (*ev));
+
+	switch (event->type) {
+	case SDL_EVENT_QUIT:
+		ev->type = MLK_EVENT_QUIT;
+		break;
+	case SDL_EVENT_KEY_DOWN:
+	case SDL_EVENT_KEY_UP:
+		convert_key(event, ev);
+		break;
+	case SDL_EVENT_MOUSE_MOTION:
+		convert_mouse(event, ev);
+		break;
+	case SDL_EVENT_MOUSE_BUTTON_DOWN:
+	case SDL_EVENT_MOUSE_BUTTON_UP:
+		convert_click(event, ev);
+		break;
+	case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+	case SDL_EVENT_GAMEPAD_BUTTON_UP:
+		convert_button(event, ev);
+		break;
+	case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+		convert_axis(event, ev);
+		break;
+	case SDL_EVENT_GAMEPAD_ADDED:
+	case SDL_EVENT_GAMEPAD_REMOVED:
+		convert_gamepad(event, ev);
+		break;
+	case SDL_EVENT_SYSTEM_THEME_CHANGED:
+		/*
+		 * We only report the event if the user preferrence is
+		 * set to auto because we don't need it otherwise.
+		 */
+		if (mlk_window.theme_user != MLK_WINDOW_THEME_AUTO)
+			return 0;
+
+		convert_theme(ev);
+		break;
+	default:
+		return 0;
+	}
+
+	return 1;
+}
+
 int
 mlk_event_poll(union mlk_event *ev)
 {
 	SDL_Event event;
 
-	memset(ev, 0, sizeof (*ev));
-
 	/*
 	 * Loop until we find an event we want to report, we skip unneeded
 	 * ones.
 	 */
-	while (SDL_PollEvent(&event)) {
-		switch (event.type) {
-		case SDL_EVENT_QUIT:
-			ev->type = MLK_EVENT_QUIT;
-			return 1;
-		case SDL_EVENT_KEY_DOWN:
-		case SDL_EVENT_KEY_UP:
-			convert_key(&event, ev);
+	while (SDL_PollEvent(&event))
+		if (convert(&event, ev))
 			return 1;
-		case SDL_EVENT_MOUSE_MOTION:
-			convert_mouse(&event, ev);
-			return 1;
-		case SDL_EVENT_MOUSE_BUTTON_DOWN:
-		case SDL_EVENT_MOUSE_BUTTON_UP:
-			convert_click(&event, ev);
-			return 1;
-		case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
-		case SDL_EVENT_GAMEPAD_BUTTON_UP:
-			convert_button(&event, ev);
-			return 1;
-		case SDL_EVENT_GAMEPAD_AXIS_MOTION:
-			convert_axis(&event, ev);
-			return 1;
-		case SDL_EVENT_GAMEPAD_ADDED:
-		case SDL_EVENT_GAMEPAD_REMOVED:
-			convert_gamepad(&event, ev);
-			return 1;
-		case SDL_EVENT_SYSTEM_THEME_CHANGED:
-			/*
-			 * We only report the event if the user preferrence is
-			 * set to auto because we don't need it otherwise.
-			 */
-			if (mlk_window.theme_user == MLK_WINDOW_THEME_AUTO) {
-				convert_theme(ev);
-				return 1;
-			}
-			break;
-		default:
+
+	memset(ev, 0, sizeof (*ev));
+
+	return 0;
+}
+
+size_t
+mlk_event_poll_batch(union mlk_event *evs, size_t evsz)
+{
+	assert(evs);
+
+	SDL_Event events[64];
+	size_t count = 0;
+	int n;
+
+	SDL_PumpEvents();
+
+	/*
+	 * Never fetch more SDL events than what is left in the destination
+	 * so that none of them is lost.
+	 */
+	while (count < evsz) {
+		n = SDL_PeepEvents(events, (int)SDL_min(evsz - count, MLK_UTIL_SIZE(events)),
+		    SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+		if (n <= 0)
 			break;
-		}
+
+		for (int i = 0; i < n; ++i)
+			if (convert(&events[i], &evs[count]))
+				count++;
 	}
 
-	return 0;
+	return count;
 }
@@ -34,6 +34,8 @@
  * See the enumeration constants for more details.
  */
 
+#include <stddef.h>
+
 #include "key.h"
 #include "mouse.h"
 #include "gamepad.h"
@@ -329,6 +331,20 @@ extern "C" {
 int
 mlk_event_poll(union mlk_event *event);
 
+/**
+ * Get as many events as possible from the queue at once.
+ *
+ * This is more efficient than calling ::mlk_event_poll repeatedly when many
+ * events are pending such as mouse motions or gamepad axes.
+ *
+ * \pre events != NULL
+ * \param events the events to fill
+ * \param eventsz the maximum number of events to fill
+ * \return the number of events filled, 0 if the queue is empty
+ */
+size_t
+mlk_event_poll_batch(union mlk_event *events, size_t eventsz);
+
 #if defined(__cplusplus)
 }
 #endif
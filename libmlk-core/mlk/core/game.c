@@ -17,17 +17,104 @@
  */
 
 #include <assert.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
 
 #include "clock.h"
+#include "coro.h"
 #include "event.h"
 #include "game.h"
+#include "image-async.h"
+#include "job.h"
+#include "timer.h"
+#include "trace.h"
 #include "util.h"
+#include "vfs-async.h"
 #include "window.h"
 
-static int quit;
+static SDL_AtomicInt quit;
+
+/* Update thread used in pipelined mode. */
+static struct {
+	SDL_Thread *thread;
+	SDL_Semaphore *go;
+	SDL_Semaphore *done;
+	unsigned int ticks;
+	int busy;
+	int quit;
+} pipeline;
 
 struct mlk_game mlk_game = {};
 
+static int
+pipeline_worker(void *data)
+{
+	(void)data;
+
+	for (;;) {
+		SDL_WaitSemaphore(pipeline.go);
+
+		if (pipeline.quit)
+			break;
+
+		mlk_game.ops->update(pipeline.ticks);
+		SDL_SignalSemaphore(pipeline.done);
+	}
+
+	return 0;
+}
+
+static void
+pipeline_wait(void)
+{
+	if (pipeline.busy) {
+		SDL_WaitSemaphore(pipeline.done);
+		pipeline.busy = 0;
+	}
+}
+
+static void
+pipeline_update(unsigned int ticks)
+{
+	pipeline.ticks = ticks;
+	pipeline.busy = 1;
+	SDL_SignalSemaphore(pipeline.go);
+}
+
+static void
+pipeline_stop(void)
+{
+	pipeline_wait();
+
+	if (pipeline.thread) {
+		pipeline.quit = 1;
+		SDL_SignalSemaphore(pipeline.go);
+		SDL_WaitThread(pipeline.thread, NULL);
+	}
+
+	if (pipeline.done)
+		SDL_DestroySemaphore(pipeline.done);
+	if (pipeline.go)
+		SDL_DestroySemaphore(pipeline.go);
+
+	memset(&pipeline, 0, sizeof (pipeline));
+}
+
+static int
+pipeline_start(void)
+{
+	if (!(pipeline.go = SDL_CreateSemaphore(0)) ||
+	    !(pipeline.done = SDL_CreateSemaphore(0)) ||
+	    !(pipeline.thread = SDL_CreateThread(pipeline_worker, "mlk-update", NULL))) {
+		mlk_tracef("pipeline: %s, using serial loop", SDL_GetError());
+		pipeline_stop();
+		return -1;
+	}
+
+	return 0;
+}
+
 void
 mlk_game_init(const struct mlk_game_ops *ops)
 {
@@ -40,8 +127,11 @@ void
 mlk_game_loop(void)
 {
 	struct mlk_clock clock = {};
+	union mlk_event evs[64];
+	size_t evsz;
 	unsigned int elapsed = 0;
 	unsigned int frametime;
+	int pipelined;
 
 	if (mlk_window.framerate > 0)
 		frametime = 1000 / mlk_window.framerate;
@@ -52,15 +142,40 @@ mlk_game_loop(void)
 	if (mlk_game.ops->start)
 		mlk_game.ops->start();
 
-	while (!quit) {
+	pipelined = mlk_game.pipeline &&
+	            mlk_game.ops->update &&
+	            mlk_game.ops->snapshot &&
+	            pipeline_start() == 0;
+
+	while (!SDL_GetAtomicInt(&quit)) {
 		mlk_clock_start(&clock);
 
-		for (union mlk_event ev; mlk_event_poll(&ev); )
-			if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_INPUT) && mlk_game.ops->handle)
-				mlk_game.ops->handle(&ev);
+		/* Nothing below may run along with the update. */
+		if (pipelined)
+			pipeline_wait();
+
+		while ((evsz = mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs))))
+			for (size_t i = 0; i < evsz; ++i)
+				if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_INPUT) && mlk_game.ops->handle)
+					mlk_game.ops->handle(&evs[i]);
+
+		/* Completed asynchronous reads, decoded images and jobs, if any. */
+		mlk_vfs_async_dispatch();
+		mlk_image_async_dispatch();
+		mlk_job_dispatch();
+
+		/* Expired timers, then coroutines woken up by time or events. */
+		mlk_timer_dispatch(elapsed);
+		mlk_coro_schedule();
 
-		if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_UPDATE) && mlk_game.ops->update)
+		if (pipelined) {
+			mlk_game.ops->snapshot();
+
+			if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_UPDATE))
+				pipeline_update(elapsed);
+		} else if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_UPDATE) && mlk_game.ops->update)
 			mlk_game.ops->update(elapsed);
+
 		if (!(mlk_game.inhibit & MLK_GAME_INHIBIT_DRAW) && mlk_game.ops->draw)
 			mlk_game.ops->draw();
 
@@ -80,10 +195,16 @@ mlk_game_loop(void)
 		if (elapsed > frametime)
 			elapsed = frametime;
 	}
+
+	if (pipelined)
+		pipeline_stop();
+
+	/* Allow entering the loop again. */
+	SDL_SetAtomicInt(&quit, 0);
 }
 
 void
 mlk_game_quit(void)
 {
-	quit = 1;
+	SDL_SetAtomicInt(&quit, 1);
 }
@@ -88,6 +88,16 @@ struct mlk_game_ops {
 	 */
 	void (*update)(unsigned int ticks);
 
+	/**
+	 * (optional)
+	 *
+	 * Copy the data needed for rendering from the simulation, required
+	 * for the pipelined mode.
+	 *
+	 * \sa ::mlk_game::pipeline
+	 */
+	void (*snapshot)(void);
+
 	/**
 	 * (optional)
 	 *
@@ -117,6 +127,25 @@ struct mlk_game {
 	 * the loop.
 	 */
 	enum mlk_game_inhibit inhibit;
+
+	/**
+	 * (read-write)
+	 *
+	 * Run the update of the next frame on a separate thread while the
+	 * current one is drawn.
+	 *
+	 * Each frame, the loop waits for the previous update to complete, then
+	 * handles events, dispatches asynchronous operations, timers and
+	 * coroutines and calls ::mlk_game_ops::snapshot before starting the
+	 * next update and drawing. This lets CPU heavy updates overlap with
+	 * driver heavy drawing at the cost of one frame of latency.
+	 *
+	 * The update function must not use the renderer nor anything used by
+	 * the draw function other than the snapshot. This is ignored if
+	 * ::mlk_game_ops::snapshot is NULL and must be set before calling
+	 * ::mlk_game_loop.
+	 */
+	int pipeline;
 };
 
 /**
@@ -142,6 +171,8 @@ mlk_game_loop(void);
 
 /**
  * Request to quit.
+ *
+ * This function can be called from the update function in pipelined mode.
  */
 void
 mlk_game_quit(void);
@@ -0,0 +1,397 @@
+/*
+ * image-async.c -- parallel image decoding
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/rawtex.h>
+#include <mlk/util/util.h>
+
+#include <utlist.h>
+
+#include "alloc.h"
+#include "err.h"
+#include "image-async.h"
+#include "pool_p.h"
+#include "texture_p.h"
+#include "vfs.h"
+
+static struct {
+	struct mlk__pool pool;
+	unsigned int uploads;
+
+	/* Requests waiting for a worker thread. */
+	struct mlk_image_async_request *pending;
+
+	/* Requests decoded (or failed) but not yet dispatched. */
+	struct mlk_image_async_request *completed;
+
+	/* Requests being decoded. */
+	size_t running;
+} async;
+
+/*
+ * Same as mlk_image_openmem, pre-decoded textures are recognized by their
+ * header. The pixels are copied into a surface because the texture can only be
+ * created on the main thread.
+ */
+static SDL_Surface *
+open_raw(const void *data, size_t datasz)
+{
+	struct mlk_rawtex_header header;
+	SDL_Surface *surface = NULL;
+	const unsigned char *pixels;
+	unsigned char *buf = NULL, *row;
+	size_t length;
+
+	if (mlk_rawtex_header_decode(&header, data, datasz) < 0) {
+		mlk_errf("invalid raw texture");
+		return NULL;
+	}
+
+	pixels = (const unsigned char *)data + MLK_RAWTEX_HEADER_SIZE;
+	length = (size_t)header.pitch * header.height;
+
+	if (header.flags & MLK_RAWTEX_LZ) {
+		buf = mlk_alloc_new(length, 1);
+
+		if (mlk_lz_decompress(pixels, header.size, buf, length) != length) {
+			mlk_errf("corrupt raw texture");
+			goto end;
+		}
+
+		pixels = buf;
+	}
+
+	if (!(surface = SDL_CreateSurface(header.width, header.height, SDL_PIXELFORMAT_RGBA32))) {
+		mlk_errf("%s", SDL_GetError());
+		goto end;
+	}
+
+	row = surface->pixels;
+
+	for (uint32_t y = 0; y < header.height; ++y) {
+		memcpy(row, pixels, (size_t)header.width * MLK_RAWTEX_BPP);
+		row += surface->pitch;
+		pixels += header.pitch;
+	}
+
+	/* SDL_CreateTextureFromSurface applies it to the texture as well. */
+	SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+end:
+	mlk_alloc_free(buf);
+
+	return surface;
+}
+
+static enum mlk_image_async_status
+decode(struct mlk_image_async_request *req)
+{
+	struct mlk_vfs_file *file;
+	SDL_IOStream *ops;
+	SDL_Surface *surface = NULL;
+	const void *data = req->buffer;
+	void *mapped = NULL;
+	char *content = NULL;
+	size_t datasz = req->buffersz;
+
+	/* The whole content is needed anyway to tell raw textures apart. */
+	if (req->vfs) {
+		if (!(file = mlk_vfs_open(req->vfs, req->path, "r")))
+			goto failed;
+
+		content = mlk_vfs_file_read_all(file, &datasz);
+		mlk_vfs_file_finish(file);
+
+		if (!(data = content))
+			goto failed;
+	} else if (!req->buffer) {
+		if (!(data = mapped = mlk_util_mmap(req->path, &datasz))) {
+			mlk_errf("%s: %s", req->path, strerror(errno));
+			goto failed;
+		}
+	}
+
+	if (mlk_rawtex_match(data, datasz))
+		surface = open_raw(data, datasz);
+	else if (!(ops = SDL_IOFromConstMem(data, datasz)) || !(surface = IMG_Load_IO(ops, 1)))
+		mlk_errf("%s", SDL_GetError());
+
+	mlk_alloc_free(content);
+	mlk_util_munmap(mapped, datasz);
+
+	if (!surface)
+		goto failed;
+
+	req->surface = surface;
+
+	return MLK_IMAGE_ASYNC_STATUS_DECODED;
+
+failed:
+	/* Errors are thread local, copy it while still on this thread. */
+	mlk_util_strlcpy(req->error, mlk_err(), sizeof (req->error));
+
+	return MLK_IMAGE_ASYNC_STATUS_FAILED;
+}
+
+static int
+worker(void *data)
+{
+	(void)data;
+
+	struct mlk_image_async_request *req;
+	enum mlk_image_async_status status;
+
+	SDL_LockMutex(async.pool.mutex);
+
+	for (;;) {
+		while (!mlk__pool_quit(&async.pool) && !async.pending)
+			SDL_WaitCondition(async.pool.work, async.pool.mutex);
+
+		if (mlk__pool_quit(&async.pool))
+			break;
+
+		req = async.pending;
+		DL_DELETE(async.pending, req);
+		req->status = MLK_IMAGE_ASYNC_STATUS_RUNNING;
+		async.running++;
+
+		SDL_UnlockMutex(async.pool.mutex);
+		status = decode(req);
+		SDL_LockMutex(async.pool.mutex);
+
+		req->status = status;
+		async.running--;
+		DL_APPEND(async.completed, req);
+		SDL_BroadcastCondition(async.pool.done);
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return 0;
+}
+
+static void
+release(struct mlk_image_async_request *req)
+{
+	if (req->surface) {
+		SDL_DestroySurface(req->surface);
+		req->surface = NULL;
+	}
+
+	req->status = MLK_IMAGE_ASYNC_STATUS_NONE;
+}
+
+static void
+discard(struct mlk_image_async_request **list)
+{
+	struct mlk_image_async_request *req, *tmp;
+
+	DL_FOREACH_SAFE(*list, req, tmp) {
+		DL_DELETE(*list, req);
+		release(req);
+	}
+}
+
+static inline void
+prepare(struct mlk_image_async_request *req)
+{
+	assert(req);
+	assert(req->texture);
+	assert(req->path || req->buffer);
+	assert(!req->vfs || req->path);
+	assert(req->status != MLK_IMAGE_ASYNC_STATUS_PENDING &&
+	       req->status != MLK_IMAGE_ASYNC_STATUS_RUNNING &&
+	       req->status != MLK_IMAGE_ASYNC_STATUS_DECODED);
+
+	req->surface = NULL;
+	req->error[0] = '\0';
+	req->status = MLK_IMAGE_ASYNC_STATUS_PENDING;
+	DL_APPEND(async.pending, req);
+}
+
+static void
+upload(struct mlk_image_async_request *req)
+{
+	SDL_Surface *surface = req->surface;
+
+	req->surface = NULL;
+
+	/* The surface is only destroyed on success. */
+	if (mlk__texture_from_surface(req->texture, surface) < 0) {
+		SDL_DestroySurface(surface);
+		mlk_util_strlcpy(req->error, mlk_err(), sizeof (req->error));
+		req->status = MLK_IMAGE_ASYNC_STATUS_FAILED;
+	} else
+		req->status = MLK_IMAGE_ASYNC_STATUS_DONE;
+}
+
+int
+mlk_image_async_init(unsigned int workers, unsigned int uploads)
+{
+	assert(!async.pool.mutex);
+
+	int cores;
+
+	if (workers == 0)
+		workers = (cores = SDL_GetNumLogicalCPUCores()) > 0 ? cores : 1;
+
+	async.uploads = uploads ? uploads : MLK_IMAGE_ASYNC_UPLOADS;
+
+	return mlk__pool_init(&async.pool, workers, "mlk-image-async", worker);
+}
+
+unsigned int
+mlk_image_async_workers(void)
+{
+	return async.pool.threadsz;
+}
+
+void
+mlk_image_async_submit(struct mlk_image_async_request *req)
+{
+	assert(async.pool.mutex);
+
+	SDL_LockMutex(async.pool.mutex);
+	prepare(req);
+	SDL_SignalCondition(async.pool.work);
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+void
+mlk_image_async_submit_all(struct mlk_image_async_request *reqs, size_t reqsz)
+{
+	assert(async.pool.mutex);
+	assert(reqs);
+
+	SDL_LockMutex(async.pool.mutex);
+
+	for (size_t i = 0; i < reqsz; ++i)
+		prepare(&reqs[i]);
+
+	SDL_BroadcastCondition(async.pool.work);
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+void
+mlk_image_async_cancel(struct mlk_image_async_request *req)
+{
+	assert(async.pool.mutex);
+	assert(req);
+
+	struct mlk_image_async_request *iter;
+
+	SDL_LockMutex(async.pool.mutex);
+
+	while (req->status == MLK_IMAGE_ASYNC_STATUS_RUNNING)
+		SDL_WaitCondition(async.pool.done, async.pool.mutex);
+
+	switch (req->status) {
+	case MLK_IMAGE_ASYNC_STATUS_PENDING:
+		DL_DELETE(async.pending, req);
+		req->status = MLK_IMAGE_ASYNC_STATUS_NONE;
+		break;
+	case MLK_IMAGE_ASYNC_STATUS_DECODED:
+	case MLK_IMAGE_ASYNC_STATUS_FAILED:
+		/* Only discard if not yet dispatched. */
+		DL_FOREACH(async.completed, iter) {
+			if (iter == req) {
+				DL_DELETE(async.completed, req);
+				release(req);
+				break;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+size_t
+mlk_image_async_dispatch(void)
+{
+	struct mlk_image_async_request *req, *iter;
+	size_t count = 0, max = 0;
+	unsigned int uploads = 0;
+
+	if (!async.pool.mutex)
+		return 0;
+
+	/*
+	 * Same as mlk_vfs_async_dispatch, requests are removed one at a time
+	 * because callbacks may cancel other ones. Creating a texture is the
+	 * only expensive part left on this thread so only a few of them are
+	 * uploaded per frame, the others stay in order for the next call.
+	 */
+	SDL_LockMutex(async.pool.mutex);
+	DL_COUNT(async.completed, iter, max);
+
+	for (; count < max && (req = async.completed); ++count) {
+		if (req->status == MLK_IMAGE_ASYNC_STATUS_DECODED && uploads++ >= async.uploads)
+			break;
+
+		DL_DELETE(async.completed, req);
+		SDL_UnlockMutex(async.pool.mutex);
+
+		if (req->status == MLK_IMAGE_ASYNC_STATUS_DECODED)
+			upload(req);
+		if (req->done)
+			req->done(req);
+
+		SDL_LockMutex(async.pool.mutex);
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return count;
+}
+
+int
+mlk_image_async_busy(void)
+{
+	int busy;
+
+	if (!async.pool.mutex)
+		return 0;
+
+	SDL_LockMutex(async.pool.mutex);
+	busy = async.pending || async.running || async.completed;
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return busy;
+}
+
+void
+mlk_image_async_finish(void)
+{
+	mlk__pool_finish(&async.pool);
+
+	/* Threads are gone, no need to lock anymore. */
+	discard(&async.pending);
+	discard(&async.completed);
+
+	memset(&async, 0, sizeof (async));
+}
@@ -0,0 +1,294 @@
+/*
+ * image-async.h -- parallel image decoding
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_IMAGE_ASYNC_H
+#define MLK_CORE_IMAGE_ASYNC_H
+
+/**
+ * \file mlk/core/image-async.h
+ * \brief Parallel image decoding.
+ *
+ * This module decodes images into surfaces from a pool of worker threads,
+ * only the final upload of the surface into a texture happens on the main
+ * thread because it requires the renderer.
+ *
+ * The user fills a ::mlk_image_async_request and submits it, several requests
+ * can be submitted at once using ::mlk_image_async_submit_all which is suited
+ * for tilesets or any set of images required together. Decoded images are
+ * uploaded in ::mlk_image_async_dispatch which is called once per frame by
+ * ::mlk_game_loop, at most the number of uploads given to
+ * ::mlk_image_async_init are performed per frame so that large batches do not
+ * freeze the game. The ::mlk_image_async_request::done callback is invoked
+ * once the texture is ready or if the image could not be decoded.
+ *
+ * The image is read from one of the following sources, in that order:
+ *
+ * - ::mlk_image_async_request::vfs and ::mlk_image_async_request::path if the
+ *   VFS is set,
+ * - ::mlk_image_async_request::buffer if set,
+ * - ::mlk_image_async_request::path on the filesystem otherwise.
+ *
+ * Like ::mlk_image_openmem, pre-decoded textures (see mlk/util/rawtex.h) are
+ * detected from their content and accepted from any of these sources.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static struct mlk_texture textures[3];
+ * static struct mlk_image_async_request reqs[3] = {
+ * 	{ .texture = &textures[0], .path = "images/world.png"   },
+ * 	{ .texture = &textures[1], .path = "images/player.png"  },
+ * 	{ .texture = &textures[2], .path = "images/font.png"    }
+ * };
+ *
+ * mlk_image_async_init(0, 0);
+ * mlk_image_async_submit_all(reqs, MLK_UTIL_SIZE(reqs));
+ * ```
+ *
+ * \warning When reading from a VFS, it is used from the worker threads. Unless
+ *          it has the ::MLK_VFS_THREAD_SAFE flag, no other thread, including
+ *          the main thread, may use the VFS while requests on it are pending,
+ *          even with a single worker. Several workers also require the flag.
+ */
+
+#include <stddef.h>
+
+#include "err.h"
+
+struct mlk_texture;
+struct mlk_vfs;
+
+/**
+ * Default number of textures uploaded per frame if 0 is given to
+ * ::mlk_image_async_init.
+ */
+#define MLK_IMAGE_ASYNC_UPLOADS 4
+
+/**
+ * \enum mlk_image_async_status
+ * \brief Request status.
+ */
+enum mlk_image_async_status {
+	/**
+	 * Request not submitted or cancelled.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_NONE,
+
+	/**
+	 * Request waiting for a worker thread.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_PENDING,
+
+	/**
+	 * Image being decoded.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_RUNNING,
+
+	/**
+	 * Image decoded, waiting for its upload.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_DECODED,
+
+	/**
+	 * Texture uploaded successfully.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_DONE,
+
+	/**
+	 * Image could not be loaded, see ::mlk_image_async_request::error.
+	 */
+	MLK_IMAGE_ASYNC_STATUS_FAILED
+};
+
+/**
+ * \struct mlk_image_async_request
+ * \brief Asynchronous image request.
+ *
+ * The structure must stay valid until its callback has been invoked or it has
+ * been cancelled.
+ */
+struct mlk_image_async_request {
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * Texture to initialize, it must be destroyed using
+	 * ::mlk_texture_finish once loaded.
+	 */
+	struct mlk_texture *texture;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * VFS to open the image from.
+	 */
+	struct mlk_vfs *vfs;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Path to the image on the filesystem or in the VFS.
+	 */
+	const char *path;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Image content if already in memory.
+	 */
+	const void *buffer;
+
+	/**
+	 * (read-write)
+	 *
+	 * Image content length.
+	 */
+	size_t buffersz;
+
+	/**
+	 * (read-only)
+	 *
+	 * Current request status.
+	 */
+	enum mlk_image_async_status status;
+
+	/**
+	 * (read-only)
+	 *
+	 * Error string if the image could not be loaded.
+	 */
+	char error[MLK_ERR_MAX];
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Invoked from the main thread once the texture has been uploaded or
+	 * the image could not be loaded.
+	 *
+	 * \param self this request
+	 */
+	void (*done)(struct mlk_image_async_request *self);
+
+	/** \cond MLK_PRIVATE_DECLS */
+	void *surface;
+	struct mlk_image_async_request *prev;
+	struct mlk_image_async_request *next;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Start the worker threads.
+ *
+ * \param workers the number of threads (0 for one per logical CPU core)
+ * \param uploads maximum textures uploaded per frame (0 for
+ *                ::MLK_IMAGE_ASYNC_UPLOADS)
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_image_async_init(unsigned int workers, unsigned int uploads);
+
+/**
+ * Return the number of worker threads started.
+ *
+ * \return the number of workers (0 if not initialized)
+ */
+unsigned int
+mlk_image_async_workers(void);
+
+/**
+ * Submit a request.
+ *
+ * \pre req != NULL
+ * \pre req->texture != NULL
+ * \pre req->path != NULL || req->buffer != NULL
+ * \pre req must not be already submitted
+ * \pre ::mlk_image_async_init must have been called
+ * \param req the request
+ */
+void
+mlk_image_async_submit(struct mlk_image_async_request *req);
+
+/**
+ * Submit several requests at once.
+ *
+ * This is equivalent to calling ::mlk_image_async_submit on each request but
+ * wakes up all workers only once.
+ *
+ * \pre reqs != NULL
+ * \param reqs the array of requests
+ * \param reqsz the number of requests
+ */
+void
+mlk_image_async_submit_all(struct mlk_image_async_request *reqs, size_t reqsz);
+
+/**
+ * Cancel a request.
+ *
+ * If the image is currently being decoded, this function waits for it to
+ * complete and discards it. Once it returns, the request is no longer used
+ * and its callback will never be invoked.
+ *
+ * \pre req != NULL
+ * \param req the request
+ */
+void
+mlk_image_async_cancel(struct mlk_image_async_request *req);
+
+/**
+ * Upload decoded images and invoke callbacks of completed requests.
+ *
+ * This function is called by ::mlk_game_loop and does nothing if the module
+ * has not been initialized.
+ *
+ * \return the number of requests dispatched
+ */
+size_t
+mlk_image_async_dispatch(void);
+
+/**
+ * Tells if requests are still pending, being decoded or not yet dispatched.
+ *
+ * \return non-zero if the module is busy
+ */
+int
+mlk_image_async_busy(void);
+
+/**
+ * Stop the worker threads.
+ *
+ * Pending requests are cancelled, decoded images not yet uploaded are
+ * discarded without invoking their callback.
+ */
+void
+mlk_image_async_finish(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_IMAGE_ASYNC_H */
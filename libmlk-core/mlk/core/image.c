@@ -17,13 +17,20 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
 
 #include <SDL3_image/SDL_image.h>
 
+#include <mlk/util/lz.h>
+#include <mlk/util/rawtex.h>
+#include <mlk/util/util.h>
+
+#include "alloc.h"
 #include "err.h"
+#include "image.h"
 #include "texture.h"
 #include "vfs.h"
-#include "vfs_p.h"
 #include "window.h"
 #include "window_p.h"
 
@@ -40,18 +47,80 @@ dimensions(struct mlk_texture *tex)
 	}
 }
 
+/*
+ * Pre-decoded textures are uploaded directly, only decompressing them first if
+ * needed. See mlk/util/rawtex.h.
+ */
+static int
+open_raw(struct mlk_texture *tex, const void *data, size_t datasz)
+{
+	struct mlk_rawtex_header header;
+	SDL_Texture *handle;
+	const unsigned char *pixels;
+	unsigned char *buf = NULL;
+	size_t length;
+	int ret = -1;
+
+	if (mlk_rawtex_header_decode(&header, data, datasz) < 0)
+		return mlk_errf("invalid raw texture");
+
+	pixels = (const unsigned char *)data + MLK_RAWTEX_HEADER_SIZE;
+	length = (size_t)header.pitch * header.height;
+
+	if (header.flags & MLK_RAWTEX_LZ) {
+		buf = mlk_alloc_new(length, 1);
+
+		if (mlk_lz_decompress(pixels, header.size, buf, length) != length) {
+			mlk_errf("corrupt raw texture");
+			goto end;
+		}
+
+		pixels = buf;
+	}
+
+	handle = SDL_CreateTexture(MLK__RENDERER(), SDL_PIXELFORMAT_RGBA32,
+	    SDL_TEXTUREACCESS_STATIC, header.width, header.height);
+
+	if (!handle) {
+		mlk_errf("%s", SDL_GetError());
+		goto end;
+	}
+
+	if (!SDL_SetTextureBlendMode(handle, SDL_BLENDMODE_BLEND_PREMULTIPLIED) ||
+	    !SDL_UpdateTexture(handle, NULL, pixels, header.pitch)) {
+		mlk_errf("%s", SDL_GetError());
+		SDL_DestroyTexture(handle);
+		goto end;
+	}
+
+	tex->handle = handle;
+	tex->w = header.width;
+	tex->h = header.height;
+	ret = 0;
+
+end:
+	mlk_alloc_free(buf);
+
+	return ret;
+}
+
 int
 mlk_image_open(struct mlk_texture *tex, const char *path)
 {
 	assert(tex);
 	assert(path);
 
-	if (!(tex->handle = IMG_LoadTexture(MLK__RENDERER(), path)))
-		return mlk_errf("%s", SDL_GetError());
+	void *data;
+	size_t datasz;
+	int ret;
 
-	dimensions(tex);
+	if (!(data = mlk_util_mmap(path, &datasz)))
+		return mlk_errf("%s: %s", path, strerror(errno));
 
-	return 0;
+	ret = mlk_image_openmem(tex, data, datasz);
+	mlk_util_munmap(data, datasz);
+
+	return ret;
 }
 
 int
@@ -60,6 +129,9 @@ mlk_image_openmem(struct mlk_texture *tex, const void *buffer, size_t size)
 	assert(tex);
 	assert(buffer);
 
+	if (mlk_rawtex_match(buffer, size))
+		return open_raw(tex, buffer, size);
+
 	SDL_IOStream *ops = SDL_IOFromConstMem(buffer, size);
 
 	if (!ops || !(tex->handle = IMG_LoadTexture_IO(MLK__RENDERER(), ops, 1)))
@@ -76,14 +148,15 @@ mlk_image_openvfs(struct mlk_texture *tex, struct mlk_vfs_file *file)
 	assert(tex);
 	assert(file);
 
-	SDL_IOStream *ops;
+	char *data;
+	size_t datasz;
+	int ret;
 
-	if (!(ops = mlk__vfs_to_rw(file)))
+	if (!(data = mlk_vfs_file_read_all(file, &datasz)))
 		return -1;
-	if (!(tex->handle = IMG_LoadTexture_IO(MLK__RENDERER(), ops, 1)))
-		return mlk_errf("%s", SDL_GetError());
 
-	dimensions(tex);
+	ret = mlk_image_openmem(tex, data, datasz);
+	mlk_alloc_free(data);
 
-	return 0;
+	return ret;
 }
@@ -22,6 +22,14 @@
 /**
  * \file mlk/core/image.h
  * \brief Basic image management
+ *
+ * Those functions decode the image on the calling thread, see
+ * mlk/core/image-async.h to decode several images in parallel.
+ *
+ * Every function also accepts pre-decoded textures created by the mlk-rawtex
+ * tool (see mlk/util/rawtex.h), they are larger than PNG files but are
+ * uploaded without any decoding which shortens the startup time. Those
+ * textures use ::MLK_TEXTURE_BLEND_PREMULTIPLIED blending.
  */
 
 #include <stddef.h>
@@ -50,7 +58,7 @@ mlk_image_open(struct mlk_texture *texture, const char *path);
 /**
  * Open an image from a const binary data.
  *
- * The binary data must be kept alive until the texture is no longer used.
+ * The binary data can be discarded after loading the image.
  *
  * \pre texture != NULL
  * \param texture the texture to initialize
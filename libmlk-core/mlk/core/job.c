@@ -0,0 +1,435 @@
+/*
+ * job.c -- work-stealing job system
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/util/util.h>
+
+#include <utlist.h>
+
+#include "alloc.h"
+#include "job.h"
+#include "pool_p.h"
+#include "util.h"
+
+/*
+ * Job queue, the owner pushes and pops at the tail while thieves take from
+ * the head. Operations are short so a spinlock is enough.
+ */
+struct queue {
+	SDL_SpinLock lock;
+	struct mlk_job *jobs;
+};
+
+struct chunk {
+	struct mlk_job job;
+	size_t begin;
+	size_t end;
+	void (*fn)(size_t, size_t, void *);
+	void *data;
+};
+
+static struct {
+	/* The mutex protects sleeping workers, dependencies and completed jobs. */
+	struct mlk__pool pool;
+
+	/* Queue 0 is shared by every thread that is not a worker. */
+	struct queue *queues;
+	unsigned int queuesz;
+
+	/* Jobs queued but not yet taken and threads waiting for one. */
+	SDL_AtomicInt pending;
+	SDL_AtomicInt sleeping;
+
+	/* Jobs run but not yet dispatched. */
+	struct mlk_job *completed;
+} jobs;
+
+/* Index of the queue owned by the calling thread. */
+static MLK_THREAD_LOCAL unsigned int self;
+
+static void
+push(struct mlk_job *job)
+{
+	struct queue *queue = &jobs.queues[self];
+
+	SDL_LockSpinlock(&queue->lock);
+	DL_APPEND(queue->jobs, job);
+	SDL_UnlockSpinlock(&queue->lock);
+
+	/*
+	 * Workers and waiters increment sleeping before checking pending again
+	 * under the mutex, one of both sides always sees the other.
+	 */
+	SDL_AddAtomicInt(&jobs.pending, 1);
+
+	if (SDL_GetAtomicInt(&jobs.sleeping) > 0) {
+		SDL_LockMutex(jobs.pool.mutex);
+		SDL_SignalCondition(jobs.pool.work);
+
+		/* Threads in mlk_job_wait sleep on the other condition. */
+		SDL_BroadcastCondition(jobs.pool.done);
+		SDL_UnlockMutex(jobs.pool.mutex);
+	}
+}
+
+static struct mlk_job *
+pop(unsigned int index, int steal)
+{
+	struct queue *queue = &jobs.queues[index];
+	struct mlk_job *job;
+
+	SDL_LockSpinlock(&queue->lock);
+
+	if ((job = queue->jobs)) {
+		if (!steal)
+			job = job->prev;
+
+		DL_DELETE(queue->jobs, job);
+	}
+
+	SDL_UnlockSpinlock(&queue->lock);
+
+	return job;
+}
+
+static struct mlk_job *
+take(void)
+{
+	struct mlk_job *job;
+
+	if (!(job = pop(self, 0)))
+		for (unsigned int i = 1; !job && i < jobs.queuesz; ++i)
+			job = pop((self + i) % jobs.queuesz, 1);
+
+	if (job)
+		SDL_AddAtomicInt(&jobs.pending, -1);
+
+	return job;
+}
+
+static void
+execute(struct mlk_job *);
+
+/*
+ * Decrement the counter if any and, with workers, queue the job for
+ * dispatch if it has a done callback. Both are done in the same critical
+ * section so that once the counter is seen at zero the callback is
+ * guaranteed to be dispatched by the next call to ::mlk_job_dispatch.
+ */
+static void
+release(struct mlk_job_counter *counter, struct mlk_job *completed)
+{
+	struct mlk_job *list = NULL, *job, *tmp;
+	int value;
+
+	if (!jobs.pool.mutex) {
+		if (counter && SDL_AddAtomicInt(&counter->value, -1) == 1) {
+			list = counter->dependents;
+			counter->dependents = NULL;
+		}
+
+		if (completed)
+			completed->done(completed);
+
+		DL_FOREACH_SAFE(list, job, tmp) {
+			DL_DELETE(list, job);
+			execute(job);
+		}
+
+		return;
+	}
+
+	/* Fast path, other jobs are still tracked by the counter. */
+	if (!completed && counter)
+		while ((value = SDL_GetAtomicInt(&counter->value)) > 1)
+			if (SDL_CompareAndSwapAtomicInt(&counter->value, value, value - 1))
+				return;
+
+	if (!completed && !counter)
+		return;
+
+	/*
+	 * Reaching zero is done with the mutex held so that waiters and
+	 * dependent submissions observe it consistently and that the counter
+	 * is not touched anymore once they have seen it.
+	 */
+	SDL_LockMutex(jobs.pool.mutex);
+
+	if (counter && SDL_AddAtomicInt(&counter->value, -1) == 1) {
+		list = counter->dependents;
+		counter->dependents = NULL;
+		SDL_BroadcastCondition(jobs.pool.done);
+	}
+
+	if (completed)
+		DL_APPEND(jobs.completed, completed);
+
+	SDL_UnlockMutex(jobs.pool.mutex);
+
+	DL_FOREACH_SAFE(list, job, tmp) {
+		DL_DELETE(list, job);
+		push(job);
+	}
+}
+
+static void
+execute(struct mlk_job *job)
+{
+	job->run(job);
+	release(job->counter, job->done ? job : NULL);
+}
+
+static int
+worker(void *data)
+{
+	struct mlk_job *job;
+
+	/* Queue 0 is not owned by any worker. */
+	self = (uintptr_t)data + 1;
+
+	while (!mlk__pool_quit(&jobs.pool)) {
+		if ((job = take())) {
+			execute(job);
+			continue;
+		}
+
+		SDL_LockMutex(jobs.pool.mutex);
+		SDL_AddAtomicInt(&jobs.sleeping, 1);
+
+		while (!mlk__pool_quit(&jobs.pool) && !SDL_GetAtomicInt(&jobs.pending))
+			SDL_WaitCondition(jobs.pool.work, jobs.pool.mutex);
+
+		SDL_AddAtomicInt(&jobs.sleeping, -1);
+		SDL_UnlockMutex(jobs.pool.mutex);
+	}
+
+	return 0;
+}
+
+static void
+run_chunk(struct mlk_job *job)
+{
+	struct chunk *chunk = MLK_UTIL_CONTAINER_OF(job, struct chunk, job);
+
+	chunk->fn(chunk->begin, chunk->end, chunk->data);
+}
+
+int
+mlk_job_init(unsigned int workers)
+{
+	assert(!jobs.pool.mutex);
+
+	int cores;
+
+	if (workers == 0)
+		workers = (cores = SDL_GetNumLogicalCPUCores()) > 1 ? cores - 1 : 1;
+
+	/* Queues must exist before the workers start looking into them. */
+	jobs.queuesz = workers + 1;
+	jobs.queues = mlk_alloc_new0(jobs.queuesz, sizeof (*jobs.queues));
+
+	if (mlk__pool_init(&jobs.pool, workers, "mlk-job", worker) < 0) {
+		mlk_job_finish();
+		return -1;
+	}
+
+	return 0;
+}
+
+unsigned int
+mlk_job_workers(void)
+{
+	return jobs.pool.threadsz;
+}
+
+void
+mlk_job_submit(struct mlk_job *job)
+{
+	assert(job);
+	assert(job->run);
+
+	if (job->counter)
+		SDL_AddAtomicInt(&job->counter->value, 1);
+
+	if (job->after && SDL_GetAtomicInt(&job->after->value) > 0) {
+		if (jobs.pool.mutex)
+			SDL_LockMutex(jobs.pool.mutex);
+
+		/* Check again, it may have reached zero in the meantime. */
+		if (SDL_GetAtomicInt(&job->after->value) > 0) {
+			DL_APPEND(job->after->dependents, job);
+			job = NULL;
+		}
+
+		if (jobs.pool.mutex)
+			SDL_UnlockMutex(jobs.pool.mutex);
+
+		if (!job)
+			return;
+	}
+
+	if (jobs.pool.mutex)
+		push(job);
+	else
+		execute(job);
+}
+
+void
+mlk_job_wait(struct mlk_job_counter *counter)
+{
+	assert(counter);
+
+	struct mlk_job *job;
+
+	/* Without workers, jobs are run on submission. */
+	if (!jobs.pool.mutex) {
+		assert(SDL_GetAtomicInt(&counter->value) == 0);
+		return;
+	}
+
+	while (SDL_GetAtomicInt(&counter->value) > 0) {
+		if ((job = take())) {
+			execute(job);
+			continue;
+		}
+
+		/*
+		 * Nothing to help with, workers are running the last jobs. Count
+		 * ourselves as sleeping so that dependents pushed once they
+		 * complete wake us up as well, we may be the only thread left
+		 * to run them when called from a worker.
+		 */
+		SDL_LockMutex(jobs.pool.mutex);
+		SDL_AddAtomicInt(&jobs.sleeping, 1);
+
+		while (SDL_GetAtomicInt(&counter->value) > 0 && !SDL_GetAtomicInt(&jobs.pending))
+			SDL_WaitCondition(jobs.pool.done, jobs.pool.mutex);
+
+		SDL_AddAtomicInt(&jobs.sleeping, -1);
+		SDL_UnlockMutex(jobs.pool.mutex);
+	}
+
+	/* Make sure the last release is done with the counter. */
+	SDL_LockMutex(jobs.pool.mutex);
+	SDL_UnlockMutex(jobs.pool.mutex);
+}
+
+int
+mlk_job_completed(struct mlk_job_counter *counter)
+{
+	assert(counter);
+
+	if (SDL_GetAtomicInt(&counter->value) > 0)
+		return 0;
+
+	if (jobs.pool.mutex) {
+		SDL_LockMutex(jobs.pool.mutex);
+		SDL_UnlockMutex(jobs.pool.mutex);
+	}
+
+	return 1;
+}
+
+void
+mlk_job_parallel_for(size_t count,
+                     size_t grain,
+                     void (*fn)(size_t, size_t, void *),
+                     void *data)
+{
+	assert(fn);
+
+	struct mlk_job_counter counter = {0};
+	struct chunk *chunks;
+	size_t chunksz;
+
+	if (count == 0)
+		return;
+	if (!jobs.pool.mutex) {
+		fn(0, count, data);
+		return;
+	}
+
+	/* A few chunks per thread to balance uneven items. */
+	if (grain == 0 && (grain = count / (jobs.queuesz * 4)) == 0)
+		grain = 1;
+
+	if ((chunksz = (count + grain - 1) / grain) == 1) {
+		fn(0, count, data);
+		return;
+	}
+
+	chunks = mlk_alloc_new0(chunksz, sizeof (*chunks));
+
+	for (size_t i = 0; i < chunksz; ++i) {
+		chunks[i].job.run = run_chunk;
+		chunks[i].job.counter = &counter;
+		chunks[i].begin = i * grain;
+		chunks[i].end = i + 1 == chunksz ? count : chunks[i].begin + grain;
+		chunks[i].fn = fn;
+		chunks[i].data = data;
+	}
+
+	/* The first chunk is run by the calling thread right away. */
+	for (size_t i = 1; i < chunksz; ++i)
+		mlk_job_submit(&chunks[i].job);
+
+	SDL_AddAtomicInt(&counter.value, 1);
+	execute(&chunks[0].job);
+	mlk_job_wait(&counter);
+
+	mlk_alloc_free(chunks);
+}
+
+size_t
+mlk_job_dispatch(void)
+{
+	struct mlk_job *job, *iter;
+	size_t count = 0, max = 0;
+
+	if (!jobs.pool.mutex)
+		return 0;
+
+	SDL_LockMutex(jobs.pool.mutex);
+	DL_COUNT(jobs.completed, iter, max);
+
+	for (; count < max && (job = jobs.completed); ++count) {
+		DL_DELETE(jobs.completed, job);
+		SDL_UnlockMutex(jobs.pool.mutex);
+		job->done(job);
+		SDL_LockMutex(jobs.pool.mutex);
+	}
+
+	SDL_UnlockMutex(jobs.pool.mutex);
+
+	return count;
+}
+
+void
+mlk_job_finish(void)
+{
+	mlk__pool_finish(&jobs.pool);
+
+	/* Queued jobs are simply forgotten, they are owned by the user. */
+	mlk_alloc_free(jobs.queues);
+	memset(&jobs, 0, sizeof (jobs));
+}
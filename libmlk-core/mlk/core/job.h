@@ -0,0 +1,238 @@
+/*
+ * job.h -- work-stealing job system
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_JOB_H
+#define MLK_CORE_JOB_H
+
+/**
+ * \file mlk/core/job.h
+ * \brief Work-stealing job system.
+ *
+ * This module runs small CPU bound tasks (decoding, parsing, pathfinding,
+ * simulations...) on a pool of worker threads.
+ *
+ * Each worker owns a double ended queue of jobs. Jobs submitted from a worker
+ * are pushed to its own queue and taken back in last in first out order
+ * while idle workers steal the oldest jobs from the others. Jobs submitted
+ * from any other thread go to a shared queue which workers steal from too.
+ *
+ * The user fills a ::mlk_job and submits it, the job is the handle to the
+ * operation and must stay valid until it has completed, or until its
+ * ::mlk_job::done callback has been invoked if any. Completion can be
+ * tracked using a ::mlk_job_counter which is incremented on submission and
+ * decremented once the job has run, before its callback is invoked. A job
+ * can also be held until a counter reaches zero using ::mlk_job::after,
+ * which allows building dependency graphs.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static struct mlk_job_counter loaded;
+ * static struct mlk_job parse = {
+ * 	.run = parse_map,
+ * 	.counter = &loaded
+ * };
+ * static struct mlk_job build = {
+ * 	.run = build_collisions,
+ * 	.done = show_map,
+ * 	.after = &loaded
+ * };
+ *
+ * mlk_job_init(0);
+ *
+ * // build_collisions will only run once parse_map has completed and
+ * // show_map is then called from the main thread.
+ * mlk_job_submit(&parse);
+ * mlk_job_submit(&build);
+ * ```
+ *
+ * Loops over independent items can be split across the workers using
+ * ::mlk_job_parallel_for.
+ *
+ * \note Jobs must not block on anything else than this module because the
+ *       calling thread of ::mlk_job_wait runs pending jobs while waiting.
+ */
+
+#include <stddef.h>
+
+#include <SDL3/SDL_atomic.h>
+
+/**
+ * \struct mlk_job_counter
+ * \brief Number of jobs not yet completed.
+ *
+ * The structure must be zero initialized.
+ */
+struct mlk_job_counter {
+	/** \cond MLK_PRIVATE_DECLS */
+	SDL_AtomicInt value;
+	struct mlk_job *dependents;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+/**
+ * \struct mlk_job
+ * \brief Job to run.
+ */
+struct mlk_job {
+	/**
+	 * (read-write)
+	 *
+	 * Function to run from a worker thread or from a thread waiting in
+	 * ::mlk_job_wait.
+	 *
+	 * \param self this job
+	 */
+	void (*run)(struct mlk_job *self);
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Invoked from the main thread in ::mlk_job_dispatch once the job has
+	 * run.
+	 *
+	 * \param self this job
+	 */
+	void (*done)(struct mlk_job *self);
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Counter incremented on submission and decremented once ::mlk_job::run
+	 * has returned.
+	 */
+	struct mlk_job_counter *counter;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Counter that must reach zero before this job can run.
+	 */
+	struct mlk_job_counter *after;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	struct mlk_job *next;
+	struct mlk_job *prev;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Start the worker threads.
+ *
+ * \param workers the number of threads (0 for one less than the number of
+ *                logical cores, the main thread helps while waiting)
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_job_init(unsigned int workers);
+
+/**
+ * Return the number of worker threads started.
+ *
+ * \return the number of workers (0 if not initialized)
+ */
+unsigned int
+mlk_job_workers(void);
+
+/**
+ * Submit a job.
+ *
+ * If the module is not initialized, the job and its ::mlk_job::done callback
+ * are run immediately from the calling thread unless it has to wait for
+ * ::mlk_job::after.
+ *
+ * \pre job != NULL
+ * \pre job->run != NULL
+ * \param job the job
+ */
+void
+mlk_job_submit(struct mlk_job *job);
+
+/**
+ * Wait until the counter reaches zero, running pending jobs in the meantime.
+ *
+ * \pre counter != NULL
+ * \param counter the counter to wait for
+ */
+void
+mlk_job_wait(struct mlk_job_counter *counter);
+
+/**
+ * Tells if every job tracked by the counter has completed.
+ *
+ * \pre counter != NULL
+ * \param counter the counter
+ * \return non-zero if the counter is zero
+ */
+int
+mlk_job_completed(struct mlk_job_counter *counter);
+
+/**
+ * Call a function over the range [0, count) split in chunks run in parallel
+ * and wait for all of them.
+ *
+ * This function can also be called from a job.
+ *
+ * \pre fn != NULL
+ * \param count the number of items
+ * \param grain the number of items per chunk (0 to pick one)
+ * \param fn the function to call for each chunk [begin, end)
+ * \param data user data passed to the function
+ */
+void
+mlk_job_parallel_for(size_t count,
+                     size_t grain,
+                     void (*fn)(size_t begin, size_t end, void *data),
+                     void *data);
+
+/**
+ * Invoke ::mlk_job::done of jobs completed since the last call.
+ *
+ * This function is called by ::mlk_game_loop and does nothing if the module
+ * has not been initialized.
+ *
+ * \return the number of jobs dispatched
+ */
+size_t
+mlk_job_dispatch(void);
+
+/**
+ * Stop the worker threads.
+ *
+ * Jobs already running complete, others are discarded without invoking their
+ * callback.
+ */
+void
+mlk_job_finish(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_JOB_H */
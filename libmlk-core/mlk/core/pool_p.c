@@ -0,0 +1,89 @@
+/*
+ * pool_p.c -- worker threads shared by asynchronous modules
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "err.h"
+#include "pool_p.h"
+
+int
+mlk__pool_init(struct mlk__pool *pool, unsigned int workers, const char *name, SDL_ThreadFunction fn)
+{
+	assert(pool);
+	assert(!pool->mutex);
+	assert(name);
+	assert(fn);
+
+	if (!(pool->mutex = SDL_CreateMutex()) ||
+	    !(pool->work = SDL_CreateCondition()) ||
+	    !(pool->done = SDL_CreateCondition())) {
+		mlk_errf("%s", SDL_GetError());
+		goto failed;
+	}
+
+	pool->threads = mlk_alloc_new0(workers, sizeof (*pool->threads));
+
+	for (; pool->threadsz < workers; ++pool->threadsz) {
+		pool->threads[pool->threadsz] = SDL_CreateThread(fn, name,
+		    (void *)(uintptr_t)pool->threadsz);
+
+		if (!pool->threads[pool->threadsz]) {
+			mlk_errf("%s", SDL_GetError());
+			goto failed;
+		}
+	}
+
+	return 0;
+
+failed:
+	mlk__pool_finish(pool);
+
+	return -1;
+}
+
+void
+mlk__pool_finish(struct mlk__pool *pool)
+{
+	assert(pool);
+
+	if (pool->mutex) {
+		SDL_SetAtomicInt(&pool->quit, 1);
+		SDL_LockMutex(pool->mutex);
+
+		if (pool->work)
+			SDL_BroadcastCondition(pool->work);
+
+		SDL_UnlockMutex(pool->mutex);
+	}
+
+	for (unsigned int i = 0; i < pool->threadsz; ++i)
+		SDL_WaitThread(pool->threads[i], NULL);
+
+	if (pool->done)
+		SDL_DestroyCondition(pool->done);
+	if (pool->work)
+		SDL_DestroyCondition(pool->work);
+	if (pool->mutex)
+		SDL_DestroyMutex(pool->mutex);
+
+	mlk_alloc_free(pool->threads);
+	memset(pool, 0, sizeof (*pool));
+}
@@ -0,0 +1,64 @@
+/*
+ * pool_p.h -- worker threads shared by asynchronous modules
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_POOL_P_H
+#define MLK_CORE_POOL_P_H
+
+#include <SDL3/SDL.h>
+
+/*
+ * Set of threads sleeping on a condition until some work is available, each
+ * module keeps its own queues and completion lists protected by the mutex.
+ *
+ * Workers must check quit with the mutex held before waiting on work so that
+ * mlk__pool_finish never misses them.
+ */
+struct mlk__pool {
+	SDL_Mutex *mutex;
+	SDL_Condition *work;
+	SDL_Condition *done;
+	SDL_Thread **threads;
+	unsigned int threadsz;
+	SDL_AtomicInt quit;
+};
+
+/*
+ * Create the synchronization primitives and start the given number of
+ * threads, each one receives its index starting from 0 as data. On error
+ * everything created so far is destroyed and -1 is returned.
+ */
+int
+mlk__pool_init(struct mlk__pool *, unsigned int, const char *, SDL_ThreadFunction);
+
+/*
+ * Tell whether the pool is shutting down.
+ */
+static inline int
+mlk__pool_quit(struct mlk__pool *pool)
+{
+	return SDL_GetAtomicInt(&pool->quit);
+}
+
+/*
+ * Wake up and join every thread then destroy the pool, no-op if the pool was
+ * not initialized.
+ */
+void
+mlk__pool_finish(struct mlk__pool *);
+
+#endif /* !MLK_CORE_POOL_P_H */
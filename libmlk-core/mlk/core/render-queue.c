@@ -0,0 +1,279 @@
+/*
+ * render-queue.c -- sort-keyed render queue
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "render-queue.h"
+#include "sprite.h"
+#include "texture.h"
+
+/* Initial capacity, doubled when full. */
+#define CAPACITY 64
+
+#define DEPTH_MIN (-(1 << 23))
+#define DEPTH_MAX ((1 << 23) - 1)
+
+/* Blend mode stored in the lowest byte of the key. */
+#define BLEND(key) ((enum mlk_texture_blend)((key) & 0xff))
+
+struct mlk__render_entry {
+	uint64_t key;
+	size_t index;
+};
+
+static void
+grow(struct mlk_render_queue *queue)
+{
+	queue->capacity = queue->capacity ? queue->capacity * 2 : CAPACITY;
+
+	if (queue->cmds) {
+		queue->cmds = mlk_alloc_resize(queue->cmds, queue->capacity);
+		queue->sorted = mlk_alloc_resize(queue->sorted, queue->capacity);
+		queue->entries = mlk_alloc_resize(queue->entries, queue->capacity);
+		queue->scratch = mlk_alloc_resize(queue->scratch, queue->capacity);
+	} else {
+		queue->cmds = mlk_alloc_new(queue->capacity, sizeof (*queue->cmds));
+		queue->sorted = mlk_alloc_new(queue->capacity, sizeof (*queue->sorted));
+		queue->entries = mlk_alloc_new(queue->capacity, sizeof (*queue->entries));
+		queue->scratch = mlk_alloc_new(queue->capacity, sizeof (*queue->scratch));
+	}
+}
+
+uint64_t
+mlk_render_key(unsigned int layer,
+               int depth,
+               const struct mlk_texture *texture,
+               enum mlk_texture_blend blend)
+{
+	assert(layer <= 255);
+
+	uint64_t id;
+
+	if (depth < DEPTH_MIN)
+		depth = DEPTH_MIN;
+	else if (depth > DEPTH_MAX)
+		depth = DEPTH_MAX;
+
+	/*
+	 * Only equality matters for the texture, spread the pointer bits with
+	 * a multiplicative hash and keep the highest ones.
+	 */
+	id = ((uint64_t)(uintptr_t)texture * UINT64_C(0x9e3779b97f4a7c15)) >> 40;
+
+	return ((uint64_t)layer << 56) |
+	       ((uint64_t)(depth - DEPTH_MIN) << 32) |
+	       (id << 8) |
+	       ((uint64_t)blend & 0xff);
+}
+
+void
+mlk_render_queue_init(struct mlk_render_queue *queue)
+{
+	assert(queue);
+
+	memset(queue, 0, sizeof (*queue));
+}
+
+void
+mlk_render_queue_push(struct mlk_render_queue *queue, const struct mlk_render_cmd *cmd)
+{
+	assert(queue);
+	assert(cmd);
+	assert(cmd->texture || cmd->draw);
+
+	if (queue->cmdsz == queue->capacity)
+		grow(queue);
+
+	queue->cmds[queue->cmdsz++] = *cmd;
+}
+
+void
+mlk_render_queue_texture(struct mlk_render_queue *queue,
+                         uint64_t key,
+                         struct mlk_texture *texture,
+                         int x,
+                         int y)
+{
+	assert(texture);
+
+	mlk_render_queue_push(queue, &(const struct mlk_render_cmd) {
+		.key = key,
+		.texture = texture,
+		.src_w = texture->w,
+		.src_h = texture->h,
+		.dst_x = x,
+		.dst_y = y,
+		.dst_w = texture->w,
+		.dst_h = texture->h,
+		.blend = BLEND(key)
+	});
+}
+
+void
+mlk_render_queue_sprite(struct mlk_render_queue *queue,
+                        uint64_t key,
+                        const struct mlk_sprite *sprite,
+                        unsigned int r,
+                        unsigned int c,
+                        int x,
+                        int y)
+{
+	assert(mlk_sprite_ok(sprite));
+	assert(r < sprite->nrows);
+	assert(c < sprite->ncols);
+
+	mlk_render_queue_push(queue, &(const struct mlk_render_cmd) {
+		.key = key,
+		.texture = sprite->texture,
+		.src_x = c * sprite->cellw,
+		.src_y = r * sprite->cellh,
+		.src_w = sprite->cellw,
+		.src_h = sprite->cellh,
+		.dst_x = x,
+		.dst_y = y,
+		.dst_w = sprite->cellw,
+		.dst_h = sprite->cellh,
+		.blend = BLEND(key)
+	});
+}
+
+void
+mlk_render_queue_sort(struct mlk_render_queue *queue)
+{
+	assert(queue);
+
+	struct mlk__render_entry *src = queue->entries, *dst = queue->scratch, *tmp;
+	struct mlk_render_cmd *cmds;
+	size_t count[8][256] = {0}, offset, n = queue->cmdsz;
+	int sorted = 1;
+
+	if (n < 2)
+		return;
+
+	/* Build all byte histograms at once, checking if already in order. */
+	for (size_t i = 0; i < n; ++i) {
+		src[i].key = queue->cmds[i].key;
+		src[i].index = i;
+
+		for (int b = 0; b < 8; ++b)
+			count[b][(src[i].key >> (b * 8)) & 0xff]++;
+
+		if (i && src[i - 1].key > src[i].key)
+			sorted = 0;
+	}
+
+	if (sorted)
+		return;
+
+	/*
+	 * Least significant digit first, each pass is stable. Bytes equal in
+	 * every key (e.g. a single layer) don't need a pass.
+	 */
+	for (int b = 0; b < 8; ++b) {
+		if (count[b][(src[0].key >> (b * 8)) & 0xff] == n)
+			continue;
+
+		offset = 0;
+
+		for (int d = 0; d < 256; ++d) {
+			size_t c = count[b][d];
+
+			count[b][d] = offset;
+			offset += c;
+		}
+
+		for (size_t i = 0; i < n; ++i)
+			dst[count[b][(src[i].key >> (b * 8)) & 0xff]++] = src[i];
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	for (size_t i = 0; i < n; ++i)
+		queue->sorted[i] = queue->cmds[src[i].index];
+
+	cmds = queue->cmds;
+	queue->cmds = queue->sorted;
+	queue->sorted = cmds;
+}
+
+int
+mlk_render_queue_flush(struct mlk_render_queue *queue)
+{
+	assert(queue);
+
+	const struct mlk_render_cmd *cmd;
+	const struct mlk_texture *texture = NULL;
+	enum mlk_texture_blend blend = MLK_TEXTURE_BLEND_NONE;
+	int ret = 0;
+
+	mlk_render_queue_sort(queue);
+
+	for (size_t i = 0; i < queue->cmdsz; ++i) {
+		cmd = &queue->cmds[i];
+
+		if (cmd->draw) {
+			/* May change any texture state. */
+			cmd->draw(cmd);
+			texture = NULL;
+			continue;
+		}
+
+		/* Commands are grouped by texture then blend, few switches. */
+		if (cmd->texture != texture || cmd->blend != blend) {
+			texture = cmd->texture;
+			blend = cmd->blend;
+
+			if (mlk_texture_set_blend_mode(cmd->texture, cmd->blend) < 0)
+				ret = -1;
+		}
+
+		if (mlk_texture_scale(cmd->texture,
+		    cmd->src_x, cmd->src_y, cmd->src_w, cmd->src_h,
+		    cmd->dst_x, cmd->dst_y, cmd->dst_w, cmd->dst_h,
+		    cmd->angle) < 0)
+			ret = -1;
+	}
+
+	queue->cmdsz = 0;
+
+	return ret;
+}
+
+void
+mlk_render_queue_clear(struct mlk_render_queue *queue)
+{
+	assert(queue);
+
+	queue->cmdsz = 0;
+}
+
+void
+mlk_render_queue_finish(struct mlk_render_queue *queue)
+{
+	assert(queue);
+
+	mlk_alloc_free(queue->cmds);
+	mlk_alloc_free(queue->sorted);
+	mlk_alloc_free(queue->entries);
+	mlk_alloc_free(queue->scratch);
+	memset(queue, 0, sizeof (*queue));
+}
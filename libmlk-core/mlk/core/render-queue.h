@@ -0,0 +1,310 @@
+/*
+ * render-queue.h -- sort-keyed render queue
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_RENDER_QUEUE_H
+#define MLK_CORE_RENDER_QUEUE_H
+
+/**
+ * \file mlk/core/render-queue.h
+ * \brief Sort-keyed render queue.
+ *
+ * This module defers draw calls so that they can be reordered before being
+ * submitted to the renderer. Each command comes with a 64-bit sort key
+ * usually built using ::mlk_render_key which packs, from the most
+ * significant bits:
+ *
+ * | bits  | field   | remarks                                   |
+ * |-------|---------|-------------------------------------------|
+ * | 56-63 | layer   | background, characters, foreground, UI... |
+ * | 32-55 | depth   | usually the bottom y of an object         |
+ * | 8-31  | texture | groups commands using the same texture    |
+ * | 0-7   | blend   | groups commands using the same blend mode |
+ *
+ * Commands are drawn by increasing key once per frame using
+ * ::mlk_render_queue_flush, which gives correct y-ordering of characters
+ * against foreground tiles and minimizes texture switches at the same time.
+ * The blend mode of each command is set on its texture before drawing, only
+ * when it differs from the previous command.
+ * The sort is a stable radix sort, commands with identical keys are drawn in
+ * submission order.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static struct mlk_render_queue queue;
+ *
+ * mlk_render_queue_init(&queue);
+ *
+ * // In the draw callback.
+ * mlk_render_queue_sprite(&queue,
+ *     mlk_render_key(LAYER_CHARACTERS, hero.y + hero.h, hero.sprite->texture,
+ *         MLK_TEXTURE_BLEND_BLEND),
+ *     hero.sprite, hero.row, hero.column, hero.x, hero.y);
+ * mlk_render_queue_sprite(&queue,
+ *     mlk_render_key(LAYER_CHARACTERS, tree.y + tree.h, trees.texture,
+ *         MLK_TEXTURE_BLEND_BLEND),
+ *     &trees, 0, 0, tree.x, tree.y);
+ * mlk_render_queue_flush(&queue);
+ * ```
+ *
+ * Any other kind of drawing can be deferred by setting the
+ * ::mlk_render_cmd::draw callback.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texture.h"
+
+struct mlk_sprite;
+
+/**
+ * \struct mlk_render_cmd
+ * \brief Deferred draw command.
+ *
+ * The command is copied when queued.
+ */
+struct mlk_render_cmd {
+	/**
+	 * (read-write)
+	 *
+	 * Sort key, see ::mlk_render_key.
+	 */
+	uint64_t key;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Texture to draw if ::mlk_render_cmd::draw is NULL.
+	 */
+	struct mlk_texture *texture;
+
+	/**
+	 * (read-write)
+	 *
+	 * Texture clip position and size.
+	 */
+	int src_x, src_y;
+	unsigned int src_w, src_h;
+
+	/**
+	 * (read-write)
+	 *
+	 * Destination rectangle position and size.
+	 */
+	int dst_x, dst_y;
+	unsigned int dst_w, dst_h;
+
+	/**
+	 * (read-write)
+	 *
+	 * Rotation angle.
+	 */
+	double angle;
+
+	/**
+	 * (read-write)
+	 *
+	 * Blend mode set on the texture before drawing it, usually the one
+	 * given to ::mlk_render_key.
+	 */
+	enum mlk_texture_blend blend;
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Custom draw function, used instead of the texture if not NULL.
+	 *
+	 * The function must not queue commands in the queue being flushed.
+	 *
+	 * \param self this command
+	 */
+	void (*draw)(const struct mlk_render_cmd *self);
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+};
+
+/**
+ * \struct mlk_render_queue
+ * \brief Queue of draw commands.
+ */
+struct mlk_render_queue {
+	/**
+	 * (read-only)
+	 *
+	 * Commands queued, in key order once sorted.
+	 */
+	struct mlk_render_cmd *cmds;
+
+	/**
+	 * (read-only)
+	 *
+	 * Number of commands queued.
+	 */
+	size_t cmdsz;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	struct mlk_render_cmd *sorted;
+	struct mlk__render_entry *entries;
+	struct mlk__render_entry *scratch;
+	size_t capacity;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Build a sort key.
+ *
+ * The depth is clamped to 24 bits signed range and the texture is reduced to
+ * a 24 bits identifier which is only used for grouping.
+ *
+ * \pre layer <= 255
+ * \param layer the layer number
+ * \param depth the depth within the layer
+ * \param texture the texture used (may be NULL)
+ * \param blend the blend mode
+ * \return the sort key
+ */
+uint64_t
+mlk_render_key(unsigned int layer,
+               int depth,
+               const struct mlk_texture *texture,
+               enum mlk_texture_blend blend);
+
+/**
+ * Initialize the queue.
+ *
+ * \pre queue != NULL
+ * \param queue the queue to initialize
+ */
+void
+mlk_render_queue_init(struct mlk_render_queue *queue);
+
+/**
+ * Queue a copy of the command.
+ *
+ * \pre queue != NULL
+ * \pre cmd != NULL
+ * \pre cmd->texture != NULL || cmd->draw != NULL
+ * \param queue the queue
+ * \param cmd the command to copy
+ */
+void
+mlk_render_queue_push(struct mlk_render_queue *queue, const struct mlk_render_cmd *cmd);
+
+/**
+ * Queue the entire texture at the given location.
+ *
+ * The blend mode is the one encoded in the key.
+ *
+ * \pre queue != NULL
+ * \pre texture != NULL
+ * \param queue the queue
+ * \param key the sort key
+ * \param texture the texture to draw
+ * \param x the x coordinate
+ * \param y the y coordinate
+ */
+void
+mlk_render_queue_texture(struct mlk_render_queue *queue,
+                         uint64_t key,
+                         struct mlk_texture *texture,
+                         int x,
+                         int y);
+
+/**
+ * Queue a sprite cell at the given location.
+ *
+ * The blend mode is the one encoded in the key.
+ *
+ * \pre queue != NULL
+ * \pre mlk_sprite_ok(sprite)
+ * \pre r < sprite->nrows && c < sprite->ncols
+ * \param queue the queue
+ * \param key the sort key
+ * \param sprite the sprite to draw
+ * \param r the row number
+ * \param c the column number
+ * \param x the x coordinate
+ * \param y the y coordinate
+ */
+void
+mlk_render_queue_sprite(struct mlk_render_queue *queue,
+                        uint64_t key,
+                        const struct mlk_sprite *sprite,
+                        unsigned int r,
+                        unsigned int c,
+                        int x,
+                        int y);
+
+/**
+ * Sort the queued commands by key.
+ *
+ * This function is called by ::mlk_render_queue_flush and only needs to be
+ * called directly to inspect ::mlk_render_queue::cmds.
+ *
+ * \pre queue != NULL
+ * \param queue the queue
+ */
+void
+mlk_render_queue_sort(struct mlk_render_queue *queue);
+
+/**
+ * Sort and draw every command, then empty the queue.
+ *
+ * All commands are drawn even if some of them fail.
+ *
+ * \pre queue != NULL
+ * \param queue the queue
+ * \return 0 on success or -1 if a texture could not be drawn
+ */
+int
+mlk_render_queue_flush(struct mlk_render_queue *queue);
+
+/**
+ * Discard all commands without drawing them, memory is kept for the next
+ * frame.
+ *
+ * \pre queue != NULL
+ * \param queue the queue
+ */
+void
+mlk_render_queue_clear(struct mlk_render_queue *queue);
+
+/**
+ * Release memory.
+ *
+ * \pre queue != NULL
+ * \param queue the queue
+ */
+void
+mlk_render_queue_finish(struct mlk_render_queue *queue);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_RENDER_QUEUE_H */
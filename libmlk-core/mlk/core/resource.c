@@ -0,0 +1,412 @@
+/*
+ * resource.c -- shared resource manager
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <mlk/util/util.h>
+
+#include "alloc.h"
+#include "cache_p.h"
+#include "err.h"
+#include "font.h"
+#include "image.h"
+#include "music.h"
+#include "resource.h"
+#include "sound.h"
+#include "texture.h"
+#include "util.h"
+#include "vfs-async.h"
+#include "vfs.h"
+
+struct mlk_resource {
+	struct mlk__cache_entry entry;
+	enum mlk_resource_type type;
+	enum mlk_resource_status status;
+	unsigned int size;
+
+	union {
+		struct mlk_texture texture;
+		struct mlk_font font;
+		struct mlk_sound sound;
+		struct mlk_music music;
+	};
+
+	/* File content, kept for types that stream from it. */
+	char *content;
+
+	struct mlk_vfs_async_request req;
+
+	char path[];
+};
+
+static struct {
+	struct mlk_vfs *vfs;
+	struct mlk__cache cache;
+} manager;
+
+static inline uint64_t
+hash(enum mlk_resource_type type, const char *path, unsigned int size)
+{
+	return mlk_util_hash(path, strlen(path)) ^ ((uint64_t)size << 8 | type);
+}
+
+static struct mlk_resource *
+find(enum mlk_resource_type type, const char *path, unsigned int size, uint64_t hash)
+{
+	struct mlk__cache_entry *entry;
+	struct mlk_resource *res;
+
+	for (entry = mlk__cache_bucket(&manager.cache, hash); entry; entry = entry->chain) {
+		res = MLK_UTIL_CONTAINER_OF(entry, struct mlk_resource, entry);
+
+		if (entry->hash == hash && res->type == type && res->size == size && strcmp(res->path, path) == 0)
+			return res;
+	}
+
+	return NULL;
+}
+
+/*
+ * Create the object from the file content, the estimated memory is stored
+ * into cost as the resource may not be in the cache yet.
+ */
+static int
+create(struct mlk_resource *res, char *content, size_t contentsz, size_t *cost)
+{
+	int rv = -1;
+
+	switch (res->type) {
+	case MLK_RESOURCE_TYPE_TEXTURE:
+		/* Pixels are copied to the renderer, no need to keep the file. */
+		if ((rv = mlk_image_openmem(&res->texture, content, contentsz)) == 0)
+			*cost = (size_t)res->texture.w * res->texture.h * 4;
+
+		mlk_alloc_free(content);
+
+		return rv;
+	case MLK_RESOURCE_TYPE_FONT:
+		rv = mlk_font_openmem(&res->font, content, contentsz, res->size);
+		break;
+	case MLK_RESOURCE_TYPE_SOUND:
+		rv = mlk_sound_openmem(&res->sound, content, contentsz);
+		break;
+	case MLK_RESOURCE_TYPE_MUSIC:
+		rv = mlk_music_openmem(&res->music, content, contentsz);
+		break;
+	default:
+		break;
+	}
+
+	if (rv < 0)
+		mlk_alloc_free(content);
+	else {
+		res->content = content;
+		*cost = contentsz;
+	}
+
+	return rv;
+}
+
+static void
+destroy(struct mlk_resource *res)
+{
+	if (res->status != MLK_RESOURCE_STATUS_LOADED)
+		return;
+
+	switch (res->type) {
+	case MLK_RESOURCE_TYPE_TEXTURE:
+		mlk_texture_finish(&res->texture);
+		break;
+	case MLK_RESOURCE_TYPE_FONT:
+		mlk_font_finish(&res->font);
+		break;
+	case MLK_RESOURCE_TYPE_SOUND:
+		mlk_sound_finish(&res->sound);
+		break;
+	case MLK_RESOURCE_TYPE_MUSIC:
+		mlk_music_finish(&res->music);
+		break;
+	default:
+		break;
+	}
+
+	mlk_alloc_free(res->content);
+	res->content = NULL;
+}
+
+static void
+evict(struct mlk__cache_entry *entry)
+{
+	struct mlk_resource *res = MLK_UTIL_CONTAINER_OF(entry, struct mlk_resource, entry);
+
+	if (res->status == MLK_RESOURCE_STATUS_LOADING)
+		mlk_vfs_async_cancel(&res->req);
+
+	destroy(res);
+	mlk_alloc_free(res);
+}
+
+static int
+load(struct mlk_resource *res, size_t *cost)
+{
+	struct mlk_vfs_file *file;
+	char *content;
+	size_t contentsz;
+
+	if (!(file = mlk_vfs_open(manager.vfs, res->path, "r")))
+		return -1;
+
+	content = mlk_vfs_file_read_all(file, &contentsz);
+	mlk_vfs_file_finish(file);
+
+	if (!content || create(res, content, contentsz, cost) < 0)
+		return -1;
+
+	res->status = MLK_RESOURCE_STATUS_LOADED;
+
+	return 0;
+}
+
+static void
+loaded(struct mlk_vfs_async_request *req)
+{
+	struct mlk_resource *res = req->data;
+	size_t cost = 0;
+
+	if (req->status == MLK_VFS_ASYNC_STATUS_DONE && create(res, req->content, req->contentsz, &cost) == 0) {
+		res->status = MLK_RESOURCE_STATUS_LOADED;
+		mlk__cache_charge(&manager.cache, &res->entry, cost);
+		mlk__cache_collect(&manager.cache);
+	} else
+		res->status = MLK_RESOURCE_STATUS_FAILED;
+
+	req->content = NULL;
+}
+
+void
+mlk_resource_init(struct mlk_vfs *vfs, size_t budget)
+{
+	assert(vfs);
+	assert(!manager.vfs);
+
+	manager.vfs = vfs;
+	manager.cache.budget = budget;
+	manager.cache.evict = evict;
+}
+
+void
+mlk_resource_set_budget(size_t budget)
+{
+	manager.cache.budget = budget;
+	mlk__cache_collect(&manager.cache);
+}
+
+struct mlk_resource *
+mlk_resource_open(enum mlk_resource_type type,
+                  const char *path,
+                  unsigned int size,
+                  unsigned int flags)
+{
+	assert(manager.vfs);
+	assert(type < MLK_RESOURCE_TYPE_LAST);
+	assert(path);
+	assert(!(flags & MLK_RESOURCE_ASYNC) || (manager.vfs->flags & MLK_VFS_THREAD_SAFE));
+
+	struct mlk_resource *res;
+	uint64_t h;
+	size_t pathsz, cost = 0;
+
+	/* Size is only meaningful for fonts. */
+	if (type != MLK_RESOURCE_TYPE_FONT)
+		size = 0;
+
+	h = hash(type, path, size);
+
+	if ((res = find(type, path, size, h))) {
+		/* Synchronous users expect the resource to be ready. */
+		if (res->status == MLK_RESOURCE_STATUS_LOADING && !(flags & MLK_RESOURCE_ASYNC)) {
+			mlk_vfs_async_cancel(&res->req);
+
+			if (load(res, &cost) < 0) {
+				res->status = MLK_RESOURCE_STATUS_FAILED;
+				return NULL;
+			}
+
+			mlk__cache_charge(&manager.cache, &res->entry, cost);
+			mlk__cache_collect(&manager.cache);
+		}
+
+		mlk__cache_ref(&manager.cache, &res->entry);
+
+		return res;
+	}
+
+	pathsz = strlen(path) + 1;
+	res = mlk_alloc_new0(1, sizeof (*res) + pathsz);
+	res->entry.hash = h;
+	res->type = type;
+	res->size = size;
+	memcpy(res->path, path, pathsz);
+
+	if (flags & MLK_RESOURCE_ASYNC) {
+		res->status = MLK_RESOURCE_STATUS_LOADING;
+		res->req.vfs = manager.vfs;
+		res->req.path = res->path;
+		res->req.data = res;
+		res->req.done = loaded;
+		mlk_vfs_async_submit(&res->req);
+	} else if (load(res, &cost) < 0) {
+		mlk_alloc_free(res);
+		return NULL;
+	}
+
+	mlk__cache_insert(&manager.cache, &res->entry);
+	mlk__cache_charge(&manager.cache, &res->entry, cost);
+	mlk__cache_collect(&manager.cache);
+
+	return res;
+}
+
+struct mlk_resource *
+mlk_resource_ref(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->entry.refs);
+
+	mlk__cache_ref(&manager.cache, &res->entry);
+
+	return res;
+}
+
+void
+mlk_resource_unref(struct mlk_resource *res)
+{
+	if (!res)
+		return;
+
+	/* Only loaded resources are worth keeping. */
+	mlk__cache_unref(&manager.cache, &res->entry, res->status == MLK_RESOURCE_STATUS_LOADED);
+}
+
+enum mlk_resource_status
+mlk_resource_status(const struct mlk_resource *res)
+{
+	assert(res);
+
+	return res->status;
+}
+
+struct mlk_texture *
+mlk_resource_texture(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->type == MLK_RESOURCE_TYPE_TEXTURE);
+
+	return res->status == MLK_RESOURCE_STATUS_LOADED ? &res->texture : NULL;
+}
+
+struct mlk_font *
+mlk_resource_font(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->type == MLK_RESOURCE_TYPE_FONT);
+
+	return res->status == MLK_RESOURCE_STATUS_LOADED ? &res->font : NULL;
+}
+
+struct mlk_sound *
+mlk_resource_sound(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->type == MLK_RESOURCE_TYPE_SOUND);
+
+	return res->status == MLK_RESOURCE_STATUS_LOADED ? &res->sound : NULL;
+}
+
+struct mlk_music *
+mlk_resource_music(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->type == MLK_RESOURCE_TYPE_MUSIC);
+
+	return res->status == MLK_RESOURCE_STATUS_LOADED ? &res->music : NULL;
+}
+
+int
+mlk_resource_reload(struct mlk_resource *res)
+{
+	assert(res);
+	assert(res->status != MLK_RESOURCE_STATUS_LOADING);
+
+	struct mlk_resource *tmp;
+	size_t pathsz, cost = 0;
+
+	/* Load in a temporary resource so that the current one survives errors. */
+	pathsz = strlen(res->path) + 1;
+	tmp = mlk_alloc_new0(1, sizeof (*tmp) + pathsz);
+	tmp->type = res->type;
+	tmp->size = res->size;
+	memcpy(tmp->path, res->path, pathsz);
+
+	if (load(tmp, &cost) < 0) {
+		mlk_alloc_free(tmp);
+		return -1;
+	}
+
+	destroy(res);
+
+	switch (res->type) {
+	case MLK_RESOURCE_TYPE_TEXTURE:
+		res->texture = tmp->texture;
+		break;
+	case MLK_RESOURCE_TYPE_FONT:
+		res->font = tmp->font;
+		break;
+	case MLK_RESOURCE_TYPE_SOUND:
+		res->sound = tmp->sound;
+		break;
+	case MLK_RESOURCE_TYPE_MUSIC:
+		res->music = tmp->music;
+		break;
+	default:
+		break;
+	}
+
+	res->content = tmp->content;
+	res->status = MLK_RESOURCE_STATUS_LOADED;
+	mlk_alloc_free(tmp);
+	mlk__cache_charge(&manager.cache, &res->entry, cost);
+	mlk__cache_collect(&manager.cache);
+
+	return 0;
+}
+
+size_t
+mlk_resource_usage(void)
+{
+	return manager.cache.usage;
+}
+
+void
+mlk_resource_finish(void)
+{
+	mlk__cache_finish(&manager.cache);
+	memset(&manager, 0, sizeof (manager));
+}
@@ -0,0 +1,295 @@
+/*
+ * resource.h -- shared resource manager
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_RESOURCE_H
+#define MLK_CORE_RESOURCE_H
+
+/**
+ * \file mlk/core/resource.h
+ * \brief Shared resource manager.
+ *
+ * This module owns textures, fonts, sounds and musics loaded from a VFS and
+ * shares them between every user requesting the same file. Resources are
+ * looked up by type and path (and size for fonts) in a hash table and
+ * reference counted through an opaque ::mlk_resource handle.
+ *
+ * When the last reference to a resource is dropped, it is kept loaded so that
+ * opening it again is free. Once the estimated memory used by all resources
+ * exceeds the budget given to ::mlk_resource_init, those unreferenced
+ * resources are destroyed starting with the least recently used and will be
+ * loaded again the next time they are opened. Resources still referenced are
+ * never evicted, the budget can therefore be exceeded by the working set.
+ *
+ * The estimated memory is the pixels size for textures and the file length
+ * for other types as their content is kept in memory.
+ *
+ * Example of use:
+ *
+ * ```c
+ * struct mlk_resource *res;
+ *
+ * mlk_resource_init(&dir.vfs, 64 * 1024 * 1024);
+ *
+ * if (!(res = mlk_resource_open(MLK_RESOURCE_TYPE_TEXTURE, "images/world.png", 0, 0)))
+ * 	mlk_panic();
+ *
+ * mlk_texture_draw(mlk_resource_texture(res), 10, 10);
+ * mlk_resource_unref(res);
+ * ```
+ *
+ * ## Asynchronous loading
+ *
+ * With ::MLK_RESOURCE_ASYNC, the file is read using mlk/core/vfs-async.h
+ * which must be initialized. The handle is returned immediately with the
+ * ::MLK_RESOURCE_STATUS_LOADING status and the resource is created from the
+ * main thread in ::mlk_vfs_async_dispatch, accessors return NULL until then.
+ *
+ * As the VFS is then read from the I/O threads while synchronous resources
+ * are still loaded from the main thread, it must have the
+ * ::MLK_VFS_THREAD_SAFE flag.
+ *
+ * \warning Like the resources themselves, this module must only be used from
+ *          the main thread.
+ */
+
+#include <stddef.h>
+
+struct mlk_font;
+struct mlk_music;
+struct mlk_resource;
+struct mlk_sound;
+struct mlk_texture;
+struct mlk_vfs;
+
+/**
+ * \enum mlk_resource_type
+ * \brief Resource type.
+ */
+enum mlk_resource_type {
+	/**
+	 * Texture opened with ::mlk_image_openmem.
+	 */
+	MLK_RESOURCE_TYPE_TEXTURE,
+
+	/**
+	 * Font opened with ::mlk_font_openmem.
+	 */
+	MLK_RESOURCE_TYPE_FONT,
+
+	/**
+	 * Sound opened with ::mlk_sound_openmem.
+	 */
+	MLK_RESOURCE_TYPE_SOUND,
+
+	/**
+	 * Music opened with ::mlk_music_openmem.
+	 */
+	MLK_RESOURCE_TYPE_MUSIC,
+
+	/**
+	 * Unused sentinel value.
+	 */
+	MLK_RESOURCE_TYPE_LAST
+};
+
+/**
+ * \enum mlk_resource_status
+ * \brief Resource status.
+ */
+enum mlk_resource_status {
+	/**
+	 * Resource being read asynchronously.
+	 */
+	MLK_RESOURCE_STATUS_LOADING,
+
+	/**
+	 * Resource ready to be used.
+	 */
+	MLK_RESOURCE_STATUS_LOADED,
+
+	/**
+	 * Resource could not be loaded asynchronously, it will be tried again
+	 * the next time it is opened once every reference has been dropped.
+	 */
+	MLK_RESOURCE_STATUS_FAILED
+};
+
+/**
+ * \enum mlk_resource_flags
+ * \brief Flags for ::mlk_resource_open.
+ */
+enum mlk_resource_flags {
+	/**
+	 * Read the file asynchronously if not already loaded.
+	 */
+	MLK_RESOURCE_ASYNC = (1 << 0)
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Initialize the resource manager.
+ *
+ * \pre vfs != NULL
+ * \param vfs the VFS to open files from (borrowed)
+ * \param budget memory budget in bytes (0 for no limit)
+ */
+void
+mlk_resource_init(struct mlk_vfs *vfs, size_t budget);
+
+/**
+ * Change the memory budget, unreferenced resources are evicted immediately if
+ * needed.
+ *
+ * \param budget memory budget in bytes (0 for no limit)
+ */
+void
+mlk_resource_set_budget(size_t budget);
+
+/**
+ * Open a resource or get a new reference to it if already opened.
+ *
+ * \pre ::mlk_resource_init must have been called
+ * \pre type < MLK_RESOURCE_TYPE_LAST
+ * \pre path != NULL
+ * \pre the VFS must have ::MLK_VFS_THREAD_SAFE with ::MLK_RESOURCE_ASYNC
+ * \param type the resource type
+ * \param path the path to the file in the VFS
+ * \param size font height in pixels (ignored for other types)
+ * \param flags optional flags (see ::mlk_resource_flags)
+ * \return a new reference to the resource or NULL on error
+ */
+struct mlk_resource *
+mlk_resource_open(enum mlk_resource_type type,
+                  const char *path,
+                  unsigned int size,
+                  unsigned int flags);
+
+/**
+ * Get an additional reference to the resource.
+ *
+ * \pre res != NULL
+ * \param res the resource
+ * \return res
+ */
+struct mlk_resource *
+mlk_resource_ref(struct mlk_resource *res);
+
+/**
+ * Drop a reference to the resource.
+ *
+ * The handle must no longer be used if it was the last reference owned by
+ * the caller.
+ *
+ * \param res the resource (may be NULL)
+ */
+void
+mlk_resource_unref(struct mlk_resource *res);
+
+/**
+ * Get the resource status.
+ *
+ * \pre res != NULL
+ * \param res the resource
+ * \return the status
+ */
+enum mlk_resource_status
+mlk_resource_status(const struct mlk_resource *res);
+
+/**
+ * Get the underlying texture.
+ *
+ * \pre res != NULL
+ * \pre res must be a ::MLK_RESOURCE_TYPE_TEXTURE resource
+ * \param res the resource
+ * \return the texture or NULL if not loaded
+ */
+struct mlk_texture *
+mlk_resource_texture(struct mlk_resource *res);
+
+/**
+ * Get the underlying font.
+ *
+ * \pre res != NULL
+ * \pre res must be a ::MLK_RESOURCE_TYPE_FONT resource
+ * \param res the resource
+ * \return the font or NULL if not loaded
+ */
+struct mlk_font *
+mlk_resource_font(struct mlk_resource *res);
+
+/**
+ * Get the underlying sound.
+ *
+ * \pre res != NULL
+ * \pre res must be a ::MLK_RESOURCE_TYPE_SOUND resource
+ * \param res the resource
+ * \return the sound or NULL if not loaded
+ */
+struct mlk_sound *
+mlk_resource_sound(struct mlk_resource *res);
+
+/**
+ * Get the underlying music.
+ *
+ * \pre res != NULL
+ * \pre res must be a ::MLK_RESOURCE_TYPE_MUSIC resource
+ * \param res the resource
+ * \return the music or NULL if not loaded
+ */
+struct mlk_music *
+mlk_resource_music(struct mlk_resource *res);
+
+/**
+ * Load again a resource from its file, for example after it has been
+ * modified on disk.
+ *
+ * The underlying object is replaced in place so pointers returned by the
+ * accessors stay valid. On error, the previous object is kept.
+ *
+ * \pre res != NULL
+ * \pre res must not be loading
+ * \param res the resource
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_resource_reload(struct mlk_resource *res);
+
+/**
+ * Return the estimated memory used by every resource loaded.
+ *
+ * \return the memory usage in bytes
+ */
+size_t
+mlk_resource_usage(void);
+
+/**
+ * Destroy every resource.
+ *
+ * All handles become invalid even if still referenced.
+ */
+void
+mlk_resource_finish(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_RESOURCE_H */
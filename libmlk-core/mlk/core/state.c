@@ -18,8 +18,37 @@
 
 #include <assert.h>
 
+#include "job.h"
 #include "state.h"
 
+static void
+preload(struct mlk_job *job)
+{
+	struct mlk_state_transition *transition = job->data;
+
+	mlk_state_preload(transition->state, transition);
+	SDL_SetAtomicInt(&transition->progress, 100);
+}
+
+static void
+preloaded(struct mlk_job *job)
+{
+	struct mlk_state_transition *transition = job->data;
+
+	if (transition->done)
+		transition->done(transition);
+}
+
+void
+mlk_state_preload(struct mlk_state *state, struct mlk_state_transition *transition)
+{
+	assert(state);
+	assert(transition);
+
+	if (state->preload)
+		state->preload(state, transition);
+}
+
 void
 mlk_state_start(struct mlk_state *state)
 {
@@ -48,6 +77,15 @@ mlk_state_update(struct mlk_state *state, unsigned int ticks)
 		state->update(state, ticks);
 }
 
+void
+mlk_state_snapshot(struct mlk_state *state)
+{
+	assert(state);
+
+	if (state->snapshot)
+		state->snapshot(state);
+}
+
 void
 mlk_state_draw(struct mlk_state *state)
 {
@@ -92,3 +130,59 @@ mlk_state_finish(struct mlk_state *state)
 	if (state->finish)
 		state->finish(state);
 }
+
+void
+mlk_state_transition_start(struct mlk_state_transition *transition)
+{
+	assert(transition);
+	assert(transition->state);
+	assert(mlk_job_completed(&transition->counter));
+
+	SDL_SetAtomicInt(&transition->progress, 0);
+
+	transition->job = (struct mlk_job) {
+		.run = preload,
+		.done = preloaded,
+		.counter = &transition->counter,
+		.data = transition
+	};
+
+	mlk_job_submit(&transition->job);
+}
+
+void
+mlk_state_transition_report(struct mlk_state_transition *transition,
+                            unsigned int done,
+                            unsigned int total)
+{
+	assert(transition);
+	assert(done <= total);
+
+	/* Keep 100 for the end of the preload function. */
+	if (total)
+		SDL_SetAtomicInt(&transition->progress, (unsigned long long)done * 99 / total);
+}
+
+unsigned int
+mlk_state_transition_progress(struct mlk_state_transition *transition)
+{
+	assert(transition);
+
+	return SDL_GetAtomicInt(&transition->progress);
+}
+
+int
+mlk_state_transition_busy(struct mlk_state_transition *transition)
+{
+	assert(transition);
+
+	return !mlk_job_completed(&transition->counter);
+}
+
+void
+mlk_state_transition_wait(struct mlk_state_transition *transition)
+{
+	assert(transition);
+
+	mlk_job_wait(&transition->counter);
+}
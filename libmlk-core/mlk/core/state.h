@@ -22,10 +22,46 @@
 /**
  * \file mlk/core/state.h
  * \brief Abstract game loop state
+ *
+ * ## Preloading
+ *
+ * A state can load its resources in the background before being started
+ * using a ::mlk_state_transition. Its ::mlk_state::preload function is then
+ * invoked from a mlk/core/job.h worker thread while the current state keeps
+ * running and the transition callback is invoked from the main thread once
+ * it has returned, which is where the states are usually swapped.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static struct mlk_state *current;
+ * static struct mlk_state_transition transition;
+ *
+ * static void
+ * switched(struct mlk_state_transition *transition)
+ * {
+ * 	mlk_state_end(current);
+ * 	mlk_state_finish(current);
+ *
+ * 	current = transition->state;
+ * 	mlk_state_start(current);
+ * }
+ *
+ * transition.state = &world;
+ * transition.done = switched;
+ * mlk_state_transition_start(&transition);
+ *
+ * // In the loading screen draw function.
+ * draw_bar(mlk_state_transition_progress(&transition));
+ * ```
  */
 
+#include "job.h"
+
 union mlk_event;
 
+struct mlk_state_transition;
+
 /**
  * \struct mlk_state
  * \brief State structure
@@ -50,6 +86,20 @@ struct mlk_state {
 	 */
 	const char *name;
 
+	/**
+	 * (read-write, optional)
+	 *
+	 * Load resources before the state starts.
+	 *
+	 * This function is invoked from a worker thread by
+	 * ::mlk_state_transition_start and must not use the renderer, it can
+	 * report its progress using ::mlk_state_transition_report.
+	 *
+	 * \param self this state
+	 * \param transition the transition in progress
+	 */
+	void (*preload)(struct mlk_state *self, struct mlk_state_transition *transition);
+
 	/**
 	 * (read-write, optional)
 	 *
@@ -79,6 +129,22 @@ struct mlk_state {
 	 */
 	void (*update)(struct mlk_state *self, unsigned int ticks);
 
+	/**
+	 * (read-write, optional)
+	 *
+	 * Copy what is needed to draw the state from the simulation data
+	 * modified by ::mlk_state::update.
+	 *
+	 * When the game loop runs in pipelined mode (see ::mlk_game::pipeline),
+	 * the update of the next frame runs on a separate thread while the
+	 * current frame is drawn. This function is then called from the main
+	 * thread while no update is running, ::mlk_state::draw must only use
+	 * the data copied here.
+	 *
+	 * \param self this state
+	 */
+	void (*snapshot)(struct mlk_state *self);
+
 	/**
 	 * (read-write, optional)
 	 *
@@ -131,10 +197,59 @@ struct mlk_state {
 	void (*finish)(struct mlk_state *self);
 };
 
+/**
+ * \struct mlk_state_transition
+ * \brief Background preload of a state.
+ *
+ * The structure must stay valid until its callback has been invoked.
+ */
+struct mlk_state_transition {
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * State to preload.
+	 */
+	struct mlk_state *state;
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Invoked from the main thread in ::mlk_job_dispatch once
+	 * ::mlk_state::preload has returned.
+	 *
+	 * \param self this transition
+	 */
+	void (*done)(struct mlk_state_transition *self);
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	struct mlk_job job;
+	struct mlk_job_counter counter;
+	SDL_AtomicInt progress;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
+/**
+ * Invoke ::mlk_state::preload function if not NULL.
+ *
+ * \pre state != NULL
+ * \pre transition != NULL
+ * \param state the state
+ * \param transition the transition in progress
+ */
+void
+mlk_state_preload(struct mlk_state *state, struct mlk_state_transition *transition);
+
 /**
  * Invoke ::mlk_state::start function if not NULL.
  *
@@ -165,6 +280,15 @@ mlk_state_handle(struct mlk_state *state, const union mlk_event *event);
 void
 mlk_state_update(struct mlk_state *state, unsigned int ticks);
 
+/**
+ * Invoke ::mlk_state::snapshot function if not NULL.
+ *
+ * \pre state != NULL
+ * \param state the state
+ */
+void
+mlk_state_snapshot(struct mlk_state *state);
+
 /**
  * Invoke ::mlk_state::draw function if not NULL.
  *
@@ -210,6 +334,66 @@ mlk_state_end(struct mlk_state *state);
 void
 mlk_state_finish(struct mlk_state *state);
 
+/**
+ * Start preloading the transition state in the background.
+ *
+ * If mlk/core/job.h has not been initialized, the state is preloaded and the
+ * callback invoked immediately.
+ *
+ * \pre transition != NULL
+ * \pre transition->state != NULL
+ * \pre the previous start of this transition must have been dispatched
+ * \param transition the transition
+ */
+void
+mlk_state_transition_start(struct mlk_state_transition *transition);
+
+/**
+ * Report the preload progress, usually called from ::mlk_state::preload.
+ *
+ * \pre transition != NULL
+ * \pre done <= total
+ * \param transition the transition
+ * \param done the amount of work done
+ * \param total the total amount of work
+ */
+void
+mlk_state_transition_report(struct mlk_state_transition *transition,
+                            unsigned int done,
+                            unsigned int total);
+
+/**
+ * Get the preload progress.
+ *
+ * \pre transition != NULL
+ * \param transition the transition
+ * \return the progress in percent, 100 once ::mlk_state::preload returned
+ */
+unsigned int
+mlk_state_transition_progress(struct mlk_state_transition *transition);
+
+/**
+ * Tells if ::mlk_state::preload is still running.
+ *
+ * \pre transition != NULL
+ * \param transition the transition
+ * \return non-zero if still running
+ */
+int
+mlk_state_transition_busy(struct mlk_state_transition *transition);
+
+/**
+ * Wait until ::mlk_state::preload has returned, running other jobs in the
+ * meantime.
+ *
+ * The callback is still invoked from ::mlk_job_dispatch.
+ *
+ * \pre transition != NULL
+ * \param transition the transition
+ */
+void
+mlk_state_transition_wait(struct mlk_state_transition *transition);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -64,6 +64,15 @@ static struct {
 	.name = "molko"
 };
 
+/*
+ * Special directories never change once computed, they are filled on first
+ * use from whichever thread comes first and then only read.
+ */
+static struct {
+	SDL_InitState init;
+	char paths[MLK_SYS_DIR_LAST][MLK_PATH_MAX];
+} dirs;
+
 struct viodata {
 	const unsigned char *data;
 	const size_t datasz;
@@ -80,22 +89,16 @@ normalize(char *str)
 	return str;
 }
 
-static const char *
-user_directory(enum mlk_sys_dir kind)
+static void
+user_directory(char *path, size_t pathsz)
 {
-	/* Kept for future use. */
-	(void)kind;
-
-	static MLK_THREAD_LOCAL char path[MLK_PATH_MAX];
 	char *pref;
 
 	if ((pref = SDL_GetPrefPath(info.organization, info.name))) {
-		mlk_util_strlcpy(path, pref, sizeof (path));
+		mlk_util_strlcpy(path, pref, pathsz);
 		SDL_free(pref);
 	} else
-		mlk_util_strlcpy(path, "./", sizeof (path));
-
-	return path;
+		mlk_util_strlcpy(path, "./", pathsz);
 }
 
 static inline int
@@ -322,16 +325,14 @@ mlk_sys_dir(enum mlk_sys_dir kind)
 {
 	assert(kind >= 0 && kind < MLK_SYS_DIR_LAST);
 
-	switch (kind) {
-	case MLK_SYS_DIR_SAVE:
-		return user_directory(kind);
-	case MLK_SYS_DIR_LOCALES:
-		return system_directory(MLK_LOCALEDIR);
-	default:
-		break;
+	if (SDL_ShouldInit(&dirs.init)) {
+		user_directory(dirs.paths[MLK_SYS_DIR_SAVE], sizeof (dirs.paths[0]));
+		mlk_util_strlcpy(dirs.paths[MLK_SYS_DIR_LOCALES],
+		    system_directory(MLK_LOCALEDIR), sizeof (dirs.paths[0]));
+		SDL_SetInitialized(&dirs.init, true);
 	}
 
-	return NULL;
+	return dirs.paths[kind];
 }
 
 int
@@ -371,6 +372,9 @@ void
 mlk_sys_finish(void)
 {
 	audio_finish();
+
+	if (SDL_ShouldQuit(&dirs.init))
+		SDL_SetInitialized(&dirs.init, false);
 }
 
 static int
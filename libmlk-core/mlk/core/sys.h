@@ -63,8 +63,11 @@ mlk_sys_init(const char *organization, const char *name);
 /**
  * Obtain a path for the given special directory.
  *
+ * Paths are computed once and cached until ::mlk_sys_finish, this function
+ * can be called from any thread.
+ *
  * \param directory directory type
- * \return a path to a thread-local static array
+ * \return a path to a static array
  */
 const char *
 mlk_sys_dir(enum mlk_sys_dir directory);
@@ -59,7 +59,8 @@ mlk_texture_set_blend_mode(struct mlk_texture *tex, enum mlk_texture_blend blend
 		[MLK_TEXTURE_BLEND_NONE] = SDL_BLENDMODE_NONE,
 		[MLK_TEXTURE_BLEND_BLEND] = SDL_BLENDMODE_BLEND,
 		[MLK_TEXTURE_BLEND_ADD] = SDL_BLENDMODE_ADD,
-		[MLK_TEXTURE_BLEND_MODULATE] = SDL_BLENDMODE_MOD
+		[MLK_TEXTURE_BLEND_MODULATE] = SDL_BLENDMODE_MOD,
+		[MLK_TEXTURE_BLEND_PREMULTIPLIED] = SDL_BLENDMODE_BLEND_PREMULTIPLIED
 	};
 
 	if (!SDL_SetTextureBlendMode(tex->handle, table[blend]))
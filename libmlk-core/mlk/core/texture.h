@@ -88,6 +88,17 @@ enum mlk_texture_blend {
 	 */
 	MLK_TEXTURE_BLEND_MODULATE,
 
+	/**
+	 * Alpha blending with colors already multiplied by alpha, this is the
+	 * mode of textures loaded from mlk/util/rawtex.h files.
+	 *
+	 * ```
+	 * RGB = SRC_RGB + (DST_RGB * (1 - SRC_A))
+	 * A   = SRC_A + (DST_A * (1 - SRC_A))
+	 * ```
+	 */
+	MLK_TEXTURE_BLEND_PREMULTIPLIED,
+
 	/**
 	 * Unused sentinel value.
 	 */
@@ -0,0 +1,207 @@
+/*
+ * timer.c -- hierarchical timer wheel
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <utlist.h>
+
+#include "timer.h"
+
+/*
+ * Four levels of 64 slots, each slot of a level covers the whole range of
+ * the previous one. Timers of upper levels are moved down (cascaded) once
+ * their slot is reached.
+ */
+#define LEVELS 4
+#define BITS   6
+#define SLOTS  (1 << BITS)
+#define MASK   (SLOTS - 1)
+#define RANGE  (UINT64_C(1) << (LEVELS * BITS))
+
+static struct {
+	struct mlk_timer *wheel[LEVELS][SLOTS];
+	uint64_t now;
+	size_t count;
+} timers;
+
+static void
+insert(struct mlk_timer *timer)
+{
+	uint64_t expires = timer->deadline, diff = expires - timers.now;
+	int level;
+
+	/* Too far away, park in the last slot and cascade again later. */
+	if (diff >= RANGE)
+		expires = timers.now + RANGE - 1;
+
+	for (level = 0; level < LEVELS - 1; ++level)
+		if (diff < UINT64_C(1) << ((level + 1) * BITS))
+			break;
+
+	timer->slot = &timers.wheel[level][(expires >> (level * BITS)) & MASK];
+	DL_APPEND(*timer->slot, timer);
+}
+
+static void
+cascade(int level)
+{
+	struct mlk_timer *list, *timer, *tmp;
+
+	list = timers.wheel[level][(timers.now >> (level * BITS)) & MASK];
+	timers.wheel[level][(timers.now >> (level * BITS)) & MASK] = NULL;
+
+	DL_FOREACH_SAFE(list, timer, tmp) {
+		DL_DELETE(list, timer);
+		insert(timer);
+	}
+}
+
+static size_t
+step(void)
+{
+	struct mlk_timer *expired, *timer;
+	size_t count = 0;
+
+	timers.now++;
+
+	/* Move upper levels down, starting with the highest. */
+	if ((timers.now & MASK) == 0) {
+		int last = 1;
+
+		while (last < LEVELS - 1 && ((timers.now >> (last * BITS)) & MASK) == 0)
+			last++;
+		while (last >= 1)
+			cascade(last--);
+	}
+
+	/*
+	 * Detach the slot so that timers scheduled again from a callback are
+	 * not fired twice, callbacks may still cancel the remaining ones.
+	 */
+	expired = timers.wheel[0][timers.now & MASK];
+	timers.wheel[0][timers.now & MASK] = NULL;
+
+	for (timer = expired; timer; timer = timer->next)
+		timer->slot = &expired;
+
+	while ((timer = expired)) {
+		DL_DELETE(expired, timer);
+
+		/* Parked too far away. */
+		if (timer->deadline > timers.now) {
+			insert(timer);
+			continue;
+		}
+
+		if (timer->interval) {
+			timer->deadline += timer->interval;
+			insert(timer);
+		} else {
+			timer->slot = NULL;
+			timers.count--;
+		}
+
+		timer->fire(timer);
+		count++;
+	}
+
+	return count;
+}
+
+void
+mlk_timer_schedule(struct mlk_timer *timer, unsigned int delay)
+{
+	assert(timer);
+	assert(timer->fire);
+	assert(!timer->slot);
+
+	/* The current slot has already been processed. */
+	timer->deadline = timers.now + (delay ? delay : 1);
+	timers.count++;
+	insert(timer);
+}
+
+void
+mlk_timer_reschedule(struct mlk_timer *timer, unsigned int delay)
+{
+	mlk_timer_cancel(timer);
+	mlk_timer_schedule(timer, delay);
+}
+
+void
+mlk_timer_cancel(struct mlk_timer *timer)
+{
+	assert(timer);
+
+	if (timer->slot) {
+		DL_DELETE(*timer->slot, timer);
+		timer->slot = NULL;
+		timers.count--;
+	}
+}
+
+int
+mlk_timer_pending(const struct mlk_timer *timer)
+{
+	assert(timer);
+
+	return timer->slot != NULL;
+}
+
+unsigned int
+mlk_timer_remaining(const struct mlk_timer *timer)
+{
+	assert(timer);
+
+	if (!timer->slot)
+		return 0;
+
+	return timer->deadline - timers.now;
+}
+
+size_t
+mlk_timer_dispatch(unsigned int ticks)
+{
+	size_t count = 0;
+
+	while (ticks--) {
+		/* Nothing to wait for, just move time forward. */
+		if (timers.count == 0) {
+			timers.now += ticks + 1;
+			break;
+		}
+
+		count += step();
+	}
+
+	return count;
+}
+
+void
+mlk_timer_finish(void)
+{
+	struct mlk_timer *timer, *tmp;
+
+	for (int l = 0; l < LEVELS; ++l)
+		for (int s = 0; s < SLOTS; ++s)
+			DL_FOREACH_SAFE(timers.wheel[l][s], timer, tmp)
+				timer->slot = NULL;
+
+	memset(&timers, 0, sizeof (timers));
+}
@@ -0,0 +1,181 @@
+/*
+ * timer.h -- hierarchical timer wheel
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_TIMER_H
+#define MLK_CORE_TIMER_H
+
+/**
+ * \file mlk/core/timer.h
+ * \brief Hierarchical timer wheel.
+ *
+ * This module invokes callbacks once a delay has expired without having to
+ * update each object every frame. Timers are stored in a hierarchical wheel
+ * of four levels with a resolution of one millisecond, scheduling and
+ * cancelling are constant time operations and a frame only costs the
+ * timers actually expiring.
+ *
+ * Time is advanced by ::mlk_timer_dispatch which is called once per frame by
+ * ::mlk_game_loop with the elapsed time, callbacks are therefore invoked
+ * from the main thread.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static void
+ * blink(struct mlk_timer *timer)
+ * {
+ * 	struct entity *entity = timer->data;
+ *
+ * 	entity->visible = !entity->visible;
+ * }
+ *
+ * entity->blink.fire = blink;
+ * entity->blink.interval = 100;
+ * entity->blink.data = entity;
+ *
+ * // Toggle visibility every 100 milliseconds starting in one second.
+ * mlk_timer_schedule(&entity->blink, 1000);
+ * ```
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \struct mlk_timer
+ * \brief Timer to schedule.
+ *
+ * The structure must be zero initialized and stay valid while it is
+ * scheduled.
+ */
+struct mlk_timer {
+	/**
+	 * (read-write)
+	 *
+	 * Function invoked once the delay has expired.
+	 *
+	 * The timer can be scheduled again or cancelled from the callback,
+	 * as can any other timer.
+	 *
+	 * \param self this timer
+	 */
+	void (*fire)(struct mlk_timer *self);
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * If not zero, the timer is scheduled again with this delay in
+	 * milliseconds right before being fired, keeping its phase.
+	 */
+	unsigned int interval;
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	uint64_t deadline;
+	struct mlk_timer **slot;
+	struct mlk_timer *next;
+	struct mlk_timer *prev;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Schedule the timer to fire in the given delay.
+ *
+ * A delay of 0 fires the timer on the next dispatch.
+ *
+ * \pre timer != NULL
+ * \pre timer->fire != NULL
+ * \pre timer must not be scheduled
+ * \param timer the timer
+ * \param delay the delay in milliseconds
+ */
+void
+mlk_timer_schedule(struct mlk_timer *timer, unsigned int delay);
+
+/**
+ * Schedule the timer again, whether it is already scheduled or not.
+ *
+ * \pre timer != NULL
+ * \pre timer->fire != NULL
+ * \param timer the timer
+ * \param delay the new delay in milliseconds from now
+ */
+void
+mlk_timer_reschedule(struct mlk_timer *timer, unsigned int delay);
+
+/**
+ * Cancel the timer, no-op if not scheduled.
+ *
+ * \pre timer != NULL
+ * \param timer the timer
+ */
+void
+mlk_timer_cancel(struct mlk_timer *timer);
+
+/**
+ * Tells if the timer is scheduled.
+ *
+ * \pre timer != NULL
+ * \param timer the timer
+ * \return non-zero if scheduled
+ */
+int
+mlk_timer_pending(const struct mlk_timer *timer);
+
+/**
+ * Get the time remaining before the timer fires.
+ *
+ * \pre timer != NULL
+ * \param timer the timer
+ * \return the remaining time in milliseconds or 0 if not scheduled
+ */
+unsigned int
+mlk_timer_remaining(const struct mlk_timer *timer);
+
+/**
+ * Advance time and fire expired timers in deadline order.
+ *
+ * This function is called by ::mlk_game_loop.
+ *
+ * \param ticks the elapsed time in milliseconds
+ * \return the number of timers fired
+ */
+size_t
+mlk_timer_dispatch(unsigned int ticks);
+
+/**
+ * Cancel all timers.
+ */
+void
+mlk_timer_finish(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_TIMER_H */
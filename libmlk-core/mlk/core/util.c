@@ -18,7 +18,9 @@
 
 #include <assert.h>
 #include <limits.h>
-#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include <SDL3/SDL.h>
 
@@ -32,10 +34,27 @@ mlk_util_sleep(unsigned int ms)
 	SDL_Delay(ms);
 }
 
+/*
+ * splitmix64, good enough for games and any state value including 0 is a
+ * valid seed.
+ */
+static inline uint64_t
+next(uint64_t *state)
+{
+	uint64_t z = (*state += UINT64_C(0x9e3779b97f4a7c15));
+
+	z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+	return z ^ (z >> 31);
+}
+
 const char *
 mlk_util_pathf(const char *fmt, ...)
 {
-	static char path[MLK_PATH_MAX];
+	assert(fmt);
+
+	static MLK_THREAD_LOCAL char path[MLK_PATH_MAX];
 	va_list ap;
 
 	va_start(ap, fmt);
@@ -45,12 +64,46 @@ mlk_util_pathf(const char *fmt, ...)
 	return path;
 }
 
+char *
+mlk_util_pathf_r(char *buf, size_t bufsz, const char *fmt, ...)
+{
+	assert(buf);
+	assert(bufsz);
+	assert(fmt);
+
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(buf, bufsz, fmt, ap);
+	va_end(ap);
+
+	return buf;
+}
+
 unsigned int
 mlk_util_nrand(unsigned int lower, unsigned int upper)
 {
-	assert(upper <= RAND_MAX);
+	static MLK_THREAD_LOCAL uint64_t state;
+	static MLK_THREAD_LOCAL int seeded;
+
+	/* The state address differs in each thread. */
+	if (!seeded) {
+		state = SDL_GetPerformanceCounter() ^ (uintptr_t)&state;
+		seeded = 1;
+	}
+
+	return mlk_util_nrand_r(&state, lower, upper);
+}
+
+unsigned int
+mlk_util_nrand_r(uint64_t *state, unsigned int lower, unsigned int upper)
+{
+	assert(state);
+
+	if (upper <= lower)
+		return lower;
 
-	return (rand() % (upper - lower)) + lower;
+	return (unsigned int)(next(state) % (upper - lower)) + lower;
 }
 
 intmax_t
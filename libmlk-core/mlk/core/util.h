@@ -60,21 +60,54 @@ mlk_util_sleep(unsigned int duration);
  * \pre fmt != NULL
  * \param fmt the format string
  * \note The returned string is static thread-local and will be modified on
- *       subsequent calls.
+ *       subsequent calls from the same thread.
  */
 const char *
 mlk_util_pathf(const char *fmt, ...);
 
+/**
+ * Reentrant version of ::mlk_util_pathf writing into a user buffer.
+ *
+ * The path is truncated if the buffer is too small.
+ *
+ * \pre buf != NULL
+ * \pre bufsz > 0
+ * \pre fmt != NULL
+ * \param buf the destination buffer
+ * \param bufsz the buffer size
+ * \param fmt the format string
+ * \return buf
+ */
+char *
+mlk_util_pathf_r(char *buf, size_t bufsz, const char *fmt, ...);
+
 /**
  * Compute a random number between [min-max).
  *
+ * Each thread uses its own generator, seeded on first use.
+ *
  * \param min the minimum range (included)
  * \param max the maximum range (excluded)
- * \return a random number
+ * \return a random number or min if the range is empty
  */
 unsigned int
 mlk_util_nrand(unsigned int min, unsigned int max);
 
+/**
+ * Reentrant version of ::mlk_util_nrand using a user state.
+ *
+ * The state can be initialized to any value, the same initial value always
+ * produces the same sequence.
+ *
+ * \pre state != NULL
+ * \param state the generator state, updated on each call
+ * \param min the minimum range (included)
+ * \param max the maximum range (excluded)
+ * \return a random number or min if the range is empty
+ */
+unsigned int
+mlk_util_nrand_r(uint64_t *state, unsigned int min, unsigned int max);
+
 /**
  * Clamp a value between limits.
  *
@@ -0,0 +1,298 @@
+/*
+ * vfs-async.c -- asynchronous VFS reads
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/util/util.h>
+
+#include <utlist.h>
+
+#include "alloc.h"
+#include "err.h"
+#include "pool_p.h"
+#include "vfs-async.h"
+#include "vfs.h"
+
+static struct {
+	struct mlk__pool pool;
+
+	/* Requests waiting for an I/O thread, one queue per priority. */
+	struct mlk_vfs_async_request *pending[MLK_VFS_ASYNC_PRIORITY_LAST];
+
+	/* Requests read but not yet dispatched. */
+	struct mlk_vfs_async_request *completed;
+
+	/* Requests being read. */
+	size_t running;
+} async;
+
+static inline int
+has_pending(void)
+{
+	for (int i = 0; i < MLK_VFS_ASYNC_PRIORITY_LAST; ++i)
+		if (async.pending[i])
+			return 1;
+
+	return 0;
+}
+
+static struct mlk_vfs_async_request *
+pop(void)
+{
+	struct mlk_vfs_async_request *req;
+
+	for (int i = 0; i < MLK_VFS_ASYNC_PRIORITY_LAST; ++i) {
+		if ((req = async.pending[i])) {
+			DL_DELETE(async.pending[i], req);
+			return req;
+		}
+	}
+
+	return NULL;
+}
+
+static enum mlk_vfs_async_status
+read_request(struct mlk_vfs_async_request *req)
+{
+	struct mlk_vfs_file *file;
+
+	if (!(file = mlk_vfs_open(req->vfs, req->path, "r")))
+		goto failed;
+
+	req->content = mlk_vfs_file_read_all(file, &req->contentsz);
+	mlk_vfs_file_finish(file);
+
+	if (!req->content)
+		goto failed;
+
+	return MLK_VFS_ASYNC_STATUS_DONE;
+
+failed:
+	/* Errors are thread local, copy it while still on this thread. */
+	mlk_util_strlcpy(req->error, mlk_err(), sizeof (req->error));
+
+	return MLK_VFS_ASYNC_STATUS_FAILED;
+}
+
+static int
+worker(void *data)
+{
+	(void)data;
+
+	struct mlk_vfs_async_request *req;
+	enum mlk_vfs_async_status status;
+
+	SDL_LockMutex(async.pool.mutex);
+
+	for (;;) {
+		while (!mlk__pool_quit(&async.pool) && !has_pending())
+			SDL_WaitCondition(async.pool.work, async.pool.mutex);
+
+		if (mlk__pool_quit(&async.pool))
+			break;
+
+		req = pop();
+		req->status = MLK_VFS_ASYNC_STATUS_RUNNING;
+		async.running++;
+
+		SDL_UnlockMutex(async.pool.mutex);
+		status = read_request(req);
+		SDL_LockMutex(async.pool.mutex);
+
+		req->status = status;
+		async.running--;
+		DL_APPEND(async.completed, req);
+		SDL_BroadcastCondition(async.pool.done);
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return 0;
+}
+
+static void
+discard(struct mlk_vfs_async_request **list)
+{
+	struct mlk_vfs_async_request *req, *tmp;
+
+	DL_FOREACH_SAFE(*list, req, tmp) {
+		DL_DELETE(*list, req);
+		mlk_alloc_free(req->content);
+		req->content = NULL;
+		req->contentsz = 0;
+		req->status = MLK_VFS_ASYNC_STATUS_NONE;
+	}
+}
+
+int
+mlk_vfs_async_init(unsigned int workers)
+{
+	assert(!async.pool.mutex);
+
+	if (workers == 0)
+		workers = MLK_VFS_ASYNC_WORKERS;
+
+	return mlk__pool_init(&async.pool, workers, "mlk-vfs-async", worker);
+}
+
+void
+mlk_vfs_async_submit(struct mlk_vfs_async_request *req)
+{
+	assert(async.pool.mutex);
+	assert(req);
+	assert(req->vfs);
+	assert(req->path);
+	assert(req->priority < MLK_VFS_ASYNC_PRIORITY_LAST);
+
+	req->content = NULL;
+	req->contentsz = 0;
+	req->error[0] = '\0';
+
+	SDL_LockMutex(async.pool.mutex);
+
+	assert(req->status != MLK_VFS_ASYNC_STATUS_PENDING &&
+	       req->status != MLK_VFS_ASYNC_STATUS_RUNNING);
+
+	req->status = MLK_VFS_ASYNC_STATUS_PENDING;
+	DL_APPEND(async.pending[req->priority], req);
+	SDL_SignalCondition(async.pool.work);
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+void
+mlk_vfs_async_prioritize(struct mlk_vfs_async_request *req,
+                         enum mlk_vfs_async_priority priority)
+{
+	assert(async.pool.mutex);
+	assert(req);
+	assert(priority < MLK_VFS_ASYNC_PRIORITY_LAST);
+
+	SDL_LockMutex(async.pool.mutex);
+
+	if (req->status == MLK_VFS_ASYNC_STATUS_PENDING && req->priority != priority) {
+		DL_DELETE(async.pending[req->priority], req);
+		DL_APPEND(async.pending[priority], req);
+	}
+
+	req->priority = priority;
+
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+void
+mlk_vfs_async_cancel(struct mlk_vfs_async_request *req)
+{
+	assert(async.pool.mutex);
+	assert(req);
+
+	struct mlk_vfs_async_request *iter;
+
+	SDL_LockMutex(async.pool.mutex);
+
+	while (req->status == MLK_VFS_ASYNC_STATUS_RUNNING)
+		SDL_WaitCondition(async.pool.done, async.pool.mutex);
+
+	switch (req->status) {
+	case MLK_VFS_ASYNC_STATUS_PENDING:
+		DL_DELETE(async.pending[req->priority], req);
+		req->status = MLK_VFS_ASYNC_STATUS_NONE;
+		break;
+	case MLK_VFS_ASYNC_STATUS_DONE:
+	case MLK_VFS_ASYNC_STATUS_FAILED:
+		/* Only discard if not yet dispatched. */
+		DL_FOREACH(async.completed, iter) {
+			if (iter == req) {
+				DL_DELETE(async.completed, req);
+				mlk_alloc_free(req->content);
+				req->content = NULL;
+				req->contentsz = 0;
+				req->status = MLK_VFS_ASYNC_STATUS_NONE;
+				break;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+}
+
+size_t
+mlk_vfs_async_dispatch(void)
+{
+	struct mlk_vfs_async_request *req, *iter;
+	size_t count = 0, max = 0;
+
+	if (!async.pool.mutex)
+		return 0;
+
+	/*
+	 * Requests are removed one at a time because callbacks may cancel
+	 * other completed requests, those submitted again by their callback
+	 * are left for the next frame.
+	 */
+	SDL_LockMutex(async.pool.mutex);
+	DL_COUNT(async.completed, iter, max);
+
+	for (; count < max && (req = async.completed); ++count) {
+		DL_DELETE(async.completed, req);
+		SDL_UnlockMutex(async.pool.mutex);
+
+		if (req->done)
+			req->done(req);
+
+		SDL_LockMutex(async.pool.mutex);
+	}
+
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return count;
+}
+
+int
+mlk_vfs_async_busy(void)
+{
+	int busy;
+
+	if (!async.pool.mutex)
+		return 0;
+
+	SDL_LockMutex(async.pool.mutex);
+	busy = has_pending() || async.running || async.completed;
+	SDL_UnlockMutex(async.pool.mutex);
+
+	return busy;
+}
+
+void
+mlk_vfs_async_finish(void)
+{
+	mlk__pool_finish(&async.pool);
+
+	/* Threads are gone, no need to lock anymore. */
+	for (int i = 0; i < MLK_VFS_ASYNC_PRIORITY_LAST; ++i)
+		discard(&async.pending[i]);
+
+	discard(&async.completed);
+
+	memset(&async, 0, sizeof (async));
+}
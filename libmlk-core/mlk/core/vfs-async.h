@@ -0,0 +1,306 @@
+/*
+ * vfs-async.h -- asynchronous VFS reads
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_VFS_ASYNC_H
+#define MLK_CORE_VFS_ASYNC_H
+
+/**
+ * \file mlk/core/vfs-async.h
+ * \brief Asynchronous VFS reads.
+ *
+ * This module reads VFS files entirely from one or more I/O threads so that
+ * the game loop does not freeze while assets are being loaded.
+ *
+ * The user fills a ::mlk_vfs_async_request and submits it, the request itself
+ * is the handle to the operation. Once the file has been read, the
+ * ::mlk_vfs_async_request::done callback is invoked from the main thread in
+ * ::mlk_vfs_async_dispatch which is called once per frame by ::mlk_game_loop
+ * right after input handling.
+ *
+ * Requests are served by priority then in submission order, low priority
+ * requests are suited for prefetching assets that may be needed later. A
+ * request can be promoted using ::mlk_vfs_async_prioritize when it becomes
+ * required or cancelled using ::mlk_vfs_async_cancel.
+ *
+ * Example of use:
+ *
+ * ```c
+ * static struct mlk_vfs_async_request req;
+ *
+ * static void
+ * loaded(struct mlk_vfs_async_request *req)
+ * {
+ * 	if (req->status == MLK_VFS_ASYNC_STATUS_FAILED)
+ * 		mlk_tracef("%s: %s", req->path, req->error);
+ * 	else {
+ * 		// Use req->content, req->contentsz...
+ * 		mlk_alloc_free(req->content);
+ * 	}
+ * }
+ *
+ * mlk_vfs_async_init(2);
+ *
+ * req.vfs = &dir.vfs;
+ * req.path = "images/world.png";
+ * req.done = loaded;
+ * mlk_vfs_async_submit(&req);
+ * ```
+ *
+ * \warning The VFS and its files are used from the I/O threads. Unless it has
+ *          the ::MLK_VFS_THREAD_SAFE flag (such as mlk/core/vfs-dir.h or
+ *          mlk/core/vfs-pack.h), no other thread, including the main thread,
+ *          may use the VFS while requests on it are pending, even with a
+ *          single I/O thread. Several I/O threads also require the flag.
+ */
+
+#include <stddef.h>
+
+#include "err.h"
+
+struct mlk_vfs;
+
+/**
+ * Default number of I/O threads if 0 is given to ::mlk_vfs_async_init.
+ */
+#define MLK_VFS_ASYNC_WORKERS 1
+
+/**
+ * \enum mlk_vfs_async_priority
+ * \brief Request priority.
+ */
+enum mlk_vfs_async_priority {
+	/**
+	 * Content required as soon as possible.
+	 */
+	MLK_VFS_ASYNC_PRIORITY_HIGH,
+
+	/**
+	 * Default priority.
+	 */
+	MLK_VFS_ASYNC_PRIORITY_NORMAL,
+
+	/**
+	 * Prefetching, only served when nothing else is pending.
+	 */
+	MLK_VFS_ASYNC_PRIORITY_LOW,
+
+	/**
+	 * Unused sentinel value.
+	 */
+	MLK_VFS_ASYNC_PRIORITY_LAST
+};
+
+/**
+ * \enum mlk_vfs_async_status
+ * \brief Request status.
+ */
+enum mlk_vfs_async_status {
+	/**
+	 * Request not submitted or cancelled.
+	 */
+	MLK_VFS_ASYNC_STATUS_NONE,
+
+	/**
+	 * Request waiting for an I/O thread.
+	 */
+	MLK_VFS_ASYNC_STATUS_PENDING,
+
+	/**
+	 * Request being read.
+	 */
+	MLK_VFS_ASYNC_STATUS_RUNNING,
+
+	/**
+	 * Request read successfully.
+	 */
+	MLK_VFS_ASYNC_STATUS_DONE,
+
+	/**
+	 * Request could not be read, see ::mlk_vfs_async_request::error.
+	 */
+	MLK_VFS_ASYNC_STATUS_FAILED
+};
+
+/**
+ * \struct mlk_vfs_async_request
+ * \brief Asynchronous read request.
+ *
+ * The structure must stay valid until its callback has been invoked or it has
+ * been cancelled.
+ */
+struct mlk_vfs_async_request {
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * VFS to open the file from.
+	 */
+	struct mlk_vfs *vfs;
+
+	/**
+	 * (read-write, borrowed)
+	 *
+	 * Path to the file in the VFS.
+	 */
+	const char *path;
+
+	/**
+	 * (read-write)
+	 *
+	 * Request priority, see also ::mlk_vfs_async_prioritize to change it
+	 * once submitted.
+	 */
+	enum mlk_vfs_async_priority priority;
+
+	/**
+	 * (read-only)
+	 *
+	 * Current request status.
+	 */
+	enum mlk_vfs_async_status status;
+
+	/**
+	 * (read-only, owned)
+	 *
+	 * Content read from the file, NUL terminated.
+	 *
+	 * Once dispatched, the user owns the content and must release it
+	 * using ::mlk_alloc_free.
+	 */
+	char *content;
+
+	/**
+	 * (read-only)
+	 *
+	 * Content length, not including the NUL terminator.
+	 */
+	size_t contentsz;
+
+	/**
+	 * (read-only)
+	 *
+	 * Error string if the read failed.
+	 */
+	char error[MLK_ERR_MAX];
+
+	/**
+	 * (read-write, borrowed, optional)
+	 *
+	 * Arbitrary user data.
+	 */
+	void *data;
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Invoked from the main thread once the request has been read or
+	 * failed.
+	 *
+	 * \param self this request
+	 */
+	void (*done)(struct mlk_vfs_async_request *self);
+
+	/** \cond MLK_PRIVATE_DECLS */
+	struct mlk_vfs_async_request *prev;
+	struct mlk_vfs_async_request *next;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Start the I/O threads.
+ *
+ * \param workers the number of threads (0 for ::MLK_VFS_ASYNC_WORKERS)
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_vfs_async_init(unsigned int workers);
+
+/**
+ * Submit a request.
+ *
+ * \pre req != NULL
+ * \pre req->vfs != NULL
+ * \pre req->path != NULL
+ * \pre req must not be already submitted
+ * \pre ::mlk_vfs_async_init must have been called
+ * \param req the request
+ */
+void
+mlk_vfs_async_submit(struct mlk_vfs_async_request *req);
+
+/**
+ * Change the priority of a request not yet started, this has no effect
+ * otherwise.
+ *
+ * \pre req != NULL
+ * \param req the request
+ * \param priority the new priority
+ */
+void
+mlk_vfs_async_prioritize(struct mlk_vfs_async_request *req,
+                         enum mlk_vfs_async_priority priority);
+
+/**
+ * Cancel a request.
+ *
+ * If the request is currently being read, this function waits for the read to
+ * complete and discards it. Once it returns, the request is no longer used and
+ * its callback will never be invoked.
+ *
+ * \pre req != NULL
+ * \param req the request
+ */
+void
+mlk_vfs_async_cancel(struct mlk_vfs_async_request *req);
+
+/**
+ * Invoke callbacks of requests completed since the last call.
+ *
+ * This function is called by ::mlk_game_loop and does nothing if the module
+ * has not been initialized.
+ *
+ * \return the number of requests dispatched
+ */
+size_t
+mlk_vfs_async_dispatch(void);
+
+/**
+ * Tells if requests are still pending, running or not yet dispatched.
+ *
+ * \return non-zero if the module is busy
+ */
+int
+mlk_vfs_async_busy(void);
+
+/**
+ * Stop the I/O threads.
+ *
+ * Pending requests are cancelled, completed requests not yet dispatched are
+ * discarded without invoking their callback.
+ */
+void
+mlk_vfs_async_finish(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_VFS_ASYNC_H */
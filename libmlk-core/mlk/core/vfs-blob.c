@@ -0,0 +1,241 @@
+/*
+ * vfs-blob.c -- VFS subsystem for assets embedded with mlk-bcc
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "err.h"
+#include "util.h"
+#include "vfs-blob.h"
+#include "vfs.h"
+
+#define MLK_VFS_BLOB_FILE(self) \
+	MLK_UTIL_CONTAINER_OF(self, struct mlk_vfs_blob_file, file)
+
+#define MLK_VFS_BLOB(self) \
+	MLK_UTIL_CONTAINER_OF(self, struct mlk_vfs_blob, vfs)
+
+static const struct mlk_vfs_blob_entry *
+lookup(const struct mlk_vfs_blob *blob, const char *name)
+{
+	size_t lo = 0, hi = blob->entriesz, mid;
+	int cmp;
+
+	/* Entries are generated sorted by name. */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+
+		if ((cmp = strcmp(blob->entries[mid].name, name)) == 0)
+			return &blob->entries[mid];
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	mlk_errf("%s: entry not found", name);
+
+	return NULL;
+}
+
+static size_t
+file_read(struct mlk_vfs_file *self, void *buf, size_t bufsz)
+{
+	return mlk_vfs_blob_file_read(MLK_VFS_BLOB_FILE(self), buf, bufsz);
+}
+
+static size_t
+file_size(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_blob_file_size(MLK_VFS_BLOB_FILE(self));
+}
+
+static int
+file_seek(struct mlk_vfs_file *self, int64_t offset, enum mlk_vfs_whence whence)
+{
+	return mlk_vfs_blob_file_seek(MLK_VFS_BLOB_FILE(self), offset, whence);
+}
+
+static size_t
+file_tell(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_blob_file_tell(MLK_VFS_BLOB_FILE(self));
+}
+
+static void
+file_finish(struct mlk_vfs_file *self)
+{
+	mlk_vfs_blob_file_finish(MLK_VFS_BLOB_FILE(self));
+}
+
+static struct mlk_vfs_file *
+vfs_open(struct mlk_vfs *self, const char *entry, const char *mode)
+{
+	return mlk_vfs_blob_open(MLK_VFS_BLOB(self), entry, mode);
+}
+
+static void
+vfs_finish(struct mlk_vfs *self)
+{
+	mlk_vfs_blob_finish(MLK_VFS_BLOB(self));
+}
+
+void
+mlk_vfs_blob_init(struct mlk_vfs_blob *blob,
+                  const void *data,
+                  const struct mlk_vfs_blob_entry *entries,
+                  size_t entriesz)
+{
+	assert(blob);
+	assert(data || entriesz == 0);
+	assert(entries || entriesz == 0);
+
+	blob->data = data;
+	blob->entries = entries;
+	blob->entriesz = entriesz;
+	blob->vfs.flags = MLK_VFS_THREAD_SAFE;
+	blob->vfs.open = vfs_open;
+	blob->vfs.finish = vfs_finish;
+}
+
+const void *
+mlk_vfs_blob_find(struct mlk_vfs_blob *blob, const char *entry, size_t *size)
+{
+	assert(blob);
+	assert(entry);
+
+	const struct mlk_vfs_blob_entry *info;
+
+	if (!(info = lookup(blob, entry)))
+		return NULL;
+	if (size)
+		*size = info->size;
+
+	return blob->data + info->offset;
+}
+
+struct mlk_vfs_file *
+mlk_vfs_blob_open(struct mlk_vfs_blob *blob, const char *entry, const char *mode)
+{
+	assert(blob);
+	assert(entry);
+	assert(mode);
+
+	struct mlk_vfs_blob_file *file;
+	const struct mlk_vfs_blob_entry *info;
+
+	if (strchr(mode, 'w')) {
+		mlk_errf("blob files are read-only");
+		return NULL;
+	}
+
+	if (!(info = lookup(blob, entry)))
+		return NULL;
+
+	file = mlk_alloc_new0(1, sizeof (*file));
+	file->data = blob->data + info->offset;
+	file->size = info->size;
+	file->file.read = file_read;
+	file->file.size = file_size;
+	file->file.seek = file_seek;
+	file->file.tell = file_tell;
+	file->file.finish = file_finish;
+
+	return &file->file;
+}
+
+void
+mlk_vfs_blob_finish(struct mlk_vfs_blob *blob)
+{
+	assert(blob);
+
+	blob->data = NULL;
+	blob->entries = NULL;
+	blob->entriesz = 0;
+}
+
+size_t
+mlk_vfs_blob_file_read(struct mlk_vfs_blob_file *file, void *buf, size_t bufsz)
+{
+	assert(file);
+	assert(buf);
+
+	size_t nr;
+
+	nr = file->size - file->offset;
+	nr = nr < bufsz ? nr : bufsz;
+
+	memcpy(buf, file->data + file->offset, nr);
+	file->offset += nr;
+
+	return nr;
+}
+
+size_t
+mlk_vfs_blob_file_size(struct mlk_vfs_blob_file *file)
+{
+	assert(file);
+
+	return file->size;
+}
+
+int
+mlk_vfs_blob_file_seek(struct mlk_vfs_blob_file *file, int64_t offset, enum mlk_vfs_whence whence)
+{
+	assert(file);
+
+	int64_t base;
+
+	switch (whence) {
+	case MLK_VFS_SEEK_CUR:
+		base = file->offset;
+		break;
+	case MLK_VFS_SEEK_END:
+		base = file->size;
+		break;
+	case MLK_VFS_SEEK_SET:
+		base = 0;
+		break;
+	default:
+		return mlk_errf("invalid whence");
+	}
+
+	if (offset < -base || base + offset > (int64_t)file->size)
+		return mlk_errf("invalid offset");
+
+	file->offset = base + offset;
+
+	return 0;
+}
+
+size_t
+mlk_vfs_blob_file_tell(struct mlk_vfs_blob_file *file)
+{
+	assert(file);
+
+	return file->offset;
+}
+
+void
+mlk_vfs_blob_file_finish(struct mlk_vfs_blob_file *file)
+{
+	assert(file);
+
+	mlk_alloc_free(file);
+}
@@ -0,0 +1,216 @@
+/*
+ * vfs-blob.h -- VFS subsystem for assets embedded with mlk-bcc
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_VFS_BLOB_H
+#define MLK_CORE_VFS_BLOB_H
+
+/**
+ * \file mlk/core/vfs-blob.h
+ * \brief VFS subsystem for assets embedded with mlk-bcc.
+ *
+ * This module gives access to a whole directory embedded in the executable
+ * using the directory mode of the mlk-bcc tool (see `mlk-bcc -d`) which
+ * generates a single aligned array containing every file and a table of
+ * ::mlk_vfs_blob_entry sorted by name.
+ *
+ * Entries are found using a binary search and read directly from the array
+ * without any allocation except the file object itself.
+ *
+ * ```c
+ * #include "assets/data.h"
+ *
+ * struct mlk_vfs_blob blob;
+ *
+ * mlk_vfs_blob_init(&blob, data_data, data_entries, MLK_UTIL_SIZE(data_entries));
+ * ```
+ *
+ * It is implemented using the ::MLK_UTIL_CONTAINER_OF macro which means you can
+ * use it and derive from it to add or modify its functions.
+ *
+ * \note It only supports reading files.
+ *
+ * ## Members used
+ *
+ * The following VFS members are used:
+ *
+ * - ::mlk_vfs::finish
+ * - ::mlk_vfs::flags
+ * - ::mlk_vfs::open
+ *
+ * The following VFS file member are used:
+ *
+ * - ::mlk_vfs_file::finish
+ * - ::mlk_vfs_file::read
+ * - ::mlk_vfs_file::seek
+ * - ::mlk_vfs_file::size
+ * - ::mlk_vfs_file::tell
+ */
+
+#include <stddef.h>
+
+#include "vfs.h"
+
+/**
+ * \struct mlk_vfs_blob_entry
+ * \brief Entry in the table generated by mlk-bcc.
+ */
+struct mlk_vfs_blob_entry {
+	/**
+	 * (read-only, borrowed)
+	 *
+	 * Entry path relative to the embedded directory.
+	 */
+	const char *name;
+
+	/**
+	 * (read-only)
+	 *
+	 * Offset to the content in the blob.
+	 */
+	size_t offset;
+
+	/**
+	 * (read-only)
+	 *
+	 * Content length.
+	 */
+	size_t size;
+};
+
+/**
+ * \struct mlk_vfs_blob_file
+ * \brief VFS file implementation for blob entries.
+ */
+struct mlk_vfs_blob_file {
+	/**
+	 * (read-write)
+	 *
+	 * Abstract VFS file to implement.
+	 */
+	struct mlk_vfs_file file;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	const unsigned char *data;
+	size_t size;
+	size_t offset;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+/**
+ * \struct mlk_vfs_blob
+ * \brief VFS implementation for embedded blobs.
+ */
+struct mlk_vfs_blob {
+	/**
+	 * (read-write)
+	 *
+	 * Abstract VFS to implement.
+	 */
+	struct mlk_vfs vfs;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	const unsigned char *data;
+	const struct mlk_vfs_blob_entry *entries;
+	size_t entriesz;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Initialize the blob object.
+ *
+ * The data and entries are not copied and must remain valid until the blob is
+ * finished, which is always the case for arrays generated by mlk-bcc.
+ *
+ * \pre blob != NULL
+ * \pre data != NULL || entriesz == 0
+ * \pre entries != NULL || entriesz == 0
+ * \param blob the blob implementation to initialize
+ * \param data the blob content
+ * \param entries the entries sorted by name
+ * \param entriesz the number of entries
+ */
+void
+mlk_vfs_blob_init(struct mlk_vfs_blob *blob,
+                  const void *data,
+                  const struct mlk_vfs_blob_entry *entries,
+                  size_t entriesz);
+
+/**
+ * Access an entry content directly without any copy.
+ *
+ * \pre blob != NULL
+ * \pre entry != NULL
+ * \param blob the blob
+ * \param entry the entry name
+ * \param size pointer receiving the entry length (can be NULL)
+ * \return the entry content or NULL if not found
+ */
+const void *
+mlk_vfs_blob_find(struct mlk_vfs_blob *blob, const char *entry, size_t *size);
+
+/**
+ * Implements ::mlk_vfs::open virtual function.
+ */
+struct mlk_vfs_file *
+mlk_vfs_blob_open(struct mlk_vfs_blob *blob, const char *entry, const char *mode);
+
+/**
+ * Implements ::mlk_vfs::finish virtual function.
+ */
+void
+mlk_vfs_blob_finish(struct mlk_vfs_blob *blob);
+
+/**
+ * Implements ::mlk_vfs_file::read virtual function.
+ */
+size_t
+mlk_vfs_blob_file_read(struct mlk_vfs_blob_file *file, void *buf, size_t bufsz);
+
+/**
+ * Implements ::mlk_vfs_file::size virtual function.
+ */
+size_t
+mlk_vfs_blob_file_size(struct mlk_vfs_blob_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::seek virtual function.
+ */
+int
+mlk_vfs_blob_file_seek(struct mlk_vfs_blob_file *file, int64_t offset, enum mlk_vfs_whence whence);
+
+/**
+ * Implements ::mlk_vfs_file::tell virtual function.
+ */
+size_t
+mlk_vfs_blob_file_tell(struct mlk_vfs_blob_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::finish virtual function.
+ */
+void
+mlk_vfs_blob_file_finish(struct mlk_vfs_blob_file *file);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_VFS_BLOB_H */
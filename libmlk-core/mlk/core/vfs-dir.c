@@ -163,6 +163,24 @@ file_flush(struct mlk_vfs_file *self)
 	return mlk_vfs_dir_file_flush(MLK_VFS_DIR_FILE(self));
 }
 
+static size_t
+file_size(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_dir_file_size(MLK_VFS_DIR_FILE(self));
+}
+
+static int
+file_seek(struct mlk_vfs_file *self, int64_t offset, enum mlk_vfs_whence whence)
+{
+	return mlk_vfs_dir_file_seek(MLK_VFS_DIR_FILE(self), offset, whence);
+}
+
+static size_t
+file_tell(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_dir_file_tell(MLK_VFS_DIR_FILE(self));
+}
+
 static void
 file_finish(struct mlk_vfs_file *self)
 {
@@ -186,6 +204,7 @@ mlk_vfs_dir_init(struct mlk_vfs_dir *dir, const char *path)
 	/* Remove terminator and switch to UNIX paths. */
 	normalize(dir->path);
 
+	dir->vfs.flags = MLK_VFS_THREAD_SAFE;
 	dir->vfs.open = vfs_open;
 	dir->vfs.finish = NULL;
 }
@@ -207,6 +226,9 @@ mlk_vfs_dir_open(struct mlk_vfs_dir *dir, const char *entry, const char *mode)
 	file->file.read = file_read;
 	file->file.write = file_write;
 	file->file.flush = file_flush;
+	file->file.size = file_size;
+	file->file.seek = file_seek;
+	file->file.tell = file_tell;
 	file->file.finish = file_finish;
 
 	return &file->file;
@@ -261,6 +283,68 @@ mlk_vfs_dir_file_flush(struct mlk_vfs_dir_file *file)
 	return fflush(file->handle) == EOF ? -1 : 0;
 }
 
+size_t
+mlk_vfs_dir_file_size(struct mlk_vfs_dir_file *file)
+{
+	assert(file);
+
+	long pos, size;
+
+	/*
+	 * Use the stdio position rather than fstat(2) so that pending writes
+	 * are accounted and the code stays portable.
+	 */
+	if ((pos = ftell(file->handle)) < 0 ||
+	    fseek(file->handle, 0, SEEK_END) < 0 ||
+	    (size = ftell(file->handle)) < 0 ||
+	    fseek(file->handle, pos, SEEK_SET) < 0)
+		return mlk_errf("%s", strerror(errno));
+
+	return size;
+}
+
+int
+mlk_vfs_dir_file_seek(struct mlk_vfs_dir_file *file, int64_t offset, enum mlk_vfs_whence whence)
+{
+	assert(file);
+
+	int w;
+
+	switch (whence) {
+	case MLK_VFS_SEEK_SET:
+		w = SEEK_SET;
+		break;
+	case MLK_VFS_SEEK_CUR:
+		w = SEEK_CUR;
+		break;
+	case MLK_VFS_SEEK_END:
+		w = SEEK_END;
+		break;
+	default:
+		return mlk_errf("invalid whence");
+	}
+
+	if (offset < LONG_MIN || offset > LONG_MAX)
+		return mlk_errf("%s", strerror(EOVERFLOW));
+	if (fseek(file->handle, offset, w) < 0)
+		return mlk_errf("%s", strerror(errno));
+
+	return 0;
+}
+
+size_t
+mlk_vfs_dir_file_tell(struct mlk_vfs_dir_file *file)
+{
+	assert(file);
+
+	long pos;
+
+	if ((pos = ftell(file->handle)) < 0)
+		return mlk_errf("%s", strerror(errno));
+
+	return pos;
+}
+
 void
 mlk_vfs_dir_file_finish(struct mlk_vfs_dir_file *file)
 {
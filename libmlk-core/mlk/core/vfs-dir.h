@@ -34,6 +34,7 @@
  * The following VFS members are used:
  *
  * - ::mlk_vfs::finish
+ * - ::mlk_vfs::flags
  * - ::mlk_vfs::open
  *
  * The following VFS file member are used:
@@ -41,6 +42,9 @@
  * - ::mlk_vfs_file::finish
  * - ::mlk_vfs_file::flush
  * - ::mlk_vfs_file::read
+ * - ::mlk_vfs_file::seek
+ * - ::mlk_vfs_file::size
+ * - ::mlk_vfs_file::tell
  * - ::mlk_vfs_file::write
  */
 
@@ -137,6 +141,24 @@ mlk_vfs_dir_file_write(struct mlk_vfs_dir_file *file, const void *buf, size_t bu
 int
 mlk_vfs_dir_file_flush(struct mlk_vfs_dir_file *file);
 
+/**
+ * Implements ::mlk_vfs_file::size virtual function.
+ */
+size_t
+mlk_vfs_dir_file_size(struct mlk_vfs_dir_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::seek virtual function.
+ */
+int
+mlk_vfs_dir_file_seek(struct mlk_vfs_dir_file *file, int64_t offset, enum mlk_vfs_whence whence);
+
+/**
+ * Implements ::mlk_vfs_file::tell virtual function.
+ */
+size_t
+mlk_vfs_dir_file_tell(struct mlk_vfs_dir_file *file);
+
 /**
  * Implements ::mlk_vfs_file::finish virtual function.
  */
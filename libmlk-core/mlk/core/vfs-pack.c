@@ -0,0 +1,287 @@
+/*
+ * vfs-pack.c -- VFS subsystem for indexed asset packs
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/pack.h>
+#include <mlk/util/util.h>
+
+#include "alloc.h"
+#include "err.h"
+#include "util.h"
+#include "vfs-pack.h"
+#include "vfs.h"
+
+#define MLK_VFS_PACK_FILE(self) \
+	MLK_UTIL_CONTAINER_OF(self, struct mlk_vfs_pack_file, file)
+
+#define MLK_VFS_PACK(self) \
+	MLK_UTIL_CONTAINER_OF(self, struct mlk_vfs_pack, vfs)
+
+static int
+lookup(struct mlk_vfs_pack *pack, const char *name, struct mlk_pack_entry *entry)
+{
+	if (mlk_pack_find(pack->data, &pack->header, name, entry) < 0)
+		return mlk_errf("%s: entry not found", name);
+
+	/* Make sure a corrupted index does not point outside of the pack. */
+	if (entry->offset > pack->size || pack->size - entry->offset < entry->size)
+		return mlk_errf("%s: corrupted entry", name);
+	if (!(entry->flags & MLK_PACK_LZ) && entry->size != entry->length)
+		return mlk_errf("%s: corrupted entry", name);
+
+	return 0;
+}
+
+static size_t
+file_read(struct mlk_vfs_file *self, void *buf, size_t bufsz)
+{
+	return mlk_vfs_pack_file_read(MLK_VFS_PACK_FILE(self), buf, bufsz);
+}
+
+static size_t
+file_size(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_pack_file_size(MLK_VFS_PACK_FILE(self));
+}
+
+static int
+file_seek(struct mlk_vfs_file *self, int64_t offset, enum mlk_vfs_whence whence)
+{
+	return mlk_vfs_pack_file_seek(MLK_VFS_PACK_FILE(self), offset, whence);
+}
+
+static size_t
+file_tell(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_pack_file_tell(MLK_VFS_PACK_FILE(self));
+}
+
+static void
+file_finish(struct mlk_vfs_file *self)
+{
+	mlk_vfs_pack_file_finish(MLK_VFS_PACK_FILE(self));
+}
+
+static struct mlk_vfs_file *
+vfs_open(struct mlk_vfs *self, const char *entry, const char *mode)
+{
+	return mlk_vfs_pack_open(MLK_VFS_PACK(self), entry, mode);
+}
+
+static void
+vfs_finish(struct mlk_vfs *self)
+{
+	mlk_vfs_pack_finish(MLK_VFS_PACK(self));
+}
+
+int
+mlk_vfs_pack_init(struct mlk_vfs_pack *pack, const char *path)
+{
+	assert(pack);
+	assert(path);
+
+	void *data;
+	size_t size;
+
+	if (!(data = mlk_util_mmap(path, &size)))
+		return mlk_errf("%s: %s", path, strerror(errno));
+
+	if (mlk_vfs_pack_initmem(pack, data, size) < 0) {
+		mlk_util_munmap(data, size);
+		return -1;
+	}
+
+	pack->mapped = 1;
+
+	return 0;
+}
+
+int
+mlk_vfs_pack_initmem(struct mlk_vfs_pack *pack, const void *data, size_t size)
+{
+	assert(pack);
+	assert(data);
+
+	if (mlk_pack_header_decode(&pack->header, data, size) < 0)
+		return mlk_errf("invalid pack file");
+
+	pack->data = data;
+	pack->size = size;
+	pack->mapped = 0;
+	pack->vfs.flags = MLK_VFS_THREAD_SAFE;
+	pack->vfs.open = vfs_open;
+	pack->vfs.finish = vfs_finish;
+
+	return 0;
+}
+
+const void *
+mlk_vfs_pack_find(struct mlk_vfs_pack *pack, const char *entry, size_t *size)
+{
+	assert(pack);
+	assert(entry);
+
+	struct mlk_pack_entry info;
+
+	if (lookup(pack, entry, &info) < 0)
+		return NULL;
+
+	if (info.flags & MLK_PACK_LZ) {
+		mlk_errf("%s: entry is compressed", entry);
+		return NULL;
+	}
+
+	if (size)
+		*size = info.size;
+
+	return pack->data + info.offset;
+}
+
+struct mlk_vfs_file *
+mlk_vfs_pack_open(struct mlk_vfs_pack *pack, const char *entry, const char *mode)
+{
+	assert(pack);
+	assert(entry);
+	assert(mode);
+
+	struct mlk_vfs_pack_file *file;
+	struct mlk_pack_entry info;
+
+	if (strchr(mode, 'w')) {
+		mlk_errf("pack files are read-only");
+		return NULL;
+	}
+
+	if (lookup(pack, entry, &info) < 0)
+		return NULL;
+
+	file = mlk_alloc_new0(1, sizeof (*file));
+	file->size = info.length;
+
+	if (info.flags & MLK_PACK_LZ) {
+		/* Compressed entries are expanded once at open time. */
+		file->buffer = mlk_alloc_new(1, info.length ? info.length : 1);
+
+		if (mlk_lz_decompress(pack->data + info.offset, info.size,
+		    file->buffer, info.length) != info.length) {
+			mlk_errf("%s: corrupted entry", entry);
+			mlk_alloc_free(file->buffer);
+			mlk_alloc_free(file);
+			return NULL;
+		}
+
+		file->data = file->buffer;
+	} else
+		file->data = pack->data + info.offset;
+
+	file->file.read = file_read;
+	file->file.size = file_size;
+	file->file.seek = file_seek;
+	file->file.tell = file_tell;
+	file->file.finish = file_finish;
+
+	return &file->file;
+}
+
+void
+mlk_vfs_pack_finish(struct mlk_vfs_pack *pack)
+{
+	assert(pack);
+
+	if (pack->mapped)
+		mlk_util_munmap((void *)pack->data, pack->size);
+
+	pack->data = NULL;
+	pack->size = 0;
+	pack->mapped = 0;
+}
+
+size_t
+mlk_vfs_pack_file_read(struct mlk_vfs_pack_file *file, void *buf, size_t bufsz)
+{
+	assert(file);
+	assert(buf);
+
+	size_t nr;
+
+	nr = file->size - file->offset;
+	nr = nr < bufsz ? nr : bufsz;
+
+	memcpy(buf, file->data + file->offset, nr);
+	file->offset += nr;
+
+	return nr;
+}
+
+size_t
+mlk_vfs_pack_file_size(struct mlk_vfs_pack_file *file)
+{
+	assert(file);
+
+	return file->size;
+}
+
+int
+mlk_vfs_pack_file_seek(struct mlk_vfs_pack_file *file, int64_t offset, enum mlk_vfs_whence whence)
+{
+	assert(file);
+
+	int64_t base;
+
+	switch (whence) {
+	case MLK_VFS_SEEK_CUR:
+		base = file->offset;
+		break;
+	case MLK_VFS_SEEK_END:
+		base = file->size;
+		break;
+	case MLK_VFS_SEEK_SET:
+		base = 0;
+		break;
+	default:
+		return mlk_errf("invalid whence");
+	}
+
+	if (offset < -base || base + offset > (int64_t)file->size)
+		return mlk_errf("invalid offset");
+
+	file->offset = base + offset;
+
+	return 0;
+}
+
+size_t
+mlk_vfs_pack_file_tell(struct mlk_vfs_pack_file *file)
+{
+	assert(file);
+
+	return file->offset;
+}
+
+void
+mlk_vfs_pack_file_finish(struct mlk_vfs_pack_file *file)
+{
+	assert(file);
+
+	mlk_alloc_free(file->buffer);
+	mlk_alloc_free(file);
+}
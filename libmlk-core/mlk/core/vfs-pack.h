@@ -0,0 +1,194 @@
+/*
+ * vfs-pack.h -- VFS subsystem for indexed asset packs
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_CORE_VFS_PACK_H
+#define MLK_CORE_VFS_PACK_H
+
+/**
+ * \file mlk/core/vfs-pack.h
+ * \brief VFS subsystem for indexed asset packs.
+ *
+ * This module can be used to read files from a pack created with the mlk-pack
+ * tool using the mlk/core/vfs.h abstract VFS module. See mlk/util/pack.h for a
+ * description of the format.
+ *
+ * The pack is memory mapped when opened and entries are found using a binary
+ * search on their name hash, no allocation is required to find an entry.
+ * Entries stored without compression are read directly from the mapping and
+ * can even be accessed without copy using ::mlk_vfs_pack_find.
+ *
+ * It is implemented using the ::MLK_UTIL_CONTAINER_OF macro which means you can
+ * use it and derive from it to add or modify its functions.
+ *
+ * \note It only supports reading files.
+ *
+ * ## Members used
+ *
+ * The following VFS members are used:
+ *
+ * - ::mlk_vfs::finish
+ * - ::mlk_vfs::flags
+ * - ::mlk_vfs::open
+ *
+ * The following VFS file member are used:
+ *
+ * - ::mlk_vfs_file::finish
+ * - ::mlk_vfs_file::read
+ * - ::mlk_vfs_file::seek
+ * - ::mlk_vfs_file::size
+ * - ::mlk_vfs_file::tell
+ */
+
+#include <mlk/util/pack.h>
+
+#include "vfs.h"
+
+/**
+ * \struct mlk_vfs_pack_file
+ * \brief VFS file implementation for pack entries.
+ */
+struct mlk_vfs_pack_file {
+	/**
+	 * (read-write)
+	 *
+	 * Abstract VFS file to implement.
+	 */
+	struct mlk_vfs_file file;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	const unsigned char *data;
+	size_t size;
+	size_t offset;
+	void *buffer;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+/**
+ * \struct mlk_vfs_pack
+ * \brief VFS implementation for packs.
+ */
+struct mlk_vfs_pack {
+	/**
+	 * (read-write)
+	 *
+	 * Abstract VFS to implement.
+	 */
+	struct mlk_vfs vfs;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	const unsigned char *data;
+	size_t size;
+	int mapped;
+	struct mlk_pack_header header;
+	/** \endcond MLK_PRIVATE_DECLS */
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Initialize the pack object by mapping the file in memory.
+ *
+ * \pre pack != NULL
+ * \pre path != NULL
+ * \param pack the pack implementation to initialize
+ * \param path the path to the pack file
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_vfs_pack_init(struct mlk_vfs_pack *pack, const char *path);
+
+/**
+ * Initialize the pack object from a pack already in memory, for example
+ * embedded in the executable using mlk-bcc.
+ *
+ * The data is not copied and must remain valid until the pack is finished.
+ *
+ * \pre pack != NULL
+ * \pre data != NULL
+ * \param pack the pack implementation to initialize
+ * \param data the pack content
+ * \param size the pack content length
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_vfs_pack_initmem(struct mlk_vfs_pack *pack, const void *data, size_t size);
+
+/**
+ * Access an entry content directly from the pack without any copy.
+ *
+ * This function only works on entries that are not compressed.
+ *
+ * \pre pack != NULL
+ * \pre entry != NULL
+ * \param pack the pack
+ * \param entry the entry name
+ * \param size pointer receiving the entry length (can be NULL)
+ * \return the entry content or NULL if not found or compressed
+ */
+const void *
+mlk_vfs_pack_find(struct mlk_vfs_pack *pack, const char *entry, size_t *size);
+
+/**
+ * Implements ::mlk_vfs::open virtual function.
+ */
+struct mlk_vfs_file *
+mlk_vfs_pack_open(struct mlk_vfs_pack *pack, const char *entry, const char *mode);
+
+/**
+ * Implements ::mlk_vfs::finish virtual function.
+ */
+void
+mlk_vfs_pack_finish(struct mlk_vfs_pack *pack);
+
+/**
+ * Implements ::mlk_vfs_file::read virtual function.
+ */
+size_t
+mlk_vfs_pack_file_read(struct mlk_vfs_pack_file *file, void *buf, size_t bufsz);
+
+/**
+ * Implements ::mlk_vfs_file::size virtual function.
+ */
+size_t
+mlk_vfs_pack_file_size(struct mlk_vfs_pack_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::seek virtual function.
+ */
+int
+mlk_vfs_pack_file_seek(struct mlk_vfs_pack_file *file, int64_t offset, enum mlk_vfs_whence whence);
+
+/**
+ * Implements ::mlk_vfs_file::tell virtual function.
+ */
+size_t
+mlk_vfs_pack_file_tell(struct mlk_vfs_pack_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::finish virtual function.
+ */
+void
+mlk_vfs_pack_file_finish(struct mlk_vfs_pack_file *file);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_CORE_VFS_PACK_H */
@@ -21,10 +21,15 @@
 #if defined(MLK_WITH_ZIP)
 
 #include <assert.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <zip.h>
 
+#include <mlk/util/util.h>
+
+#include <utlist.h>
+
 #include "alloc.h"
 #include "err.h"
 #include "util.h"
@@ -37,6 +42,25 @@
 #define MLK_VFS_ZIP(self) \
 	MLK_UTIL_CONTAINER_OF(self, struct mlk_vfs_zip, vfs)
 
+/*
+ * Slot in the open addressing name index, the table is never resized after
+ * init so the cache can link slots directly.
+ */
+struct mlk_vfs_zip_entry {
+	uint64_t hash;
+	zip_uint64_t index;
+	int used;
+
+	/* Decompressed content if cached. */
+	unsigned char *data;
+	size_t size;
+	unsigned int refs;
+
+	/* Cache LRU list, most recent first. */
+	struct mlk_vfs_zip_entry *prev;
+	struct mlk_vfs_zip_entry *next;
+};
+
 static inline int
 mkflags(const char *mode)
 {
@@ -65,12 +89,149 @@ mkflags(const char *mode)
 	return flags;
 }
 
+static void
+index_build(struct mlk_vfs_zip *zip)
+{
+	struct mlk_vfs_zip_entry *entry;
+	zip_int64_t n;
+	const char *name;
+	uint64_t hash;
+	size_t pos;
+
+	n = zip_get_num_entries(zip->handle, 0);
+
+	/* Keep the load factor under 50%. */
+	for (zip->entriesz = 16; zip->entriesz < (size_t)n * 2; zip->entriesz *= 2)
+		continue;
+
+	zip->entries = mlk_alloc_new0(zip->entriesz, sizeof (*zip->entries));
+
+	for (zip_int64_t i = 0; i < n; ++i) {
+		if (!(name = zip_get_name(zip->handle, i, 0)))
+			continue;
+
+		hash = mlk_util_hash(name, strlen(name));
+		pos = hash & (zip->entriesz - 1);
+
+		while (zip->entries[pos].used)
+			pos = (pos + 1) & (zip->entriesz - 1);
+
+		entry = &zip->entries[pos];
+		entry->hash = hash;
+		entry->index = i;
+		entry->used = 1;
+	}
+}
+
+static struct mlk_vfs_zip_entry *
+index_find(struct mlk_vfs_zip *zip, const char *name)
+{
+	struct mlk_vfs_zip_entry *entry;
+	const uint64_t hash = mlk_util_hash(name, strlen(name));
+	const char *ename;
+	size_t pos;
+
+	for (pos = hash & (zip->entriesz - 1); zip->entries[pos].used; pos = (pos + 1) & (zip->entriesz - 1)) {
+		entry = &zip->entries[pos];
+
+		if (entry->hash != hash)
+			continue;
+		if ((ename = zip_get_name(zip->handle, entry->index, 0)) && strcmp(ename, name) == 0)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void
+cache_evict(struct mlk_vfs_zip *zip, struct mlk_vfs_zip_entry *entry)
+{
+	DL_DELETE(zip->lru, entry);
+
+	zip->stats.size -= entry->size;
+	zip->stats.evictions++;
+
+	mlk_alloc_free(entry->data);
+	entry->data = NULL;
+	entry->size = 0;
+}
+
+static void
+cache_trim(struct mlk_vfs_zip *zip)
+{
+	struct mlk_vfs_zip_entry *entry, *prev;
+
+	if (!zip->lru)
+		return;
+
+	/* Walk from the least recently used, skipping entries still opened. */
+	for (entry = zip->lru->prev; zip->stats.size > zip->cache_limit; entry = prev) {
+		prev = entry == zip->lru ? NULL : entry->prev;
+
+		if (entry->refs == 0)
+			cache_evict(zip, entry);
+		if (!prev)
+			break;
+	}
+}
+
+static int
+cache_load(struct mlk_vfs_zip *zip, struct mlk_vfs_zip_entry *entry, size_t size)
+{
+	zip_file_t *fp;
+	zip_int64_t nr;
+	size_t len = 0;
+
+	if (!(fp = zip_fopen_index(zip->handle, entry->index, 0)))
+		return mlk_errf("%s", zip_strerror(zip->handle));
+
+	/* Always allocate at least one byte, NULL means not cached. */
+	entry->data = mlk_alloc_new(1, size ? size : 1);
+
+	while (len < size && (nr = zip_fread(fp, entry->data + len, size - len)) > 0)
+		len += nr;
+
+	if (len != size) {
+		mlk_errf("%s", zip_file_strerror(fp));
+		mlk_alloc_free(entry->data);
+		entry->data = NULL;
+		zip_fclose(fp);
+		return -1;
+	}
+
+	zip_fclose(fp);
+
+	entry->size = size;
+	zip->stats.size += size;
+	DL_PREPEND(zip->lru, entry);
+
+	return 0;
+}
+
 static size_t
 file_read(struct mlk_vfs_file *self, void *buf, size_t bufsz)
 {
 	return mlk_vfs_zip_file_read(MLK_VFS_ZIP_FILE(self), buf, bufsz);
 }
 
+static size_t
+file_size(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_zip_file_size(MLK_VFS_ZIP_FILE(self));
+}
+
+static int
+file_seek(struct mlk_vfs_file *self, int64_t offset, enum mlk_vfs_whence whence)
+{
+	return mlk_vfs_zip_file_seek(MLK_VFS_ZIP_FILE(self), offset, whence);
+}
+
+static size_t
+file_tell(struct mlk_vfs_file *self)
+{
+	return mlk_vfs_zip_file_tell(MLK_VFS_ZIP_FILE(self));
+}
+
 static void
 file_finish(struct mlk_vfs_file *self)
 {
@@ -101,30 +262,82 @@ mlk_vfs_zip_init(struct mlk_vfs_zip *zip, const char *file, const char *mode)
 		return -1;
 	}
 
+	zip->cache_limit = MLK_VFS_ZIP_CACHE_LIMIT;
+	zip->stats = (struct mlk_vfs_zip_stats) {};
+	zip->lru = NULL;
+	zip->vfs.flags = MLK_VFS_NONE;
 	zip->vfs.open = vfs_open;
 	zip->vfs.finish = vfs_finish;
 
+	index_build(zip);
+
 	return 0;
 }
 
 struct mlk_vfs_file *
 mlk_vfs_zip_open(struct mlk_vfs_zip *zip, const char *entry, const char *mode)
 {
+	assert(zip);
+	assert(entry);
+
 	(void)mode;
 
 	struct mlk_vfs_zip_file *file;
+	struct mlk_vfs_zip_entry *ent;
+	zip_stat_t st;
 
-	file = mlk_alloc_new0(1, sizeof (*file));
-
-	if (!(file->handle = zip_fopen(zip->handle, entry, 0))) {
-		mlk_errf("unable to open file in archive");
-		mlk_alloc_free(file);
+	if (!(ent = index_find(zip, entry))) {
+		mlk_errf("%s: entry not found in archive", entry);
 		return NULL;
 	}
 
+	file = mlk_alloc_new0(1, sizeof (*file));
+	file->zip = zip;
 	file->file.read = file_read;
+	file->file.size = file_size;
+	file->file.seek = file_seek;
+	file->file.tell = file_tell;
 	file->file.finish = file_finish;
 
+	if (ent->data) {
+		zip->stats.hits++;
+
+		/* Move to front of the LRU. */
+		DL_DELETE(zip->lru, ent);
+		DL_PREPEND(zip->lru, ent);
+	} else {
+		zip->stats.misses++;
+
+		if (zip_stat_index(zip->handle, ent->index, 0, &st) < 0 || !(st.valid & ZIP_STAT_SIZE)) {
+			mlk_errf("%s", zip_strerror(zip->handle));
+			mlk_alloc_free(file);
+			return NULL;
+		}
+
+		file->size = st.size;
+
+		/* Too large to be cached, stream it directly. */
+		if (zip->cache_limit == 0 || st.size > zip->cache_limit) {
+			if (!(file->handle = zip_fopen_index(zip->handle, ent->index, 0))) {
+				mlk_errf("%s", zip_strerror(zip->handle));
+				mlk_alloc_free(file);
+				return NULL;
+			}
+
+			return &file->file;
+		}
+
+		if (cache_load(zip, ent, st.size) < 0) {
+			mlk_alloc_free(file);
+			return NULL;
+		}
+	}
+
+	ent->refs++;
+	file->entry = ent;
+	file->size = ent->size;
+	cache_trim(zip);
+
 	return &file->file;
 }
 
@@ -133,8 +346,19 @@ mlk_vfs_zip_finish(struct mlk_vfs_zip *zip)
 {
 	assert(zip);
 
+	struct mlk_vfs_zip_entry *entry, *tmp;
+
+	DL_FOREACH_SAFE(zip->lru, entry, tmp) {
+		DL_DELETE(zip->lru, entry);
+		mlk_alloc_free(entry->data);
+	}
+
+	mlk_alloc_free(zip->entries);
 	zip_close(zip->handle);
+	zip->stats.size = 0;
 	zip->handle = NULL;
+	zip->entries = NULL;
+	zip->entriesz = 0;
 }
 
 size_t
@@ -144,6 +368,17 @@ mlk_vfs_zip_file_read(struct mlk_vfs_zip_file *file, void *buf, size_t bufsz)
 	assert(buf);
 
 	zip_int64_t rv;
+	size_t nr;
+
+	if (file->entry) {
+		nr = file->entry->size - file->offset;
+		nr = nr < bufsz ? nr : bufsz;
+
+		memcpy(buf, file->entry->data + file->offset, nr);
+		file->offset += nr;
+
+		return nr;
+	}
 
 	if ((rv = zip_fread(file->handle, buf, bufsz)) < 0) {
 		mlk_errf("%s", zip_file_strerror(file->handle));
@@ -153,12 +388,85 @@ mlk_vfs_zip_file_read(struct mlk_vfs_zip_file *file, void *buf, size_t bufsz)
 	return rv;
 }
 
+size_t
+mlk_vfs_zip_file_size(struct mlk_vfs_zip_file *file)
+{
+	assert(file);
+
+	return file->size;
+}
+
+int
+mlk_vfs_zip_file_seek(struct mlk_vfs_zip_file *file, int64_t offset, enum mlk_vfs_whence whence)
+{
+	assert(file);
+
+	static const int table[] = {
+		[MLK_VFS_SEEK_SET] = SEEK_SET,
+		[MLK_VFS_SEEK_CUR] = SEEK_CUR,
+		[MLK_VFS_SEEK_END] = SEEK_END
+	};
+	int64_t base;
+
+	if ((unsigned int)whence > MLK_VFS_SEEK_END)
+		return mlk_errf("invalid whence");
+
+	/* Streamed entries, libzip can seek in compressed data too. */
+	if (!file->entry) {
+		if (zip_fseek(file->handle, offset, table[whence]) < 0)
+			return mlk_errf("%s", zip_file_strerror(file->handle));
+
+		return 0;
+	}
+
+	switch (whence) {
+	case MLK_VFS_SEEK_CUR:
+		base = file->offset;
+		break;
+	case MLK_VFS_SEEK_END:
+		base = file->size;
+		break;
+	case MLK_VFS_SEEK_SET:
+		base = 0;
+		break;
+	default:
+		return mlk_errf("invalid whence");
+	}
+
+	if (offset < -base || base + offset > (int64_t)file->size)
+		return mlk_errf("invalid offset");
+
+	file->offset = base + offset;
+
+	return 0;
+}
+
+size_t
+mlk_vfs_zip_file_tell(struct mlk_vfs_zip_file *file)
+{
+	assert(file);
+
+	zip_int64_t pos;
+
+	if (file->entry)
+		return file->offset;
+	if ((pos = zip_ftell(file->handle)) < 0)
+		return mlk_errf("%s", zip_file_strerror(file->handle));
+
+	return pos;
+}
+
 void
 mlk_vfs_zip_file_finish(struct mlk_vfs_zip_file *file)
 {
 	assert(file);
 
-	zip_fclose(file->handle);
+	if (file->entry) {
+		file->entry->refs--;
+		cache_trim(file->zip);
+	} else
+		zip_fclose(file->handle);
+
 	mlk_alloc_free(file);
 }
 
@@ -31,17 +31,38 @@
  *
  * \note It currently supports reading files but not writing.
  *
+ * ## Caching
+ *
+ * When the archive is opened, its central directory is indexed in a hash
+ * table so that finding an entry does not require a linear search.
+ *
+ * Decompressed entries are also kept in memory in a least recently used cache
+ * bounded by ::mlk_vfs_zip::cache_limit bytes. Opening an entry that is still
+ * cached does not decompress it again which is useful for assets used by
+ * several maps or tilesets. Entries larger than the limit are streamed as
+ * before and entries still opened are never evicted.
+ *
+ * \note The archive handle and the cache are shared by every file, this VFS
+ *       does not set ::MLK_VFS_THREAD_SAFE.
+ *
  * ## Members used
  *
  * The following VFS members are used:
  *
  * - ::mlk_vfs::finish
+ * - ::mlk_vfs::flags
  * - ::mlk_vfs::open
  *
  * The following VFS file member are used:
  *
  * - ::mlk_vfs_file::finish
  * - ::mlk_vfs_file::read
+ * - ::mlk_vfs_file::seek
+ * - ::mlk_vfs_file::size
+ * - ::mlk_vfs_file::tell
+ *
+ * Seeking a cached entry is free, seeking a streamed entry is delegated to
+ * libzip which may have to decompress from the beginning.
  */
 
 #include "sysconfig.h"
@@ -49,6 +70,40 @@
 
 #if defined(MLK_WITH_ZIP)
 
+/**
+ * Default value for ::mlk_vfs_zip::cache_limit.
+ */
+#define MLK_VFS_ZIP_CACHE_LIMIT (8U * 1024U * 1024U)
+
+struct mlk_vfs_zip;
+struct mlk_vfs_zip_entry;
+
+/**
+ * \struct mlk_vfs_zip_stats
+ * \brief Cache statistics.
+ */
+struct mlk_vfs_zip_stats {
+	/**
+	 * Number of entries opened from the cache.
+	 */
+	size_t hits;
+
+	/**
+	 * Number of entries that had to be decompressed.
+	 */
+	size_t misses;
+
+	/**
+	 * Number of entries removed from the cache.
+	 */
+	size_t evictions;
+
+	/**
+	 * Current number of bytes in the cache.
+	 */
+	size_t size;
+};
+
 /**
  * \struct mlk_vfs_zip_file
  * \brief VFS file implementation for ZIP files.
@@ -63,6 +118,10 @@ struct mlk_vfs_zip_file {
 
 	/** \cond MLK_PRIVATE_DECLS */
 	void *handle;
+	struct mlk_vfs_zip *zip;
+	struct mlk_vfs_zip_entry *entry;
+	size_t offset;
+	size_t size;
 	/** \endcond MLK_PRIVATE_DECLS */
 };
 
@@ -71,6 +130,24 @@ struct mlk_vfs_zip_file {
  * \brief VFS implementation for ZIP files.
  */
 struct mlk_vfs_zip {
+	/**
+	 * (read-write)
+	 *
+	 * Maximum number of decompressed bytes kept in the cache, 0 disables
+	 * caching.
+	 *
+	 * Set to ::MLK_VFS_ZIP_CACHE_LIMIT by ::mlk_vfs_zip_init, it can be
+	 * changed at any time and applies on the next open.
+	 */
+	size_t cache_limit;
+
+	/**
+	 * (read-only)
+	 *
+	 * Cache statistics.
+	 */
+	struct mlk_vfs_zip_stats stats;
+
 	/**
 	 * (read-write)
 	 *
@@ -80,6 +157,9 @@ struct mlk_vfs_zip {
 
 	/** \cond MLK_PRIVATE_DECLS */
 	void *handle;
+	struct mlk_vfs_zip_entry *entries;
+	size_t entriesz;
+	struct mlk_vfs_zip_entry *lru;
 	/** \endcond MLK_PRIVATE_DECLS */
 };
 
@@ -108,7 +188,7 @@ struct mlk_vfs_file *
 mlk_vfs_zip_open(struct mlk_vfs_zip *zip, const char *entry, const char *mode);
 
 /**
- * Implements ::mlk_vfs::open virtual function.
+ * Implements ::mlk_vfs::finish virtual function.
  */
 void
 mlk_vfs_zip_finish(struct mlk_vfs_zip *zip);
@@ -119,6 +199,24 @@ mlk_vfs_zip_finish(struct mlk_vfs_zip *zip);
 size_t
 mlk_vfs_zip_file_read(struct mlk_vfs_zip_file *file, void *buf, size_t bufsz);
 
+/**
+ * Implements ::mlk_vfs_file::size virtual function.
+ */
+size_t
+mlk_vfs_zip_file_size(struct mlk_vfs_zip_file *file);
+
+/**
+ * Implements ::mlk_vfs_file::seek virtual function.
+ */
+int
+mlk_vfs_zip_file_seek(struct mlk_vfs_zip_file *file, int64_t offset, enum mlk_vfs_whence whence);
+
+/**
+ * Implements ::mlk_vfs_file::tell virtual function.
+ */
+size_t
+mlk_vfs_zip_file_tell(struct mlk_vfs_zip_file *file);
+
 /**
  * Implements ::mlk_vfs_file::finish virtual function.
  */
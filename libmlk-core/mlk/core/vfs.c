@@ -55,24 +55,53 @@ mlk_vfs_file_read(struct mlk_vfs_file *file, void *buf, size_t bufsz)
 	return file->read(file, buf, bufsz);
 }
 
+static size_t
+remaining(struct mlk_vfs_file *file)
+{
+	size_t size, pos = 0;
+
+	if (!file->size || (size = file->size(file)) == (size_t)-1)
+		return -1;
+	if (file->tell && (pos = file->tell(file)) == (size_t)-1)
+		return -1;
+
+	return pos < size ? size - pos : 0;
+}
+
 char *
 mlk_vfs_file_read_all(struct mlk_vfs_file *file, size_t *outlen)
 {
-	char data[BUFSIZ], *str;
-	size_t nr, len = 0, cap = sizeof (data);
+	assert(file);
+
+	char extra[BUFSIZ], *str;
+	size_t nr, len = 0, cap;
+
+	/* Allocate exactly if the size is known, keep room for the NUL. */
+	if ((cap = remaining(file)) == (size_t)-1)
+		cap = sizeof (extra);
 
-	/* Initial allocation. */
-	str = mlk_alloc_new0(cap, 1);
+	str = mlk_alloc_new(cap + 1, 1);
 
-	while ((nr = mlk_vfs_file_read(file, data, sizeof (data))) > 0) {
-		if (nr >= cap - len) {
-			while (nr >= cap - len)
-				cap *= 2;
+	for (;;) {
+		if (len < cap)
+			nr = mlk_vfs_file_read(file, &str[len], cap - len);
+		else {
+			/*
+			 * Buffer is full, most of the time this is the end of
+			 * file so check it before growing the buffer.
+			 */
+			if ((nr = mlk_vfs_file_read(file, extra, sizeof (extra))) > 0 && nr != (size_t)-1) {
+				while (nr > cap - len)
+					cap = cap ? cap * 2 : sizeof (extra);
 
-			str = mlk_alloc_resize(str, cap);
+				str = mlk_alloc_resize(str, cap + 1);
+				memcpy(&str[len], extra, nr);
+			}
 		}
 
-		memcpy(&str[len], data, nr);
+		if (nr == 0 || nr == (size_t)-1)
+			break;
+
 		len += nr;
 	}
 
@@ -81,6 +110,8 @@ mlk_vfs_file_read_all(struct mlk_vfs_file *file, size_t *outlen)
 		return NULL;
 	}
 
+	str[len] = '\0';
+
 	if (outlen)
 		*outlen = len;
 
@@ -93,6 +124,9 @@ mlk_vfs_file_write(struct mlk_vfs_file *file, void *buf, size_t bufsz)
 	assert(file);
 	assert(buf);
 
+	if (!file->write)
+		return mlk_errf("operation not supported");
+
 	return file->write(file, buf, bufsz);
 }
 
@@ -107,6 +141,39 @@ mlk_vfs_file_flush(struct mlk_vfs_file *file)
 	return 0;
 }
 
+size_t
+mlk_vfs_file_size(struct mlk_vfs_file *file)
+{
+	assert(file);
+
+	if (!file->size)
+		return mlk_errf("operation not supported");
+
+	return file->size(file);
+}
+
+int
+mlk_vfs_file_seek(struct mlk_vfs_file *file, int64_t offset, enum mlk_vfs_whence whence)
+{
+	assert(file);
+
+	if (!file->seek)
+		return mlk_errf("operation not supported");
+
+	return file->seek(file, offset, whence);
+}
+
+size_t
+mlk_vfs_file_tell(struct mlk_vfs_file *file)
+{
+	assert(file);
+
+	if (!file->tell)
+		return mlk_errf("operation not supported");
+
+	return file->tell(file);
+}
+
 void
 mlk_vfs_file_finish(struct mlk_vfs_file *file)
 {
@@ -118,35 +185,108 @@ mlk_vfs_file_finish(struct mlk_vfs_file *file)
 
 /* private */
 
-static int
-rw_vfs_file_close(SDL_IOStream *context)
+/*
+ * SDL_IOStream implementation reading from a VFS file content loaded in
+ * memory, the content is owned by the stream and released on close.
+ */
+struct rw_memory {
+	char *data;
+	size_t size;
+	size_t offset;
+};
+
+static Sint64
+rw_memory_size(void *userdata)
 {
-#if 0
-	mlk_alloc_free(context->hidden.mem.base);
-	SDL_DestroyRW(context);
-#endif
+	const struct rw_memory *mem = userdata;
 
-	return 0;
+	return mem->size;
+}
+
+static Sint64
+rw_memory_seek(void *userdata, Sint64 offset, SDL_IOWhence whence)
+{
+	struct rw_memory *mem = userdata;
+	Sint64 pos;
+
+	switch (whence) {
+	case SDL_IO_SEEK_SET:
+		pos = offset;
+		break;
+	case SDL_IO_SEEK_CUR:
+		pos = (Sint64)mem->offset + offset;
+		break;
+	case SDL_IO_SEEK_END:
+		pos = (Sint64)mem->size + offset;
+		break;
+	default:
+		return SDL_SetError("invalid whence"), -1;
+	}
+
+	if (pos < 0)
+		return SDL_SetError("seek before beginning of file"), -1;
+
+	mem->offset = (size_t)pos > mem->size ? mem->size : (size_t)pos;
+
+	return mem->offset;
+}
+
+static size_t
+rw_memory_read(void *userdata, void *ptr, size_t size, SDL_IOStatus *status)
+{
+	struct rw_memory *mem = userdata;
+	size_t nr;
+
+	nr = mem->size - mem->offset;
+	nr = nr < size ? nr : size;
+
+	if (nr == 0)
+		*status = SDL_IO_STATUS_EOF;
+
+	memcpy(ptr, mem->data + mem->offset, nr);
+	mem->offset += nr;
+
+	return nr;
+}
+
+static bool
+rw_memory_close(void *userdata)
+{
+	struct rw_memory *mem = userdata;
+
+	mlk_alloc_free(mem->data);
+	mlk_alloc_free(mem);
+
+	return true;
 }
 
 SDL_IOStream *
 mlk__vfs_to_rw(struct mlk_vfs_file *file)
 {
-#if 0
+	assert(file);
+
+	SDL_IOStreamInterface iface;
 	SDL_IOStream *ops;
-	char *data;
-	size_t datasz;
+	struct rw_memory *mem;
 
-	if (!(data = mlk_vfs_file_read_all(file, &datasz)))
+	SDL_INIT_INTERFACE(&iface);
+	iface.size = rw_memory_size;
+	iface.seek = rw_memory_seek;
+	iface.read = rw_memory_read;
+	iface.close = rw_memory_close;
+
+	mem = mlk_alloc_new0(1, sizeof (*mem));
+
+	if (!(mem->data = mlk_vfs_file_read_all(file, &mem->size))) {
+		mlk_alloc_free(mem);
 		return NULL;
-	if (!(ops = SDL_RWFromConstMem(data, datasz))) {
-		mlk_alloc_free(data);
-		return mlk_errf("%s", SDL_GetError()), NULL;
 	}
 
-	ops->close = rw_vfs_file_close;
+	if (!(ops = SDL_OpenIO(&iface, mem))) {
+		mlk_errf("%s", SDL_GetError());
+		rw_memory_close(mem);
+		return NULL;
+	}
 
 	return ops;
-#endif
-	return NULL;
 }
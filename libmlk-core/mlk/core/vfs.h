@@ -27,12 +27,14 @@
  * operation on them. This can be useful for games that are designed to load
  * large assets from compressed archives.
  *
- * The molko frameworks comes with two implementations:
+ * The molko frameworks comes with the following implementations:
  *
- * | module             | support     | remarks                            |
- * |--------------------|-------------|------------------------------------|
- * | mlk/core/vfs-dir.h | read, write | opens file relative to a directory |
- * | mlk/core/vfs-zip.h | read        | zip archive files extractor        |
+ * | module              | support     | remarks                            |
+ * |---------------------|-------------|------------------------------------|
+ * | mlk/core/vfs-blob.h | read        | directories embedded with mlk-bcc  |
+ * | mlk/core/vfs-dir.h  | read, write | opens file relative to a directory |
+ * | mlk/core/vfs-pack.h | read        | memory mapped mlk-pack files       |
+ * | mlk/core/vfs-zip.h  | read        | zip archive files extractor        |
  *
  * ## Opening mode
  *
@@ -90,6 +92,20 @@
  * // Use content freely...
  * ```
  *
+ * ## Random access
+ *
+ * Implementations may also provide ::mlk_vfs_file::size,
+ * ::mlk_vfs_file::seek and ::mlk_vfs_file::tell to query the file length and
+ * read at arbitrary offsets. When available, ::mlk_vfs_file_read_all
+ * allocates the exact amount of memory required up front.
+ *
+ * ## Threads
+ *
+ * Implementations setting ::MLK_VFS_THREAD_SAFE in ::mlk_vfs::flags can open
+ * and read files from several threads at once, this is required by modules
+ * reading files in background threads while the VFS is still used elsewhere.
+ * The other implementations must only be used from one thread at a time.
+ *
  * ## Cleaning up resources
  *
  * Opened files SHOULD be destroyed before the VFS itself because depending on
@@ -103,14 +119,61 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 
 struct mlk_vfs_file;
 
+/**
+ * \enum mlk_vfs_whence
+ * \brief Reference position for ::mlk_vfs_file::seek.
+ */
+enum mlk_vfs_whence {
+	/**
+	 * Offset is relative to the beginning of the file.
+	 */
+	MLK_VFS_SEEK_SET,
+
+	/**
+	 * Offset is relative to the current position.
+	 */
+	MLK_VFS_SEEK_CUR,
+
+	/**
+	 * Offset is relative to the end of the file.
+	 */
+	MLK_VFS_SEEK_END
+};
+
+/**
+ * \enum mlk_vfs_flags
+ * \brief VFS capabilities.
+ *
+ * This enumeration is implemented as a bitmask.
+ */
+enum mlk_vfs_flags {
+	/**
+	 * No flags.
+	 */
+	MLK_VFS_NONE            = 0,
+
+	/**
+	 * Files can be opened and read from several threads at once.
+	 */
+	MLK_VFS_THREAD_SAFE     = (1 << 0)
+};
+
 /**
  * \struct mlk_vfs
  * \brief Abstract VFS loader.
  */
 struct mlk_vfs {
+	/**
+	 * (read-write)
+	 *
+	 * Capabilities of the implementation, see ::mlk_vfs_flags.
+	 */
+	unsigned int flags;
+
 	/**
 	 * (read-write)
 	 *
@@ -200,6 +263,50 @@ struct mlk_vfs_file {
 	 */
 	int (*flush)(struct mlk_vfs_file *self);
 
+	/**
+	 * (read-write, optional)
+	 *
+	 * Return the total file length in bytes.
+	 *
+	 * If the function is NULL, an error is returned with an error string
+	 * telling that the operation is not supported.
+	 *
+	 * \pre self != NULL
+	 * \param self this VFS file
+	 * \return the file length or -1 on error
+	 */
+	size_t (*size)(struct mlk_vfs_file *self);
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Move the current file position.
+	 *
+	 * If the function is NULL, an error is returned with an error string
+	 * telling that the operation is not supported.
+	 *
+	 * \pre self != NULL
+	 * \param self this VFS file
+	 * \param offset the offset relative to whence
+	 * \param whence the reference position
+	 * \return 0 on success or -1 on error
+	 */
+	int (*seek)(struct mlk_vfs_file *self, int64_t offset, enum mlk_vfs_whence whence);
+
+	/**
+	 * (read-write, optional)
+	 *
+	 * Return the current file position.
+	 *
+	 * If the function is NULL, an error is returned with an error string
+	 * telling that the operation is not supported.
+	 *
+	 * \pre self != NULL
+	 * \param self this VFS file
+	 * \return the current position or -1 on error
+	 */
+	size_t (*tell)(struct mlk_vfs_file *self);
+
 	/**
 	 * (read-write, optional)
 	 *
@@ -237,6 +344,9 @@ mlk_vfs_file_read(struct mlk_vfs_file *file, void *buf, size_t bufsz);
  * Convenient function to read an entire file content using repeated calls to
  * ::mlk_vfs_file_read function until end of file is reached.
  *
+ * If the file implements ::mlk_vfs_file::size, the buffer is allocated once
+ * with the remaining length of the file.
+ *
  * The returned string is dynamically allocated and must be free'd using
  * ::mlk_alloc_free function.
  *
@@ -249,7 +359,7 @@ char *
 mlk_vfs_file_read_all(struct mlk_vfs_file *file, size_t *len);
 
 /**
- * Invoke ::mlk_vfs_file::finish if not NULL.
+ * Invoke ::mlk_vfs_file::write if not NULL.
  */
 size_t
 mlk_vfs_file_write(struct mlk_vfs_file *file, void *buf, size_t bufsz);
@@ -260,6 +370,24 @@ mlk_vfs_file_write(struct mlk_vfs_file *file, void *buf, size_t bufsz);
 int
 mlk_vfs_file_flush(struct mlk_vfs_file *file);
 
+/**
+ * Invoke ::mlk_vfs_file::size if not NULL.
+ */
+size_t
+mlk_vfs_file_size(struct mlk_vfs_file *file);
+
+/**
+ * Invoke ::mlk_vfs_file::seek if not NULL.
+ */
+int
+mlk_vfs_file_seek(struct mlk_vfs_file *file, int64_t offset, enum mlk_vfs_whence whence);
+
+/**
+ * Invoke ::mlk_vfs_file::tell if not NULL.
+ */
+size_t
+mlk_vfs_file_tell(struct mlk_vfs_file *file);
+
 /**
  * Invoke ::mlk_vfs_file::finish if not NULL.
  */
@@ -46,7 +46,6 @@ mlk_example_init(const char *name)
 		return err;
 
 	mlk_ui_set_theme(mlk_window.theme_effective);
-	mlk_registry_init();
 
 	return 0;
 }
@@ -54,6 +53,8 @@ mlk_example_init(const char *name)
 void
 mlk_example_finish(void)
 {
+	mlk_registry_report();
+	mlk_registry_finish();
 	mlk_window_finish();
 	mlk_rpg_finish();
 	mlk_ui_finish();
@@ -16,12 +16,19 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <assert.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
 
 #include <mlk/core/err.h>
+#include <mlk/core/image-async.h>
 #include <mlk/core/image.h>
 #include <mlk/core/panic.h>
 #include <mlk/core/sys.h>
+#include <mlk/core/trace.h>
 #include <mlk/core/util.h>
 
 #include <assets/images/battle-background.h>
@@ -48,152 +55,336 @@
 
 #include "registry.h"
 
-struct mlk_texture mlk_registry_images[MLK_REGISTRY_IMAGE_LAST] = {0};
-struct mlk_texture mlk_registry_textures[MLK_REGISTRY_TEXTURE_LAST] = {0};
-struct mlk_sprite mlk_registry_sprites[MLK_REGISTRY_TEXTURE_LAST] = {0};
-struct mlk_sound mlk_registry_sounds[MLK_REGISTRY_SOUND_LAST] = {0};
-struct mlk_music mlk_registry_music[MLK_REGISTRY_MUSIC_LAST] = {0};
-
-#define MLK_REGISTRY_IMAGE(i, data)                     \
-	{ (i), (data), sizeof (data) }
-#define MLK_REGISTRY_TEXTURE(s, data, cw, ch)           \
-	{ (s), (data), sizeof (data), (cw), (ch) }
-#define MLK_REGISTRY_SOUND(s, data)                     \
-	{ (s), (data), sizeof (data) }
-#define MLK_REGISTRY_MUSIC(m, data)                     \
-	{ (m), (data), sizeof (data) }
-
-static const struct {
-	enum mlk_registry_image index;
-	const unsigned char *data;
-	size_t datasz;
-} images[] = {
-	MLK_REGISTRY_IMAGE(MLK_REGISTRY_IMAGE_BATTLE_BACKGROUND, assets_images_battle_background)
-};
-
-static const struct {
-	enum mlk_registry_texture index;
+/*
+ * Assets are decoded on first access so that the startup cost only depends
+ * on what the first screen needs, mlk_registry_warmup loads everything else
+ * at once.
+ */
+struct asset {
+	const char *name;
 	const unsigned char *data;
 	size_t datasz;
 	unsigned int cellw;
 	unsigned int cellh;
-} textures[] = {
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_BLACK_CAT, assets_images_black_cat, 0, 0),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_CAT_RUNNING, assets_sprites_cat_running, 512, 256),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_CHEST, assets_sprites_chest, 32, 32),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_CURSOR, assets_sprites_ui_cursor, 24, 24),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_EXPLOSION, assets_sprites_explosion, 256, 256),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_HAUNTED_WOOD, assets_images_haunted_wood, 0, 0),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_JOHN, assets_sprites_john, 48, 48),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_JOHN_SWORD, assets_sprites_john_sword, 256, 256),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_JOHN_WALK, assets_sprites_john_walk, 256, 256),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_NUMBERS, assets_sprites_numbers, 48, 48),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_PEOPLE, assets_sprites_people, 48, 48),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_SWORD, assets_images_sword, 0, 0),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_WATER, assets_sprites_water, 48, 48),
-	MLK_REGISTRY_TEXTURE(MLK_REGISTRY_TEXTURE_WORLD, assets_sprites_world, 48, 48)
+	Uint64 elapsed;
+	int loaded;
+	int parallel;
 };
 
-static const struct {
-	enum mlk_registry_sound index;
-	const unsigned char *data;
-	size_t datasz;
-} sounds[] = {
-	MLK_REGISTRY_SOUND(MLK_REGISTRY_SOUND_FIRE, assets_sounds_fire),
-	MLK_REGISTRY_SOUND(MLK_REGISTRY_SOUND_OPEN_CHEST, assets_sounds_open_chest)
+#define ASSET(n, d)                                     \
+	{ .name = (n), .data = (d), .datasz = sizeof (d) }
+#define SPRITE(n, d, cw, ch)                            \
+	{ .name = (n), .data = (d), .datasz = sizeof (d), .cellw = (cw), .cellh = (ch) }
+
+static struct asset images[MLK_REGISTRY_IMAGE_LAST] = {
+	[MLK_REGISTRY_IMAGE_BATTLE_BACKGROUND]  = ASSET("images/battle-background.png", assets_images_battle_background)
 };
 
-static const struct {
-	enum mlk_registry_music index;
-	const unsigned char *data;
-	size_t datasz;
-} musics[] = {
-	MLK_REGISTRY_MUSIC(MLK_REGISTRY_MUSIC_ROMANCE, assets_music_vabsounds_romance)
+static struct asset textures[MLK_REGISTRY_TEXTURE_LAST] = {
+	[MLK_REGISTRY_TEXTURE_BLACK_CAT]        = SPRITE("images/black-cat.png", assets_images_black_cat, 0, 0),
+	[MLK_REGISTRY_TEXTURE_CAT_RUNNING]      = SPRITE("sprites/cat-running.png", assets_sprites_cat_running, 512, 256),
+	[MLK_REGISTRY_TEXTURE_CHEST]            = SPRITE("sprites/chest.png", assets_sprites_chest, 32, 32),
+	[MLK_REGISTRY_TEXTURE_CURSOR]           = SPRITE("sprites/ui-cursor.png", assets_sprites_ui_cursor, 24, 24),
+	[MLK_REGISTRY_TEXTURE_EXPLOSION]        = SPRITE("sprites/explosion.png", assets_sprites_explosion, 256, 256),
+	[MLK_REGISTRY_TEXTURE_HAUNTED_WOOD]     = SPRITE("images/haunted-wood.png", assets_images_haunted_wood, 0, 0),
+	[MLK_REGISTRY_TEXTURE_JOHN]             = SPRITE("sprites/john.png", assets_sprites_john, 48, 48),
+	[MLK_REGISTRY_TEXTURE_JOHN_SWORD]       = SPRITE("sprites/john-sword.png", assets_sprites_john_sword, 256, 256),
+	[MLK_REGISTRY_TEXTURE_JOHN_WALK]        = SPRITE("sprites/john-walk.png", assets_sprites_john_walk, 256, 256),
+	[MLK_REGISTRY_TEXTURE_NUMBERS]          = SPRITE("sprites/numbers.png", assets_sprites_numbers, 48, 48),
+	[MLK_REGISTRY_TEXTURE_PEOPLE]           = SPRITE("sprites/people.png", assets_sprites_people, 48, 48),
+	[MLK_REGISTRY_TEXTURE_SWORD]            = SPRITE("images/sword.png", assets_images_sword, 0, 0),
+	[MLK_REGISTRY_TEXTURE_WATER]            = SPRITE("sprites/water.png", assets_sprites_water, 48, 48),
+	[MLK_REGISTRY_TEXTURE_WORLD]            = SPRITE("sprites/world.png", assets_sprites_world, 48, 48)
 };
 
+static struct asset sounds[MLK_REGISTRY_SOUND_LAST] = {
+	[MLK_REGISTRY_SOUND_FIRE]               = ASSET("sounds/fire.wav", assets_sounds_fire),
+	[MLK_REGISTRY_SOUND_OPEN_CHEST]         = ASSET("sounds/open-chest.wav", assets_sounds_open_chest)
+};
+
+static struct asset musics[MLK_REGISTRY_MUSIC_LAST] = {
+	[MLK_REGISTRY_MUSIC_ROMANCE]            = ASSET("music/vabsounds-romance.ogg", assets_music_vabsounds_romance)
+};
+
+static struct {
+	struct mlk_texture images[MLK_REGISTRY_IMAGE_LAST];
+	struct mlk_texture textures[MLK_REGISTRY_TEXTURE_LAST];
+	struct mlk_sprite sprites[MLK_REGISTRY_TEXTURE_LAST];
+	struct mlk_sound sounds[MLK_REGISTRY_SOUND_LAST];
+	struct mlk_music musics[MLK_REGISTRY_MUSIC_LAST];
+} registry;
+
+/*
+ * Images decoded in parallel overlap each other, they are timed from the
+ * start of the warm-up and only its whole duration is meaningful.
+ */
+static Uint64 warmup_start;
+static Uint64 warmup_elapsed;
+static size_t warmup_done;
+
 static void
-load_images(void)
+loaded(struct asset *asset, Uint64 start)
 {
-	struct mlk_texture *texture;
+	asset->elapsed = SDL_GetTicksNS() - start;
+	asset->loaded = 1;
 
-	for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i) {
-		texture = &mlk_registry_images[images[i].index];
+	mlk_tracef("registry: %s loaded in %.2f ms", asset->name, asset->elapsed / 1e6);
+}
 
-		if (mlk_image_openmem(texture, images[i].data, images[i].datasz) < 0)
-			mlk_panicf("unable to open image: %s", mlk_err());
+static void
+init_sprite(enum mlk_registry_texture index)
+{
+	struct mlk_texture *texture = &registry.textures[index];
+	struct mlk_sprite *sprite = &registry.sprites[index];
+
+	if (textures[index].cellw == 0 || textures[index].cellh == 0) {
+		sprite->cellw = texture->w;
+		sprite->cellh = texture->h;
+	} else {
+		sprite->cellw = textures[index].cellw;
+		sprite->cellh = textures[index].cellh;
 	}
+
+	sprite->texture = texture;
+	mlk_sprite_init(sprite);
 }
 
 static void
-load_textures_and_sprites(void)
+open_texture(struct mlk_texture *texture, struct asset *asset)
 {
-	struct mlk_texture *texture;
-	struct mlk_sprite *sprite;
+	Uint64 start = SDL_GetTicksNS();
 
-	for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i) {
-		texture = &mlk_registry_textures[textures[i].index];
-		sprite = &mlk_registry_sprites[textures[i].index];
-
-		if (mlk_image_openmem(texture, textures[i].data, textures[i].datasz) < 0)
-			mlk_panicf("unable to open image: %s", mlk_err());
-
-		if (textures[i].cellw == 0 || textures[i].cellh == 0) {
-			sprite->cellw = texture->w;
-			sprite->cellh = texture->h;
-		} else {
-			sprite->cellw = textures[i].cellw;
-			sprite->cellh = textures[i].cellh;
-		}
+	if (mlk_image_openmem(texture, asset->data, asset->datasz) < 0)
+		mlk_panicf("unable to open image %s: %s", asset->name, mlk_err());
 
-		sprite->texture = texture;
-		mlk_sprite_init(sprite);
-	}
+	loaded(asset, start);
 }
 
 static void
-load_sounds(void)
+warmed(struct mlk_image_async_request *req)
+{
+	struct asset *asset = req->data;
+
+	if (req->status == MLK_IMAGE_ASYNC_STATUS_FAILED)
+		mlk_panicf("unable to open image %s: %s", asset->name, req->error);
+
+	loaded(asset, warmup_start);
+	asset->parallel = 1;
+	warmup_done++;
+
+	if (asset >= textures && asset < textures + MLK_UTIL_SIZE(textures))
+		init_sprite(asset - textures);
+}
+
+static int
+cmp_elapsed(const void *d1, const void *d2)
+{
+	const struct asset *a1 = *(const struct asset **)d1;
+	const struct asset *a2 = *(const struct asset **)d2;
+
+	if (a1->elapsed != a2->elapsed)
+		return a1->elapsed < a2->elapsed ? 1 : -1;
+
+	return 0;
+}
+
+struct mlk_texture *
+mlk_registry_image(enum mlk_registry_image index)
+{
+	assert(index < MLK_REGISTRY_IMAGE_LAST);
+
+	if (!images[index].loaded)
+		open_texture(&registry.images[index], &images[index]);
+
+	return &registry.images[index];
+}
+
+struct mlk_texture *
+mlk_registry_texture(enum mlk_registry_texture index)
 {
-	struct mlk_sound *sound;
+	assert(index < MLK_REGISTRY_TEXTURE_LAST);
 
-	for (size_t i = 0; i < MLK_UTIL_SIZE(sounds); ++i) {
-		sound = &mlk_registry_sounds[sounds[i].index];
+	if (!textures[index].loaded) {
+		open_texture(&registry.textures[index], &textures[index]);
+		init_sprite(index);
+	}
+
+	return &registry.textures[index];
+}
+
+struct mlk_sprite *
+mlk_registry_sprite(enum mlk_registry_texture index)
+{
+	mlk_registry_texture(index);
+
+	return &registry.sprites[index];
+}
+
+struct mlk_sound *
+mlk_registry_sound(enum mlk_registry_sound index)
+{
+	assert(index < MLK_REGISTRY_SOUND_LAST);
+
+	struct asset *asset = &sounds[index];
+	Uint64 start;
+
+	if (!asset->loaded) {
+		start = SDL_GetTicksNS();
+
+		if (mlk_sound_openmem(&registry.sounds[index], asset->data, asset->datasz) < 0)
+			mlk_panicf("unable to open sound %s: %s", asset->name, mlk_err());
 
-		if (mlk_sound_openmem(sound, sounds[i].data, sounds[i].datasz) < 0)
-			mlk_panicf("unable to open sound: %s", mlk_err());
+		loaded(asset, start);
 	}
+
+	return &registry.sounds[index];
 }
 
-static void
-load_music(void)
+struct mlk_music *
+mlk_registry_music(enum mlk_registry_music index)
 {
-	struct mlk_music *music;
+	assert(index < MLK_REGISTRY_MUSIC_LAST);
+
+	struct asset *asset = &musics[index];
+	Uint64 start;
 
-	for (size_t i = 0; i < MLK_UTIL_SIZE(musics); ++i) {
-		music = &mlk_registry_music[musics[i].index];
+	if (!asset->loaded) {
+		start = SDL_GetTicksNS();
 
-		if (mlk_music_openmem(music, musics[i].data, musics[i].datasz) < 0)
-			mlk_panicf("unable to open music: %s", mlk_err());
+		if (mlk_music_openmem(&registry.musics[index], asset->data, asset->datasz) < 0)
+			mlk_panicf("unable to open music %s: %s", asset->name, mlk_err());
+
+		loaded(asset, start);
 	}
+
+	return &registry.musics[index];
 }
 
 void
-mlk_registry_init(void)
+mlk_registry_warmup(void)
 {
-	load_images();
-	load_textures_and_sprites();
-	load_sounds();
-	load_music();
+	struct mlk_image_async_request reqs[MLK_REGISTRY_IMAGE_LAST + MLK_REGISTRY_TEXTURE_LAST] = {0};
+	size_t reqsz = 0;
+	int started = 0;
+
+	warmup_start = SDL_GetTicksNS();
+	warmup_done = 0;
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i) {
+		if (!images[i].loaded) {
+			reqs[reqsz].texture = &registry.images[i];
+			reqs[reqsz].buffer = images[i].data;
+			reqs[reqsz].buffersz = images[i].datasz;
+			reqs[reqsz].data = &images[i];
+			reqs[reqsz++].done = warmed;
+		}
+	}
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i) {
+		if (!textures[i].loaded) {
+			reqs[reqsz].texture = &registry.textures[i];
+			reqs[reqsz].buffer = textures[i].data;
+			reqs[reqsz].buffersz = textures[i].datasz;
+			reqs[reqsz].data = &textures[i];
+			reqs[reqsz++].done = warmed;
+		}
+	}
+
+	/*
+	 * Images are decoded on every core, nothing else happens meanwhile so
+	 * all of them can be uploaded as soon as they are ready. If the module
+	 * is already used by the game, share it and leave it running. Without
+	 * threads, just load them one by one.
+	 */
+	if (reqsz && (mlk_image_async_workers() || (started = mlk_image_async_init(0, reqsz) == 0))) {
+		mlk_image_async_submit_all(reqs, reqsz);
+
+		/* Only wait for our requests, others may be pending. */
+		while (warmup_done < reqsz)
+			if (mlk_image_async_dispatch() == 0)
+				SDL_Delay(1);
+
+		if (started)
+			mlk_image_async_finish();
+	} else {
+		for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i)
+			mlk_registry_image(i);
+		for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i)
+			mlk_registry_texture(i);
+	}
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(sounds); ++i)
+		mlk_registry_sound(i);
+	for (size_t i = 0; i < MLK_UTIL_SIZE(musics); ++i)
+		mlk_registry_music(i);
+
+	warmup_elapsed = SDL_GetTicksNS() - warmup_start;
+	mlk_tracef("registry: warm-up done in %.2f ms", warmup_elapsed / 1e6);
+}
+
+void
+mlk_registry_report(void)
+{
+	struct asset *list[MLK_REGISTRY_IMAGE_LAST + MLK_REGISTRY_TEXTURE_LAST +
+	                   MLK_REGISTRY_SOUND_LAST + MLK_REGISTRY_MUSIC_LAST];
+	size_t listsz = 0;
+	Uint64 total = 0;
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i)
+		list[listsz++] = &images[i];
+	for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i)
+		list[listsz++] = &textures[i];
+	for (size_t i = 0; i < MLK_UTIL_SIZE(sounds); ++i)
+		list[listsz++] = &sounds[i];
+	for (size_t i = 0; i < MLK_UTIL_SIZE(musics); ++i)
+		list[listsz++] = &musics[i];
+
+	/* Slowest first. */
+	qsort(list, listsz, sizeof (*list), cmp_elapsed);
+
+	/* Parallel entries overlap, they are covered by the warm-up time. */
+	for (size_t i = 0; i < listsz; ++i) {
+		if (!list[i]->loaded)
+			mlk_tracef("registry: %-32s   unused", list[i]->name);
+		else if (list[i]->parallel)
+			mlk_tracef("registry: %-32s %8.2f ms (ready, warm-up)", list[i]->name, list[i]->elapsed / 1e6);
+		else {
+			mlk_tracef("registry: %-32s %8.2f ms", list[i]->name, list[i]->elapsed / 1e6);
+			total += list[i]->elapsed;
+		}
+	}
+
+	if (warmup_elapsed)
+		mlk_tracef("registry: %-32s %8.2f ms", "warm-up", warmup_elapsed / 1e6);
+
+	mlk_tracef("registry: %-32s %8.2f ms", "total (sequential)", total / 1e6);
 }
 
 void
 mlk_registry_finish(void)
 {
-	for (size_t i = 0; i < MLK_UTIL_SIZE(mlk_registry_images); ++i)
-		mlk_texture_finish(&mlk_registry_images[i]);
-	for (size_t i = 0; i < MLK_UTIL_SIZE(mlk_registry_textures); ++i)
-		mlk_texture_finish(&mlk_registry_textures[i]);
-	for (size_t i = 0; i < MLK_UTIL_SIZE(mlk_registry_sounds); ++i)
-		mlk_sound_finish(&mlk_registry_sounds[i]);
-	for (size_t i = 0; i < MLK_UTIL_SIZE(mlk_registry_music); ++i)
-		mlk_music_finish(&mlk_registry_music[i]);
+	for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i)
+		if (images[i].loaded)
+			mlk_texture_finish(&registry.images[i]);
+	for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i)
+		if (textures[i].loaded)
+			mlk_texture_finish(&registry.textures[i]);
+	for (size_t i = 0; i < MLK_UTIL_SIZE(sounds); ++i)
+		if (sounds[i].loaded)
+			mlk_sound_finish(&registry.sounds[i]);
+	for (size_t i = 0; i < MLK_UTIL_SIZE(musics); ++i)
+		if (musics[i].loaded)
+			mlk_music_finish(&registry.musics[i]);
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(images); ++i)
+		images[i].loaded = images[i].parallel = 0;
+	for (size_t i = 0; i < MLK_UTIL_SIZE(textures); ++i)
+		textures[i].loaded = textures[i].parallel = 0;
+	for (size_t i = 0; i < MLK_UTIL_SIZE(sounds); ++i)
+		sounds[i].loaded = 0;
+	for (size_t i = 0; i < MLK_UTIL_SIZE(musics); ++i)
+		musics[i].loaded = 0;
+
+	memset(&registry, 0, sizeof (registry));
+	warmup_elapsed = 0;
 }
@@ -73,14 +73,40 @@ enum mlk_registry_music {
 	MLK_REGISTRY_MUSIC_LAST
 };
 
-extern struct mlk_texture mlk_registry_images[MLK_REGISTRY_IMAGE_LAST];
-extern struct mlk_texture mlk_registry_textures[MLK_REGISTRY_TEXTURE_LAST];
-extern struct mlk_sprite mlk_registry_sprites[MLK_REGISTRY_TEXTURE_LAST];
-extern struct mlk_sound mlk_registry_sounds[MLK_REGISTRY_SOUND_LAST];
-extern struct mlk_music mlk_registry_music[MLK_REGISTRY_MUSIC_LAST];
+/*
+ * Assets are loaded on first access and remain loaded until
+ * mlk_registry_finish, the program panics if one can't be opened.
+ */
+
+struct mlk_texture *
+mlk_registry_image(enum mlk_registry_image index);
+
+struct mlk_texture *
+mlk_registry_texture(enum mlk_registry_texture index);
+
+struct mlk_sprite *
+mlk_registry_sprite(enum mlk_registry_texture index);
+
+struct mlk_sound *
+mlk_registry_sound(enum mlk_registry_sound index);
+
+struct mlk_music *
+mlk_registry_music(enum mlk_registry_music index);
 
+/*
+ * Load every asset not yet loaded at once, images are decoded in parallel
+ * using mlk/core/image-async.h.
+ */
+void
+mlk_registry_warmup(void);
+
+/*
+ * Trace the time spent loading each asset, slowest first. Images decoded in
+ * parallel by mlk_registry_warmup are left out of the total, the warm-up
+ * duration is reported instead.
+ */
 void
-mlk_registry_init(void);
+mlk_registry_report(void);
 
 void
 mlk_registry_finish(void);
@@ -107,7 +107,7 @@ fire_action(struct battle *bt, struct character *owner, const struct selection *
 	self = mlk_alloc_new0(1, sizeof (*self));
 	self->selection = slt->index_character;
 	self->battle = bt;
-	self->animation.sprite = &mlk_registry_sprites[MLK_REGISTRY_TEXTURE_EXPLOSION],
+	self->animation.sprite = mlk_registry_sprite(MLK_REGISTRY_TEXTURE_EXPLOSION),
 	self->animation.delay = 12;
 	self->drawable.data = self;
 	self->drawable.update = update;
@@ -116,7 +116,7 @@ fire_action(struct battle *bt, struct character *owner, const struct selection *
 	self->drawable.end = end;
 
 	mlk_animation_start(&self->animation);
-	mlk_sound_play(&mlk_registry_sounds[MLK_REGISTRY_SOUND_FIRE]);
+	mlk_sound_play(mlk_registry_sound(MLK_REGISTRY_SOUND_FIRE));
 
 	battle_state_rendering(bt, &self->drawable);
 }
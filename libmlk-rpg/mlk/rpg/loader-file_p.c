@@ -17,7 +17,9 @@
  */
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <utlist.h>
 
@@ -25,15 +27,37 @@
 
 #include <mlk/core/alloc.h>
 #include <mlk/core/animation.h>
+#include <mlk/core/cache_p.h>
+#include <mlk/core/err.h>
 #include <mlk/core/image.h>
 #include <mlk/core/sprite.h>
 #include <mlk/core/texture.h>
+#include <mlk/core/util.h>
+#include <mlk/core/vfs.h>
 
 #include "loader-file_p.h"
 
-struct texture_node {
+/*
+ * Textures are shared by every loader through a cache keyed by VFS and
+ * resolved path so that maps and tilesets referencing the same image only
+ * decode and upload it once. Entries are reference counted, one reference per
+ * successful mlk__loader_file_texture_open call, and destroyed when the last
+ * loader holding them is cleared.
+ *
+ * Like textures themselves, the cache must only be used from the main thread.
+ */
+struct texture_entry {
+	struct mlk__cache_entry entry;
 	struct mlk_texture texture;
-	struct texture_node *next;
+	struct mlk_vfs *vfs;
+	char path[];
+};
+
+static void
+cache_evict(struct mlk__cache_entry *);
+
+static struct mlk__cache cache = {
+	.evict = cache_evict
 };
 
 struct sprite_node {
@@ -48,22 +72,116 @@ struct animation_node {
 
 struct mlk__loader_file {
 	char directory[MLK_PATH_MAX];
-	struct texture_node *textures;
+	struct mlk_vfs *vfs;
+	struct texture_entry **textures;
+	size_t texturesz;
+	size_t texturecap;
 	struct sprite_node *sprites;
 	struct animation_node *animations;
 };
 
-static inline void
-free_textures(struct mlk__loader_file *loader)
+static inline uint64_t
+cache_hash(const struct mlk_vfs *vfs, const char *path)
 {
-	struct texture_node *node, *tmp;
+	return mlk_util_hash(path, strlen(path)) ^ (uint64_t)(uintptr_t)vfs;
+}
 
-	LL_FOREACH_SAFE(loader->textures, node, tmp) {
-		mlk_texture_finish(&node->texture);
-		mlk_alloc_free(node);
+static struct texture_entry *
+cache_find(const struct mlk_vfs *vfs, const char *path, uint64_t hash)
+{
+	struct mlk__cache_entry *iter;
+	struct texture_entry *entry;
+
+	for (iter = mlk__cache_bucket(&cache, hash); iter; iter = iter->chain) {
+		entry = MLK_UTIL_CONTAINER_OF(iter, struct texture_entry, entry);
+
+		if (iter->hash == hash && entry->vfs == vfs && strcmp(entry->path, path) == 0)
+			return entry;
 	}
 
+	return NULL;
+}
+
+static void
+cache_evict(struct mlk__cache_entry *iter)
+{
+	struct texture_entry *entry = MLK_UTIL_CONTAINER_OF(iter, struct texture_entry, entry);
+
+	mlk_texture_finish(&entry->texture);
+	mlk_alloc_free(entry);
+}
+
+static int
+normalize(char *path, size_t pathsz)
+{
+	char out[MLK_PATH_MAX], *cut;
+	const char *src = path;
+	size_t outlen = 0, depth = 0, n;
+	int absolute = path[0] == '/';
+
+	/*
+	 * Remove "." and resolve ".." components lexically so that an image
+	 * referenced as "../images/world.png" from different directories ends
+	 * up with the same key. Components are never dropped as two long
+	 * paths could then share the same key.
+	 */
+	if (absolute)
+		out[outlen++] = '/';
+
+	while (*src) {
+		while (*src == '/')
+			src++;
+		if (!*src)
+			break;
+
+		n = strcspn(src, "/");
+
+		if (n == 1 && src[0] == '.')
+			;
+		else if (n == 2 && src[0] == '.' && src[1] == '.' && depth) {
+			out[outlen] = '\0';
+			cut = strrchr(out, '/');
+			outlen = cut ? (size_t)(cut - out) : 0;
+
+			if (absolute && outlen == 0)
+				outlen = 1;
+
+			depth--;
+		} else {
+			if (outlen + n + 2 >= sizeof (out))
+				return -1;
+			if (outlen && out[outlen - 1] != '/')
+				out[outlen++] = '/';
+
+			memcpy(out + outlen, src, n);
+			outlen += n;
+
+			if (n != 2 || src[0] != '.' || src[1] != '.')
+				depth++;
+		}
+
+		src += n;
+	}
+
+	if (!outlen)
+		out[outlen++] = '.';
+
+	out[outlen] = '\0';
+	mlk_util_strlcpy(path, out, pathsz);
+
+	return 0;
+}
+
+static inline void
+free_textures(struct mlk__loader_file *loader)
+{
+	/* Textures are destroyed as soon as no loader uses them anymore. */
+	for (size_t i = 0; i < loader->texturesz; ++i)
+		mlk__cache_unref(&cache, &loader->textures[i]->entry, 0);
+
+	mlk_alloc_free(loader->textures);
 	loader->textures = NULL;
+	loader->texturesz = loader->texturecap = 0;
 }
 
 static inline void
@@ -88,8 +206,23 @@ free_animations(struct mlk__loader_file *loader)
 	loader->animations = NULL;
 }
 
+static int
+texture_openvfs(struct mlk__loader_file *loader, struct mlk_texture *texture, const char *path)
+{
+	struct mlk_vfs_file *file;
+	int rv;
+
+	if (!(file = mlk_vfs_open(loader->vfs, path, "r")))
+		return -1;
+
+	rv = mlk_image_openvfs(texture, file);
+	mlk_vfs_file_finish(file);
+
+	return rv;
+}
+
 struct mlk__loader_file *
-mlk__loader_file_new(const char *file)
+mlk__loader_file_new(struct mlk_vfs *vfs, const char *file)
 {
 	assert(file);
 
@@ -101,37 +234,93 @@ mlk__loader_file_new(const char *file)
 
 	mlk_util_strlcpy(filepath, file, sizeof (filepath));
 	mlk_util_strlcpy(loader->directory, mlk_util_dirname(filepath), sizeof (loader->directory));
+	loader->vfs = vfs;
 
 	return loader;
 }
 
-const char *
-mlk__loader_file_directory(const struct mlk__loader_file *loader)
+struct mlk_vfs *
+mlk__loader_file_vfs(const struct mlk__loader_file *loader)
 {
 	assert(loader);
 
-	return loader->directory;
+	return loader->vfs;
+}
+
+void
+mlk__loader_file_path(const struct mlk__loader_file *loader,
+                      const char *ident,
+                      char *path,
+                      size_t pathsz)
+{
+	assert(loader);
+	assert(ident);
+	assert(path);
+
+	/*
+	 * VFS entries are usually not prefixed by "./" (e.g. in zip archives)
+	 * so don't add the directory when the file is at the root.
+	 */
+	if (loader->vfs && (strcmp(loader->directory, ".") == 0 || !loader->directory[0]))
+		mlk_util_strlcpy(path, ident, pathsz);
+	else
+		snprintf(path, pathsz, "%s/%s", loader->directory, ident);
 }
 
 struct mlk_texture *
 mlk__loader_file_texture_open(struct mlk__loader_file *loader, const char *ident)
 {
-	struct texture_node *node;
+	struct texture_entry *entry;
 	char path[MLK_PATH_MAX];
+	uint64_t hash;
+	size_t pathsz;
+	int rv;
 
-	if (!(node = mlk_alloc_new0(1, sizeof (*node))))
+	mlk__loader_file_path(loader, ident, path, sizeof (path));
+
+	if (normalize(path, sizeof (path)) < 0) {
+		mlk_errf("%s: path too long", ident);
 		return NULL;
+	}
 
-	snprintf(path, sizeof (path), "%s/%s", loader->directory, ident);
+	hash = cache_hash(loader->vfs, path);
 
-	if (mlk_image_open(&node->texture, path) < 0) {
-		mlk_alloc_free(node);
-		return NULL;
+	if ((entry = cache_find(loader->vfs, path, hash)))
+		mlk__cache_ref(&cache, &entry->entry);
+	else {
+		pathsz = strlen(path) + 1;
+
+		if (!(entry = mlk_alloc_new0(1, sizeof (*entry) + pathsz)))
+			return NULL;
+
+		if (loader->vfs)
+			rv = texture_openvfs(loader, &entry->texture, path);
+		else
+			rv = mlk_image_open(&entry->texture, path);
+
+		if (rv < 0) {
+			mlk_alloc_free(entry);
+			return NULL;
+		}
+
+		memcpy(entry->path, path, pathsz);
+		entry->entry.hash = hash;
+		entry->vfs = loader->vfs;
+		mlk__cache_insert(&cache, &entry->entry);
+	}
+
+	if (loader->texturesz == loader->texturecap) {
+		loader->texturecap = loader->texturecap ? loader->texturecap * 2 : 16;
+
+		if (!loader->textures)
+			loader->textures = mlk_alloc_new(loader->texturecap, sizeof (*loader->textures));
+		else
+			loader->textures = mlk_alloc_resize(loader->textures, loader->texturecap);
 	}
 
-	LL_APPEND(loader->textures, node);
+	loader->textures[loader->texturesz++] = entry;
 
-	return &node->texture;
+	return &entry->texture;
 }
 
 struct mlk_sprite *
@@ -19,17 +19,26 @@
 #ifndef MLK_RPG_LOADER_FILE_P_H
 #define MLK_RPG_LOADER_FILE_P_H
 
+#include <stddef.h>
+
 struct mlk_animation;
 struct mlk_sprite;
 struct mlk_texture;
+struct mlk_vfs;
 
 struct mlk__loader_file;
 
 struct mlk__loader_file *
-mlk__loader_file_new(const char *path);
+mlk__loader_file_new(struct mlk_vfs *vfs, const char *path);
+
+struct mlk_vfs *
+mlk__loader_file_vfs(const struct mlk__loader_file *loader);
 
-const char *
-mlk__loader_file_directory(const struct mlk__loader_file *loader);
+void
+mlk__loader_file_path(const struct mlk__loader_file *loader,
+                      const char *ident,
+                      char *path,
+                      size_t pathsz);
 
 struct mlk_texture *
 mlk__loader_file_texture_open(struct mlk__loader_file *loader, const char *ident);
@@ -78,9 +78,11 @@ new_tileset(struct mlk_map_loader *self, struct mlk_map *map, const char *ident)
 	(void)map;
 
 	struct mlk_map_loader_file *file = THIS(self);
+	struct mlk_vfs *vfs = mlk__loader_file_vfs(file->lf);
 	char path[MLK_PATH_MAX] = {};
+	int rv;
 
-	snprintf(path, sizeof (path), "%s/%s", mlk__loader_file_directory(file->lf), ident);
+	mlk__loader_file_path(file->lf, ident, path, sizeof (path));
 
 	/*
 	 * Cleanup existing resources in case the tileset appears multiple times
@@ -88,7 +90,12 @@ new_tileset(struct mlk_map_loader *self, struct mlk_map *map, const char *ident)
 	 */
 	mlk_tileset_loader_clear(file->tileset_loader, &file->tileset);
 
-	if (mlk_tileset_loader_open(file->tileset_loader, &file->tileset, path) < 0)
+	if (vfs)
+		rv = mlk_tileset_loader_openvfs(file->tileset_loader, &file->tileset, vfs, path);
+	else
+		rv = mlk_tileset_loader_open(file->tileset_loader, &file->tileset, path);
+
+	if (rv < 0)
 		return NULL;
 
 	return &file->tileset;
@@ -119,12 +126,12 @@ expand_blocks(struct mlk_map_loader *self,
 	struct mlk_map_block *ptr;
 
 	if (!file->blocks)
-		ptr = mlk_alloc_new0(1, sizeof (*ptr));
+		ptr = mlk_alloc_new0(blocksz, sizeof (*ptr));
 	else
-		ptr = mlk_alloc_expand(file->blocks, blocksz);
+		ptr = mlk_alloc_resize(file->blocks, blocksz);
 
 	if (ptr)
-		file->blocks = blocks;
+		file->blocks = ptr;
 
 	return ptr;
 }
@@ -150,18 +157,15 @@ finish(struct mlk_map_loader *self)
 	file->lf = NULL;
 }
 
-int
-mlk_map_loader_file_init(struct mlk_map_loader_file *file,
-                         struct mlk_tileset_loader *tileset_loader,
-                         const char *filename)
+static int
+init(struct mlk_map_loader_file *file,
+     struct mlk_tileset_loader *tileset_loader,
+     struct mlk_vfs *vfs,
+     const char *filename)
 {
-	assert(file);
-	assert(tileset_loader);
-	assert(filename);
-
 	memset(file, 0, sizeof (*file));
 
-	if (!(file->lf = mlk__loader_file_new(filename)))
+	if (!(file->lf = mlk__loader_file_new(vfs, filename)))
 		return -1;
 
 	file->tileset_loader = tileset_loader;
@@ -175,3 +179,29 @@ mlk_map_loader_file_init(struct mlk_map_loader_file *file,
 
 	return 0;
 }
+
+int
+mlk_map_loader_file_init(struct mlk_map_loader_file *file,
+                         struct mlk_tileset_loader *tileset_loader,
+                         const char *filename)
+{
+	assert(file);
+	assert(tileset_loader);
+	assert(filename);
+
+	return init(file, tileset_loader, NULL, filename);
+}
+
+int
+mlk_map_loader_file_initvfs(struct mlk_map_loader_file *file,
+                            struct mlk_tileset_loader *tileset_loader,
+                            struct mlk_vfs *vfs,
+                            const char *entry)
+{
+	assert(file);
+	assert(tileset_loader);
+	assert(vfs);
+	assert(entry);
+
+	return init(file, tileset_loader, vfs, entry);
+}
@@ -56,6 +56,10 @@
  * mlk_map_loader_file_finish(&map_loader);
  * mlk_tileset_loader_file_finish(&tileset_loader);
  * ```
+ *
+ * Maps can also be loaded from a VFS using ::mlk_map_loader_file_initvfs and
+ * ::mlk_map_loader_openvfs, in that case the tileset and every texture are
+ * opened from the same VFS relative to the map entry.
  */
 
 #include "map-loader.h"
@@ -63,6 +67,7 @@
 #include "tileset.h"
 
 struct mlk_tileset_loader;
+struct mlk_vfs;
 
 struct mlk_map_loader_file {
 	/**
@@ -103,4 +108,26 @@ mlk_map_loader_file_init(struct mlk_map_loader_file *file,
                          struct mlk_tileset_loader *tileset_loader,
                          const char *filename);
 
+/**
+ * Similar to ::mlk_map_loader_file_init but resources are opened from the
+ * given VFS relative to the map entry.
+ *
+ * The tileset loader should be initialized with
+ * ::mlk_tileset_loader_file_initvfs using the same VFS.
+ *
+ * \pre file != NULL
+ * \pre vfs != NULL
+ * \pre entry != NULL
+ * \param file the file loader
+ * \param tileset_loader tileset loader interface (borrowed)
+ * \param vfs the VFS to open resources from (borrowed)
+ * \param entry the map entry name in the VFS
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_map_loader_file_initvfs(struct mlk_map_loader_file *file,
+                            struct mlk_tileset_loader *tileset_loader,
+                            struct mlk_vfs *vfs,
+                            const char *entry);
+
 #endif /* !MLK_RPG_MAP_LOADER_FILE_H */
@@ -17,50 +17,47 @@
  */
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <mlk/util/mapbin.h>
 #include <mlk/util/util.h>
 
+#include <mlk/core/alloc.h>
 #include <mlk/core/err.h>
 #include <mlk/core/sprite.h>
 #include <mlk/core/trace.h>
 #include <mlk/core/util.h>
+#include <mlk/core/vfs.h>
 
 #include "map-loader.h"
 #include "map.h"
+#include "scan_p.h"
 
 static int
-parse_layer_tiles(struct mlk_map_loader *loader, struct mlk_map *map, const char *layer_name, FILE *fp)
+parse_layer_tiles(struct mlk_map_loader *loader,
+                  struct mlk_map *map,
+                  struct mlk__scan *scan,
+                  enum mlk_map_layer_type type)
 {
-	enum mlk_map_layer_type layer_type;
-	size_t amount, current;
+	const size_t amount = (size_t)map->columns * map->rows;
 	unsigned int *tiles;
 
-	if (strcmp(layer_name, "background") == 0)
-		layer_type = MLK_MAP_LAYER_TYPE_BG;
-	else if (strcmp(layer_name, "foreground") == 0)
-		layer_type = MLK_MAP_LAYER_TYPE_FG;
-	else if (strcmp(layer_name, "above") == 0)
-		layer_type = MLK_MAP_LAYER_TYPE_ABOVE;
-	else
-		return mlk_errf("invalid layer type: %s", layer_name);
-
-	amount = map->columns * map->rows;
-	current = 0;
-
 	/*
-	 * The next line after a layer declaration is a list of plain integer
+	 * The next lines after a layer declaration are a list of plain integer
 	 * that fill the layer tiles.
 	 */
-	if (!(tiles = loader->new_tiles(loader, map, layer_type, amount)))
+	if (!(tiles = loader->new_tiles(loader, map, type, amount)))
 		return -1;
 
-	for (unsigned int tile; fscanf(fp, "%u\n", &tile) && current < amount; ++current)
-		tiles[current] = tile;
+	for (size_t i = 0; i < amount && isdigit(mlk__scan_peek(scan)); ++i)
+		if (mlk__scan_uint(scan, &tiles[i]) < 0 || mlk__scan_eol(scan) < 0)
+			return -1;
 
-	map->layers[layer_type].tiles = tiles;
+	map->layers[type].tiles = tiles;
 
 	return 0;
 }
@@ -68,26 +65,35 @@ parse_layer_tiles(struct mlk_map_loader *loader, struct mlk_map *map, const char
 static int
 parse_objects(struct mlk_map_loader *loader,
               struct mlk_map *map,
-              const char *line,
-              FILE *fp)
+              struct mlk__scan *scan)
 {
-	(void)line;
-
-	char fmt[64] = {0}, exec[256] = {0};
-	int x = 0, y = 0, isblock = 0;
-	unsigned int w = 0, h = 0;
+	char exec[256];
+	int x, y, isblock, ch;
+	unsigned int w, h;
 	struct mlk_map_block *array, *block, *blocks = NULL;
 	size_t blocksz = 0;
 
-	snprintf(fmt, sizeof (fmt), "%%d|%%d|%%u|%%u|%%d|%%%zu[^\n]\n", sizeof (exec) - 1);
+	while (isdigit(ch = mlk__scan_peek(scan)) || ch == '-') {
+		if (mlk__scan_int(scan, &x) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_int(scan, &y) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_uint(scan, &w) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_uint(scan, &h) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_int(scan, &isblock) < 0)
+			return -1;
 
-	while (fscanf(fp, fmt, &x, &y, &w, &h, &isblock, exec) >= 5) {
-		if (!loader->new_object) {
-			mlk_tracef("ignoring object %d,%d,%u,%u,%d,%s", x, y, w, h, isblock, exec);
-			continue;
-		}
+		/* The object argument is optional. */
+		exec[0] = '\0';
+
+		if (mlk__scan_peek(scan) == '|' &&
+		    (mlk__scan_sep(scan) < 0 || mlk__scan_text(scan, exec, sizeof (exec)) < 0))
+			return -1;
+		if (mlk__scan_eol(scan) < 0)
+			return -1;
 
-		loader->new_object(loader, map, x, y, w, h, exec);
+		if (!loader->new_object)
+			mlk_tracef("ignoring object %d,%d,%u,%u,%d,%s", x, y, w, h, isblock, exec);
+		else
+			loader->new_object(loader, map, x, y, w, h, exec);
 
 		/*
 		 * Actions do not have concept of collisions because they are
@@ -119,39 +125,46 @@ parse_objects(struct mlk_map_loader *loader,
 static int
 parse_layer(struct mlk_map_loader *loader,
             struct mlk_map *map,
-            const char *line,
-            FILE *fp)
+            struct mlk__scan *scan)
 {
-	char fmt[32] = {0}, layer_name[32] = {0};
+	struct mlk__scan at;
+	char name[32];
 
 	/* Check if weight/height has been specified. */
 	if (map->columns == 0 || map->rows == 0)
-		return mlk_errf("missing map dimensions before layer");
+		return mlk__scan_errf(scan, "missing map dimensions before layer");
+	if (mlk__scan_sep(scan) < 0)
+		return -1;
 
-	/* Determine layer type. */
-	snprintf(fmt, sizeof (fmt), "layer|%%%zus", sizeof (layer_name) - 1);
+	at = *scan;
+
+	if (mlk__scan_word(scan, name, sizeof (name)) < 0 || mlk__scan_eol(scan) < 0)
+		return -1;
 
-	if (sscanf(line, fmt, layer_name) <= 0)
-		return mlk_errf("missing layer type definition");
-	if (strcmp(layer_name, "actions") == 0)
-		return parse_objects(loader, map, line, fp);
+	if (strcmp(name, "actions") == 0)
+		return parse_objects(loader, map, scan);
+	if (strcmp(name, "background") == 0)
+		return parse_layer_tiles(loader, map, scan, MLK_MAP_LAYER_TYPE_BG);
+	if (strcmp(name, "foreground") == 0)
+		return parse_layer_tiles(loader, map, scan, MLK_MAP_LAYER_TYPE_FG);
+	if (strcmp(name, "above") == 0)
+		return parse_layer_tiles(loader, map, scan, MLK_MAP_LAYER_TYPE_ABOVE);
 
-	return parse_layer_tiles(loader, map, layer_name, fp);
+	return mlk__scan_errf(&at, "invalid layer type: %s", name);
 }
 
 static int
 parse_tileset(struct mlk_map_loader *loader,
               struct mlk_map *map,
-              const char *line,
-              FILE *fp)
+              struct mlk__scan *scan)
 {
-	(void)fp;
+	char ident[FILENAME_MAX + 1];
 
-	const char *p;
-
-	if (!(p = strchr(line, '|')))
-		return mlk_errf("could not parse tileset");
-	if (!(map->tileset = loader->new_tileset(loader, map, p + 1)))
+	if (mlk__scan_sep(scan) < 0 ||
+	    mlk__scan_text(scan, ident, sizeof (ident)) < 0 ||
+	    mlk__scan_eol(scan) < 0)
+		return -1;
+	if (!(map->tileset = loader->new_tileset(loader, map, ident)))
 		return -1;
 
 	return 0;
@@ -160,65 +173,57 @@ parse_tileset(struct mlk_map_loader *loader,
 static int
 parse_columns(struct mlk_map_loader *loader,
               struct mlk_map *map,
-              const char *line,
-              FILE *fp)
+              struct mlk__scan *scan)
 {
 	(void)loader;
-	(void)fp;
 
-	if (sscanf(line, "columns|%u", &map->columns) != 1 || map->columns == 0)
-		return mlk_errf("null map columns");
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &map->columns) < 0)
+		return -1;
+	if (map->columns == 0)
+		return mlk__scan_errf(scan, "null map columns");
 
-	return 0;
+	return mlk__scan_eol(scan);
 }
 
 static int
 parse_rows(struct mlk_map_loader *loader,
            struct mlk_map *map,
-           const char *line,
-           FILE *fp)
+           struct mlk__scan *scan)
 {
 	(void)loader;
-	(void)fp;
 
-	if (sscanf(line, "rows|%u", &map->rows) != 1 || map->rows == 0)
-		return mlk_errf("null map rows");
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &map->rows) < 0)
+		return -1;
+	if (map->rows == 0)
+		return mlk__scan_errf(scan, "null map rows");
 
-	return 0;
+	return mlk__scan_eol(scan);
 }
 
 static int
 parse_player_origin(struct mlk_map_loader *loader,
                     struct mlk_map *map,
-                    const char *line,
-                    FILE *fp)
+                    struct mlk__scan *scan)
 {
 	(void)loader;
-	(void)fp;
 
-	if (sscanf(line, "player-origin|%d|%d", &map->player_x, &map->player_y) != 2)
-		return mlk_errf("invalid player origin");
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_int(scan, &map->player_x) < 0 ||
+	    mlk__scan_sep(scan) < 0 || mlk__scan_int(scan, &map->player_y) < 0)
+		return -1;
 
-	return 0;
+	return mlk__scan_eol(scan);
 }
 
 static int
-parse_player_sprite(struct mlk_map_loader *loader,
-                    struct mlk_map *map,
-                    const char *line,
-                    FILE *fp)
+load_player_sprite(struct mlk_map_loader *loader,
+                   struct mlk_map *map,
+                   unsigned int w,
+                   unsigned int h,
+                   const char *ident)
 {
-	(void)fp;
-
-	char format[32], ident[FILENAME_MAX + 1] = {0};
-	unsigned int w = 0, h = 0;
 	struct mlk_sprite *sprite;
 	struct mlk_texture *texture;
 
-	snprintf(format, sizeof (format), "player-sprite|%%u|%%u|%%%zu[^\n]", sizeof (ident) - 1);
-
-	if (sscanf(line, format, &w, &h, ident) != 3)
-		return mlk_errf("invalid player sprite");
 	if (!(texture = loader->new_texture(loader, map, ident)))
 		return -1;
 	if (!(sprite = loader->new_sprite(loader, map)))
@@ -235,15 +240,31 @@ parse_player_sprite(struct mlk_map_loader *loader,
 	return 0;
 }
 
+static int
+parse_player_sprite(struct mlk_map_loader *loader,
+                    struct mlk_map *map,
+                    struct mlk__scan *scan)
+{
+	char ident[FILENAME_MAX + 1];
+	unsigned int w, h;
+
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &w) < 0 ||
+	    mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &h) < 0 ||
+	    mlk__scan_sep(scan) < 0 || mlk__scan_text(scan, ident, sizeof (ident)) < 0 ||
+	    mlk__scan_eol(scan) < 0)
+		return -1;
+
+	return load_player_sprite(loader, map, w, h, ident);
+}
+
 static int
 parse_line(struct mlk_map_loader *loader,
            struct mlk_map *map,
-           const char *line,
-           FILE *fp)
+           struct mlk__scan *scan)
 {
 	static const struct {
 		const char *property;
-		int (*read)(struct mlk_map_loader *, struct mlk_map *, const char *, FILE *);
+		int (*read)(struct mlk_map_loader *, struct mlk_map *, struct mlk__scan *);
 	} props[] = {
 		{ "columns",            parse_columns           },
 		{ "rows",               parse_rows              },
@@ -253,11 +274,18 @@ parse_line(struct mlk_map_loader *loader,
 		{ "layer",              parse_layer             },
 	};
 
+	char key[32];
+
+	mlk__scan_key(scan, key, sizeof (key));
+
 	for (size_t i = 0; i < MLK_UTIL_SIZE(props); ++i) {
-		if (strncmp(line, props[i].property, strlen(props[i].property)) == 0)
-			return props[i].read(loader, map, line, fp);
+		if (strcmp(key, props[i].property) == 0)
+			return props[i].read(loader, map, scan);
 	}
 
+	/* Unknown properties are ignored. */
+	mlk__scan_skip(scan);
+
 	return 0;
 }
 
@@ -279,21 +307,179 @@ check(struct mlk_map *map)
 }
 
 static int
-parse(struct mlk_map_loader *loader, struct mlk_map *map, FILE *fp)
+parse_text(struct mlk_map_loader *loader, struct mlk_map *map, const void *data, size_t datasz)
 {
-	char line[128];
+	struct mlk__scan scan;
 
-	while (fgets(line, sizeof (line), fp)) {
-		/* Remove \n if any */
-		line[strcspn(line, "\r\n")] = '\0';
+	mlk__scan_init(&scan, data, datasz);
 
-		if (parse_line(loader, map, line, fp) < 0)
+	while (!mlk__scan_done(&scan))
+		if (parse_line(loader, map, &scan) < 0)
 			return -1;
+
+	return check(map);
+}
+
+static inline int
+is_binary(const void *data, size_t datasz)
+{
+	return datasz >= sizeof (MLK_MAPBIN_MAGIC) &&
+	       memcmp(data, MLK_MAPBIN_MAGIC, sizeof (MLK_MAPBIN_MAGIC)) == 0;
+}
+
+/*
+ * Tells if the array in the compiled map can be used in place, which requires
+ * a little endian host and suitable alignment of the data.
+ */
+static inline int
+is_native(const void *p, size_t alignment)
+{
+	const uint16_t one = 1;
+
+	return *(const unsigned char *)&one == 1 &&
+	       sizeof (unsigned int) == sizeof (uint32_t) &&
+	       (uintptr_t)p % alignment == 0;
+}
+
+static int
+parse_binary_tiles(struct mlk_map_loader *loader,
+                   struct mlk_map *map,
+                   const unsigned char *data,
+                   enum mlk_map_layer_type type)
+{
+	const size_t amount = (size_t)map->columns * map->rows;
+	unsigned int *tiles;
+
+	/*
+	 * Unlike blocks, tiles are writable (e.g. an opened door) while the
+	 * content may be read-only memory so they are always copied.
+	 */
+	if (!(tiles = loader->new_tiles(loader, map, type, amount)))
+		return -1;
+
+	if (is_native(tiles, 1))
+		memcpy(tiles, data, amount * sizeof (*tiles));
+	else
+		for (size_t i = 0; i < amount; ++i)
+			tiles[i] = mlk_mapbin_tile_decode(data + i * 4);
+
+	map->layers[type].tiles = tiles;
+
+	return 0;
+}
+
+static int
+parse_binary_blocks(struct mlk_map_loader *loader,
+                    struct mlk_map *map,
+                    const unsigned char *data,
+                    size_t blocksz)
+{
+	struct mlk_map_block *blocks;
+	struct mlk_mapbin_block block;
+
+	if (blocksz == 0)
+		return 0;
+
+	if (sizeof (*blocks) == MLK_MAPBIN_BLOCK_SIZE && is_native(data, _Alignof (struct mlk_map_block))) {
+		map->blocks = (const struct mlk_map_block *)data;
+		map->blocksz = blocksz;
+		return 0;
+	}
+
+	if (!(blocks = loader->expand_blocks(loader, map, NULL, blocksz)))
+		return -1;
+
+	for (size_t i = 0; i < blocksz; ++i) {
+		mlk_mapbin_block_decode(&block, data + i * MLK_MAPBIN_BLOCK_SIZE);
+		blocks[i].x = block.x;
+		blocks[i].y = block.y;
+		blocks[i].w = block.w;
+		blocks[i].h = block.h;
+	}
+
+	map->blocks = blocks;
+	map->blocksz = blocksz;
+
+	return 0;
+}
+
+static int
+parse_binary_objects(struct mlk_map_loader *loader,
+                     struct mlk_map *map,
+                     const unsigned char *data,
+                     const struct mlk_mapbin_header *header)
+{
+	const char *strings = (const char *)data + header->strings;
+	struct mlk_mapbin_object object;
+
+	for (size_t i = 0; i < header->objectsz; ++i) {
+		mlk_mapbin_object_decode(&object, data + header->objects + i * MLK_MAPBIN_OBJECT_SIZE);
+
+		if (object.exec >= header->stringsz)
+			return mlk_errf("invalid object argument");
+
+		if (!loader->new_object) {
+			mlk_tracef("ignoring object %d,%d,%u,%u,%s",
+			    object.x, object.y, object.w, object.h, strings + object.exec);
+			continue;
+		}
+
+		loader->new_object(loader, map, object.x, object.y, object.w, object.h, strings + object.exec);
 	}
 
+	return 0;
+}
+
+static int
+parse_binary(struct mlk_map_loader *loader, struct mlk_map *map, const unsigned char *data, size_t datasz)
+{
+	struct mlk_mapbin_header header;
+	const char *strings;
+
+	if (mlk_mapbin_header_decode(&header, data, datasz) < 0)
+		return mlk_errf("invalid compiled map");
+	if (header.columns == 0 || header.rows == 0)
+		return mlk_errf("null map dimensions");
+
+	strings = (const char *)data + header.strings;
+	map->columns = header.columns;
+	map->rows = header.rows;
+	map->player_x = header.player_x;
+	map->player_y = header.player_y;
+
+	if (strings[header.tileset] == '\0')
+		return mlk_errf("missing tileset");
+	if (!(map->tileset = loader->new_tileset(loader, map, strings + header.tileset)))
+		return -1;
+	if (strings[header.player_sprite] &&
+	    load_player_sprite(loader, map, header.player_w, header.player_h, strings + header.player_sprite) < 0)
+		return -1;
+
+	for (int i = 0; i < MLK_MAP_LAYER_TYPE_LAST; ++i)
+		if (header.tiles[i] && parse_binary_tiles(loader, map, data + header.tiles[i], i) < 0)
+			return -1;
+
+	if (parse_binary_blocks(loader, map, data + header.blocks, header.blocksz) < 0)
+		return -1;
+	if (parse_binary_objects(loader, map, data, &header) < 0)
+		return -1;
+
 	return check(map);
 }
 
+static void
+release(struct mlk_map *map)
+{
+	if (map->mapped)
+		mlk_util_munmap(map->data, map->datasz);
+	else
+		mlk_alloc_free(map->data);
+
+	map->data = NULL;
+	map->datasz = 0;
+	map->mapped = 0;
+}
+
 int
 mlk_map_loader_open(struct mlk_map_loader *loader, struct mlk_map *map, const char *path)
 {
@@ -301,14 +487,32 @@ mlk_map_loader_open(struct mlk_map_loader *loader, struct mlk_map *map, const ch
 	assert(map);
 	assert(path);
 
-	FILE *fp;
+	void *data;
+	size_t datasz;
+	int rv;
 
 	memset(map, 0, sizeof (*map));
 
-	if (!(fp = fopen(path, "r")))
+	if (!(data = mlk_util_mmap(path, &datasz)))
 		return mlk_errf("%s", strerror(errno));
 
-	return parse(loader, map, fp);
+	/*
+	 * Compiled maps reference the mapping until the map is cleared, text
+	 * maps are parsed right away.
+	 */
+	if (is_binary(data, datasz)) {
+		map->data = data;
+		map->datasz = datasz;
+		map->mapped = 1;
+
+		if ((rv = parse_binary(loader, map, data, datasz)) < 0)
+			release(map);
+	} else {
+		rv = parse_text(loader, map, data, datasz);
+		mlk_util_munmap(data, datasz);
+	}
+
+	return rv;
 }
 
 int
@@ -318,14 +522,49 @@ mlk_map_loader_openmem(struct mlk_map_loader *loader, struct mlk_map *map, const
 	assert(map);
 	assert(data);
 
-	FILE *fp;
-
 	memset(map, 0, sizeof (*map));
 
-	if (!(fp = mlk_util_fmemopen((void *)data, datasz, "r")))
+	if (is_binary(data, datasz))
+		return parse_binary(loader, map, data, datasz);
+
+	return parse_text(loader, map, data, datasz);
+}
+
+int
+mlk_map_loader_openvfs(struct mlk_map_loader *loader,
+                       struct mlk_map *map,
+                       struct mlk_vfs *vfs,
+                       const char *entry)
+{
+	assert(loader);
+	assert(map);
+	assert(vfs);
+	assert(entry);
+
+	struct mlk_vfs_file *file;
+	char *data;
+	size_t datasz;
+	int rv;
+
+	if (!(file = mlk_vfs_open(vfs, entry, "r")))
+		return -1;
+
+	data = mlk_vfs_file_read_all(file, &datasz);
+	mlk_vfs_file_finish(file);
+
+	if (!data)
 		return -1;
 
-	return parse(loader, map, fp);
+	rv = mlk_map_loader_openmem(loader, map, data, datasz);
+
+	/* Compiled maps keep referencing the content. */
+	if (rv == 0 && is_binary(data, datasz)) {
+		map->data = data;
+		map->datasz = datasz;
+	} else
+		mlk_alloc_free(data);
+
+	return rv;
 }
 
 void
@@ -338,6 +577,7 @@ mlk_map_loader_clear(struct mlk_map_loader *loader,
 	if (loader->clear)
 		loader->clear(loader, map);
 
+	release(map);
 	memset(map, 0, sizeof (*map));
 }
 
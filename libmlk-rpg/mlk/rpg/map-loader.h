@@ -28,6 +28,7 @@ struct mlk_map_block;
 struct mlk_sprite;
 struct mlk_texture;
 struct mlk_tileset;
+struct mlk_vfs;
 
 /**
  * \file mlk/rpg/map-loader.h
@@ -35,6 +36,14 @@ struct mlk_tileset;
  *
  * This module provides a generic way to open maps. It uses a callback similar
  * to the ::mlk_tileset_loader.
+ *
+ * Maps can either be in the textual format or compiled using `mlk-map -b`
+ * (see mlk/util/mapbin.h), the format is detected automatically. Compiled maps
+ * are memory mapped by ::mlk_map_loader_open and on little endian hosts the
+ * collision blocks point directly into the file content rather than being
+ * allocated through the loader, the content is then released by
+ * ::mlk_map_loader_clear. Layers tiles are always copied into the area
+ * returned by ::mlk_map_loader::new_tiles so that they can be modified.
  */
 
 /**
@@ -178,7 +187,10 @@ mlk_map_loader_open(struct mlk_map_loader *loader,
                     const char *path);
 
 /**
- * Try to open a map from the given path.
+ * Try to open a map from memory.
+ *
+ * If the content is a compiled map, it is not copied and must remain valid
+ * until the map is cleared.
  *
  * \pre loader != NULL
  * \pre map != NULL
@@ -194,6 +206,28 @@ mlk_map_loader_openmem(struct mlk_map_loader *loader,
                        const void *data,
                        size_t datasz);
 
+/**
+ * Try to open a map from an entry in the given VFS.
+ *
+ * The entry content is read entirely and released before returning unless
+ * it is a compiled map, in which case it is kept until the map is cleared.
+ *
+ * \pre loader != NULL
+ * \pre map != NULL
+ * \pre vfs != NULL
+ * \pre entry != NULL
+ * \param loader the loader interface
+ * \param map the map destination
+ * \param vfs the VFS to open the entry from
+ * \param entry the entry name (usually ending in .map)
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_map_loader_openvfs(struct mlk_map_loader *loader,
+                       struct mlk_map *map,
+                       struct mlk_vfs *vfs,
+                       const char *entry);
+
 /**
  * Cleanup data for this map.
  *
@@ -94,6 +94,12 @@ struct mlk_map {
 
 	struct mlk_button_style *style;
 	struct mlk_button_delegate *delegate;
+
+	/** \cond MLK_PRIVATE_DECLS */
+	void *data;
+	size_t datasz;
+	int mapped;
+	/** \endcond MLK_PRIVATE_DECLS */
 };
 
 extern struct mlk_map_style mlk_map_style;
@@ -45,9 +45,9 @@ set_error(struct mlk_save *db)
 }
 
 static inline const char *
-path(unsigned int idx)
+path(char *buf, size_t bufsz, unsigned int idx)
 {
-	return mlk_util_pathf("%s%u.db", mlk_sys_dir(MLK_SYS_DIR_SAVE), idx);
+	return mlk_util_pathf_r(buf, bufsz, "%s%u.db", mlk_sys_dir(MLK_SYS_DIR_SAVE), idx);
 }
 
 static inline int
@@ -166,7 +166,9 @@ mlk_save_open(struct mlk_save *db, unsigned int idx, enum mlk_save_mode mode)
 {
 	assert(db);
 
-	return mlk_save_open_path(db, path(idx), mode);
+	char buf[MLK_PATH_MAX];
+
+	return mlk_save_open_path(db, path(buf, sizeof (buf), idx), mode);
 }
 
 int
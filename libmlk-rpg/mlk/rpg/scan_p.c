@@ -0,0 +1,268 @@
+/*
+ * scan_p.c -- in-memory tokenizer for text formats
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <mlk/core/err.h>
+
+#include "scan_p.h"
+
+#define EOL(c) ((c) == '\n' || (c) == '\r')
+
+static inline int
+is_blank(int c)
+{
+	return c == ' ' || c == '\t';
+}
+
+static inline int
+is_digit(int c)
+{
+	return c >= '0' && c <= '9';
+}
+
+/*
+ * Advance until the delimiter or end of line is reached and return the length
+ * of the value without its trailing blanks.
+ */
+static size_t
+span(struct mlk__scan *scan, int delim)
+{
+	const char *start = scan->p;
+	size_t len;
+
+	while (scan->p < scan->end && !EOL(*scan->p) && *scan->p != delim)
+		scan->p++;
+
+	len = scan->p - start;
+
+	while (len > 0 && is_blank(start[len - 1]))
+		len--;
+
+	return len;
+}
+
+/*
+ * Copy characters until one of the delimiters or end of line is reached,
+ * trailing blanks are removed.
+ */
+static int
+copy(struct mlk__scan *scan, char *buf, size_t bufsz, int delim)
+{
+	const char *start = scan->p;
+	size_t len;
+
+	len = span(scan, delim);
+
+	if (len >= bufsz) {
+		scan->p = start;
+		return mlk__scan_errf(scan, "value too long");
+	}
+
+	for (size_t i = 0; i < len; ++i)
+		buf[i] = start[i];
+
+	buf[len] = '\0';
+
+	return 0;
+}
+
+void
+mlk__scan_init(struct mlk__scan *scan, const void *data, size_t datasz)
+{
+	assert(scan);
+	assert(data || datasz == 0);
+
+	scan->p = data;
+	scan->end = scan->p + datasz;
+	scan->bol = scan->p;
+	scan->line = 1;
+}
+
+int
+mlk__scan_peek(const struct mlk__scan *scan)
+{
+	assert(scan);
+
+	if (scan->p >= scan->end)
+		return EOF;
+
+	return (unsigned char)*scan->p;
+}
+
+int
+mlk__scan_done(const struct mlk__scan *scan)
+{
+	assert(scan);
+
+	return scan->p >= scan->end;
+}
+
+int
+mlk__scan_word(struct mlk__scan *scan, char *buf, size_t bufsz)
+{
+	assert(scan);
+	assert(buf);
+	assert(bufsz);
+
+	return copy(scan, buf, bufsz, '|');
+}
+
+void
+mlk__scan_key(struct mlk__scan *scan, char *buf, size_t bufsz)
+{
+	assert(scan);
+	assert(buf);
+	assert(bufsz);
+
+	const char *start = scan->p;
+	size_t len;
+
+	/* Too long to be a known key, let the caller ignore it. */
+	if ((len = span(scan, '|')) >= bufsz)
+		len = 0;
+
+	for (size_t i = 0; i < len; ++i)
+		buf[i] = start[i];
+
+	buf[len] = '\0';
+}
+
+int
+mlk__scan_text(struct mlk__scan *scan, char *buf, size_t bufsz)
+{
+	assert(scan);
+	assert(buf);
+	assert(bufsz);
+
+	return copy(scan, buf, bufsz, '\n');
+}
+
+int
+mlk__scan_uint(struct mlk__scan *scan, unsigned int *value)
+{
+	assert(scan);
+	assert(value);
+
+	const char *p = scan->p;
+	unsigned int v = 0, d;
+
+	if (p >= scan->end || !is_digit(*p))
+		return mlk__scan_errf(scan, "number expected");
+
+	for (; p < scan->end && is_digit(*p); ++p) {
+		d = *p - '0';
+
+		if (v > (UINT_MAX - d) / 10)
+			return mlk__scan_errf(scan, "number too large");
+
+		v = v * 10 + d;
+	}
+
+	scan->p = p;
+	*value = v;
+
+	return 0;
+}
+
+int
+mlk__scan_int(struct mlk__scan *scan, int *value)
+{
+	assert(scan);
+	assert(value);
+
+	unsigned int v;
+	int negative = 0;
+
+	if (mlk__scan_peek(scan) == '-') {
+		negative = 1;
+		scan->p++;
+	}
+
+	if (mlk__scan_uint(scan, &v) < 0)
+		return -1;
+	if (v > (unsigned int)INT_MAX + negative)
+		return mlk__scan_errf(scan, "number too large");
+
+	*value = negative ? (int)(0U - v) : (int)v;
+
+	return 0;
+}
+
+int
+mlk__scan_sep(struct mlk__scan *scan)
+{
+	assert(scan);
+
+	if (mlk__scan_peek(scan) != '|')
+		return mlk__scan_errf(scan, "'|' expected");
+
+	scan->p++;
+
+	return 0;
+}
+
+int
+mlk__scan_eol(struct mlk__scan *scan)
+{
+	assert(scan);
+
+	while (scan->p < scan->end && is_blank(*scan->p))
+		scan->p++;
+
+	if (scan->p < scan->end && !EOL(*scan->p))
+		return mlk__scan_errf(scan, "end of line expected");
+
+	mlk__scan_skip(scan);
+
+	return 0;
+}
+
+void
+mlk__scan_skip(struct mlk__scan *scan)
+{
+	assert(scan);
+
+	while (scan->p < scan->end && *scan->p != '\n')
+		scan->p++;
+
+	if (scan->p < scan->end) {
+		scan->p++;
+		scan->bol = scan->p;
+		scan->line++;
+	}
+}
+
+int
+mlk__scan_errf(const struct mlk__scan *scan, const char *fmt, ...)
+{
+	assert(scan);
+	assert(fmt);
+
+	char msg[MLK_ERR_MAX];
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(msg, sizeof (msg), fmt, ap);
+	va_end(ap);
+
+	return mlk_errf("%u:%u: %s", scan->line, (unsigned int)(scan->p - scan->bol) + 1, msg);
+}
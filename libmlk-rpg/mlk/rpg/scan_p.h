@@ -0,0 +1,72 @@
+/*
+ * scan_p.h -- in-memory tokenizer for text formats
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_RPG_SCAN_P_H
+#define MLK_RPG_SCAN_P_H
+
+#include <stddef.h>
+
+/*
+ * Tokenizer for the line based `key|value|value` text formats used by maps
+ * and tilesets. It works directly on a memory buffer without allocating and
+ * tracks the position to report errors as line:column.
+ */
+struct mlk__scan {
+	const char *p;
+	const char *end;
+	const char *bol;
+	unsigned int line;
+};
+
+void
+mlk__scan_init(struct mlk__scan *scan, const void *data, size_t datasz);
+
+int
+mlk__scan_peek(const struct mlk__scan *scan);
+
+int
+mlk__scan_done(const struct mlk__scan *scan);
+
+int
+mlk__scan_word(struct mlk__scan *scan, char *buf, size_t bufsz);
+
+void
+mlk__scan_key(struct mlk__scan *scan, char *buf, size_t bufsz);
+
+int
+mlk__scan_text(struct mlk__scan *scan, char *buf, size_t bufsz);
+
+int
+mlk__scan_uint(struct mlk__scan *scan, unsigned int *value);
+
+int
+mlk__scan_int(struct mlk__scan *scan, int *value);
+
+int
+mlk__scan_sep(struct mlk__scan *scan);
+
+int
+mlk__scan_eol(struct mlk__scan *scan);
+
+void
+mlk__scan_skip(struct mlk__scan *scan);
+
+int
+mlk__scan_errf(const struct mlk__scan *scan, const char *fmt, ...);
+
+#endif /* !MLK_RPG_SCAN_P_H */
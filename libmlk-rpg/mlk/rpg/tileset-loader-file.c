@@ -54,7 +54,7 @@ expand(void **array, size_t n, size_t w)
 	if (!*array)
 		ptr = mlk_alloc_new0(n, w);
 	else
-		ptr = mlk_alloc_expand(*array, n);
+		ptr = mlk_alloc_resize(*array, n);
 
 	if (ptr)
 		*array = ptr;
@@ -141,15 +141,12 @@ finish(struct mlk_tileset_loader *self)
 	file->lf = NULL;
 }
 
-int
-mlk_tileset_loader_file_init(struct mlk_tileset_loader_file *file, const char *filename)
+static int
+init(struct mlk_tileset_loader_file *file, struct mlk_vfs *vfs, const char *filename)
 {
-	assert(file);
-	assert(filename);
-
 	memset(file, 0, sizeof (*file));
 
-	if (!(file->lf = mlk__loader_file_new(filename)))
+	if (!(file->lf = mlk__loader_file_new(vfs, filename)))
 		return -1;
 
 	file->iface.new_texture = new_texture;
@@ -162,3 +159,24 @@ mlk_tileset_loader_file_init(struct mlk_tileset_loader_file *file, const char *f
 
 	return 0;
 }
+
+int
+mlk_tileset_loader_file_init(struct mlk_tileset_loader_file *file, const char *filename)
+{
+	assert(file);
+	assert(filename);
+
+	return init(file, NULL, filename);
+}
+
+int
+mlk_tileset_loader_file_initvfs(struct mlk_tileset_loader_file *file,
+                                struct mlk_vfs *vfs,
+                                const char *entry)
+{
+	assert(file);
+	assert(vfs);
+	assert(entry);
+
+	return init(file, vfs, entry);
+}
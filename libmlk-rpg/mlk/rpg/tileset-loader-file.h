@@ -36,6 +36,7 @@
 struct mlk_tileset_collision;
 struct mlk_tileset_animation;
 struct mlk__loader_file;
+struct mlk_vfs;
 
 /**
  * \struct mlk_tileset_loader_file
@@ -76,6 +77,23 @@ extern "C" {
 int
 mlk_tileset_loader_file_init(struct mlk_tileset_loader_file *file, const char *filename);
 
+/**
+ * Similar to ::mlk_tileset_loader_file_init but resources are opened from the
+ * given VFS relative to the tileset entry.
+ *
+ * \pre file != NULL
+ * \pre vfs != NULL
+ * \pre entry != NULL
+ * \param file the file loader
+ * \param vfs the VFS to open resources from (borrowed)
+ * \param entry the tileset entry name in the VFS
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_tileset_loader_file_initvfs(struct mlk_tileset_loader_file *file,
+                                struct mlk_vfs *vfs,
+                                const char *entry);
+
 #if defined(__cplusplus)
 }
 #endif
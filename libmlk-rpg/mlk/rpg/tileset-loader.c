@@ -17,18 +17,21 @@
  */
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <mlk/util/util.h>
 
+#include <mlk/core/alloc.h>
 #include <mlk/core/animation.h>
 #include <mlk/core/err.h>
 #include <mlk/core/sprite.h>
 #include <mlk/core/util.h>
+#include <mlk/core/vfs.h>
 
+#include "scan_p.h"
 #include "tileset-loader.h"
 #include "tileset.h"
 
@@ -63,49 +66,53 @@ animation_cmp(const void *d1, const void *d2)
 static int
 parse_tilewidth(struct mlk_tileset_loader *loader,
                 struct mlk_tileset *tileset,
-                const char *line,
-                FILE *fp)
+                struct mlk__scan *scan)
 {
-	(void)loader;
 	(void)tileset;
-	(void)fp;
 
-	if (sscanf(line, "tilewidth|%u", &loader->tilewidth) != 1 || loader->tilewidth == 0)
-		return mlk_errf("tilewidth is null or invalid");
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &loader->tilewidth) < 0)
+		return -1;
+	if (loader->tilewidth == 0)
+		return mlk__scan_errf(scan, "tilewidth is null or invalid");
 
-	return 0;
+	return mlk__scan_eol(scan);
 }
 
 static int
 parse_tileheight(struct mlk_tileset_loader *loader,
                  struct mlk_tileset *tileset,
-                 const char *line,
-                 FILE *fp)
+                 struct mlk__scan *scan)
 {
-	(void)loader;
 	(void)tileset;
-	(void)fp;
 
-	if (sscanf(line, "tileheight|%u", &loader->tileheight) != 1 || loader->tileheight == 0)
-		return mlk_errf("tileheight is null or invalid");
+	if (mlk__scan_sep(scan) < 0 || mlk__scan_uint(scan, &loader->tileheight) < 0)
+		return -1;
+	if (loader->tileheight == 0)
+		return mlk__scan_errf(scan, "tileheight is null or invalid");
 
-	return 0;
+	return mlk__scan_eol(scan);
 }
 
 static int
 parse_collisions(struct mlk_tileset_loader *loader,
                  struct mlk_tileset *tileset,
-                 const char *line,
-                 FILE *fp)
+                 struct mlk__scan *scan)
 {
-	(void)line;
-
 	struct mlk_tileset_collision *array, *collision, *collisions = NULL;
 	unsigned int id, w, h;
 	int x, y;
 	size_t collisionsz = 0;
 
-	while (fscanf(fp, "%u|%d|%d|%u|%u\n", &id, &x, &y, &w, &h) == 5) {
+	if (mlk__scan_eol(scan) < 0)
+		return -1;
+
+	while (isdigit(mlk__scan_peek(scan))) {
+		if (mlk__scan_uint(scan, &id) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_int(scan, &x) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_int(scan, &y) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_uint(scan, &w) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_uint(scan, &h) < 0 || mlk__scan_eol(scan) < 0)
+			return -1;
 		if (!(array = loader->expand_collisions(loader, tileset, collisions, collisionsz + 1)))
 			return -1;
 
@@ -132,12 +139,9 @@ parse_collisions(struct mlk_tileset_loader *loader,
 static int
 parse_animations(struct mlk_tileset_loader *loader,
                  struct mlk_tileset *tileset,
-                 const char *line,
-                 FILE *fp)
+                 struct mlk__scan *scan)
 {
-	(void)line;
-
-	char fmt[64], filename[MLK_PATH_MAX];
+	char filename[MLK_PATH_MAX];
 	unsigned int id, delay;
 	struct mlk_tileset_animation *array, *tileanimation, *tileanimations = NULL;
 	struct mlk_texture *texture;
@@ -145,8 +149,8 @@ parse_animations(struct mlk_tileset_loader *loader,
 	struct mlk_animation *animation;
 	size_t tileanimationsz = 0;
 
-	/* Create a format string for fscanf. */
-	snprintf(fmt, sizeof (fmt), "%%u|%%%zu[^|]|%%u", sizeof (filename) - 1);
+	if (mlk__scan_eol(scan) < 0)
+		return -1;
 
 	/*
 	 * When parsing animations, we have to create three different
@@ -157,7 +161,11 @@ parse_animations(struct mlk_tileset_loader *loader,
 	 * 3. The animation object.
 	 * 4. Link the animation to the tileset animation.
 	 */
-	while (fscanf(fp, fmt, &id, filename, &delay) == 3) {
+	while (isdigit(mlk__scan_peek(scan))) {
+		if (mlk__scan_uint(scan, &id) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_word(scan, filename, sizeof (filename)) < 0 || mlk__scan_sep(scan) < 0 ||
+		    mlk__scan_uint(scan, &delay) < 0 || mlk__scan_eol(scan) < 0)
+			return -1;
 		if (!(texture = loader->new_texture(loader, tileset, filename)))
 			return -1;
 		if (!(sprite = loader->new_sprite(loader, tileset)))
@@ -198,20 +206,19 @@ parse_animations(struct mlk_tileset_loader *loader,
 static int
 parse_image(struct mlk_tileset_loader *loader,
             struct mlk_tileset *tileset,
-            const char *line,
-            FILE *fp)
+            struct mlk__scan *scan)
 {
-	(void)fp;
-
-	const char *p;
+	char filename[MLK_PATH_MAX];
 	struct mlk_texture *texture;
 	struct mlk_sprite *sprite;
 
 	if (loader->tilewidth == 0 || loader->tileheight == 0)
-		return mlk_errf("missing tile dimensions before image");
-	if (!(p = strchr(line, '|')))
-		return mlk_errf("could not parse image");
-	if (!(texture = loader->new_texture(loader, tileset, p + 1)))
+		return mlk__scan_errf(scan, "missing tile dimensions before image");
+	if (mlk__scan_sep(scan) < 0 ||
+	    mlk__scan_text(scan, filename, sizeof (filename)) < 0 ||
+	    mlk__scan_eol(scan) < 0)
+		return -1;
+	if (!(texture = loader->new_texture(loader, tileset, filename)))
 		return -1;
 	if (!(sprite = loader->new_sprite(loader, tileset)))
 		return -1;
@@ -231,12 +238,11 @@ parse_image(struct mlk_tileset_loader *loader,
 static int
 parse_line(struct mlk_tileset_loader *loader,
            struct mlk_tileset *tileset,
-           const char *line,
-           FILE *fp)
+           struct mlk__scan *scan)
 {
 	static const struct {
 		const char *property;
-		int (*read)(struct mlk_tileset_loader *, struct mlk_tileset *, const char *, FILE *);
+		int (*read)(struct mlk_tileset_loader *, struct mlk_tileset *, struct mlk__scan *);
 	} props[] = {
 		{ "tilewidth",  parse_tilewidth         },
 		{ "tileheight", parse_tileheight        },
@@ -245,11 +251,18 @@ parse_line(struct mlk_tileset_loader *loader,
 		{ "image",      parse_image             }
 	};
 
+	char key[32];
+
+	mlk__scan_key(scan, key, sizeof (key));
+
 	for (size_t i = 0; i < MLK_UTIL_SIZE(props); ++i) {
-		if (strncmp(line, props[i].property, strlen(props[i].property)) == 0)
-			return props[i].read(loader, tileset, line, fp);
+		if (strcmp(key, props[i].property) == 0)
+			return props[i].read(loader, tileset, scan);
 	}
 
+	/* Unknown properties are ignored. */
+	mlk__scan_skip(scan);
+
 	return 0;
 }
 
@@ -263,17 +276,18 @@ check(const struct mlk_tileset *tileset)
 }
 
 static int
-parse(struct mlk_tileset_loader *loader, struct mlk_tileset *tileset, FILE *fp)
+parse(struct mlk_tileset_loader *loader,
+      struct mlk_tileset *tileset,
+      const void *data,
+      size_t datasz)
 {
-	char line[128];
+	struct mlk__scan scan;
 
-	while (fgets(line, sizeof (line), fp)) {
-		/* Remove \n if any */
-		line[strcspn(line, "\r\n")] = 0;
+	mlk__scan_init(&scan, data, datasz);
 
-		if (parse_line(loader, tileset, line, fp) < 0)
+	while (!mlk__scan_done(&scan))
+		if (parse_line(loader, tileset, &scan) < 0)
 			return -1;
-	}
 
 	return check(tileset);
 }
@@ -287,14 +301,19 @@ mlk_tileset_loader_open(struct mlk_tileset_loader *loader,
 	assert(tileset);
 	assert(path);
 
-	FILE *fp;
+	void *data;
+	size_t datasz;
+	int rv;
 
 	memset(tileset, 0, sizeof (*tileset));
 
-	if (!(fp = fopen(path, "r")))
+	if (!(data = mlk_util_mmap(path, &datasz)))
 		return mlk_errf("%s", strerror(errno));
 
-	return parse(loader, tileset, fp);
+	rv = parse(loader, tileset, data, datasz);
+	mlk_util_munmap(data, datasz);
+
+	return rv;
 }
 
 int
@@ -307,14 +326,40 @@ mlk_tileset_loader_openmem(struct mlk_tileset_loader *loader,
 	assert(tileset);
 	assert(data);
 
-	FILE *fp;
-
 	memset(tileset, 0, sizeof (*tileset));
 
-	if (!(fp = mlk_util_fmemopen((void *)data, datasz, "r")))
+	return parse(loader, tileset, data, datasz);
+}
+
+int
+mlk_tileset_loader_openvfs(struct mlk_tileset_loader *loader,
+                           struct mlk_tileset *tileset,
+                           struct mlk_vfs *vfs,
+                           const char *entry)
+{
+	assert(loader);
+	assert(tileset);
+	assert(vfs);
+	assert(entry);
+
+	struct mlk_vfs_file *file;
+	char *data;
+	size_t datasz;
+	int rv;
+
+	if (!(file = mlk_vfs_open(vfs, entry, "r")))
 		return -1;
 
-	return parse(loader, tileset, fp);
+	data = mlk_vfs_file_read_all(file, &datasz);
+	mlk_vfs_file_finish(file);
+
+	if (!data)
+		return -1;
+
+	rv = mlk_tileset_loader_openmem(loader, tileset, data, datasz);
+	mlk_alloc_free(data);
+
+	return rv;
 }
 
 void
@@ -38,6 +38,7 @@
 
 struct mlk_tileset;
 struct mlk_tileset_animations;
+struct mlk_vfs;
 struct mlk_tileset_collision;
 
 /**
@@ -185,6 +186,27 @@ mlk_tileset_loader_openmem(struct mlk_tileset_loader *loader,
                            const void *data,
                            size_t datasz);
 
+/**
+ * Open a tileset from an entry in the given VFS.
+ *
+ * The entry content is read entirely and released before returning.
+ *
+ * \pre loader != NULL
+ * \pre tileset != NULL
+ * \pre vfs != NULL
+ * \pre entry != NULL
+ * \param loader the loader
+ * \param tileset the tileset destination
+ * \param vfs the VFS to open the entry from
+ * \param entry the entry name (usually ending in .tileset)
+ * \return 0 on success or -1 on error
+ */
+int
+mlk_tileset_loader_openvfs(struct mlk_tileset_loader *loader,
+                           struct mlk_tileset *tileset,
+                           struct mlk_vfs *vfs,
+                           const char *entry);
+
 /**
  * Cleanup data for this tileset.
  *
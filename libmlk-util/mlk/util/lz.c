@@ -0,0 +1,227 @@
+/*
+ * lz.c -- fast LZ77 block compression
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lz.h"
+
+#define HASH_BITS       12
+#define MIN_MATCH       4
+#define MAX_OFFSET      65535
+
+/*
+ * Like LZ4, the last bytes are always emitted as literals so that the
+ * decoder never has to check for a match at the very end of the input.
+ */
+#define LAST_LITERALS   5
+#define MF_LIMIT        12
+
+static inline uint32_t
+read32(const unsigned char *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof (v));
+
+	return v;
+}
+
+static inline unsigned int
+hash(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static inline size_t
+cost(size_t litlen, size_t matchlen)
+{
+	/* Token, extra lengths, literals, offset. */
+	return 1 + litlen / 255 + 1 + litlen + 2 + matchlen / 255 + 1;
+}
+
+static inline unsigned char *
+put_length(unsigned char *op, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		*op++ = 255;
+
+	*op++ = len;
+
+	return op;
+}
+
+static inline unsigned char *
+put_literals(unsigned char *op, const unsigned char *anchor, size_t litlen, size_t matchlen)
+{
+	*op++ = (litlen >= 15 ? 15 : litlen) << 4 | (matchlen >= 15 ? 15 : matchlen);
+
+	if (litlen >= 15)
+		op = put_length(op, litlen - 15);
+
+	memcpy(op, anchor, litlen);
+
+	return op + litlen;
+}
+
+static inline const unsigned char *
+get_length(const unsigned char *ip, const unsigned char *iend, size_t *len)
+{
+	unsigned char b;
+
+	do {
+		if (ip >= iend)
+			return NULL;
+
+		b = *ip++;
+		*len += b;
+	} while (b == 255);
+
+	return ip;
+}
+
+size_t
+mlk_lz_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t
+mlk_lz_compress(const void *src, size_t srcsz, void *dst, size_t dstsz)
+{
+	assert(src || srcsz == 0);
+	assert(dst);
+
+	uint32_t table[1 << HASH_BITS] = {};
+	const unsigned char *base = src, *ip = src, *anchor = src, *ref, *mp, *rp;
+	const unsigned char *iend = base + srcsz;
+	unsigned char *op = dst, *oend = op + dstsz;
+	size_t litlen, matchlen, offset;
+	uint32_t seq;
+	unsigned int h;
+
+	if (srcsz > MF_LIMIT) {
+		while (ip < iend - MF_LIMIT) {
+			seq = read32(ip);
+			h = hash(seq);
+			ref = base + table[h];
+			table[h] = ip - base;
+
+			if (ref >= ip || ip - ref > MAX_OFFSET || read32(ref) != seq) {
+				++ip;
+				continue;
+			}
+
+			/* Extend the match as far as possible. */
+			mp = ip + MIN_MATCH;
+			rp = ref + MIN_MATCH;
+
+			while (mp < iend - LAST_LITERALS && *mp == *rp) {
+				++mp;
+				++rp;
+			}
+
+			litlen = ip - anchor;
+			matchlen = mp - ip - MIN_MATCH;
+			offset = ip - ref;
+
+			if (cost(litlen, matchlen) > (size_t)(oend - op))
+				return 0;
+
+			op = put_literals(op, anchor, litlen, matchlen);
+			*op++ = offset & 0xff;
+			*op++ = (offset >> 8) & 0xff;
+
+			if (matchlen >= 15)
+				op = put_length(op, matchlen - 15);
+
+			ip = anchor = mp;
+		}
+	}
+
+	/* Final literals-only sequence. */
+	litlen = iend - anchor;
+
+	if (1 + litlen / 255 + 1 + litlen > (size_t)(oend - op))
+		return 0;
+
+	op = put_literals(op, anchor, litlen, 0);
+
+	return op - (unsigned char *)dst;
+}
+
+size_t
+mlk_lz_decompress(const void *src, size_t srcsz, void *dst, size_t dstsz)
+{
+	assert(src);
+	assert(dst);
+
+	const unsigned char *ip = src, *iend = ip + srcsz, *ref;
+	unsigned char *ostart = dst, *op = dst, *oend = op + dstsz;
+	size_t len, offset;
+	unsigned int token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Literals. */
+		if ((len = token >> 4) == 15 && !(ip = get_length(ip, iend, &len)))
+			return -1;
+		if (len > (size_t)(iend - ip) || len > (size_t)(oend - op))
+			return -1;
+
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* Last sequence has no match. */
+		if (ip == iend)
+			break;
+		if (iend - ip < 2)
+			return -1;
+
+		offset = ip[0] | ip[1] << 8;
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - ostart))
+			return -1;
+
+		/* Match. */
+		if ((len = token & 15) == 15 && !(ip = get_length(ip, iend, &len)))
+			return -1;
+
+		len += MIN_MATCH;
+
+		if (len > (size_t)(oend - op))
+			return -1;
+
+		ref = op - offset;
+
+		/* Overlapping matches repeat the pattern byte per byte. */
+		if (offset >= len)
+			memcpy(op, ref, len);
+		else
+			for (size_t i = 0; i < len; ++i)
+				op[i] = ref[i];
+
+		op += len;
+	}
+
+	return op - ostart;
+}
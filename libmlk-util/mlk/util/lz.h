@@ -0,0 +1,99 @@
+/*
+ * lz.h -- fast LZ77 block compression
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_UTIL_LZ_H
+#define MLK_UTIL_LZ_H
+
+/**
+ * \file mlk/util/lz.h
+ * \brief Fast LZ77 block compression
+ *
+ * This module implements a small LZ77 byte oriented codec in the spirit of
+ * LZ4 block format. It favors decompression speed over ratio and is used by
+ * the asset file formats where startup time matters more than disk usage.
+ *
+ * A compressed block is a sequence of:
+ *
+ * 1. A token byte, the high nibble is the literal length and the low nibble
+ *    is the match length minus 4. A nibble of 15 indicates that additional
+ *    length bytes follow, each byte of 255 means another one follows.
+ * 2. The literals.
+ * 3. A 16 bits little endian match offset.
+ * 4. The additional match length bytes if any.
+ *
+ * The last sequence only contains literals.
+ *
+ * The block does not store its decompressed size, the caller must keep it
+ * alongside.
+ */
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Return the maximum size a compressed block can take for the given input
+ * size.
+ *
+ * \param size the uncompressed size
+ * \return the worst case compressed size
+ */
+size_t
+mlk_lz_bound(size_t size);
+
+/**
+ * Compress the source into the destination.
+ *
+ * The function fails if the destination is too small, using ::mlk_lz_bound
+ * ensures it never happens.
+ *
+ * \pre src != NULL || srcsz == 0
+ * \pre dst != NULL
+ * \param src the source data
+ * \param srcsz the source length
+ * \param dst the destination buffer
+ * \param dstsz the destination buffer capacity
+ * \return the compressed size or 0 if dst is too small
+ */
+size_t
+mlk_lz_compress(const void *src, size_t srcsz, void *dst, size_t dstsz);
+
+/**
+ * Decompress the source into the destination.
+ *
+ * This function validates the whole input and never reads or writes out of
+ * bounds even on malicious data.
+ *
+ * \pre src != NULL
+ * \pre dst != NULL
+ * \param src the compressed block
+ * \param srcsz the compressed block length
+ * \param dst the destination buffer
+ * \param dstsz the destination buffer capacity
+ * \return the decompressed size or (size_t)-1 on corrupted input
+ */
+size_t
+mlk_lz_decompress(const void *src, size_t srcsz, void *dst, size_t dstsz);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_UTIL_LZ_H */
@@ -0,0 +1,212 @@
+/*
+ * mapbin.c -- compiled binary map format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "mapbin.h"
+
+static inline uint32_t
+get32(const unsigned char *p)
+{
+	return (uint32_t)p[0]       |
+	       (uint32_t)p[1] << 8  |
+	       (uint32_t)p[2] << 16 |
+	       (uint32_t)p[3] << 24;
+}
+
+static inline void
+put32(unsigned char *p, uint32_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
+
+/*
+ * Reserve count elements of size bytes at the current offset, checking that
+ * they fit in the file.
+ */
+static inline int
+section(uint64_t *offset, uint64_t *section, uint64_t count, uint64_t size, size_t datasz)
+{
+	if (*offset > datasz || (datasz - *offset) / size < count)
+		return -1;
+
+	*section = *offset;
+	*offset += count * size;
+
+	return 0;
+}
+
+int
+mlk_mapbin_header_decode(struct mlk_mapbin_header *header, const void *data, size_t datasz)
+{
+	assert(header);
+	assert(data);
+
+	const unsigned char *p = data;
+	uint64_t offset = MLK_MAPBIN_HEADER_SIZE;
+
+	if (datasz < MLK_MAPBIN_HEADER_SIZE || memcmp(p, MLK_MAPBIN_MAGIC, sizeof (MLK_MAPBIN_MAGIC)) != 0)
+		return -1;
+
+	memset(header, 0, sizeof (*header));
+	header->version         = get32(p + 8);
+	header->layers          = get32(p + 12);
+	header->columns         = get32(p + 16);
+	header->rows            = get32(p + 20);
+	header->player_x        = (int32_t)get32(p + 24);
+	header->player_y        = (int32_t)get32(p + 28);
+	header->player_w        = get32(p + 32);
+	header->player_h        = get32(p + 36);
+	header->player_sprite   = get32(p + 40);
+	header->tileset         = get32(p + 44);
+	header->blocksz         = get32(p + 48);
+	header->objectsz        = get32(p + 52);
+	header->stringsz        = get32(p + 56);
+
+	if (header->version != MLK_MAPBIN_VERSION)
+		return -1;
+	if (header->layers & ~(uint32_t)(MLK_MAPBIN_LAYER_BG | MLK_MAPBIN_LAYER_FG | MLK_MAPBIN_LAYER_ABOVE))
+		return -1;
+
+	/* Check every section fits in the file. */
+	for (size_t i = 0; i < sizeof (header->tiles) / sizeof (header->tiles[0]); ++i) {
+		if (!(header->layers & (1U << i)))
+			continue;
+		if (section(&offset, &header->tiles[i], (uint64_t)header->columns * header->rows, 4, datasz) < 0)
+			return -1;
+	}
+
+	if (section(&offset, &header->blocks, header->blocksz, MLK_MAPBIN_BLOCK_SIZE, datasz) < 0)
+		return -1;
+	if (section(&offset, &header->objects, header->objectsz, MLK_MAPBIN_OBJECT_SIZE, datasz) < 0)
+		return -1;
+	if (section(&offset, &header->strings, header->stringsz, 1, datasz) < 0)
+		return -1;
+
+	/* Strings must start with the empty string and be terminated. */
+	if (header->stringsz == 0 || p[header->strings] != '\0' ||
+	    p[header->strings + header->stringsz - 1] != '\0')
+		return -1;
+	if (header->tileset >= header->stringsz || header->player_sprite >= header->stringsz)
+		return -1;
+
+	return 0;
+}
+
+void
+mlk_mapbin_header_encode(const struct mlk_mapbin_header *header, void *buf)
+{
+	assert(header);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	memset(p, 0, MLK_MAPBIN_HEADER_SIZE);
+	memcpy(p, MLK_MAPBIN_MAGIC, sizeof (MLK_MAPBIN_MAGIC));
+	put32(p + 8, header->version);
+	put32(p + 12, header->layers);
+	put32(p + 16, header->columns);
+	put32(p + 20, header->rows);
+	put32(p + 24, (uint32_t)header->player_x);
+	put32(p + 28, (uint32_t)header->player_y);
+	put32(p + 32, header->player_w);
+	put32(p + 36, header->player_h);
+	put32(p + 40, header->player_sprite);
+	put32(p + 44, header->tileset);
+	put32(p + 48, header->blocksz);
+	put32(p + 52, header->objectsz);
+	put32(p + 56, header->stringsz);
+}
+
+uint32_t
+mlk_mapbin_tile_decode(const void *buf)
+{
+	assert(buf);
+
+	return get32(buf);
+}
+
+void
+mlk_mapbin_tile_encode(uint32_t tile, void *buf)
+{
+	assert(buf);
+
+	put32(buf, tile);
+}
+
+void
+mlk_mapbin_block_decode(struct mlk_mapbin_block *block, const void *buf)
+{
+	assert(block);
+	assert(buf);
+
+	const unsigned char *p = buf;
+
+	block->x = (int32_t)get32(p);
+	block->y = (int32_t)get32(p + 4);
+	block->w = get32(p + 8);
+	block->h = get32(p + 12);
+}
+
+void
+mlk_mapbin_block_encode(const struct mlk_mapbin_block *block, void *buf)
+{
+	assert(block);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	put32(p, (uint32_t)block->x);
+	put32(p + 4, (uint32_t)block->y);
+	put32(p + 8, block->w);
+	put32(p + 12, block->h);
+}
+
+void
+mlk_mapbin_object_decode(struct mlk_mapbin_object *object, const void *buf)
+{
+	assert(object);
+	assert(buf);
+
+	const unsigned char *p = buf;
+
+	object->x    = (int32_t)get32(p);
+	object->y    = (int32_t)get32(p + 4);
+	object->w    = get32(p + 8);
+	object->h    = get32(p + 12);
+	object->exec = get32(p + 16);
+}
+
+void
+mlk_mapbin_object_encode(const struct mlk_mapbin_object *object, void *buf)
+{
+	assert(object);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	put32(p, (uint32_t)object->x);
+	put32(p + 4, (uint32_t)object->y);
+	put32(p + 8, object->w);
+	put32(p + 12, object->h);
+	put32(p + 16, object->exec);
+}
@@ -0,0 +1,344 @@
+/*
+ * mapbin.h -- compiled binary map format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_UTIL_MAPBIN_H
+#define MLK_UTIL_MAPBIN_H
+
+/**
+ * \file mlk/util/mapbin.h
+ * \brief Compiled binary map format
+ *
+ * This module describes the on-disk layout of compiled maps, it is shared
+ * between the mlk-map tool that creates them and the mlk/rpg/map-loader.h
+ * module that reads them.
+ *
+ * A compiled map is laid out as following, every integer is stored in little
+ * endian and every section follows the previous one without padding:
+ *
+ * | Section  | Description                                               |
+ * |----------|-----------------------------------------------------------|
+ * | header   | ::MLK_MAPBIN_HEADER_SIZE bytes                            |
+ * | tiles    | columns * rows 32 bits tiles for each layer present       |
+ * | blocks   | ::MLK_MAPBIN_BLOCK_SIZE bytes per collision block         |
+ * | objects  | ::MLK_MAPBIN_OBJECT_SIZE bytes per object                 |
+ * | strings  | NUL terminated strings, starting with an empty one        |
+ *
+ * Layers are stored in the ::mlk_mapbin_layer order and blocks use the same
+ * layout as the rpg map blocks so that a memory mapped map can reference
+ * tiles and blocks directly on little endian hosts.
+ *
+ * Strings are referenced by their offset in the strings section, the offset
+ * 0 designates the empty string which means absent.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * File signature, including the NUL terminator.
+ */
+#define MLK_MAPBIN_MAGIC        "MLKMAP"
+
+/**
+ * Current format version.
+ */
+#define MLK_MAPBIN_VERSION      1
+
+/**
+ * Size of the header in bytes.
+ */
+#define MLK_MAPBIN_HEADER_SIZE  64
+
+/**
+ * Size of one collision block in bytes.
+ */
+#define MLK_MAPBIN_BLOCK_SIZE   16
+
+/**
+ * Size of one object in bytes.
+ */
+#define MLK_MAPBIN_OBJECT_SIZE  20
+
+/**
+ * \enum mlk_mapbin_layer
+ * \brief Layers present in the map
+ *
+ * Those follow the ::mlk_map_layer_type order.
+ */
+enum mlk_mapbin_layer {
+	/**
+	 * Background layer.
+	 */
+	MLK_MAPBIN_LAYER_BG     = (1 << 0),
+
+	/**
+	 * Foreground layer.
+	 */
+	MLK_MAPBIN_LAYER_FG     = (1 << 1),
+
+	/**
+	 * Layer drawn above the player.
+	 */
+	MLK_MAPBIN_LAYER_ABOVE  = (1 << 2)
+};
+
+/**
+ * \struct mlk_mapbin_header
+ * \brief Decoded map header
+ */
+struct mlk_mapbin_header {
+	/**
+	 * Format version, must be ::MLK_MAPBIN_VERSION.
+	 */
+	uint32_t version;
+
+	/**
+	 * Layers present (see ::mlk_mapbin_layer).
+	 */
+	uint32_t layers;
+
+	/**
+	 * Number of columns.
+	 */
+	uint32_t columns;
+
+	/**
+	 * Number of rows.
+	 */
+	uint32_t rows;
+
+	/**
+	 * Player origin.
+	 */
+	int32_t player_x;
+
+	/**
+	 * Player origin.
+	 */
+	int32_t player_y;
+
+	/**
+	 * Player sprite cell width.
+	 */
+	uint32_t player_w;
+
+	/**
+	 * Player sprite cell height.
+	 */
+	uint32_t player_h;
+
+	/**
+	 * Player sprite image in the strings section.
+	 */
+	uint32_t player_sprite;
+
+	/**
+	 * Tileset file in the strings section.
+	 */
+	uint32_t tileset;
+
+	/**
+	 * Number of collision blocks.
+	 */
+	uint32_t blocksz;
+
+	/**
+	 * Number of objects.
+	 */
+	uint32_t objectsz;
+
+	/**
+	 * Length of the strings section.
+	 */
+	uint32_t stringsz;
+
+	/**
+	 * Offset to each layer tiles or 0 if absent, computed when decoding.
+	 */
+	uint64_t tiles[3];
+
+	/**
+	 * Offset to the blocks section, computed when decoding.
+	 */
+	uint64_t blocks;
+
+	/**
+	 * Offset to the objects section, computed when decoding.
+	 */
+	uint64_t objects;
+
+	/**
+	 * Offset to the strings section, computed when decoding.
+	 */
+	uint64_t strings;
+};
+
+/**
+ * \struct mlk_mapbin_block
+ * \brief Decoded collision block
+ */
+struct mlk_mapbin_block {
+	/**
+	 * Block position.
+	 */
+	int32_t x;
+
+	/**
+	 * Block position.
+	 */
+	int32_t y;
+
+	/**
+	 * Block width.
+	 */
+	uint32_t w;
+
+	/**
+	 * Block height.
+	 */
+	uint32_t h;
+};
+
+/**
+ * \struct mlk_mapbin_object
+ * \brief Decoded map object
+ */
+struct mlk_mapbin_object {
+	/**
+	 * Object position.
+	 */
+	int32_t x;
+
+	/**
+	 * Object position.
+	 */
+	int32_t y;
+
+	/**
+	 * Object width.
+	 */
+	uint32_t w;
+
+	/**
+	 * Object height.
+	 */
+	uint32_t h;
+
+	/**
+	 * Object argument in the strings section.
+	 */
+	uint32_t exec;
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Decode and validate the map header and its sections boundaries.
+ *
+ * \pre header != NULL
+ * \pre data != NULL
+ * \param header the header to fill
+ * \param data the whole map content
+ * \param datasz the map content length
+ * \return 0 on success or -1 if the map is invalid
+ */
+int
+mlk_mapbin_header_decode(struct mlk_mapbin_header *header, const void *data, size_t datasz);
+
+/**
+ * Encode the header into the given buffer, computed offsets are ignored.
+ *
+ * \pre header != NULL
+ * \pre buf != NULL
+ * \param header the header to encode
+ * \param buf the destination of ::MLK_MAPBIN_HEADER_SIZE bytes
+ */
+void
+mlk_mapbin_header_encode(const struct mlk_mapbin_header *header, void *buf);
+
+/**
+ * Decode a tile.
+ *
+ * \pre buf != NULL
+ * \param buf the source of 4 bytes
+ * \return the tile
+ */
+uint32_t
+mlk_mapbin_tile_decode(const void *buf);
+
+/**
+ * Encode a tile.
+ *
+ * \pre buf != NULL
+ * \param tile the tile
+ * \param buf the destination of 4 bytes
+ */
+void
+mlk_mapbin_tile_encode(uint32_t tile, void *buf);
+
+/**
+ * Decode a collision block.
+ *
+ * \pre block != NULL
+ * \pre buf != NULL
+ * \param block the block to fill
+ * \param buf the source of ::MLK_MAPBIN_BLOCK_SIZE bytes
+ */
+void
+mlk_mapbin_block_decode(struct mlk_mapbin_block *block, const void *buf);
+
+/**
+ * Encode a collision block.
+ *
+ * \pre block != NULL
+ * \pre buf != NULL
+ * \param block the block to encode
+ * \param buf the destination of ::MLK_MAPBIN_BLOCK_SIZE bytes
+ */
+void
+mlk_mapbin_block_encode(const struct mlk_mapbin_block *block, void *buf);
+
+/**
+ * Decode an object.
+ *
+ * \pre object != NULL
+ * \pre buf != NULL
+ * \param object the object to fill
+ * \param buf the source of ::MLK_MAPBIN_OBJECT_SIZE bytes
+ */
+void
+mlk_mapbin_object_decode(struct mlk_mapbin_object *object, const void *buf);
+
+/**
+ * Encode an object.
+ *
+ * \pre object != NULL
+ * \pre buf != NULL
+ * \param object the object to encode
+ * \param buf the destination of ::MLK_MAPBIN_OBJECT_SIZE bytes
+ */
+void
+mlk_mapbin_object_encode(const struct mlk_mapbin_object *object, void *buf);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_UTIL_MAPBIN_H */
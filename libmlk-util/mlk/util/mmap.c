@@ -0,0 +1,131 @@
+/*
+ * mmap.c -- portable read-only file mapping
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "sysconfig.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util.h"
+
+#if defined(MLK_HAVE_MMAP) && defined(MLK_HAVE_SYS_MMAN_H)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+void *
+mlk_util_mmap(const char *path, size_t *size)
+{
+	assert(path);
+	assert(size);
+
+	struct stat st;
+	void *data;
+	int fd, err;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	if (fstat(fd, &st) < 0)
+		goto err;
+
+	/* mmap(2) does not accept empty mappings. */
+	if (st.st_size == 0) {
+		errno = EINVAL;
+		goto err;
+	}
+
+	if ((data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+		goto err;
+
+	close(fd);
+	*size = st.st_size;
+
+	return data;
+
+err:
+	err = errno;
+	close(fd);
+	errno = err;
+
+	return NULL;
+}
+
+void
+mlk_util_munmap(void *data, size_t size)
+{
+	if (data)
+		munmap(data, size);
+}
+
+#else
+
+void *
+mlk_util_mmap(const char *path, size_t *size)
+{
+	assert(path);
+	assert(size);
+
+	FILE *fp;
+	long len;
+	void *data = NULL;
+	int err;
+
+	if (!(fp = fopen(path, "rb")))
+		return NULL;
+	if (fseek(fp, 0, SEEK_END) < 0 || (len = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) < 0)
+		goto err;
+
+	if (len == 0) {
+		errno = EINVAL;
+		goto err;
+	}
+
+	if (!(data = malloc(len)))
+		goto err;
+	if (fread(data, 1, len, fp) != (size_t)len) {
+		errno = EIO;
+		goto err;
+	}
+
+	fclose(fp);
+	*size = len;
+
+	return data;
+
+err:
+	err = errno;
+	free(data);
+	fclose(fp);
+	errno = err;
+
+	return NULL;
+}
+
+void
+mlk_util_munmap(void *data, size_t size)
+{
+	(void)size;
+
+	free(data);
+}
+
+#endif
@@ -33,7 +33,7 @@
 char *
 mlk_util_basename(char *path)
 {
-	static char bname[MLK_PATH_MAX];
+	static MLK_THREAD_LOCAL char bname[MLK_PATH_MAX];
 	size_t len;
 	const char *endp, *startp;
 
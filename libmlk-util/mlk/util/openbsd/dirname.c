@@ -33,7 +33,7 @@
 char *
 mlk_util_dirname(char *path)
 {
-	static char dname[MLK_PATH_MAX];
+	static MLK_THREAD_LOCAL char dname[MLK_PATH_MAX];
 	size_t len;
 	const char *endp;
 
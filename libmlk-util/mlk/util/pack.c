@@ -0,0 +1,191 @@
+/*
+ * pack.c -- indexed asset pack format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "pack.h"
+#include "util.h"
+
+static inline uint32_t
+get32(const unsigned char *p)
+{
+	return (uint32_t)p[0]       |
+	       (uint32_t)p[1] << 8  |
+	       (uint32_t)p[2] << 16 |
+	       (uint32_t)p[3] << 24;
+}
+
+static inline uint64_t
+get64(const unsigned char *p)
+{
+	return (uint64_t)get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+static inline void
+put32(unsigned char *p, uint32_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
+
+static inline void
+put64(unsigned char *p, uint64_t v)
+{
+	put32(p, v & 0xffffffff);
+	put32(p + 4, v >> 32);
+}
+
+static inline int
+entry_cmp(const struct mlk_pack_entry *entry,
+          const char *names,
+          uint64_t hash,
+          const char *name)
+{
+	if (entry->hash != hash)
+		return entry->hash < hash ? -1 : 1;
+
+	return strcmp(names + entry->name, name);
+}
+
+uint64_t
+mlk_pack_hash(const char *name)
+{
+	assert(name);
+
+	return mlk_util_hash(name, strlen(name));
+}
+
+int
+mlk_pack_header_decode(struct mlk_pack_header *header, const void *data, size_t datasz)
+{
+	assert(header);
+	assert(data);
+
+	const unsigned char *p = data;
+
+	if (datasz < MLK_PACK_HEADER_SIZE || memcmp(p, MLK_PACK_MAGIC, sizeof (MLK_PACK_MAGIC)) != 0)
+		return -1;
+
+	header->version  = get32(p + 8);
+	header->entriesz = get32(p + 12);
+	header->index    = get64(p + 16);
+	header->names    = get64(p + 24);
+	header->namesz   = get64(p + 32);
+
+	if (header->version != MLK_PACK_VERSION)
+		return -1;
+
+	/* Check every section fits in the file, names must be terminated. */
+	if (header->index > datasz ||
+	    (datasz - header->index) / MLK_PACK_ENTRY_SIZE < header->entriesz)
+		return -1;
+	if (header->names > datasz || datasz - header->names < header->namesz)
+		return -1;
+	if (header->namesz && p[header->names + header->namesz - 1] != '\0')
+		return -1;
+
+	return 0;
+}
+
+void
+mlk_pack_header_encode(const struct mlk_pack_header *header, void *buf)
+{
+	assert(header);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	memset(p, 0, MLK_PACK_HEADER_SIZE);
+	memcpy(p, MLK_PACK_MAGIC, sizeof (MLK_PACK_MAGIC));
+	put32(p + 8, header->version);
+	put32(p + 12, header->entriesz);
+	put64(p + 16, header->index);
+	put64(p + 24, header->names);
+	put64(p + 32, header->namesz);
+}
+
+void
+mlk_pack_entry_decode(struct mlk_pack_entry *entry, const void *buf)
+{
+	assert(entry);
+	assert(buf);
+
+	const unsigned char *p = buf;
+
+	entry->hash   = get64(p);
+	entry->offset = get64(p + 8);
+	entry->size   = get64(p + 16);
+	entry->length = get64(p + 24);
+	entry->name   = get32(p + 32);
+	entry->flags  = get32(p + 36);
+}
+
+void
+mlk_pack_entry_encode(const struct mlk_pack_entry *entry, void *buf)
+{
+	assert(entry);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	put64(p, entry->hash);
+	put64(p + 8, entry->offset);
+	put64(p + 16, entry->size);
+	put64(p + 24, entry->length);
+	put32(p + 32, entry->name);
+	put32(p + 36, entry->flags);
+}
+
+int
+mlk_pack_find(const void *data,
+              const struct mlk_pack_header *header,
+              const char *name,
+              struct mlk_pack_entry *entry)
+{
+	assert(data);
+	assert(header);
+	assert(name);
+	assert(entry);
+
+	const unsigned char *index = (const unsigned char *)data + header->index;
+	const char *names = (const char *)data + header->names;
+	const uint64_t hash = mlk_pack_hash(name);
+	size_t lo = 0, hi = header->entriesz, mid;
+	int cmp;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		mlk_pack_entry_decode(entry, index + mid * MLK_PACK_ENTRY_SIZE);
+
+		/* Corrupted name offset, stop here. */
+		if (entry->name >= header->namesz)
+			return -1;
+
+		if ((cmp = entry_cmp(entry, names, hash, name)) == 0)
+			return 0;
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return -1;
+}
@@ -0,0 +1,237 @@
+/*
+ * pack.h -- indexed asset pack format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_UTIL_PACK_H
+#define MLK_UTIL_PACK_H
+
+/**
+ * \file mlk/util/pack.h
+ * \brief Indexed asset pack format
+ *
+ * This module describes the on-disk layout of molko asset packs, it is shared
+ * between the mlk-pack tool that creates them and the mlk/core/vfs-pack.h
+ * module that reads them.
+ *
+ * A pack file is laid out as following, every integer is stored in little
+ * endian:
+ *
+ * | Section  | Alignment | Description                                  |
+ * |----------|-----------|----------------------------------------------|
+ * | header   | 0         | ::MLK_PACK_HEADER_SIZE bytes                 |
+ * | data     | 64        | entries content, each on its own alignment   |
+ * | index    | 64        | ::MLK_PACK_ENTRY_SIZE bytes per entry        |
+ * | names    | 1         | NUL terminated entry names                   |
+ *
+ * The index is sorted by entry name hash (see ::mlk_pack_hash) then by name
+ * so that entries can be found using a binary search without having to read
+ * the names except on hash collisions.
+ *
+ * Entries can be stored as-is or compressed using mlk/util/lz.h, in the former
+ * case they can be accessed directly from a memory mapped pack.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * File signature, including the NUL terminator.
+ */
+#define MLK_PACK_MAGIC          "MLKPACK"
+
+/**
+ * Current format version.
+ */
+#define MLK_PACK_VERSION        1
+
+/**
+ * Alignment of entries data in the file.
+ */
+#define MLK_PACK_ALIGN          64
+
+/**
+ * Size of the pack header in bytes.
+ */
+#define MLK_PACK_HEADER_SIZE    64
+
+/**
+ * Size of one index entry in bytes.
+ */
+#define MLK_PACK_ENTRY_SIZE     40
+
+/**
+ * \enum mlk_pack_flags
+ * \brief Per entry flags
+ */
+enum mlk_pack_flags {
+	/**
+	 * Entry is compressed using mlk/util/lz.h.
+	 */
+	MLK_PACK_LZ = (1 << 0)
+};
+
+/**
+ * \struct mlk_pack_header
+ * \brief Decoded pack header
+ */
+struct mlk_pack_header {
+	/**
+	 * Format version, must be ::MLK_PACK_VERSION.
+	 */
+	uint32_t version;
+
+	/**
+	 * Number of entries in the index.
+	 */
+	uint32_t entriesz;
+
+	/**
+	 * Offset to the index from the beginning of the file.
+	 */
+	uint64_t index;
+
+	/**
+	 * Offset to the names table from the beginning of the file.
+	 */
+	uint64_t names;
+
+	/**
+	 * Length of the names table.
+	 */
+	uint64_t namesz;
+};
+
+/**
+ * \struct mlk_pack_entry
+ * \brief Decoded index entry
+ */
+struct mlk_pack_entry {
+	/**
+	 * Hash of the entry name.
+	 */
+	uint64_t hash;
+
+	/**
+	 * Offset to the data from the beginning of the file.
+	 */
+	uint64_t offset;
+
+	/**
+	 * Stored length of data.
+	 */
+	uint64_t size;
+
+	/**
+	 * Original length of data, same as size if not compressed.
+	 */
+	uint64_t length;
+
+	/**
+	 * Offset to the entry name in the names table.
+	 */
+	uint32_t name;
+
+	/**
+	 * Entry flags (see ::mlk_pack_flags).
+	 */
+	uint32_t flags;
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Compute the hash of an entry name.
+ *
+ * \pre name != NULL
+ * \param name the entry name
+ * \return the hash
+ */
+uint64_t
+mlk_pack_hash(const char *name);
+
+/**
+ * Decode and validate the pack header and its sections boundaries.
+ *
+ * \pre header != NULL
+ * \pre data != NULL
+ * \param header the header to fill
+ * \param data the whole pack content
+ * \param datasz the pack content length
+ * \return 0 on success or -1 if the pack is invalid
+ */
+int
+mlk_pack_header_decode(struct mlk_pack_header *header, const void *data, size_t datasz);
+
+/**
+ * Encode the header into the given buffer.
+ *
+ * \pre header != NULL
+ * \pre buf != NULL
+ * \param header the header to encode
+ * \param buf the destination of ::MLK_PACK_HEADER_SIZE bytes
+ */
+void
+mlk_pack_header_encode(const struct mlk_pack_header *header, void *buf);
+
+/**
+ * Decode the index entry from the given buffer.
+ *
+ * \pre entry != NULL
+ * \pre buf != NULL
+ * \param entry the entry to fill
+ * \param buf the source of ::MLK_PACK_ENTRY_SIZE bytes
+ */
+void
+mlk_pack_entry_decode(struct mlk_pack_entry *entry, const void *buf);
+
+/**
+ * Encode the index entry into the given buffer.
+ *
+ * \pre entry != NULL
+ * \pre buf != NULL
+ * \param entry the entry to encode
+ * \param buf the destination of ::MLK_PACK_ENTRY_SIZE bytes
+ */
+void
+mlk_pack_entry_encode(const struct mlk_pack_entry *entry, void *buf);
+
+/**
+ * Find an entry using a binary search in the index.
+ *
+ * \pre data != NULL
+ * \pre header != NULL
+ * \pre name != NULL
+ * \pre entry != NULL
+ * \param data the whole pack content
+ * \param header the pack header previously decoded
+ * \param name the entry name
+ * \param entry the entry to fill if found
+ * \return 0 if found or -1 otherwise
+ */
+int
+mlk_pack_find(const void *data,
+              const struct mlk_pack_header *header,
+              const char *name,
+              struct mlk_pack_entry *entry);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_UTIL_PACK_H */
@@ -0,0 +1,103 @@
+/*
+ * rawtex.c -- pre-decoded texture format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "rawtex.h"
+
+static inline uint32_t
+get32(const unsigned char *p)
+{
+	return (uint32_t)p[0]       |
+	       (uint32_t)p[1] << 8  |
+	       (uint32_t)p[2] << 16 |
+	       (uint32_t)p[3] << 24;
+}
+
+static inline void
+put32(unsigned char *p, uint32_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
+
+int
+mlk_rawtex_match(const void *data, size_t datasz)
+{
+	assert(data);
+
+	return datasz >= MLK_RAWTEX_HEADER_SIZE &&
+	       memcmp(data, MLK_RAWTEX_MAGIC, sizeof (MLK_RAWTEX_MAGIC)) == 0;
+}
+
+int
+mlk_rawtex_header_decode(struct mlk_rawtex_header *header, const void *data, size_t datasz)
+{
+	assert(header);
+	assert(data);
+
+	const unsigned char *p = data;
+
+	if (!mlk_rawtex_match(data, datasz))
+		return -1;
+
+	header->version = get32(p + 8);
+	header->flags   = get32(p + 12);
+	header->width   = get32(p + 16);
+	header->height  = get32(p + 20);
+	header->pitch   = get32(p + 24);
+	header->size    = get32(p + 28);
+
+	if (header->version != MLK_RAWTEX_VERSION)
+		return -1;
+	if (header->width == 0 || header->height == 0)
+		return -1;
+
+	/* Rows must hold every pixel and the whole image must fit in 32 bits. */
+	if (header->pitch / MLK_RAWTEX_BPP < header->width)
+		return -1;
+	if (UINT32_MAX / header->pitch < header->height)
+		return -1;
+	if (datasz - MLK_RAWTEX_HEADER_SIZE < header->size)
+		return -1;
+	if (!(header->flags & MLK_RAWTEX_LZ) && header->size != header->pitch * header->height)
+		return -1;
+
+	return 0;
+}
+
+void
+mlk_rawtex_header_encode(const struct mlk_rawtex_header *header, void *buf)
+{
+	assert(header);
+	assert(buf);
+
+	unsigned char *p = buf;
+
+	memset(p, 0, MLK_RAWTEX_HEADER_SIZE);
+	memcpy(p, MLK_RAWTEX_MAGIC, sizeof (MLK_RAWTEX_MAGIC));
+	put32(p + 8, header->version);
+	put32(p + 12, header->flags);
+	put32(p + 16, header->width);
+	put32(p + 20, header->height);
+	put32(p + 24, header->pitch);
+	put32(p + 28, header->size);
+}
@@ -0,0 +1,159 @@
+/*
+ * rawtex.h -- pre-decoded texture format
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MLK_UTIL_RAWTEX_H
+#define MLK_UTIL_RAWTEX_H
+
+/**
+ * \file mlk/util/rawtex.h
+ * \brief Pre-decoded texture format
+ *
+ * This module describes a texture format holding pixels ready to be uploaded
+ * as-is to the renderer, it is shared between the mlk-rawtex tool that
+ * converts images at build time and the mlk/core/image.h module that loads
+ * them.
+ *
+ * Pixels are stored as 8 bits per channel in R, G, B, A byte order with alpha
+ * pre-multiplied, rows are ::mlk_rawtex_header::pitch bytes apart. They can be
+ * compressed using mlk/util/lz.h, trading a fast decompression for a smaller
+ * file than raw pixels but still larger than PNG.
+ *
+ * A raw texture file is laid out as following, every integer is stored in
+ * little endian:
+ *
+ * | Section  | Description                                          |
+ * |----------|------------------------------------------------------|
+ * | header   | ::MLK_RAWTEX_HEADER_SIZE bytes                       |
+ * | pixels   | ::mlk_rawtex_header::size bytes, possibly compressed |
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * File signature, including the NUL terminator.
+ */
+#define MLK_RAWTEX_MAGIC        "MLKTEX"
+
+/**
+ * Current format version.
+ */
+#define MLK_RAWTEX_VERSION      1
+
+/**
+ * Size of the header in bytes.
+ */
+#define MLK_RAWTEX_HEADER_SIZE  32
+
+/**
+ * Number of bytes per pixel.
+ */
+#define MLK_RAWTEX_BPP          4
+
+/**
+ * \enum mlk_rawtex_flags
+ * \brief Texture flags
+ */
+enum mlk_rawtex_flags {
+	/**
+	 * Pixels are compressed using mlk/util/lz.h.
+	 */
+	MLK_RAWTEX_LZ = (1 << 0)
+};
+
+/**
+ * \struct mlk_rawtex_header
+ * \brief Decoded texture header
+ */
+struct mlk_rawtex_header {
+	/**
+	 * Format version, must be ::MLK_RAWTEX_VERSION.
+	 */
+	uint32_t version;
+
+	/**
+	 * Texture flags (see ::mlk_rawtex_flags).
+	 */
+	uint32_t flags;
+
+	/**
+	 * Texture width in pixels.
+	 */
+	uint32_t width;
+
+	/**
+	 * Texture height in pixels.
+	 */
+	uint32_t height;
+
+	/**
+	 * Length of a row of pixels in bytes, the uncompressed pixels take
+	 * pitch * height bytes.
+	 */
+	uint32_t pitch;
+
+	/**
+	 * Stored length of pixels following the header.
+	 */
+	uint32_t size;
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Tells if the data starts with a raw texture signature.
+ *
+ * \pre data != NULL
+ * \param data the file content
+ * \param datasz the file content length
+ * \return non-zero if the data looks like a raw texture
+ */
+int
+mlk_rawtex_match(const void *data, size_t datasz);
+
+/**
+ * Decode and validate the header and the pixels boundaries.
+ *
+ * \pre header != NULL
+ * \pre data != NULL
+ * \param header the header to fill
+ * \param data the whole file content
+ * \param datasz the file content length
+ * \return 0 on success or -1 if the texture is invalid
+ */
+int
+mlk_rawtex_header_decode(struct mlk_rawtex_header *header, const void *data, size_t datasz);
+
+/**
+ * Encode the header into the given buffer.
+ *
+ * \pre header != NULL
+ * \pre buf != NULL
+ * \param header the header to encode
+ * \param buf the destination of ::MLK_RAWTEX_HEADER_SIZE bytes
+ */
+void
+mlk_rawtex_header_encode(const struct mlk_rawtex_header *header, void *buf);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !MLK_UTIL_RAWTEX_H */
@@ -31,10 +31,12 @@
 
 #cmakedefine MLK_HAVE_DIRENT_H
 #cmakedefine MLK_HAVE_LIBGEN_H
+#cmakedefine MLK_HAVE_SYS_MMAN_H
 
 #cmakedefine MLK_HAVE_BASENAME
 #cmakedefine MLK_HAVE_DIRNAME
 #cmakedefine MLK_HAVE_FMEMOPEN
+#cmakedefine MLK_HAVE_MMAP
 #cmakedefine MLK_HAVE_STRLCAT
 #cmakedefine MLK_HAVE_STRLCPY
 
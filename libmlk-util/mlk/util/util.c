@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "util.h"
+
 void
 mlk_util_die(const char *fmt, ...)
 {
@@ -33,3 +35,19 @@ mlk_util_die(const char *fmt, ...)
 	va_end(ap);
 	exit(1);
 }
+
+uint64_t
+mlk_util_hash(const void *data, size_t size)
+{
+	assert(data || size == 0);
+
+	const unsigned char *p = data;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= p[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
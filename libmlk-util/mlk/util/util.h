@@ -27,6 +27,8 @@
 #include "sysconfig.h"
 
 #include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #if defined(__cplusplus)
@@ -94,6 +96,49 @@ mlk_util_basename(char *);
 char *
 mlk_util_dirname(char *);
 
+/**
+ * Compute a 64 bits FNV-1a hash of the given data.
+ *
+ * This hash is used by several file formats (e.g. asset packs) and must be
+ * kept stable across versions.
+ *
+ * \pre data != NULL || size == 0
+ * \param data the data to hash
+ * \param size the data length
+ * \return the hash value
+ */
+uint64_t
+mlk_util_hash(const void *data, size_t size);
+
+/**
+ * Map a whole file in memory for reading.
+ *
+ * On systems with [mmap] the file is mapped read-only, otherwise its content
+ * is loaded in a dynamically allocated buffer. In both cases the returned
+ * pointer must be released using ::mlk_util_munmap.
+ *
+ * The returned memory must never be written to.
+ *
+ * \pre path != NULL
+ * \pre size != NULL
+ * \param path path to the file
+ * \param size pointer receiving the file length
+ * \return the file content or NULL on error (errno is set)
+ *
+ * [mmap]: https://pubs.opengroup.org/onlinepubs/9699919799/functions/mmap.html
+ */
+void *
+mlk_util_mmap(const char *path, size_t *size);
+
+/**
+ * Release memory obtained using ::mlk_util_mmap.
+ *
+ * \param data the file content (may be NULL)
+ * \param size the file length as returned by ::mlk_util_mmap
+ */
+void
+mlk_util_munmap(void *data, size_t size);
+
 extern int mlk_util_opterr;
 extern int mlk_util_optind;
 extern int mlk_util_optopt;
@@ -22,17 +22,42 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <mlk/util/dir.h>
+#include <mlk/util/util.h>
+
 #include "arg.h"
 
+#define COLUMNS 12
+
+/* Alignment of every file in directory mode. */
+#define ALIGN 16
+
+struct file {
+	char *name;
+	char *path;
+	long offset;
+	long size;
+};
+
+enum mode {
+	MODE_HEX,
+	MODE_EMBED,
+	MODE_INCBIN
+};
+
 static const char *charset = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
 static const char *ftype = "unsigned char";
 static char findentchar = '\t';
-static int findent = 1, fconst, fnull, fstatic;
+static int findent = 1, fconst, fdirectory, fnull, fstatic;
+static enum mode fmode = MODE_HEX;
+static struct file *files;
+static size_t filesz;
 
 static void
 usage(void)
 {
-	fprintf(stderr, "usage: bcc [-0cs] [-I tab-num] [-i space-num] [-t type] input variable\n");
+	fprintf(stderr, "usage: bcc [-0cs] [-I tab-num] [-i space-num] [-m mode] [-t type] input variable\n");
+	fprintf(stderr, "       bcc -d [-cs] [-I tab-num] [-i space-num] [-m mode] directory variable\n");
 	exit(1);
 }
 
@@ -48,6 +73,21 @@ die(const char *fmt, ...)
 	exit(1);
 }
 
+static enum mode
+mode(const char *name)
+{
+	if (strcmp(name, "hex") == 0)
+		return MODE_HEX;
+	if (strcmp(name, "embed") == 0)
+		return MODE_EMBED;
+	if (strcmp(name, "incbin") == 0)
+		return MODE_INCBIN;
+
+	die("%s: invalid mode\n", name);
+
+	return MODE_HEX;
+}
+
 static char *
 mangle(char *variable)
 {
@@ -73,57 +113,497 @@ indent(void)
 }
 
 static void
-put(int ch)
+qualifiers(void)
 {
-	printf("0x%02hhx", (unsigned char)ch);
+	if (fstatic)
+		printf("static ");
+	if (fconst)
+		printf("const ");
 }
 
-static void
-process(const char *input, const char *variable)
+static FILE *
+openfile(const char *input)
 {
 	FILE *fp;
-	int ch, col = 0;
 
 	if (strcmp(input, "-") == 0)
-		fp = stdin;
-	else if (!(fp = fopen(input, "rb")))
+		return stdin;
+	if (!(fp = fopen(input, "rb")))
 		die("%s: %s\n", input, strerror(errno));
 
-	if (fstatic)
-		printf("static ");
+	return fp;
+}
+
+static long
+length(const char *input)
+{
+	FILE *fp;
+	long size;
+
+	fp = openfile(input);
+
+	if (fseek(fp, 0, SEEK_END) < 0 || (size = ftell(fp)) < 0)
+		die("%s: %s\n", input, strerror(errno));
+
+	fclose(fp);
+
+	return size;
+}
+
+static void
+check_path(const char *input)
+{
+	if (strcmp(input, "-") == 0)
+		die("standard input can not be used in this mode\n");
+	if (strpbrk(input, "\"\n"))
+		die("%s: invalid file name for this mode\n", input);
+}
+
+/*
+ * Textual list of bytes, this is the most portable mode but also the slowest
+ * to compile. Lines are formatted in a buffer and written at once rather than
+ * printing every byte.
+ */
+static struct {
+	char *line;
+	char *p;
+	size_t col;
+	size_t count;
+} hex;
+
+static void
+hex_begin(void)
+{
+	/* Indentation, every byte as "0xNN, " and the newline. */
+	if (!(hex.line = hex.p = malloc(findent + COLUMNS * 6 + 2)))
+		die("%s\n", strerror(errno));
+
+	hex.col = hex.count = 0;
+}
+
+static void
+hex_put(const unsigned char *data, size_t datasz)
+{
+	static const char digits[] = "0123456789abcdef";
+
+	for (size_t i = 0; i < datasz; ++i) {
+		if (hex.count++ != 0) {
+			*hex.p++ = ',';
+
+			if (hex.col == 0) {
+				*hex.p++ = '\n';
+				fwrite(hex.line, 1, hex.p - hex.line, stdout);
+				hex.p = hex.line;
+			} else
+				*hex.p++ = ' ';
+		}
+
+		if (hex.col == 0)
+			for (int n = 0; n < findent; ++n)
+				*hex.p++ = findentchar;
+
+		*hex.p++ = '0';
+		*hex.p++ = 'x';
+		*hex.p++ = digits[data[i] >> 4];
+		*hex.p++ = digits[data[i] & 0xf];
+
+		hex.col = (hex.col + 1) % COLUMNS;
+	}
+}
+
+static void
+hex_file(const char *input)
+{
+	unsigned char in[BUFSIZ * 8];
+	size_t nr;
+	FILE *fp;
+
+	fp = openfile(input);
+
+	while ((nr = fread(in, 1, sizeof (in), fp)) > 0)
+		hex_put(in, nr);
+
+	if (ferror(fp))
+		die("%s: %s\n", input, strerror(errno));
+	if (fp != stdin)
+		fclose(fp);
+}
+
+static void
+hex_end(void)
+{
+	if (hex.count != 0) {
+		*hex.p++ = '\n';
+		fwrite(hex.line, 1, hex.p - hex.line, stdout);
+	}
+
+	free(hex.line);
+	hex.line = hex.p = NULL;
+}
+
+static void
+process_hex(const char *input, const char *variable)
+{
+	qualifiers();
+	printf("%s %s[] = {\n", ftype, variable);
+
+	hex_begin();
+	hex_file(input);
+
+	/* Add final '\0' if required. */
+	if (fnull)
+		hex_put((const unsigned char []) { 0 }, 1);
+
+	hex_end();
+	puts("};");
+}
+
+/*
+ * Use the C23 #embed directive, the compiler reads the file itself.
+ */
+static void
+process_embed(const char *input, const char *variable)
+{
+	check_path(input);
+
+	qualifiers();
+	printf("%s %s[] = {\n", ftype, variable);
+	indent();
+	printf("#embed \"%s\"%s\n", input, fnull ? " suffix(, 0) if_empty(0)" : "");
+	puts("};");
+}
+
+static void
+put_asm_path(const char *input)
+{
+	/* Escaped twice, once for the C string and once for the assembler. */
+	for (; *input; ++input) {
+		if (*input == '\\')
+			fputs("\\\\\\\\", stdout);
+		else
+			putchar(*input);
+	}
+}
+
+/*
+ * Use the assembler .incbin directive through a top level asm statement, the
+ * array is declared with an explicit assembler name so that no platform
+ * specific symbol prefix is required.
+ */
+static void
+process_incbin(const char *input, const char *variable)
+{
+	long size;
+
+	check_path(input);
+	size = length(input) + (fnull ? 1 : 0);
+
+	puts("__asm__(");
+	puts("#if defined(__APPLE__)");
+	indent();
+	printf("\"%s\\n\"\n", fconst ? ".const_data" : ".data");
+	puts("#else");
+	indent();
+	printf("\".section %s\\n\"\n", fconst ? ".rodata" : ".data");
+	puts("#endif");
+
+	if (!fstatic) {
+		indent();
+		printf("\".globl %s\\n\"\n", variable);
+	}
+
+	indent();
+	puts("\".balign 16\\n\"");
+	indent();
+	printf("\"%s:\\n\"\n", variable);
+	indent();
+	printf("\".incbin \\\"");
+	put_asm_path(input);
+	printf("\\\"\\n\"\n");
+
+	if (fnull) {
+		indent();
+		puts("\".byte 0\\n\"");
+	}
+
+	indent();
+	puts("\".text\\n\"");
+	puts(");");
+	puts("");
+
+	/* Static arrays are local labels, the assembler resolves them. */
+	printf("extern ");
+
 	if (fconst)
 		printf("const ");
 
-	printf("%s %s[] = {\n", ftype, variable);
+	printf("%s %s[%ld] __asm__(\"%s\");\n", ftype, variable, size, variable);
+}
 
-	for (ch = fgetc(fp); ch != EOF; ) {
-		if (col == 0)
-			indent();
+static void
+xsnprintf(char *buf, size_t bufsz, const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = vsnprintf(buf, bufsz, fmt, ap);
+	va_end(ap);
 
-		put(ch);
+	if (ret < 0)
+		die("%s\n", strerror(errno));
+	if ((size_t)ret >= bufsz)
+		die("%s: path too long\n", buf);
+}
 
-		if ((ch = fgetc(fp)) != EOF || fnull)
-			printf(",%s", col < 3 ? " " : "");
+static char *
+xstrdup(const char *str)
+{
+	char *ret;
 
-		if (++col == 4) {
-			col = 0;
-			putchar('\n');
-		}
+	if (!(ret = strdup(str)))
+		die("%s\n", strerror(errno));
+
+	return ret;
+}
+
+static void
+add(const char *root, const char *name)
+{
+	char path[MLK_PATH_MAX];
+	struct file *file;
+
+	xsnprintf(path, sizeof (path), "%s/%s", root, name);
+
+	if (!(files = realloc(files, (filesz + 1) * sizeof (*files))))
+		die("%s\n", strerror(errno));
+
+	file = &files[filesz++];
+	file->name = xstrdup(name);
+	file->path = xstrdup(path);
+	file->size = length(path);
+}
+
+static void
+walk(const char *root, const char *prefix)
+{
+	struct mlk_dir iter, sub;
+	char path[MLK_PATH_MAX], name[MLK_PATH_MAX];
+
+	if (prefix)
+		xsnprintf(path, sizeof (path), "%s/%s", root, prefix);
+	else
+		xsnprintf(path, sizeof (path), "%s", root);
+
+	if (mlk_dir_open(&iter, path) < 0)
+		die("%s: %s\n", path, strerror(errno));
 
-		/* Add final '\0' if required. */
-		if (ch == EOF && fnull) {
-			if (col++ == 0)
-				indent();
+	while (mlk_dir_next(&iter)) {
+		if (prefix)
+			xsnprintf(name, sizeof (name), "%s/%s", prefix, iter.entry);
+		else
+			xsnprintf(name, sizeof (name), "%s", iter.entry);
 
-			put(0);
+		xsnprintf(path, sizeof (path), "%s/%s", root, name);
+
+		/* There is no portable stat, try to open it as a directory. */
+		if (mlk_dir_open(&sub, path) == 0) {
+			mlk_dir_finish(&sub);
+			walk(root, name);
+		} else
+			add(root, name);
+	}
+}
+
+static int
+cmp(const void *d1, const void *d2)
+{
+	const struct file *f1 = d1, *f2 = d2;
+
+	return strcmp(f1->name, f2->name);
+}
+
+static void
+put_string(const char *str)
+{
+	putchar('"');
+
+	for (; *str; ++str) {
+		if (*str == '"' || *str == '\\')
+			printf("\\%c", *str);
+		else if ((unsigned char)*str < 0x20 || (unsigned char)*str >= 0x7f)
+			printf("\\%03o", (unsigned char)*str);
+		else
+			putchar(*str);
+	}
+
+	putchar('"');
+}
+
+static void
+blob_hex(const char *variable)
+{
+	static const unsigned char zero[ALIGN];
+
+	qualifiers();
+	printf("_Alignas(%d) unsigned char %s_data[] = {\n", ALIGN, variable);
+	hex_begin();
+
+	for (size_t i = 0; i < filesz; ++i) {
+		hex_put(zero, files[i].offset - hex.count);
+		hex_file(files[i].path);
+	}
+
+	hex_end();
+	puts("};");
+}
+
+static void
+blob_embed(const char *variable)
+{
+	long offset = 0;
+
+	qualifiers();
+	printf("_Alignas(%d) unsigned char %s_data[] = {\n", ALIGN, variable);
+
+	/* Trailing commas are allowed in initializers, always add one. */
+	for (size_t i = 0; i < filesz; ++i) {
+		/* Empty files don't produce anything, skip them. */
+		if (files[i].size == 0)
+			continue;
+
+		if (offset != files[i].offset) {
+			indent();
+
+			for (; offset < files[i].offset; ++offset)
+				printf("0,%s", offset + 1 < files[i].offset ? " " : "\n");
 		}
+
+		printf("#embed \"%s\" suffix(,)\n", files[i].path);
+		offset += files[i].size;
+	}
+
+	puts("};");
+}
+
+static void
+blob_incbin(const char *variable, long total)
+{
+	puts("__asm__(");
+	puts("#if defined(__APPLE__)");
+	indent();
+	printf("\"%s\\n\"\n", fconst ? ".const_data" : ".data");
+	puts("#else");
+	indent();
+	printf("\".section %s\\n\"\n", fconst ? ".rodata" : ".data");
+	puts("#endif");
+
+	if (!fstatic) {
+		indent();
+		printf("\".globl %s_data\\n\"\n", variable);
+	}
+
+	indent();
+	printf("\".balign %d\\n\"\n", ALIGN);
+	indent();
+	printf("\"%s_data:\\n\"\n", variable);
+
+	for (size_t i = 0; i < filesz; ++i) {
+		if (files[i].size == 0)
+			continue;
+
+		indent();
+		printf("\".balign %d\\n\"\n", ALIGN);
+		indent();
+		printf("\".incbin \\\"");
+		put_asm_path(files[i].path);
+		printf("\\\"\\n\"\n");
+	}
+
+	indent();
+	puts("\".text\\n\"");
+	puts(");");
+	puts("");
+
+	printf("extern ");
+
+	if (fconst)
+		printf("const ");
+
+	printf("unsigned char %s_data[%ld] __asm__(\"%s_data\");\n", variable, total, variable);
+}
+
+/*
+ * Pack a whole directory into a single aligned array and a table of entries
+ * sorted by name, suitable for mlk/core/vfs-blob.h.
+ */
+static void
+process_directory(const char *directory, const char *variable)
+{
+	long offset = 0;
+
+	walk(directory, NULL);
+	qsort(files, filesz, sizeof (*files), cmp);
+
+	for (size_t i = 0; i < filesz; ++i) {
+		if (fmode != MODE_HEX)
+			check_path(files[i].path);
+
+		/* Empty files are not aligned to stay within the array. */
+		if (files[i].size)
+			offset = (offset + ALIGN - 1) / ALIGN * ALIGN;
+
+		files[i].offset = offset;
+		offset += files[i].size;
+	}
+
+	puts("#include <mlk/core/vfs-blob.h>");
+	puts("");
+
+	switch (fmode) {
+	case MODE_EMBED:
+		blob_embed(variable);
+		break;
+	case MODE_INCBIN:
+		blob_incbin(variable, offset);
+		break;
+	default:
+		blob_hex(variable);
+		break;
 	}
 
-	if (col != 0)
-		printf("\n");
+	puts("");
+	qualifiers();
+	printf("struct mlk_vfs_blob_entry %s_entries[] = {\n", variable);
+
+	for (size_t i = 0; i < filesz; ++i) {
+		indent();
+		printf("{ ");
+		put_string(files[i].name);
+		printf(", %ld, %ld }%s\n", files[i].offset, files[i].size, i + 1 < filesz ? "," : "");
+
+		free(files[i].name);
+		free(files[i].path);
+	}
 
 	puts("};");
-	fclose(fp);
+	free(files);
+}
+
+static void
+process(const char *input, const char *variable)
+{
+	switch (fmode) {
+	case MODE_EMBED:
+		process_embed(input, variable);
+		break;
+	case MODE_INCBIN:
+		process_incbin(input, variable);
+		break;
+	default:
+		process_hex(input, variable);
+		break;
+	}
 }
 
 int
@@ -141,6 +621,9 @@ main(int argc, char *argv[])
 	case 'c':
 		fconst = 1;
 		break;
+	case 'd':
+		fdirectory = 1;
+		break;
 	case 'I':
 		findentchar = '\t';
 		findent = atoi(EARGF(usage()));
@@ -149,6 +632,9 @@ main(int argc, char *argv[])
 		findentchar = ' ';
 		findent = atoi(EARGF(usage()));
 		break;
+	case 'm':
+		fmode = mode(EARGF(usage()));
+		break;
 	case 's':
 		fstatic = 1;
 		break;
@@ -163,5 +649,8 @@ main(int argc, char *argv[])
 	if (argc < 2)
 		usage();
 
-	process(argv[0], mangle(argv[1]));
+	if (fdirectory)
+		process_directory(argv[0], mangle(argv[1]));
+	else
+		process(argv[0], mangle(argv[1]));
 }
@@ -17,14 +17,65 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <jansson.h>
 
+#include <mlk/util/mapbin.h>
 #include <mlk/util/util.h>
 
+/*
+ * Compiled map being built when -b is given, see mlk/util/mapbin.h.
+ */
+static struct {
+	struct mlk_mapbin_header header;
+	uint32_t *tiles[3];
+	struct mlk_mapbin_block *blocks;
+	struct mlk_mapbin_object *objects;
+	char *strings;
+} bin;
+
+static int fbinary;
+
+static void
+usage(void)
+{
+	fprintf(stderr, "usage: mlk-map [-b] < input > output\n");
+	exit(1);
+}
+
+static void *
+xrealloc(void *ptr, size_t n, size_t w)
+{
+	/* realloc(ptr, 0) may return NULL. */
+	if (!(ptr = realloc(ptr, n && w ? n * w : 1)))
+		mlk_util_die("abort: %s\n", strerror(errno));
+
+	return ptr;
+}
+
+static uint32_t
+intern(const char *str)
+{
+	const size_t len = strlen(str);
+	uint32_t offset;
+
+	/* The empty string is always at the beginning. */
+	if (len == 0)
+		return 0;
+
+	offset = bin.header.stringsz;
+	bin.strings = xrealloc(bin.strings, offset + len + 1, 1);
+	memcpy(bin.strings + offset, str, len + 1);
+	bin.header.stringsz += len + 1;
+
+	return offset;
+}
+
 static inline int
 is_layer(const char *name)
 {
@@ -66,6 +117,12 @@ write_player_origin(const json_t *props)
 	    !y || !json_is_integer(y))
 		return;
 
+	if (fbinary) {
+		bin.header.player_x = (int32_t)json_integer_value(x);
+		bin.header.player_y = (int32_t)json_integer_value(y);
+		return;
+	}
+
 	printf("player-origin|%d|%d\n",
 	    (int)json_integer_value(x),
 	    (int)json_integer_value(y));
@@ -85,6 +142,13 @@ write_player_sprite(const json_t *props)
 	    !h      || !json_is_integer(h))
 		return;
 
+	if (fbinary) {
+		bin.header.player_w = (uint32_t)json_integer_value(w);
+		bin.header.player_h = (uint32_t)json_integer_value(h);
+		bin.header.player_sprite = intern(json_string_value(sprite));
+		return;
+	}
+
 	printf("player-sprite|%d|%d|%s\n",
 	    (int)json_integer_value(w),
 	    (int)json_integer_value(h),
@@ -112,10 +176,45 @@ write_dimensions(const json_t *document)
 	if (!height || !json_is_integer(height))
 		mlk_util_die("missing 'height' property\n");
 
+	if (fbinary) {
+		bin.header.columns = (uint32_t)json_integer_value(width);
+		bin.header.rows = (uint32_t)json_integer_value(height);
+		return;
+	}
+
 	printf("columns|%d\n", (int)json_integer_value(width));
 	printf("rows|%d\n", (int)json_integer_value(height));
 }
 
+static void
+write_object_binary(const json_t *x,
+                    const json_t *y,
+                    const json_t *width,
+                    const json_t *height,
+                    const json_t *block,
+                    const json_t *exec)
+{
+	struct mlk_mapbin_object *object;
+	struct mlk_mapbin_block *b;
+
+	bin.objects = xrealloc(bin.objects, bin.header.objectsz + 1, sizeof (*bin.objects));
+	object = &bin.objects[bin.header.objectsz++];
+	object->x = (int32_t)json_integer_value(x);
+	object->y = (int32_t)json_integer_value(y);
+	object->w = (uint32_t)json_integer_value(width);
+	object->h = (uint32_t)json_integer_value(height);
+	object->exec = json_is_string(exec) ? intern(json_string_value(exec)) : 0;
+
+	if (json_is_true(block)) {
+		bin.blocks = xrealloc(bin.blocks, bin.header.blocksz + 1, sizeof (*bin.blocks));
+		b = &bin.blocks[bin.header.blocksz++];
+		b->x = object->x;
+		b->y = object->y;
+		b->w = object->w;
+		b->h = object->h;
+	}
+}
+
 static void
 write_object(const json_t *object)
 {
@@ -140,6 +239,12 @@ write_object(const json_t *object)
 
 	/* This is optional and set to 0 if not present. */
 	block = find_property(props, "block");
+	exec = find_property(props, "exec");
+
+	if (fbinary) {
+		write_object_binary(x, y, width, height, block, exec);
+		return;
+	}
 
 	/* In tiled, those properties are float but we only use ints in MA */
 	printf("%d|%d|%d|%d|%d",
@@ -150,12 +255,44 @@ write_object(const json_t *object)
 	    (int)json_is_true(block)
 	);
 
-	if ((exec = find_property(props, "exec")) && json_is_string(exec))
+	if (json_is_string(exec))
 		printf("|%s", json_string_value(exec));
 
 	printf("\n");
 }
 
+static void
+write_tiles_binary(const char *name, const json_t *data)
+{
+	static const char *names[] = { "background", "foreground", "above" };
+	const json_t *tile;
+	size_t index, layer;
+	uint32_t *tiles;
+
+	for (layer = 0; layer < sizeof (names) / sizeof (names[0]); ++layer)
+		if (strcmp(names[layer], name) == 0)
+			break;
+
+	if (layer >= sizeof (names) / sizeof (names[0]))
+		return;
+	if (bin.header.columns == 0 || bin.header.rows == 0)
+		mlk_util_die("missing map dimensions before layer\n");
+	if (json_array_size(data) != (size_t)bin.header.columns * bin.header.rows)
+		mlk_util_die("invalid 'data' length in layer %s\n", name);
+
+	tiles = xrealloc(bin.tiles[layer], json_array_size(data), sizeof (*tiles));
+
+	json_array_foreach(data, index, tile) {
+		if (!json_is_integer(tile))
+			mlk_util_die("invalid 'data' property in layer\n");
+
+		tiles[index] = (uint32_t)json_integer_value(tile);
+	}
+
+	bin.tiles[layer] = tiles;
+	bin.header.layers |= 1U << layer;
+}
+
 static void
 write_layer(const json_t *layer)
 {
@@ -171,10 +308,13 @@ write_layer(const json_t *layer)
 	if (!is_layer(json_string_value(name)))
 		mlk_util_die("invalid 'name' layer: %s\n", json_string_value(name));
 
-	printf("layer|%s\n", json_string_value(name));
+	if (!fbinary)
+		printf("layer|%s\n", json_string_value(name));
 
 	/* Only foreground/background have 'data' property */
-	if (json_is_array(data)) {
+	if (fbinary && json_is_array(data))
+		write_tiles_binary(json_string_value(name), data);
+	else if (json_is_array(data)) {
 		json_array_foreach(data, index, tile) {
 			if (!json_is_integer(tile))
 				mlk_util_die("invalid 'data' property in layer\n");
@@ -214,14 +354,14 @@ write_layers(const json_t *layers)
 static void
 write_tileset(const json_t *tilesets)
 {
-	char path[MLK_PATH_MAX], *ext;
-	const json_t *tileset, *source;
+	char path[MLK_PATH_MAX], tileset[MLK_PATH_MAX + 8], *ext;
+	const json_t *ts, *source;
 
 	if (json_array_size(tilesets) != 1)
 		mlk_util_die("map must contain exactly one tileset");
 
-	tileset = json_array_get(tilesets, 0);
-	source = json_object_get(tileset, "source");
+	ts = json_array_get(tilesets, 0);
+	source = json_object_get(ts, "source");
 
 	if (!json_is_string(source))
 		mlk_util_die("invalid 'source' property in tileset\n");
@@ -234,14 +374,80 @@ write_tileset(const json_t *tilesets)
 
 	*ext = '\0';
 
-	printf("tileset|%s.tileset\n", path);
+	if (fbinary) {
+		snprintf(tileset, sizeof (tileset), "%s.tileset", path);
+		bin.header.tileset = intern(tileset);
+	} else
+		printf("tileset|%s.tileset\n", path);
+}
+
+static void
+write_binary(void)
+{
+	unsigned char buf[MLK_MAPBIN_HEADER_SIZE];
+	const size_t ntiles = (size_t)bin.header.columns * bin.header.rows;
+
+	bin.header.version = MLK_MAPBIN_VERSION;
+	mlk_mapbin_header_encode(&bin.header, buf);
+	fwrite(buf, 1, sizeof (buf), stdout);
+
+	for (size_t l = 0; l < sizeof (bin.tiles) / sizeof (bin.tiles[0]); ++l) {
+		if (!bin.tiles[l])
+			continue;
+
+		for (size_t i = 0; i < ntiles; ++i) {
+			mlk_mapbin_tile_encode(bin.tiles[l][i], buf);
+			fwrite(buf, 1, 4, stdout);
+		}
+	}
+
+	for (size_t i = 0; i < bin.header.blocksz; ++i) {
+		mlk_mapbin_block_encode(&bin.blocks[i], buf);
+		fwrite(buf, 1, MLK_MAPBIN_BLOCK_SIZE, stdout);
+	}
+
+	for (size_t i = 0; i < bin.header.objectsz; ++i) {
+		mlk_mapbin_object_encode(&bin.objects[i], buf);
+		fwrite(buf, 1, MLK_MAPBIN_OBJECT_SIZE, stdout);
+	}
+
+	fwrite(bin.strings, 1, bin.header.stringsz, stdout);
+
+	if (fflush(stdout) == EOF || ferror(stdout))
+		mlk_util_die("abort: %s\n", strerror(errno));
+
+	for (size_t l = 0; l < sizeof (bin.tiles) / sizeof (bin.tiles[0]); ++l)
+		free(bin.tiles[l]);
+
+	free(bin.blocks);
+	free(bin.objects);
+	free(bin.strings);
 }
 
 int
-main(void)
+main(int argc, char **argv)
 {
 	json_t *document;
 	json_error_t error;
+	int ch;
+
+	while ((ch = mlk_util_getopt(argc, argv, "b")) != -1) {
+		switch (ch) {
+		case 'b':
+			fbinary = 1;
+			break;
+		default:
+			usage();
+			break;
+		}
+	}
+
+	/* Strings section always starts with the empty string. */
+	if (fbinary) {
+		bin.strings = xrealloc(NULL, 1, 1);
+		bin.strings[0] = '\0';
+		bin.header.stringsz = 1;
+	}
 
 	document = json_loadf(stdin, 0, &error);
 
@@ -253,5 +459,8 @@ main(void)
 	write_layers(json_object_get(document, "layers"));
 	write_tileset(json_object_get(document, "tilesets"));
 
+	if (fbinary)
+		write_binary();
+
 	json_decref(document);
 }
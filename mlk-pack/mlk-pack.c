@@ -0,0 +1,300 @@
+/*
+ * mlk-pack.c -- create indexed asset packs
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/pack.h>
+#include <mlk/util/util.h>
+
+struct file {
+	char *name;
+	unsigned char *data;
+	size_t size;
+	size_t length;
+	unsigned int flags;
+	uint64_t hash;
+	uint64_t offset;
+};
+
+static const char *fdirectory;
+static int fcompress;
+
+static void
+usage(void)
+{
+	fprintf(stderr, "usage: mlk-pack [-z] [-C directory] output file...\n");
+	fprintf(stderr, "       mlk-pack -t input\n");
+	exit(1);
+}
+
+static void *
+xalloc(size_t size)
+{
+	void *ptr;
+
+	/* malloc(0) may return NULL. */
+	if (!(ptr = malloc(size ? size : 1)))
+		mlk_util_die("abort: %s\n", strerror(errno));
+
+	return ptr;
+}
+
+static unsigned char *
+slurp(const char *path, size_t *size)
+{
+	FILE *fp;
+	unsigned char *data = NULL;
+	size_t cap = 0, nr;
+
+	if (!(fp = fopen(path, "rb")))
+		mlk_util_die("abort: %s: %s\n", path, strerror(errno));
+
+	*size = 0;
+
+	do {
+		if (*size == cap) {
+			cap = cap ? cap * 2 : BUFSIZ;
+
+			if (!(data = realloc(data, cap)))
+				mlk_util_die("abort: %s\n", strerror(errno));
+		}
+
+		nr = fread(data + *size, 1, cap - *size, fp);
+		*size += nr;
+	} while (nr != 0);
+
+	if (ferror(fp))
+		mlk_util_die("abort: %s: %s\n", path, strerror(errno));
+
+	fclose(fp);
+
+	return data;
+}
+
+static void
+compress(struct file *f)
+{
+	unsigned char *out;
+	size_t outsz;
+
+	out = xalloc(mlk_lz_bound(f->length));
+	outsz = mlk_lz_compress(f->data, f->length, out, mlk_lz_bound(f->length));
+
+	/* Only keep the compressed version if it is worth it. */
+	if (outsz != 0 && outsz < f->length) {
+		free(f->data);
+		f->data = out;
+		f->size = outsz;
+		f->flags |= MLK_PACK_LZ;
+	} else
+		free(out);
+}
+
+static void
+load(struct file *f, const char *name)
+{
+	char path[MLK_PATH_MAX];
+
+	if (fdirectory)
+		snprintf(path, sizeof (path), "%s/%s", fdirectory, name);
+	else
+		snprintf(path, sizeof (path), "%s", name);
+
+	/* Entries are always looked up without leading "./". */
+	while (strncmp(name, "./", 2) == 0)
+		name += 2;
+
+	if (!(f->name = strdup(name)))
+		mlk_util_die("abort: %s\n", strerror(errno));
+
+	f->data = slurp(path, &f->length);
+	f->size = f->length;
+	f->hash = mlk_pack_hash(f->name);
+
+	if (fcompress)
+		compress(f);
+}
+
+static int
+cmp(const void *d1, const void *d2)
+{
+	const struct file *f1 = d1, *f2 = d2;
+
+	if (f1->hash != f2->hash)
+		return f1->hash < f2->hash ? -1 : 1;
+
+	return strcmp(f1->name, f2->name);
+}
+
+static void
+pad(FILE *fp, uint64_t *offset)
+{
+	while (*offset % MLK_PACK_ALIGN) {
+		fputc(0, fp);
+		*offset += 1;
+	}
+}
+
+static void
+create(const char *output, int argc, char **argv)
+{
+	struct file *files;
+	struct mlk_pack_header header = {
+		.version = MLK_PACK_VERSION,
+		.entriesz = argc
+	};
+	struct mlk_pack_entry entry;
+	unsigned char buf[MLK_PACK_HEADER_SIZE];
+	uint64_t offset = MLK_PACK_HEADER_SIZE;
+	uint32_t name = 0;
+	FILE *fp;
+
+	files = xalloc(sizeof (*files) * argc);
+
+	for (int i = 0; i < argc; ++i)
+		load(&files[i], argv[i]);
+
+	qsort(files, argc, sizeof (*files), cmp);
+
+	for (int i = 1; i < argc; ++i)
+		if (cmp(&files[i - 1], &files[i]) == 0)
+			mlk_util_die("abort: %s: duplicate entry\n", files[i].name);
+
+	if (!(fp = fopen(output, "wb")))
+		mlk_util_die("abort: %s: %s\n", output, strerror(errno));
+
+	/* Header is rewritten once the sections are known. */
+	fwrite(buf, 1, sizeof (buf), fp);
+
+	for (int i = 0; i < argc; ++i) {
+		pad(fp, &offset);
+		files[i].offset = offset;
+		fwrite(files[i].data, 1, files[i].size, fp);
+		offset += files[i].size;
+	}
+
+	pad(fp, &offset);
+	header.index = offset;
+
+	for (int i = 0; i < argc; ++i) {
+		entry.hash = files[i].hash;
+		entry.offset = files[i].offset;
+		entry.size = files[i].size;
+		entry.length = files[i].length;
+		entry.name = name;
+		entry.flags = files[i].flags;
+
+		mlk_pack_entry_encode(&entry, buf);
+		fwrite(buf, 1, MLK_PACK_ENTRY_SIZE, fp);
+		name += strlen(files[i].name) + 1;
+	}
+
+	header.names = header.index + (uint64_t)argc * MLK_PACK_ENTRY_SIZE;
+	header.namesz = name;
+
+	for (int i = 0; i < argc; ++i)
+		fwrite(files[i].name, 1, strlen(files[i].name) + 1, fp);
+
+	mlk_pack_header_encode(&header, buf);
+
+	if (fseek(fp, 0, SEEK_SET) < 0)
+		mlk_util_die("abort: %s: %s\n", output, strerror(errno));
+
+	fwrite(buf, 1, MLK_PACK_HEADER_SIZE, fp);
+
+	if (ferror(fp) || fclose(fp) != 0) {
+		remove(output);
+		mlk_util_die("abort: %s: %s\n", output, strerror(errno));
+	}
+
+	for (int i = 0; i < argc; ++i) {
+		free(files[i].name);
+		free(files[i].data);
+	}
+
+	free(files);
+}
+
+static void
+list(const char *input)
+{
+	struct mlk_pack_header header;
+	struct mlk_pack_entry entry;
+	const unsigned char *data;
+	size_t datasz;
+
+	if (!(data = mlk_util_mmap(input, &datasz)))
+		mlk_util_die("abort: %s: %s\n", input, strerror(errno));
+	if (mlk_pack_header_decode(&header, data, datasz) < 0)
+		mlk_util_die("abort: %s: invalid pack\n", input);
+
+	for (uint32_t i = 0; i < header.entriesz; ++i) {
+		mlk_pack_entry_decode(&entry, data + header.index + i * MLK_PACK_ENTRY_SIZE);
+
+		if (entry.name >= header.namesz)
+			mlk_util_die("abort: %s: invalid pack\n", input);
+
+		printf("%-40s %10llu %10llu%s\n",
+		    (const char *)data + header.names + entry.name,
+		    (unsigned long long)entry.length,
+		    (unsigned long long)entry.size,
+		    entry.flags & MLK_PACK_LZ ? " lz" : "");
+	}
+
+	mlk_util_munmap((void *)data, datasz);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *input = NULL;
+	int ch;
+
+	while ((ch = mlk_util_getopt(argc, argv, "C:t:z")) != -1) {
+		switch (ch) {
+		case 'C':
+			fdirectory = mlk_util_optarg;
+			break;
+		case 't':
+			input = mlk_util_optarg;
+			break;
+		case 'z':
+			fcompress = 1;
+			break;
+		default:
+			usage();
+			break;
+		}
+	}
+
+	argc -= mlk_util_optind;
+	argv += mlk_util_optind;
+
+	if (input)
+		list(input);
+	else {
+		if (argc < 2)
+			usage();
+
+		create(argv[0], argc - 1, argv + 1);
+	}
+}
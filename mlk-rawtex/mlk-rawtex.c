@@ -0,0 +1,166 @@
+/*
+ * mlk-rawtex.c -- convert images to pre-decoded textures
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/rawtex.h>
+#include <mlk/util/util.h>
+
+static int fcompress;
+
+static void
+usage(void)
+{
+	fprintf(stderr, "usage: mlk-rawtex [-z] input output\n");
+	exit(1);
+}
+
+static void *
+xalloc(size_t size)
+{
+	void *ptr;
+
+	/* malloc(0) may return NULL. */
+	if (!(ptr = malloc(size ? size : 1)))
+		mlk_util_die("abort: %s\n", strerror(errno));
+
+	return ptr;
+}
+
+static SDL_Surface *
+load(const char *input)
+{
+	SDL_Surface *image, *surface;
+
+	if (!(image = IMG_Load(input)))
+		mlk_util_die("abort: %s: %s\n", input, SDL_GetError());
+
+	/* RGBA32 is R, G, B, A in memory whatever the endianness. */
+	if (!(surface = SDL_ConvertSurface(image, SDL_PIXELFORMAT_RGBA32)))
+		mlk_util_die("abort: %s: %s\n", input, SDL_GetError());
+	if (!SDL_PremultiplySurfaceAlpha(surface, false))
+		mlk_util_die("abort: %s: %s\n", input, SDL_GetError());
+
+	SDL_DestroySurface(image);
+
+	return surface;
+}
+
+static unsigned char *
+pixels(SDL_Surface *surface, struct mlk_rawtex_header *header)
+{
+	unsigned char *data;
+	const unsigned char *row = surface->pixels;
+
+	header->width = surface->w;
+	header->height = surface->h;
+	header->pitch = surface->w * MLK_RAWTEX_BPP;
+	header->size = header->pitch * header->height;
+
+	/* Surface rows may be padded, store them tightly. */
+	data = xalloc(header->size);
+
+	for (uint32_t r = 0; r < header->height; ++r, row += surface->pitch)
+		memcpy(data + r * header->pitch, row, header->pitch);
+
+	return data;
+}
+
+static unsigned char *
+compress(unsigned char *data, struct mlk_rawtex_header *header)
+{
+	unsigned char *out;
+	size_t outsz;
+
+	out = xalloc(mlk_lz_bound(header->size));
+	outsz = mlk_lz_compress(data, header->size, out, mlk_lz_bound(header->size));
+
+	/* Only keep the compressed version if it is worth it. */
+	if (outsz != 0 && outsz < header->size) {
+		free(data);
+		header->size = outsz;
+		header->flags |= MLK_RAWTEX_LZ;
+
+		return out;
+	}
+
+	free(out);
+
+	return data;
+}
+
+static void
+convert(const char *input, const char *output)
+{
+	struct mlk_rawtex_header header = {
+		.version = MLK_RAWTEX_VERSION
+	};
+	unsigned char buf[MLK_RAWTEX_HEADER_SIZE], *data;
+	SDL_Surface *surface;
+	FILE *fp;
+
+	surface = load(input);
+	data = pixels(surface, &header);
+	SDL_DestroySurface(surface);
+
+	if (fcompress)
+		data = compress(data, &header);
+
+	mlk_rawtex_header_encode(&header, buf);
+
+	if (!(fp = fopen(output, "wb")))
+		mlk_util_die("abort: %s: %s\n", output, strerror(errno));
+	if (fwrite(buf, sizeof (buf), 1, fp) != 1 ||
+	    fwrite(data, header.size, 1, fp) != 1 ||
+	    fclose(fp) != 0)
+		mlk_util_die("abort: %s: %s\n", output, strerror(errno));
+
+	free(data);
+}
+
+int
+main(int argc, char **argv)
+{
+	int ch;
+
+	while ((ch = mlk_util_getopt(argc, argv, "z")) != -1) {
+		switch (ch) {
+		case 'z':
+			fcompress = 1;
+			break;
+		default:
+			usage();
+			break;
+		}
+	}
+
+	argc -= mlk_util_optind;
+	argv += mlk_util_optind;
+
+	if (argc != 2)
+		usage();
+
+	convert(argv[0], argv[1]);
+}
@@ -0,0 +1,92 @@
+/*
+ * bench-coro.c -- coroutine spawn/destroy benchmark
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdio.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/core/coro.h>
+#include <mlk/core/util.h>
+
+/*
+ * Measure the cost of creating and destroying short-lived coroutines, with
+ * stacks reused from the pool, allocated each time and guarded.
+ */
+
+#define ITERATIONS      10000
+
+enum mode {
+	MODE_POOLED,
+	MODE_UNPOOLED,
+	MODE_GUARD
+};
+
+static void
+entry(struct mlk_coro *coro)
+{
+	(void)coro;
+}
+
+static void
+run(const char *name, enum mode mode, size_t stack_size)
+{
+	struct mlk_coro coro = {
+		.entry = entry,
+		.stack_size = stack_size
+	};
+	Uint64 start, elapsed;
+
+	mlk_coro_pool_clear();
+	mlk_coro_pool_guard(mode == MODE_GUARD);
+
+	start = SDL_GetTicksNS();
+
+	for (int i = 0; i < ITERATIONS; ++i) {
+		mlk_coro_spawn(&coro);
+		mlk_coro_destroy(&coro);
+
+		if (mode == MODE_UNPOOLED)
+			mlk_coro_pool_clear();
+	}
+
+	elapsed = SDL_GetTicksNS() - start;
+
+	printf("%-9s %8zu bytes %10.2f us/coroutine\n", name, stack_size,
+	    (double)elapsed / ITERATIONS / 1e3);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const size_t sizes[] = {
+		MLK_CORO_STACK_SMALL,
+		0,
+		MLK_CORO_STACK_LARGE
+	};
+
+	printf("%d iterations\n", ITERATIONS);
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(sizes); ++i) {
+		run("pooled", MODE_POOLED, sizes[i]);
+		run("unpooled", MODE_UNPOOLED, sizes[i]);
+		run("guard", MODE_GUARD, sizes[i]);
+	}
+
+	mlk_coro_pool_guard(0);
+	mlk_coro_pool_clear();
+}
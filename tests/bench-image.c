@@ -0,0 +1,172 @@
+/*
+ * bench-image.c -- benchmark PNG against pre-decoded textures
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/rawtex.h>
+#include <mlk/util/util.h>
+
+#include <mlk/core/alloc.h>
+
+/*
+ * Compare decoding a PNG image against reading the same image converted to a
+ * pre-decoded texture (see mlk-rawtex), with and without compression.
+ *
+ * Only the CPU side is measured, both paths end with a single upload of the
+ * same pixels to the renderer.
+ */
+
+#define ITERATIONS      20
+
+static unsigned char *
+convert(const void *png, size_t pngsz, int compress, size_t *size)
+{
+	struct mlk_rawtex_header header = {
+		.version = MLK_RAWTEX_VERSION
+	};
+	SDL_Surface *image, *surface;
+	unsigned char *data, *out;
+	const unsigned char *row;
+	size_t outsz;
+
+	if (!(image = IMG_Load_IO(SDL_IOFromConstMem(png, pngsz), 1)) ||
+	    !(surface = SDL_ConvertSurface(image, SDL_PIXELFORMAT_RGBA32)) ||
+	    !SDL_PremultiplySurfaceAlpha(surface, false)) {
+		fprintf(stderr, "%s\n", SDL_GetError());
+		exit(1);
+	}
+
+	header.width = surface->w;
+	header.height = surface->h;
+	header.pitch = surface->w * MLK_RAWTEX_BPP;
+	header.size = header.pitch * header.height;
+
+	data = mlk_alloc_new(MLK_RAWTEX_HEADER_SIZE + mlk_lz_bound(header.size), 1);
+	row = surface->pixels;
+
+	for (uint32_t r = 0; r < header.height; ++r, row += surface->pitch)
+		memcpy(data + MLK_RAWTEX_HEADER_SIZE + r * header.pitch, row, header.pitch);
+
+	if (compress) {
+		out = mlk_alloc_new(mlk_lz_bound(header.size), 1);
+		outsz = mlk_lz_compress(data + MLK_RAWTEX_HEADER_SIZE, header.size,
+		    out, mlk_lz_bound(header.size));
+		memcpy(data + MLK_RAWTEX_HEADER_SIZE, out, outsz);
+		mlk_alloc_free(out);
+
+		header.size = outsz;
+		header.flags |= MLK_RAWTEX_LZ;
+	}
+
+	mlk_rawtex_header_encode(&header, data);
+	*size = MLK_RAWTEX_HEADER_SIZE + header.size;
+
+	SDL_DestroySurface(surface);
+	SDL_DestroySurface(image);
+
+	return data;
+}
+
+static void
+decode_png(const void *data, size_t size, void *pixels)
+{
+	SDL_Surface *surface;
+
+	if (!(surface = IMG_Load_IO(SDL_IOFromConstMem(data, size), 1))) {
+		fprintf(stderr, "%s\n", SDL_GetError());
+		exit(1);
+	}
+
+	SDL_DestroySurface(surface);
+}
+
+static void
+decode_raw(const void *data, size_t size, void *pixels)
+{
+	struct mlk_rawtex_header header;
+	const unsigned char *p = (const unsigned char *)data + MLK_RAWTEX_HEADER_SIZE;
+	size_t length;
+
+	if (mlk_rawtex_header_decode(&header, data, size) < 0) {
+		fprintf(stderr, "invalid raw texture\n");
+		exit(1);
+	}
+
+	length = (size_t)header.pitch * header.height;
+
+	/* Uncompressed pixels would be given as-is to SDL_UpdateTexture. */
+	if (!(header.flags & MLK_RAWTEX_LZ))
+		memcpy(pixels, p, length);
+	else if (mlk_lz_decompress(p, header.size, pixels, length) != length) {
+		fprintf(stderr, "corrupt raw texture\n");
+		exit(1);
+	}
+}
+
+static void
+run(const char *name,
+    const void *data,
+    size_t size,
+    void *pixels,
+    void (*decode)(const void *, size_t, void *))
+{
+	Uint64 start, elapsed;
+
+	start = SDL_GetTicksNS();
+
+	for (int i = 0; i < ITERATIONS; ++i)
+		decode(data, size, pixels);
+
+	elapsed = SDL_GetTicksNS() - start;
+
+	printf("%-8s %9zu bytes %12.1f us/image\n", name, size,
+	    (double)elapsed / ITERATIONS / 1e3);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *path = argc > 1 ? argv[1] : ASSETS "/sprites/world.png";
+	unsigned char *png, *raw, *rawlz, *pixels;
+	size_t pngsz, rawsz, rawlzsz;
+
+	if (!(png = SDL_LoadFile(path, &pngsz))) {
+		fprintf(stderr, "%s: %s\n", path, SDL_GetError());
+		return 1;
+	}
+
+	raw = convert(png, pngsz, 0, &rawsz);
+	rawlz = convert(png, pngsz, 1, &rawlzsz);
+	pixels = mlk_alloc_new(rawsz, 1);
+
+	printf("%s, %d iterations\n", path, ITERATIONS);
+	run("png", png, pngsz, pixels, decode_png);
+	run("raw", raw, rawsz, pixels, decode_raw);
+	run("raw-lz", rawlz, rawlzsz, pixels, decode_raw);
+
+	mlk_alloc_free(pixels);
+	mlk_alloc_free(rawlz);
+	mlk_alloc_free(raw);
+	SDL_free(png);
+}
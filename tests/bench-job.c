@@ -0,0 +1,100 @@
+/*
+ * bench-job.c -- job system scaling benchmark
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/err.h>
+#include <mlk/core/job.h>
+
+/*
+ * Run the same CPU bound parallel loop with an increasing number of threads,
+ * the main thread counts as one since it helps while waiting.
+ */
+
+#define ITEMS           (1 << 16)
+#define ROUNDS          2000
+#define ITERATIONS      5
+
+static uint32_t *values;
+
+static void
+work(size_t begin, size_t end, void *data)
+{
+	uint32_t x;
+
+	for (size_t i = begin; i < end; ++i) {
+		x = (uint32_t)i;
+
+		/* Some xorshift rounds, enough to keep a core busy. */
+		for (int r = 0; r < ROUNDS; ++r) {
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+		}
+
+		values[i] = x;
+	}
+}
+
+static double
+run(unsigned int threads)
+{
+	Uint64 start, elapsed;
+
+	if (threads > 1 && mlk_job_init(threads - 1) < 0) {
+		fprintf(stderr, "%s\n", mlk_err());
+		exit(1);
+	}
+
+	start = SDL_GetTicksNS();
+
+	for (int i = 0; i < ITERATIONS; ++i)
+		mlk_job_parallel_for(ITEMS, 0, work, NULL);
+
+	elapsed = SDL_GetTicksNS() - start;
+
+	if (threads > 1)
+		mlk_job_finish();
+
+	return (double)elapsed / ITERATIONS / 1e6;
+}
+
+int
+main(int argc, char **argv)
+{
+	int cores = SDL_GetNumLogicalCPUCores();
+	double base, ms;
+
+	values = mlk_alloc_new(ITEMS, sizeof (*values));
+
+	printf("%d items, %d rounds, %d iterations\n", ITEMS, ROUNDS, ITERATIONS);
+	base = run(1);
+	printf("%3d thread(s) %10.2f ms %6.2fx\n", 1, base, 1.0);
+
+	for (int t = 2; t <= cores; ++t) {
+		ms = run(t);
+		printf("%3d thread(s) %10.2f ms %6.2fx\n", t, ms, base / ms);
+	}
+
+	mlk_alloc_free(values);
+}
@@ -0,0 +1,179 @@
+/*
+ * bench-map-loader.c -- benchmark map loader
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/util/mapbin.h>
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/err.h>
+#include <mlk/core/util.h>
+
+#include <mlk/rpg/map-loader.h>
+#include <mlk/rpg/map.h>
+#include <mlk/rpg/tileset.h>
+
+/*
+ * Compare the textual and compiled map formats on a large synthetic map
+ * loaded from memory.
+ */
+
+#define COLUMNS         1000
+#define ROWS            1000
+#define ITERATIONS      10
+
+static struct mlk_tileset tileset;
+static unsigned int *tiles[MLK_MAP_LAYER_TYPE_LAST];
+
+static struct mlk_tileset *
+new_tileset(struct mlk_map_loader *self, struct mlk_map *map, const char *ident)
+{
+	return &tileset;
+}
+
+static unsigned int *
+new_tiles(struct mlk_map_loader *self,
+          struct mlk_map *map,
+          enum mlk_map_layer_type type,
+          size_t n)
+{
+	return tiles[type] = mlk_alloc_new0(n, sizeof (unsigned int));
+}
+
+static struct mlk_map_block *
+expand_blocks(struct mlk_map_loader *self,
+              struct mlk_map *map,
+              struct mlk_map_block *blocks,
+              size_t blocksz)
+{
+	return NULL;
+}
+
+static void
+clear(struct mlk_map_loader *self, struct mlk_map *map)
+{
+	for (int i = 0; i < MLK_MAP_LAYER_TYPE_LAST; ++i) {
+		mlk_alloc_free(tiles[i]);
+		tiles[i] = NULL;
+	}
+}
+
+static struct mlk_map_loader loader = {
+	.new_tileset = new_tileset,
+	.new_tiles = new_tiles,
+	.expand_blocks = expand_blocks,
+	.clear = clear
+};
+
+static char *
+generate_text(size_t *size)
+{
+	static const char *layers[] = { "background", "foreground", "above" };
+	char *text, *p;
+
+	/* At most 5 digits and a newline per tile. */
+	p = text = mlk_alloc_new(COLUMNS * ROWS * MLK_UTIL_SIZE(layers) * 6 + 256, 1);
+	p += sprintf(p, "columns|%u\nrows|%u\ntileset|world.tileset\n", COLUMNS, ROWS);
+
+	for (size_t l = 0; l < MLK_UTIL_SIZE(layers); ++l) {
+		p += sprintf(p, "layer|%s\n", layers[l]);
+
+		for (unsigned int i = 0; i < COLUMNS * ROWS; ++i)
+			p += sprintf(p, "%u\n", (i * 7919U) % 4096U);
+	}
+
+	*size = p - text;
+
+	return text;
+}
+
+static unsigned char *
+generate_binary(size_t *size)
+{
+	static const char strings[] = "\0world.tileset";
+	struct mlk_mapbin_header header = {
+		.version = MLK_MAPBIN_VERSION,
+		.layers = MLK_MAPBIN_LAYER_BG | MLK_MAPBIN_LAYER_FG | MLK_MAPBIN_LAYER_ABOVE,
+		.columns = COLUMNS,
+		.rows = ROWS,
+		.tileset = 1,
+		.stringsz = sizeof (strings)
+	};
+	unsigned char *data, *p;
+
+	*size = MLK_MAPBIN_HEADER_SIZE + COLUMNS * ROWS * 3 * 4 + sizeof (strings);
+	p = data = mlk_alloc_new(*size, 1);
+
+	mlk_mapbin_header_encode(&header, p);
+	p += MLK_MAPBIN_HEADER_SIZE;
+
+	for (int l = 0; l < 3; ++l)
+		for (unsigned int i = 0; i < COLUMNS * ROWS; ++i, p += 4)
+			mlk_mapbin_tile_encode((i * 7919U) % 4096U, p);
+
+	memcpy(p, strings, sizeof (strings));
+
+	return data;
+}
+
+static void
+run(const char *name, const void *data, size_t size)
+{
+	struct mlk_map map;
+	Uint64 start, elapsed;
+
+	start = SDL_GetTicksNS();
+
+	for (int i = 0; i < ITERATIONS; ++i) {
+		if (mlk_map_loader_openmem(&loader, &map, data, size) < 0) {
+			fprintf(stderr, "%s: %s\n", name, mlk_err());
+			exit(1);
+		}
+
+		mlk_map_loader_clear(&loader, &map);
+	}
+
+	elapsed = SDL_GetTicksNS() - start;
+
+	printf("%-8s %9zu bytes %12.1f us/map %10.1f MiB/s\n", name, size,
+	    (double)elapsed / ITERATIONS / 1e3,
+	    (double)size * ITERATIONS / (1024.0 * 1024.0) / ((double)elapsed / 1e9));
+}
+
+int
+main(void)
+{
+	char *text;
+	unsigned char *binary;
+	size_t textsz, binarysz;
+
+	text = generate_text(&textsz);
+	binary = generate_binary(&binarysz);
+
+	printf("%ux%u map, 3 layers, %d iterations\n", COLUMNS, ROWS, ITERATIONS);
+	run("text", text, textsz);
+	run("binary", binary, binarysz);
+
+	mlk_alloc_free(text);
+	mlk_alloc_free(binary);
+}
@@ -0,0 +1,116 @@
+/*
+ * bench-pipeline.c -- serial versus pipelined game loop
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdio.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/core/game.h>
+#include <mlk/core/util.h>
+#include <mlk/core/window.h>
+
+/*
+ * Measure the number of frames per second of the game loop with a fake
+ * update and draw keeping the CPU busy for a given duration, first serially
+ * then with the pipelined mode where both can overlap.
+ */
+
+#define FRAMES          200
+
+static struct {
+	unsigned int update;
+	unsigned int draw;
+	unsigned int frames;
+} bench;
+
+static void
+spin(unsigned int us)
+{
+	Uint64 end = SDL_GetTicksNS() + us * 1000ULL;
+
+	while (SDL_GetTicksNS() < end)
+		continue;
+}
+
+static void
+update(unsigned int ticks)
+{
+	spin(bench.update);
+}
+
+static void
+snapshot(void)
+{
+}
+
+static void
+draw(void)
+{
+	spin(bench.draw);
+
+	if (++bench.frames == FRAMES)
+		mlk_game_quit();
+}
+
+static double
+run(int pipeline)
+{
+	static const struct mlk_game_ops ops = {
+		.update = update,
+		.snapshot = snapshot,
+		.draw = draw
+	};
+	Uint64 start, elapsed;
+
+	mlk_game_init(&ops);
+	mlk_game.pipeline = pipeline;
+	bench.frames = 0;
+
+	start = SDL_GetTicksNS();
+	mlk_game_loop();
+	elapsed = SDL_GetTicksNS() - start;
+
+	return FRAMES / ((double)elapsed / 1e9);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const unsigned int loads[][2] = {
+		{ 4000, 4000 },
+		{ 6000, 2000 },
+		{ 2000, 6000 },
+		{ 500,  500  }
+	};
+	double serial, pipelined;
+
+	/* No frame limiter. */
+	mlk_window.framerate = 100000;
+
+	printf("%d frames\n", FRAMES);
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(loads); ++i) {
+		bench.update = loads[i][0];
+		bench.draw = loads[i][1];
+		serial = run(0);
+		pipelined = run(1);
+
+		printf("update %5u us, draw %5u us: serial %7.1f fps, pipelined %7.1f fps (%.2fx)\n",
+		    bench.update, bench.draw, serial, pipelined, pipelined / serial);
+	}
+}
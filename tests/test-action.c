@@ -514,6 +514,43 @@ test_stack_finish(void)
 	DT_ASSERT(table[1].inv.finish);
 }
 
+static void
+test_stack_growable(void)
+{
+	struct {
+		struct invokes inv;
+		struct mlk_action act;
+	} table[20];
+	struct mlk_action_stack st = {0};
+
+	mlk_action_stack_init(&st);
+
+	/* Odd entries complete on first update. */
+	for (int i = 0; i < 20; ++i) {
+		table[i].inv = (struct invokes) {0};
+		table[i].act = (struct mlk_action) INIT(&table[i], i % 2 ? my_update_true : my_update_false);
+		DT_EQ_INT(mlk_action_stack_add(&st, &table[i].act), 0);
+	}
+
+	DT_EQ_SIZE(st.length, 20U);
+	DT_ASSERT(st.actionsz >= 20U);
+	DT_ASSERT(!mlk_action_stack_update(&st, 0));
+
+	/* Remaining entries are packed in insertion order. */
+	DT_EQ_SIZE(st.length, 10U);
+
+	for (int i = 0; i < 10; ++i)
+		DT_EQ_PTR(st.actions[i], &table[i * 2].act);
+
+	mlk_action_stack_finish(&st);
+
+	DT_EQ_PTR(st.actions, NULL);
+	DT_EQ_SIZE(st.actionsz, 0U);
+	DT_EQ_SIZE(st.length, 0U);
+	DT_ASSERT(table[0].inv.finish);
+	DT_ASSERT(table[18].inv.finish);
+}
+
 int
 main(void)
 {
@@ -529,5 +566,6 @@ main(void)
 	DT_RUN(test_stack_update);
 	DT_RUN(test_stack_draw);
 	DT_RUN(test_stack_finish);
+	DT_RUN(test_stack_growable);
 	DT_SUMMARY();
 }
@@ -56,6 +56,22 @@ my_free(void *ptr)
 	my_stats.free_count += 1;
 }
 
+static size_t last_realloc;
+
+static void *
+track_realloc(void *ptr, size_t n)
+{
+	last_realloc = n;
+
+	return realloc(ptr, n);
+}
+
+static const struct mlk_alloc_funcs track_funcs = {
+	.alloc = malloc,
+	.realloc = track_realloc,
+	.free = free
+};
+
 static const struct mlk_alloc_funcs my_funcs = {
 	.alloc = my_alloc,
 	.realloc = my_realloc,
@@ -95,6 +111,8 @@ test_basics_resize0(void)
 	DT_EQ_INT(points[2].y, 0);
 	DT_EQ_INT(points[3].x, 0);
 	DT_EQ_INT(points[3].y, 0);
+
+	mlk_alloc_free(points);
 }
 
 static void
@@ -134,6 +152,39 @@ test_basics_expand0(void)
 	DT_EQ_INT(points[4].y, 0);
 	DT_EQ_INT(points[5].x, 0);
 	DT_EQ_INT(points[5].y, 0);
+
+	mlk_alloc_free(points);
+}
+
+static void
+test_basics_count(void)
+{
+	int *ints;
+	size_t header;
+
+	mlk_alloc_set(&track_funcs);
+
+	/* Resize takes the new total, expand the number of items to add. */
+	ints = mlk_alloc_new(2, sizeof (*ints));
+	ints = mlk_alloc_resize(ints, 4);
+	DT_EQ_SIZE(mlk_alloc_getn(ints), 4);
+	header = last_realloc - 4 * sizeof (*ints);
+
+	ints = mlk_alloc_resize(ints, 3);
+	DT_EQ_SIZE(mlk_alloc_getn(ints), 3);
+	DT_EQ_SIZE(last_realloc, header + 3 * sizeof (*ints));
+
+	for (int i = 0; i < 5; ++i)
+		ints = mlk_alloc_expand(ints, 1);
+
+	DT_EQ_SIZE(mlk_alloc_getn(ints), 8);
+	DT_EQ_SIZE(last_realloc, header + 8 * sizeof (*ints));
+
+	/* Nothing to add. */
+	DT_EQ_PTR(mlk_alloc_expand(ints, 0), ints);
+	DT_EQ_SIZE(mlk_alloc_getn(ints), 8);
+
+	mlk_alloc_free(ints);
 }
 
 static void
@@ -162,6 +213,7 @@ main(void)
 {
 	DT_RUN(test_basics_resize0);
 	DT_RUN(test_basics_expand0);
+	DT_RUN(test_basics_count);
 	DT_RUN(test_basics_sdupf);
 	DT_RUN(test_custom_count);
 	DT_SUMMARY();
@@ -0,0 +1,246 @@
+/*
+ * test-cache.c -- test resource cache
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <mlk/core/cache_p.h>
+#include <mlk/core/util.h>
+
+#include <dt.h>
+
+struct item {
+	struct mlk__cache_entry entry;
+	int id;
+	int evicted;
+};
+
+static struct item items[256];
+
+/* Identifiers of evicted items, in order. */
+static int evicted[256];
+static size_t evictedsz;
+
+static void
+evict(struct mlk__cache_entry *entry)
+{
+	struct item *item = MLK_UTIL_CONTAINER_OF(entry, struct item, entry);
+
+	item->evicted = 1;
+	evicted[evictedsz++] = item->id;
+}
+
+static struct item *
+find(struct mlk__cache *cache, uint64_t hash)
+{
+	for (struct mlk__cache_entry *entry = mlk__cache_bucket(cache, hash); entry; entry = entry->chain)
+		if (entry->hash == hash)
+			return MLK_UTIL_CONTAINER_OF(entry, struct item, entry);
+
+	return NULL;
+}
+
+static void
+setup(struct mlk__cache *cache, size_t budget, size_t count, size_t cost)
+{
+	*cache = (struct mlk__cache) {
+		.budget = budget,
+		.evict = evict
+	};
+
+	evictedsz = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		items[i] = (struct item) {
+			.entry.hash = i * 7919,
+			.id = i
+		};
+
+		mlk__cache_insert(cache, &items[i].entry);
+		mlk__cache_charge(cache, &items[i].entry, cost);
+	}
+}
+
+static void
+test_basics_find(void)
+{
+	struct mlk__cache cache;
+
+	/* Enough items to grow the table a few times. */
+	setup(&cache, 0, 256, 1);
+
+	DT_EQ_SIZE(cache.entriesz, 256U);
+	DT_EQ_SIZE(cache.usage, 256U);
+
+	for (size_t i = 0; i < 256; ++i)
+		DT_EQ_PTR(find(&cache, i * 7919), &items[i]);
+
+	DT_EQ_PTR(find(&cache, 1), NULL);
+
+	mlk__cache_finish(&cache);
+	DT_EQ_SIZE(evictedsz, 256U);
+	DT_EQ_SIZE(cache.entriesz, 0U);
+	DT_EQ_SIZE(cache.usage, 0U);
+	DT_EQ_PTR(cache.buckets, NULL);
+	DT_EQ_PTR(find(&cache, 0), NULL);
+}
+
+static void
+test_basics_refcount(void)
+{
+	struct mlk__cache cache;
+
+	setup(&cache, 0, 1, 10);
+
+	mlk__cache_ref(&cache, &items[0].entry);
+	DT_EQ_UINT(items[0].entry.refs, 2U);
+
+	mlk__cache_unref(&cache, &items[0].entry, 0);
+	DT_EQ_UINT(items[0].entry.refs, 1U);
+	DT_EQ_INT(items[0].evicted, 0);
+
+	/* Not kept, evicted right away along with the table. */
+	mlk__cache_unref(&cache, &items[0].entry, 0);
+	DT_EQ_INT(items[0].evicted, 1);
+	DT_EQ_SIZE(cache.usage, 0U);
+	DT_EQ_PTR(cache.buckets, NULL);
+}
+
+static void
+test_basics_keep(void)
+{
+	struct mlk__cache cache;
+
+	/* Without budget, unused entries are kept forever. */
+	setup(&cache, 0, 4, 100);
+
+	for (size_t i = 0; i < 4; ++i)
+		mlk__cache_unref(&cache, &items[i].entry, 1);
+
+	DT_EQ_SIZE(evictedsz, 0U);
+	DT_EQ_SIZE(cache.usage, 400U);
+
+	/* Taking it back removes it from the LRU list. */
+	mlk__cache_ref(&cache, &items[1].entry);
+	DT_EQ_PTR(cache.lru, &items[0].entry);
+	DT_EQ_PTR(cache.lru->next, &items[2].entry);
+	DT_EQ_PTR(cache.lru->next->next, &items[3].entry);
+
+	mlk__cache_finish(&cache);
+	DT_EQ_SIZE(evictedsz, 4U);
+	DT_EQ_PTR(cache.lru, NULL);
+}
+
+static void
+test_basics_lru(void)
+{
+	struct mlk__cache cache;
+
+	setup(&cache, 0, 4, 100);
+
+	/* Release in a different order than insertion. */
+	mlk__cache_unref(&cache, &items[2].entry, 1);
+	mlk__cache_unref(&cache, &items[0].entry, 1);
+	mlk__cache_unref(&cache, &items[3].entry, 1);
+	mlk__cache_unref(&cache, &items[1].entry, 1);
+
+	/* Item 0 is used again, it becomes the most recently used. */
+	mlk__cache_ref(&cache, &items[0].entry);
+	mlk__cache_unref(&cache, &items[0].entry, 1);
+
+	/* Shrinking the budget evicts least recently used first. */
+	cache.budget = 200;
+	mlk__cache_collect(&cache);
+
+	DT_EQ_SIZE(evictedsz, 2U);
+	DT_EQ_INT(evicted[0], 2);
+	DT_EQ_INT(evicted[1], 3);
+	DT_EQ_SIZE(cache.usage, 200U);
+	DT_EQ_PTR(find(&cache, items[2].entry.hash), NULL);
+	DT_EQ_PTR(find(&cache, items[1].entry.hash), &items[1]);
+
+	mlk__cache_finish(&cache);
+}
+
+static void
+test_basics_budget(void)
+{
+	struct mlk__cache cache;
+
+	setup(&cache, 250, 4, 100);
+
+	/* Referenced entries are never evicted, even over budget. */
+	mlk__cache_collect(&cache);
+	DT_EQ_SIZE(evictedsz, 0U);
+	DT_EQ_SIZE(cache.usage, 400U);
+
+	/* Each unused entry goes as long as the usage does not fit. */
+	mlk__cache_unref(&cache, &items[0].entry, 1);
+	DT_EQ_SIZE(evictedsz, 1U);
+	DT_EQ_INT(evicted[0], 0);
+	mlk__cache_unref(&cache, &items[1].entry, 1);
+	DT_EQ_SIZE(evictedsz, 2U);
+	DT_EQ_INT(evicted[1], 1);
+	DT_EQ_SIZE(cache.usage, 200U);
+
+	/* Now fits, kept in the LRU list. */
+	mlk__cache_unref(&cache, &items[2].entry, 1);
+	DT_EQ_SIZE(evictedsz, 2U);
+	DT_EQ_PTR(cache.lru, &items[2].entry);
+
+	mlk__cache_finish(&cache);
+}
+
+static void
+test_basics_reload(void)
+{
+	struct mlk__cache cache;
+
+	setup(&cache, 300, 3, 100);
+
+	mlk__cache_unref(&cache, &items[0].entry, 1);
+	mlk__cache_unref(&cache, &items[1].entry, 1);
+	DT_EQ_SIZE(evictedsz, 0U);
+
+	/* Reloading item 2 with a bigger content pushes the others out. */
+	mlk__cache_charge(&cache, &items[2].entry, 250);
+	DT_EQ_SIZE(cache.usage, 450U);
+	mlk__cache_collect(&cache);
+
+	DT_EQ_SIZE(evictedsz, 2U);
+	DT_EQ_INT(evicted[0], 0);
+	DT_EQ_INT(evicted[1], 1);
+	DT_EQ_SIZE(cache.usage, 250U);
+	DT_EQ_INT(items[2].evicted, 0);
+
+	/* Smaller again. */
+	mlk__cache_charge(&cache, &items[2].entry, 50);
+	DT_EQ_SIZE(cache.usage, 50U);
+
+	mlk__cache_finish(&cache);
+	DT_EQ_SIZE(cache.usage, 0U);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_find);
+	DT_RUN(test_basics_refcount);
+	DT_RUN(test_basics_keep);
+	DT_RUN(test_basics_lru);
+	DT_RUN(test_basics_budget);
+	DT_RUN(test_basics_reload);
+	DT_SUMMARY();
+}
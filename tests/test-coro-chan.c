@@ -0,0 +1,281 @@
+/*
+ * test-coro-chan.c -- test coroutine channels
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <mlk/core/coro-chan.h>
+#include <mlk/core/coro.h>
+#include <mlk/core/util.h>
+
+#include <dt.h>
+
+#define PRODUCERS       4
+#define CONSUMERS       3
+#define VALUES          2000
+
+static struct mlk_coro_chan chan, other;
+static int received[PRODUCERS * VALUES];
+static int last[PRODUCERS];
+static int counter, ordered;
+
+static void
+producer(struct mlk_coro *self)
+{
+	int id = self->name[0] - '0';
+
+	for (int i = 0; i < VALUES; ++i) {
+		int value = id * VALUES + i;
+
+		mlk_coro_chan_send(&chan, &value);
+	}
+}
+
+static void
+consumer(struct mlk_coro *self)
+{
+	int value, id;
+
+	while (mlk_coro_chan_recv(&chan, &value) == 0) {
+		received[value]++;
+		counter++;
+
+		/* Values from the same producer arrive in order. */
+		id = value / VALUES;
+
+		if (value % VALUES != last[id] + 1)
+			ordered = 0;
+
+		last[id] = value % VALUES;
+	}
+}
+
+static void
+receiver(struct mlk_coro *self)
+{
+	int value;
+
+	while (mlk_coro_chan_recv(&chan, &value) == 0)
+		counter += value;
+}
+
+static void
+sender(struct mlk_coro *self)
+{
+	int value = 1;
+
+	while (mlk_coro_chan_send(&chan, &value) == 0)
+		counter++;
+}
+
+static void
+selector(struct mlk_coro *self)
+{
+	int a, b, index;
+	struct mlk_coro_chan_op ops[] = {
+		{ .chan = &chan,  .dir = MLK_CORO_CHAN_RECV, .data = &a },
+		{ .chan = &other, .dir = MLK_CORO_CHAN_RECV, .data = &b }
+	};
+
+	while ((index = mlk_coro_chan_select(ops, MLK_UTIL_SIZE(ops))) >= 0)
+		counter += index == 0 ? a : b * 100;
+}
+
+static void
+test_basics_buffered(void)
+{
+	int value;
+
+	mlk_coro_chan_init(&chan, sizeof (int), 2);
+
+	/* Usable without coroutines as long as nothing blocks. */
+	value = 1;
+	DT_ASSERT(mlk_coro_chan_try_send(&chan, &value));
+	value = 2;
+	DT_ASSERT(mlk_coro_chan_try_send(&chan, &value));
+	DT_ASSERT(!mlk_coro_chan_try_send(&chan, &value));
+	DT_EQ_SIZE(chan.length, 2U);
+
+	DT_ASSERT(mlk_coro_chan_try_recv(&chan, &value));
+	DT_EQ_INT(value, 1);
+	DT_ASSERT(mlk_coro_chan_try_recv(&chan, &value));
+	DT_EQ_INT(value, 2);
+	DT_ASSERT(!mlk_coro_chan_try_recv(&chan, &value));
+
+	/* Closed, sends fail but queued values are still received. */
+	DT_ASSERT(mlk_coro_chan_try_send(&chan, &value));
+	mlk_coro_chan_close(&chan);
+	DT_ASSERT(!mlk_coro_chan_try_send(&chan, &value));
+	DT_ASSERT(mlk_coro_chan_try_recv(&chan, &value));
+	DT_ASSERT(!mlk_coro_chan_try_recv(&chan, &value));
+
+	mlk_coro_chan_finish(&chan);
+}
+
+static void
+test_basics_park(void)
+{
+	struct mlk_coro coro = { .entry = receiver };
+	int value = 5;
+
+	counter = 0;
+	MLK_CORO_CHAN_INIT(&chan, int, 4);
+	mlk_coro_run(&coro);
+
+	/* Parked on the empty channel, not resumed anymore. */
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_SIZE(mlk_coro_schedule(), 0U);
+	DT_EQ_SIZE(mlk_coro_schedule(), 0U);
+
+	/* A value wakes it up on the next frame. */
+	mlk_coro_chan_try_send(&chan, &value);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_INT(counter, 5);
+	DT_EQ_SIZE(mlk_coro_schedule(), 0U);
+
+	/* Closing terminates the loop. */
+	mlk_coro_chan_close(&chan);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_ASSERT(!coro.mco_coro);
+
+	mlk_coro_chan_finish(&chan);
+}
+
+static void
+test_basics_full(void)
+{
+	struct mlk_coro coro = { .entry = sender };
+	int value;
+
+	counter = 0;
+	MLK_CORO_CHAN_INIT(&chan, int, 3);
+	mlk_coro_run(&coro);
+
+	/* Fills the channel then parks. */
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_INT(counter, 3);
+	DT_EQ_SIZE(mlk_coro_schedule(), 0U);
+
+	/* Room for one more value. */
+	mlk_coro_chan_try_recv(&chan, &value);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_INT(counter, 4);
+
+	/* Destroying a parked coroutine unregisters it. */
+	mlk_coro_destroy(&coro);
+	DT_ASSERT(!chan.senders);
+
+	mlk_coro_chan_finish(&chan);
+}
+
+static void
+test_basics_select(void)
+{
+	struct mlk_coro coro = { .entry = selector };
+	int value;
+
+	counter = 0;
+	MLK_CORO_CHAN_INIT(&chan, int, 1);
+	MLK_CORO_CHAN_INIT(&other, int, 1);
+	mlk_coro_run(&coro);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+
+	value = 1;
+	mlk_coro_chan_try_send(&other, &value);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_INT(counter, 100);
+
+	value = 2;
+	mlk_coro_chan_try_send(&chan, &value);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_EQ_INT(counter, 102);
+
+	/* Still waiting on the other channel until it is closed as well. */
+	mlk_coro_chan_close(&chan);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_ASSERT(coro.mco_coro);
+	mlk_coro_chan_close(&other);
+	DT_EQ_SIZE(mlk_coro_schedule(), 1U);
+	DT_ASSERT(!coro.mco_coro);
+
+	mlk_coro_chan_finish(&other);
+	mlk_coro_chan_finish(&chan);
+}
+
+static void
+test_stress_producers_consumers(void)
+{
+	static const char *names[] = { "0", "1", "2", "3" };
+	struct mlk_coro producers[PRODUCERS] = {0}, consumers[CONSUMERS] = {0};
+	int running, frames = 0;
+
+	counter = 0;
+	ordered = 1;
+
+	for (int i = 0; i < PRODUCERS; ++i)
+		last[i] = -1;
+
+	MLK_CORO_CHAN_INIT(&chan, int, 5);
+
+	for (int i = 0; i < PRODUCERS; ++i) {
+		producers[i].name = names[i];
+		producers[i].entry = producer;
+		producers[i].stack_size = MLK_CORO_STACK_SMALL;
+		mlk_coro_run(&producers[i]);
+	}
+
+	for (int i = 0; i < CONSUMERS; ++i) {
+		consumers[i].entry = consumer;
+		consumers[i].stack_size = MLK_CORO_STACK_SMALL;
+		mlk_coro_run(&consumers[i]);
+	}
+
+	/* Run until every producer is done. */
+	do {
+		mlk_coro_schedule();
+		frames++;
+		running = 0;
+
+		for (int i = 0; i < PRODUCERS; ++i)
+			running += producers[i].mco_coro != NULL;
+	} while (running && frames < 100000);
+
+	mlk_coro_chan_close(&chan);
+
+	while (mlk_coro_schedule())
+		continue;
+
+	DT_EQ_INT(counter, PRODUCERS * VALUES);
+	DT_ASSERT(ordered);
+
+	for (int i = 0; i < PRODUCERS * VALUES; ++i)
+		DT_EQ_INT(received[i], 1);
+
+	for (int i = 0; i < CONSUMERS; ++i)
+		DT_ASSERT(!consumers[i].mco_coro);
+
+	mlk_coro_chan_finish(&chan);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_buffered);
+	DT_RUN(test_basics_park);
+	DT_RUN(test_basics_full);
+	DT_RUN(test_basics_select);
+	DT_RUN(test_stress_producers_consumers);
+	DT_SUMMARY();
+}
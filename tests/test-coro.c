@@ -0,0 +1,241 @@
+/*
+ * test-coro.c -- test coroutine scheduler
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <mlk/core/coro.h>
+#include <mlk/core/timer.h>
+#include <mlk/core/util.h>
+
+#include <dt.h>
+
+static struct mlk_coro_event event;
+static struct mlk_coro target;
+static int counter;
+
+/*
+ * Advance time then resume coroutines, like mlk_game_loop does.
+ */
+static size_t
+frame(unsigned int ticks)
+{
+	mlk_timer_dispatch(ticks);
+
+	return mlk_coro_schedule();
+}
+
+static void
+sleeper(struct mlk_coro *self)
+{
+	mlk_coro_sleep(100);
+	counter++;
+	mlk_coro_sleep(1000);
+	counter++;
+}
+
+static void
+yielder(struct mlk_coro *self)
+{
+	for (int i = 0; i < 3; ++i) {
+		counter++;
+		mlk_coro_yield();
+	}
+}
+
+static void
+waiter(struct mlk_coro *self)
+{
+	mlk_coro_event_wait(&event);
+	counter++;
+}
+
+static void
+awaiter(struct mlk_coro *self)
+{
+	mlk_coro_await(&target);
+
+	/* The sleeper must have completed. */
+	if (counter == 2)
+		counter = 10;
+}
+
+static void
+test_basics_sleep(void)
+{
+	struct mlk_coro coro = { .entry = sleeper };
+
+	counter = 0;
+	mlk_coro_run(&coro);
+
+	/* Not started until scheduled, then sleeping. */
+	DT_EQ_INT(counter, 0);
+	DT_EQ_SIZE(frame(0), 1U);
+	DT_EQ_SIZE(frame(50), 0U);
+	DT_EQ_INT(counter, 0);
+	DT_EQ_SIZE(frame(50), 1U);
+	DT_EQ_INT(counter, 1);
+
+	/* Cascaded from an upper level of the timer wheel. */
+	for (int i = 0; i < 9; ++i)
+		DT_EQ_SIZE(frame(100), 0U);
+
+	DT_EQ_INT(counter, 1);
+	DT_EQ_SIZE(frame(100), 1U);
+	DT_EQ_INT(counter, 2);
+
+	/* Terminated and destroyed. */
+	DT_ASSERT(!coro.mco_coro);
+	DT_EQ_SIZE(frame(16), 0U);
+}
+
+static void
+test_basics_large_step(void)
+{
+	struct mlk_coro coro = { .entry = sleeper };
+
+	counter = 0;
+	mlk_coro_run(&coro);
+	frame(0);
+
+	/* A single large step still wakes each deadline. */
+	frame(5000);
+	DT_EQ_INT(counter, 1);
+	frame(5000);
+	DT_EQ_INT(counter, 2);
+	DT_ASSERT(!coro.mco_coro);
+}
+
+static void
+test_basics_yield(void)
+{
+	struct mlk_coro coro = { .entry = yielder };
+
+	counter = 0;
+	mlk_coro_run(&coro);
+
+	/* Resumed once per call. */
+	for (int i = 1; i <= 3; ++i) {
+		frame(16);
+		DT_EQ_INT(counter, i);
+	}
+
+	frame(16);
+	DT_ASSERT(!coro.mco_coro);
+}
+
+static void
+test_basics_event(void)
+{
+	struct mlk_coro coros[3] = {
+		{ .entry = waiter },
+		{ .entry = waiter },
+		{ .entry = waiter }
+	};
+
+	counter = 0;
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(coros); ++i)
+		mlk_coro_run(&coros[i]);
+
+	/* Waiting coroutines are not resumed. */
+	DT_EQ_SIZE(frame(16), 3U);
+	DT_EQ_SIZE(frame(16), 0U);
+
+	DT_EQ_SIZE(mlk_coro_event_signal(&event), 3U);
+	DT_EQ_SIZE(mlk_coro_event_signal(&event), 0U);
+	DT_EQ_INT(counter, 0);
+	DT_EQ_SIZE(frame(16), 3U);
+	DT_EQ_INT(counter, 3);
+}
+
+static void
+test_basics_await(void)
+{
+	struct mlk_coro coro = { .entry = awaiter };
+
+	counter = 0;
+	target.entry = sleeper;
+	mlk_coro_run(&target);
+	mlk_coro_run(&coro);
+
+	frame(0);
+	frame(100);
+	DT_EQ_INT(counter, 1);
+	frame(1000);
+	DT_EQ_INT(counter, 2);
+
+	/* Woken up when the target terminated, resumed on the next call. */
+	DT_ASSERT(coro.mco_coro);
+	frame(16);
+	DT_EQ_INT(counter, 10);
+	DT_ASSERT(!coro.mco_coro);
+}
+
+static void
+test_basics_destroy(void)
+{
+	struct mlk_coro coro = { .entry = sleeper };
+
+	counter = 0;
+	mlk_coro_run(&coro);
+	frame(0);
+
+	/* Destroying a sleeping coroutine cancels its timer. */
+	mlk_coro_destroy(&coro);
+	DT_EQ_SIZE(frame(1000), 0U);
+	DT_EQ_INT(counter, 0);
+}
+
+static void
+test_basics_pool(void)
+{
+	struct mlk_coro coro = { .entry = sleeper, .stack_size = 40000 };
+	struct mco_coro *stack;
+
+	mlk_coro_pool_clear();
+	mlk_coro_run(&coro);
+	stack = coro.mco_coro;
+	mlk_coro_destroy(&coro);
+
+	/* Same size class, the stack is reused. */
+	coro.stack_size = 50000;
+	mlk_coro_run(&coro);
+	DT_EQ_PTR(coro.mco_coro, stack);
+	mlk_coro_destroy(&coro);
+
+	/* Guarded stacks are never taken from the pool. */
+	mlk_coro_pool_guard(1);
+	mlk_coro_run(&coro);
+	mlk_coro_pool_guard(0);
+	DT_ASSERT(coro.mco_coro);
+	DT_ASSERT(coro.mco_coro != stack);
+	mlk_coro_destroy(&coro);
+
+	mlk_coro_pool_clear();
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_sleep);
+	DT_RUN(test_basics_large_step);
+	DT_RUN(test_basics_yield);
+	DT_RUN(test_basics_event);
+	DT_RUN(test_basics_await);
+	DT_RUN(test_basics_destroy);
+	DT_RUN(test_basics_pool);
+	DT_SUMMARY();
+}
@@ -360,6 +360,43 @@ test_stack_finish(void)
 	DT_ASSERT(table[0].inv.finish);
 }
 
+static void
+test_stack_growable(void)
+{
+	struct {
+		struct invokes inv;
+		struct mlk_drawable dw;
+	} table[20];
+	struct mlk_drawable_stack st = {0};
+
+	mlk_drawable_stack_init(&st);
+
+	/* Odd entries complete on first update. */
+	for (int i = 0; i < 20; ++i) {
+		table[i].inv = (struct invokes) {0};
+		table[i].dw = (struct mlk_drawable) INIT(&table[i], i % 2 ? my_update_true : my_update_false);
+		DT_EQ_INT(mlk_drawable_stack_add(&st, &table[i].dw), 0);
+	}
+
+	DT_EQ_SIZE(st.length, 20U);
+	DT_ASSERT(st.objectsz >= 20U);
+	DT_ASSERT(!mlk_drawable_stack_update(&st, 0));
+
+	/* Remaining entries are packed in insertion order. */
+	DT_EQ_SIZE(st.length, 10U);
+
+	for (int i = 0; i < 10; ++i)
+		DT_EQ_PTR(st.objects[i], &table[i * 2].dw);
+
+	mlk_drawable_stack_finish(&st);
+
+	DT_EQ_PTR(st.objects, NULL);
+	DT_EQ_SIZE(st.objectsz, 0U);
+	DT_EQ_SIZE(st.length, 0U);
+	DT_ASSERT(table[0].inv.finish);
+	DT_ASSERT(table[18].inv.finish);
+}
+
 int
 main(void)
 {
@@ -371,5 +408,6 @@ main(void)
 	DT_RUN(test_stack_update);
 	DT_RUN(test_stack_draw);
 	DT_RUN(test_stack_finish);
+	DT_RUN(test_stack_growable);
 	DT_SUMMARY();
 }
@@ -0,0 +1,233 @@
+/*
+ * test-event.c -- test event translation
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <SDL3/SDL.h>
+
+#include <mlk/core/event.h>
+#include <mlk/core/util.h>
+
+#include <dt.h>
+
+static union mlk_event evs[128];
+
+static void
+push(const SDL_Event *event)
+{
+	SDL_Event copy = *event;
+
+	DT_ASSERT(SDL_PushEvent(&copy));
+}
+
+static void
+push_key(Uint32 type, SDL_Keycode key)
+{
+	push(&(const SDL_Event) {
+		.key = {
+			.type = type,
+			.key = key,
+			.down = type == SDL_EVENT_KEY_DOWN
+		}
+	});
+}
+
+static void
+test_basics_key(void)
+{
+	push_key(SDL_EVENT_KEY_DOWN, SDLK_A);
+	push_key(SDL_EVENT_KEY_UP, SDLK_RETURN);
+
+	/* Non printable keys have the scancode mask set. */
+	push_key(SDL_EVENT_KEY_DOWN, SDLK_F5);
+	push_key(SDL_EVENT_KEY_DOWN, SDLK_RGUI);
+
+	/* Unicode characters beyond ASCII are not mapped. */
+	push_key(SDL_EVENT_KEY_DOWN, 0x20ac);
+
+	DT_EQ_SIZE(mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs)), 5U);
+	DT_EQ_INT(evs[0].type, MLK_EVENT_KEYDOWN);
+	DT_EQ_INT(evs[0].key.key, MLK_KEY_A);
+	DT_EQ_INT(evs[1].type, MLK_EVENT_KEYUP);
+	DT_EQ_INT(evs[1].key.key, MLK_KEY_ENTER);
+	DT_EQ_INT(evs[2].key.key, MLK_KEY_F5);
+	DT_EQ_INT(evs[3].key.key, MLK_KEY_RSUPER);
+	DT_EQ_INT(evs[4].type, MLK_EVENT_KEYDOWN);
+	DT_EQ_INT(evs[4].key.key, MLK_KEY_UNKNOWN);
+}
+
+static void
+test_basics_mouse(void)
+{
+	push(&(const SDL_Event) {
+		.motion = {
+			.type = SDL_EVENT_MOUSE_MOTION,
+			.state = SDL_BUTTON_LMASK | SDL_BUTTON_RMASK,
+			.x = 10,
+			.y = 20
+		}
+	});
+	push(&(const SDL_Event) {
+		.button = {
+			.type = SDL_EVENT_MOUSE_BUTTON_DOWN,
+			.button = SDL_BUTTON_MIDDLE,
+			.clicks = 2,
+			.x = 30,
+			.y = 40
+		}
+	});
+	push(&(const SDL_Event) {
+		.button = {
+			.type = SDL_EVENT_MOUSE_BUTTON_UP,
+			.button = SDL_BUTTON_X1,
+			.clicks = 1
+		}
+	});
+
+	DT_EQ_SIZE(mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs)), 3U);
+	DT_EQ_INT(evs[0].type, MLK_EVENT_MOUSE);
+	DT_EQ_INT(evs[0].mouse.buttons, MLK_MOUSE_BUTTON_LEFT | MLK_MOUSE_BUTTON_RIGHT);
+	DT_EQ_INT(evs[0].mouse.x, 10);
+	DT_EQ_INT(evs[0].mouse.y, 20);
+	DT_EQ_INT(evs[1].type, MLK_EVENT_CLICKDOWN);
+	DT_EQ_INT(evs[1].click.button, MLK_MOUSE_BUTTON_MIDDLE);
+	DT_EQ_UINT(evs[1].click.clicks, 2U);
+	DT_EQ_INT(evs[1].click.x, 30);
+	DT_EQ_INT(evs[1].click.y, 40);
+
+	/* Extra buttons are not mapped. */
+	DT_EQ_INT(evs[2].type, MLK_EVENT_CLICKUP);
+	DT_EQ_INT(evs[2].click.button, MLK_MOUSE_BUTTON_NONE);
+}
+
+static void
+test_basics_gamepad(void)
+{
+	push(&(const SDL_Event) {
+		.gdevice = {
+			.type = SDL_EVENT_GAMEPAD_ADDED,
+			.which = 3
+		}
+	});
+	push(&(const SDL_Event) {
+		.gbutton = {
+			.type = SDL_EVENT_GAMEPAD_BUTTON_DOWN,
+			.which = 3,
+			.button = SDL_GAMEPAD_BUTTON_SOUTH
+		}
+	});
+	push(&(const SDL_Event) {
+		.gbutton = {
+			.type = SDL_EVENT_GAMEPAD_BUTTON_UP,
+			.which = 3,
+			.button = SDL_GAMEPAD_BUTTON_DPAD_LEFT
+		}
+	});
+	push(&(const SDL_Event) {
+		.gaxis = {
+			.type = SDL_EVENT_GAMEPAD_AXIS_MOTION,
+			.which = 3,
+			.axis = SDL_GAMEPAD_AXIS_RIGHT_TRIGGER,
+			.value = -1234
+		}
+	});
+	push(&(const SDL_Event) {
+		.gdevice = {
+			.type = SDL_EVENT_GAMEPAD_REMOVED,
+			.which = 3
+		}
+	});
+
+	DT_EQ_SIZE(mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs)), 5U);
+	DT_EQ_INT(evs[0].type, MLK_EVENT_GAMEPAD_ATTACH);
+	DT_EQ_INT(evs[0].gamepad.index, 3);
+	DT_EQ_INT(evs[1].type, MLK_EVENT_BUTTONDOWN);
+	DT_EQ_INT(evs[1].button.button, MLK_GAMEPAD_BUTTON_A);
+	DT_EQ_INT(evs[2].type, MLK_EVENT_BUTTONUP);
+	DT_EQ_INT(evs[2].button.button, MLK_GAMEPAD_BUTTON_LEFT);
+	DT_EQ_INT(evs[3].type, MLK_EVENT_AXIS);
+	DT_EQ_INT(evs[3].axis.axis, MLK_GAMEPAD_AXIS_RTRIGGER);
+	DT_EQ_INT(evs[3].axis.value, -1234);
+	DT_EQ_INT(evs[4].type, MLK_EVENT_GAMEPAD_DETACH);
+	DT_EQ_INT(evs[4].gamepad.index, 3);
+}
+
+static void
+test_basics_unknown(void)
+{
+	union mlk_event ev;
+
+	/* Events not reported are skipped without taking a slot. */
+	push(&(const SDL_Event) { .type = SDL_EVENT_USER });
+	push_key(SDL_EVENT_KEY_DOWN, SDLK_Z);
+	push(&(const SDL_Event) { .type = SDL_EVENT_USER + 1 });
+	push(&(const SDL_Event) { .type = SDL_EVENT_QUIT });
+	push(&(const SDL_Event) { .type = SDL_EVENT_USER + 2 });
+
+	DT_EQ_SIZE(mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs)), 2U);
+	DT_EQ_INT(evs[0].type, MLK_EVENT_KEYDOWN);
+	DT_EQ_INT(evs[0].key.key, MLK_KEY_Z);
+	DT_EQ_INT(evs[1].type, MLK_EVENT_QUIT);
+
+	/* Same with the single event variant. */
+	push(&(const SDL_Event) { .type = SDL_EVENT_USER });
+	push(&(const SDL_Event) { .type = SDL_EVENT_QUIT });
+
+	DT_EQ_INT(mlk_event_poll(&ev), 1);
+	DT_EQ_INT(ev.type, MLK_EVENT_QUIT);
+	DT_EQ_INT(mlk_event_poll(&ev), 0);
+}
+
+static void
+test_basics_batch(void)
+{
+	size_t total = 0, n;
+
+	for (int i = 0; i < 100; ++i)
+		push_key(SDL_EVENT_KEY_DOWN, i % 2 ? SDLK_A : SDLK_B);
+
+	/* Never more than requested and none of them lost. */
+	while ((n = mlk_event_poll_batch(evs, 7))) {
+		DT_ASSERT(n <= 7U);
+
+		for (size_t i = 0; i < n; ++i)
+			DT_EQ_INT(evs[i].key.key, (total + i) % 2 ? MLK_KEY_A : MLK_KEY_B);
+
+		total += n;
+	}
+
+	DT_EQ_SIZE(total, 100U);
+	DT_EQ_SIZE(mlk_event_poll_batch(evs, MLK_UTIL_SIZE(evs)), 0U);
+}
+
+int
+main(void)
+{
+	if (!SDL_Init(SDL_INIT_EVENTS))
+		return 1;
+
+	/* Anything queued by the initialization. */
+	SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+	DT_RUN(test_basics_key);
+	DT_RUN(test_basics_mouse);
+	DT_RUN(test_basics_gamepad);
+	DT_RUN(test_basics_unknown);
+	DT_RUN(test_basics_batch);
+	DT_SUMMARY();
+
+	SDL_Quit();
+}
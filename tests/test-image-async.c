@@ -0,0 +1,152 @@
+/*
+ * test-image-async.c -- test parallel image decoding
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/rawtex.h>
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/core.h>
+#include <mlk/core/image-async.h>
+#include <mlk/core/texture.h>
+#include <mlk/core/window.h>
+
+#include <dt.h>
+
+/* 2x2 premultiplied pixels, rows are padded to 12 bytes on purpose. */
+#define WIDTH   2
+#define HEIGHT  2
+#define PITCH   12
+
+static const unsigned char pixels[PITCH * HEIGHT] = {
+	0xff, 0x00, 0x00, 0xff,  0x00, 0xff, 0x00, 0xff,  0xaa, 0xaa, 0xaa, 0xaa,
+	0x00, 0x00, 0xff, 0xff,  0x40, 0x40, 0x40, 0x80,  0xaa, 0xaa, 0xaa, 0xaa
+};
+
+static unsigned char *
+raw(unsigned int flags, size_t *size)
+{
+	struct mlk_rawtex_header header = {
+		.version = MLK_RAWTEX_VERSION,
+		.flags = flags,
+		.width = WIDTH,
+		.height = HEIGHT,
+		.pitch = PITCH
+	};
+	unsigned char *data;
+	size_t bound = mlk_lz_bound(sizeof (pixels));
+
+	data = mlk_alloc_new0(MLK_RAWTEX_HEADER_SIZE + bound, 1);
+
+	if (flags & MLK_RAWTEX_LZ)
+		header.size = mlk_lz_compress(pixels, sizeof (pixels), data + MLK_RAWTEX_HEADER_SIZE, bound);
+	else {
+		header.size = sizeof (pixels);
+		memcpy(data + MLK_RAWTEX_HEADER_SIZE, pixels, sizeof (pixels));
+	}
+
+	mlk_rawtex_header_encode(&header, data);
+	*size = MLK_RAWTEX_HEADER_SIZE + header.size;
+
+	return data;
+}
+
+static void
+drain(void)
+{
+	while (mlk_image_async_busy())
+		mlk_image_async_dispatch();
+}
+
+static void
+load(unsigned int flags)
+{
+	struct mlk_texture texture = {0};
+	struct mlk_image_async_request req = {0};
+	SDL_BlendMode blend;
+
+	req.texture = &texture;
+	req.buffer = raw(flags, &req.buffersz);
+
+	mlk_image_async_submit(&req);
+	drain();
+
+	DT_EQ_INT(req.status, MLK_IMAGE_ASYNC_STATUS_DONE);
+	DT_EQ_UINT(texture.w, WIDTH);
+	DT_EQ_UINT(texture.h, HEIGHT);
+	DT_ASSERT(SDL_GetTextureBlendMode(texture.handle, &blend));
+	DT_EQ_UINT(blend, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+	mlk_texture_finish(&texture);
+	mlk_alloc_free((void *)req.buffer);
+}
+
+static void
+test_basics_raw(void)
+{
+	load(0);
+}
+
+static void
+test_basics_raw_lz(void)
+{
+	load(MLK_RAWTEX_LZ);
+}
+
+static void
+test_error_raw(void)
+{
+	struct mlk_texture texture = {0};
+	struct mlk_image_async_request req = {0};
+	unsigned char *data;
+
+	/* Valid magic but unsupported version. */
+	req.texture = &texture;
+	req.buffer = data = raw(0, &req.buffersz);
+	data[8] = 0xff;
+
+	mlk_image_async_submit(&req);
+	drain();
+
+	DT_EQ_INT(req.status, MLK_IMAGE_ASYNC_STATUS_FAILED);
+	DT_ASSERT(req.error[0]);
+	DT_EQ_PTR(texture.handle, NULL);
+
+	mlk_alloc_free(data);
+}
+
+int
+main(void)
+{
+	if (mlk_core_init("fr.malikania", "test") < 0 || mlk_window_open("test-image-async", 100, 100) < 0)
+		return 1;
+	if (mlk_image_async_init(2, 0) < 0)
+		return 1;
+
+	DT_RUN(test_basics_raw);
+	DT_RUN(test_basics_raw_lz);
+	DT_RUN(test_error_raw);
+	DT_SUMMARY();
+
+	mlk_image_async_finish();
+	mlk_window_finish();
+	mlk_core_finish();
+}
@@ -0,0 +1,278 @@
+/*
+ * test-job.c -- test job system
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/core/job.h>
+
+#include <dt.h>
+
+#define ITEMS 100000
+
+static SDL_AtomicInt total;
+static int items[ITEMS];
+static int first, second, dispatched;
+
+static void
+increment(struct mlk_job *self)
+{
+	SDL_AddAtomicInt(&total, 1);
+}
+
+static void
+set_first(struct mlk_job *self)
+{
+	SDL_Delay(10);
+	first = 1;
+}
+
+static void
+set_second(struct mlk_job *self)
+{
+	/* Only run once the first job has completed. */
+	second = first + 1;
+}
+
+static void
+finished(struct mlk_job *self)
+{
+	dispatched++;
+}
+
+static void
+fill(size_t begin, size_t end, void *data)
+{
+	int *values = data ? data : items;
+
+	for (size_t i = begin; i < end; ++i)
+		values[i] += (int)i + 1;
+}
+
+static void
+nested(size_t begin, size_t end, void *data)
+{
+	for (size_t i = begin; i < end; ++i)
+		mlk_job_parallel_for(1000, 100, fill, &items[i * 1000]);
+}
+
+/*
+ * Jobs for test_basics_wait_dependent, the waiter runs on the only worker
+ * and the gate runs on the main thread.
+ */
+static SDL_AtomicInt started, armed;
+static struct mlk_job_counter gate, inner;
+static struct mlk_job dependent = {
+	.run = increment,
+	.counter = &inner,
+	.after = &gate
+};
+
+static void
+wait_dependent(struct mlk_job *self)
+{
+	SDL_SetAtomicInt(&started, 1);
+
+	while (!SDL_GetAtomicInt(&armed))
+		SDL_Delay(1);
+
+	/* Held until the gate is released by the main thread. */
+	mlk_job_submit(&dependent);
+	mlk_job_wait(&inner);
+}
+
+static void
+open_gate(struct mlk_job *self)
+{
+	SDL_SetAtomicInt(&armed, 1);
+
+	/* Give the worker some time to block in mlk_job_wait. */
+	SDL_Delay(50);
+}
+
+static int
+check_items(int times)
+{
+	for (int i = 0; i < ITEMS; ++i)
+		if (items[i] != (i + 1) * times)
+			return 0;
+
+	return 1;
+}
+
+static void
+test_basics_inline(void)
+{
+	struct mlk_job_counter counter = {0};
+	struct mlk_job job = {
+		.run = increment,
+		.done = finished,
+		.counter = &counter
+	};
+
+	/* Not initialized, everything runs from the calling thread. */
+	SDL_SetAtomicInt(&total, 0);
+	dispatched = 0;
+	mlk_job_submit(&job);
+	DT_EQ_INT(SDL_GetAtomicInt(&total), 1);
+	DT_EQ_INT(dispatched, 1);
+	DT_ASSERT(mlk_job_completed(&counter));
+
+	memset(items, 0, sizeof (items));
+	mlk_job_parallel_for(ITEMS, 0, fill, NULL);
+	DT_ASSERT(check_items(1));
+}
+
+static void
+test_basics_counter(void)
+{
+	struct mlk_job_counter counter = {0};
+	struct mlk_job jobs[1000] = {0};
+
+	DT_EQ_INT(mlk_job_init(4), 0);
+	DT_EQ_UINT(mlk_job_workers(), 4U);
+
+	SDL_SetAtomicInt(&total, 0);
+
+	for (size_t i = 0; i < 1000; ++i) {
+		jobs[i].run = increment;
+		jobs[i].counter = &counter;
+		mlk_job_submit(&jobs[i]);
+	}
+
+	mlk_job_wait(&counter);
+	DT_ASSERT(mlk_job_completed(&counter));
+	DT_EQ_INT(SDL_GetAtomicInt(&total), 1000);
+
+	mlk_job_finish();
+}
+
+static void
+test_basics_after(void)
+{
+	struct mlk_job_counter c1 = {0}, c2 = {0};
+	struct mlk_job j1 = { .run = set_first, .counter = &c1 };
+	struct mlk_job j2 = { .run = set_second, .counter = &c2, .after = &c1 };
+
+	DT_EQ_INT(mlk_job_init(2), 0);
+
+	first = second = 0;
+
+	/* The second job is held until the first, slower one has completed. */
+	mlk_job_submit(&j1);
+	mlk_job_submit(&j2);
+	mlk_job_wait(&c2);
+	DT_EQ_INT(second, 2);
+
+	mlk_job_finish();
+}
+
+static void
+test_basics_parallel_for(void)
+{
+	DT_EQ_INT(mlk_job_init(0), 0);
+
+	memset(items, 0, sizeof (items));
+	mlk_job_parallel_for(ITEMS, 0, fill, NULL);
+	DT_ASSERT(check_items(1));
+	mlk_job_parallel_for(ITEMS, 7, fill, NULL);
+	DT_ASSERT(check_items(2));
+
+	/* Jobs waiting for other jobs help rather than block. */
+	memset(items, 0, sizeof (items));
+	mlk_job_parallel_for(64, 1, nested, NULL);
+
+	for (int i = 0; i < 64000; ++i)
+		DT_EQ_INT(items[i], i % 1000 + 1);
+
+	mlk_job_finish();
+}
+
+static void
+test_basics_dispatch(void)
+{
+	struct mlk_job_counter counter = {0};
+	struct mlk_job job = {
+		.run = increment,
+		.done = finished,
+		.counter = &counter
+	};
+
+	DT_EQ_INT(mlk_job_init(1), 0);
+
+	dispatched = 0;
+	mlk_job_submit(&job);
+	mlk_job_wait(&counter);
+
+	/* Continuations only run from the main thread. */
+	DT_EQ_INT(dispatched, 0);
+	DT_EQ_SIZE(mlk_job_dispatch(), 1U);
+	DT_EQ_INT(dispatched, 1);
+	DT_EQ_SIZE(mlk_job_dispatch(), 0U);
+
+	mlk_job_finish();
+}
+
+static void
+test_basics_wait_dependent(void)
+{
+	struct mlk_job_counter outer = {0};
+	struct mlk_job waiter = { .run = wait_dependent, .counter = &outer };
+	struct mlk_job opener = { .run = open_gate, .counter = &gate };
+
+	DT_EQ_INT(mlk_job_init(1), 0);
+
+	SDL_SetAtomicInt(&total, 0);
+	SDL_SetAtomicInt(&started, 0);
+	SDL_SetAtomicInt(&armed, 0);
+
+	mlk_job_submit(&waiter);
+
+	while (!SDL_GetAtomicInt(&started))
+		SDL_Delay(1);
+
+	/* The worker is busy, the gate can only be run from here. */
+	mlk_job_submit(&opener);
+	mlk_job_wait(&gate);
+
+	/*
+	 * The dependent job has been pushed on our queue, don't help with it:
+	 * the worker blocked in mlk_job_wait must pick it up by itself.
+	 */
+	for (int i = 0; i < 200 && !mlk_job_completed(&outer); ++i)
+		SDL_Delay(10);
+
+	DT_ASSERT(mlk_job_completed(&outer));
+	DT_EQ_INT(SDL_GetAtomicInt(&total), 1);
+
+	mlk_job_wait(&outer);
+	mlk_job_finish();
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_inline);
+	DT_RUN(test_basics_counter);
+	DT_RUN(test_basics_after);
+	DT_RUN(test_basics_parallel_for);
+	DT_RUN(test_basics_dispatch);
+	DT_RUN(test_basics_wait_dependent);
+	DT_SUMMARY();
+}
@@ -0,0 +1,162 @@
+/*
+ * test-lz.c -- test LZ compression
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <mlk/util/lz.h>
+
+#include <dt.h>
+
+#define SIZE 4096
+
+static unsigned char src[SIZE];
+static unsigned char packed[SIZE + SIZE / 255 + 16];
+static unsigned char unpacked[SIZE];
+
+/*
+ * Simple xorshift generator so that the incompressible input is the same on
+ * every platform.
+ */
+static void
+fill_random(unsigned char *data, size_t datasz)
+{
+	uint32_t x = 0x2545f491;
+
+	for (size_t i = 0; i < datasz; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		data[i] = x & 0xff;
+	}
+}
+
+static size_t
+roundtrip(const unsigned char *data, size_t datasz)
+{
+	size_t packedsz;
+
+	memset(unpacked, 0, sizeof (unpacked));
+
+	DT_ASSERT(mlk_lz_bound(datasz) <= sizeof (packed));
+	DT_ASSERT((packedsz = mlk_lz_compress(data, datasz, packed, mlk_lz_bound(datasz))) != 0);
+	DT_EQ_SIZE(mlk_lz_decompress(packed, packedsz, unpacked, datasz), datasz);
+	DT_ASSERT(memcmp(data, unpacked, datasz) == 0);
+
+	return packedsz;
+}
+
+static void
+test_basics_empty(void)
+{
+	/* Even empty input produces a single token. */
+	DT_EQ_SIZE(roundtrip(src, 0), 1U);
+}
+
+static void
+test_basics_incompressible(void)
+{
+	fill_random(src, sizeof (src));
+
+	/* Must not exceed the bound even when nothing matches. */
+	DT_ASSERT(roundtrip(src, sizeof (src)) <= mlk_lz_bound(sizeof (src)));
+}
+
+static void
+test_basics_repetitive(void)
+{
+	memset(src, 'a', sizeof (src));
+	DT_ASSERT(roundtrip(src, sizeof (src)) < sizeof (src) / 16);
+
+	for (size_t i = 0; i < sizeof (src); ++i)
+		src[i] = "molko"[i % 5];
+
+	DT_ASSERT(roundtrip(src, sizeof (src)) < sizeof (src) / 16);
+}
+
+static void
+test_basics_small(void)
+{
+	/* Shorter than the minimum match search window. */
+	DT_EQ_SIZE(roundtrip((const unsigned char *)"abcabcabc", 9), 10U);
+}
+
+static void
+test_error_dst(void)
+{
+	size_t packedsz;
+
+	/* Too small destination for compression is reported as 0. */
+	fill_random(src, sizeof (src));
+	DT_EQ_SIZE(mlk_lz_compress(src, sizeof (src), packed, sizeof (src) / 2), 0U);
+
+	/* Too small destination for decompression is an error. */
+	memset(src, 'a', sizeof (src));
+	DT_ASSERT((packedsz = mlk_lz_compress(src, sizeof (src), packed, sizeof (packed))) != 0);
+	DT_EQ_SIZE(mlk_lz_decompress(packed, packedsz, unpacked, sizeof (src) - 1), (size_t)-1);
+}
+
+static void
+test_error_truncated(void)
+{
+	size_t packedsz;
+
+	memset(src, 'a', sizeof (src));
+	DT_ASSERT((packedsz = mlk_lz_compress(src, sizeof (src), packed, sizeof (packed))) != 0);
+
+	/* Every prefix of the stream is either an error or a shorter output. */
+	for (size_t i = 1; i < packedsz; ++i)
+		DT_ASSERT(mlk_lz_decompress(packed, i, unpacked, sizeof (unpacked)) != sizeof (src));
+
+	/* Cut right after the literal, before the match offset. */
+	DT_EQ_SIZE(mlk_lz_decompress(packed, 3, unpacked, sizeof (unpacked)), (size_t)-1);
+
+	/* Cut in the middle of an extended literal length. */
+	DT_EQ_SIZE(mlk_lz_decompress((const unsigned char []) { 0xf0, 0xff }, 2,
+	    unpacked, sizeof (unpacked)), (size_t)-1);
+}
+
+static void
+test_error_corrupt(void)
+{
+	/* Literal 'a' followed by a match offset going before the output. */
+	static const unsigned char before[] = { 0x10, 'a', 0x02, 0x00 };
+
+	/* Offset 0 is never valid. */
+	static const unsigned char zero[] = { 0x10, 'a', 0x00, 0x00 };
+
+	/* Literal length larger than the remaining input. */
+	static const unsigned char literals[] = { 0x50, 'a', 'b' };
+
+	DT_EQ_SIZE(mlk_lz_decompress(before, sizeof (before), unpacked, sizeof (unpacked)), (size_t)-1);
+	DT_EQ_SIZE(mlk_lz_decompress(zero, sizeof (zero), unpacked, sizeof (unpacked)), (size_t)-1);
+	DT_EQ_SIZE(mlk_lz_decompress(literals, sizeof (literals), unpacked, sizeof (unpacked)), (size_t)-1);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_empty);
+	DT_RUN(test_basics_incompressible);
+	DT_RUN(test_basics_repetitive);
+	DT_RUN(test_basics_small);
+	DT_RUN(test_error_dst);
+	DT_RUN(test_error_truncated);
+	DT_RUN(test_error_corrupt);
+	DT_SUMMARY();
+}
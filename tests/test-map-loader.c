@@ -0,0 +1,443 @@
+/*
+ * test-map-loader.c -- test map loader
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mlk/util/mapbin.h>
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/err.h>
+#include <mlk/core/util.h>
+#include <mlk/core/vfs-blob.h>
+#include <mlk/core/vfs-zip.h>
+
+#include <mlk/rpg/map-loader.h>
+#include <mlk/rpg/map.h>
+#include <mlk/rpg/tileset.h>
+
+#if defined(MLK_WITH_ZIP)
+#	include <zip.h>
+#endif
+
+#include <dt.h>
+
+/*
+ * Text version of the map produced by compile, property names that are
+ * unknown or too long are ignored.
+ */
+static const char text_map[] =
+	"columns|2\n"
+	"rows|1\n"
+	"a-property-name-longer-than-any-known-one|1\n"
+	"tileset|world.tileset\n"
+	"layer|background\n"
+	"1\n"
+	"2\n"
+	"layer|foreground\n"
+	"3\n"
+	"4\n"
+	"layer|actions\n"
+	"-8|16|32|48|1|chest\n"
+	"1|2|3|4|0\n";
+
+/*
+ * Minimal loader that records what has been requested without opening any
+ * graphical resource.
+ */
+struct loader {
+	struct mlk_map_loader iface;
+	struct mlk_tileset tileset;
+	char tileset_name[64];
+	unsigned int *tiles[MLK_MAP_LAYER_TYPE_LAST];
+	struct mlk_map_block *blocks;
+	char objects[4][64];
+	size_t objectsz;
+};
+
+static struct mlk_tileset *
+new_tileset(struct mlk_map_loader *self, struct mlk_map *map, const char *ident)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, iface);
+
+	snprintf(loader->tileset_name, sizeof (loader->tileset_name), "%s", ident);
+
+	return &loader->tileset;
+}
+
+static unsigned int *
+new_tiles(struct mlk_map_loader *self,
+          struct mlk_map *map,
+          enum mlk_map_layer_type type,
+          size_t n)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, iface);
+
+	return loader->tiles[type] = mlk_alloc_new0(n, sizeof (unsigned int));
+}
+
+static struct mlk_map_block *
+expand_blocks(struct mlk_map_loader *self,
+              struct mlk_map *map,
+              struct mlk_map_block *blocks,
+              size_t blocksz)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, iface);
+
+	if (!loader->blocks)
+		loader->blocks = mlk_alloc_new0(blocksz, sizeof (*loader->blocks));
+	else
+		loader->blocks = mlk_alloc_resize0(loader->blocks, blocksz);
+
+	return loader->blocks;
+}
+
+static void
+new_object(struct mlk_map_loader *self,
+           struct mlk_map *map,
+           int x,
+           int y,
+           unsigned int w,
+           unsigned int h,
+           const char *argument)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, iface);
+
+	if (loader->objectsz < MLK_UTIL_SIZE(loader->objects))
+		snprintf(loader->objects[loader->objectsz++], sizeof (loader->objects[0]),
+		    "%d|%d|%u|%u|%s", x, y, w, h, argument);
+}
+
+static void
+clear(struct mlk_map_loader *self, struct mlk_map *map)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, iface);
+
+	for (int i = 0; i < MLK_MAP_LAYER_TYPE_LAST; ++i) {
+		mlk_alloc_free(loader->tiles[i]);
+		loader->tiles[i] = NULL;
+	}
+
+	mlk_alloc_free(loader->blocks);
+	loader->blocks = NULL;
+	loader->objectsz = 0;
+}
+
+static void
+init(struct loader *loader)
+{
+	memset(loader, 0, sizeof (*loader));
+	loader->iface.new_tileset = new_tileset;
+	loader->iface.new_tiles = new_tiles;
+	loader->iface.new_object = new_object;
+	loader->iface.expand_blocks = expand_blocks;
+	loader->iface.clear = clear;
+}
+
+/*
+ * Compile a 2x1 map with two layers, one block and two objects. The buffer is
+ * aligned so that blocks can be used in place.
+ */
+static size_t
+compile(unsigned char *buf)
+{
+	static const char strings[] = "\0world.tileset\0chest\0";
+	struct mlk_mapbin_header header = {
+		.version = MLK_MAPBIN_VERSION,
+		.layers = MLK_MAPBIN_LAYER_BG | MLK_MAPBIN_LAYER_FG,
+		.columns = 2,
+		.rows = 1,
+		.player_x = 10,
+		.player_y = 20,
+		.tileset = 1,
+		.blocksz = 1,
+		.objectsz = 2,
+		.stringsz = sizeof (strings)
+	};
+	struct mlk_mapbin_block block = { .x = -8, .y = 16, .w = 32, .h = 48 };
+	struct mlk_mapbin_object objects[] = {
+		{ .x = -8, .y = 16, .w = 32, .h = 48, .exec = 15 },
+		{ .x = 1, .y = 2, .w = 3, .h = 4, .exec = 0 }
+	};
+	unsigned char *p = buf;
+
+	mlk_mapbin_header_encode(&header, p);
+	p += MLK_MAPBIN_HEADER_SIZE;
+
+	for (uint32_t i = 0; i < 4; ++i, p += 4)
+		mlk_mapbin_tile_encode(i + 1, p);
+
+	mlk_mapbin_block_encode(&block, p);
+	p += MLK_MAPBIN_BLOCK_SIZE;
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(objects); ++i, p += MLK_MAPBIN_OBJECT_SIZE)
+		mlk_mapbin_object_encode(&objects[i], p);
+
+	memcpy(p, strings, sizeof (strings));
+
+	return (p - buf) + sizeof (strings);
+}
+
+/*
+ * Check what both the compiled and the text maps have in common.
+ */
+static void
+check_map(const struct loader *loader, const struct mlk_map *map)
+{
+	DT_EQ_STR(loader->tileset_name, "world.tileset");
+	DT_EQ_UINT(map->columns, 2U);
+	DT_EQ_UINT(map->rows, 1U);
+	DT_EQ_UINT(map->layers[MLK_MAP_LAYER_TYPE_BG].tiles[1], 2U);
+	DT_EQ_UINT(map->layers[MLK_MAP_LAYER_TYPE_FG].tiles[1], 4U);
+	DT_EQ_SIZE(map->blocksz, 1U);
+	DT_EQ_INT(map->blocks[0].x, -8);
+	DT_EQ_SIZE(loader->objectsz, 2U);
+	DT_EQ_STR(loader->objects[0], "-8|16|32|48|chest");
+}
+
+static void
+test_basics_binary(void)
+{
+	_Alignas(16) unsigned char data[256];
+	struct loader loader;
+	struct mlk_map map;
+	size_t datasz;
+
+	init(&loader);
+	datasz = compile(data);
+
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, data, datasz), 0);
+	DT_EQ_STR(loader.tileset_name, "world.tileset");
+	DT_EQ_PTR(map.tileset, &loader.tileset);
+	DT_EQ_UINT(map.columns, 2U);
+	DT_EQ_UINT(map.rows, 1U);
+	DT_EQ_INT(map.player_x, 10);
+	DT_EQ_INT(map.player_y, 20);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[0], 1U);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[1], 2U);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_FG].tiles[0], 3U);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_FG].tiles[1], 4U);
+	DT_ASSERT(!map.layers[MLK_MAP_LAYER_TYPE_ABOVE].tiles);
+	DT_EQ_SIZE(map.blocksz, 1U);
+	DT_EQ_INT(map.blocks[0].x, -8);
+	DT_EQ_INT(map.blocks[0].y, 16);
+	DT_EQ_UINT(map.blocks[0].w, 32U);
+	DT_EQ_UINT(map.blocks[0].h, 48U);
+	DT_EQ_SIZE(loader.objectsz, 2U);
+	DT_EQ_STR(loader.objects[0], "-8|16|32|48|chest");
+	DT_EQ_STR(loader.objects[1], "1|2|3|4|");
+
+	mlk_map_loader_clear(&loader.iface, &map);
+}
+
+static void
+test_basics_binary_writable(void)
+{
+	_Alignas(16) unsigned char data[256];
+	struct loader loader;
+	struct mlk_map map;
+	size_t datasz;
+	FILE *fp;
+
+	init(&loader);
+	datasz = compile(data);
+
+	DT_ASSERT((fp = fopen("writable.map", "wb")));
+	DT_EQ_SIZE(fwrite(data, 1, datasz, fp), datasz);
+	fclose(fp);
+
+	/* The file is mapped read-only, tiles must be copied to be edited. */
+	DT_EQ_INT(mlk_map_loader_open(&loader.iface, &map, "writable.map"), 0);
+	DT_EQ_PTR(map.layers[MLK_MAP_LAYER_TYPE_BG].tiles, loader.tiles[MLK_MAP_LAYER_TYPE_BG]);
+	DT_EQ_PTR(map.layers[MLK_MAP_LAYER_TYPE_FG].tiles, loader.tiles[MLK_MAP_LAYER_TYPE_FG]);
+
+	map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[0] = 42;
+	map.layers[MLK_MAP_LAYER_TYPE_FG].tiles[1] = 43;
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[0], 42U);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[1], 2U);
+	DT_EQ_UINT(map.layers[MLK_MAP_LAYER_TYPE_FG].tiles[1], 43U);
+	mlk_map_loader_clear(&loader.iface, &map);
+
+	/* The same goes for memory given by the user. */
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, data, datasz), 0);
+	map.layers[MLK_MAP_LAYER_TYPE_BG].tiles[0] = 42;
+	DT_EQ_UINT(mlk_mapbin_tile_decode(data + MLK_MAPBIN_HEADER_SIZE), 1U);
+	mlk_map_loader_clear(&loader.iface, &map);
+
+	remove("writable.map");
+}
+
+static void
+test_basics_text(void)
+{
+	struct loader loader;
+	struct mlk_map map;
+
+	init(&loader);
+
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, text_map, sizeof (text_map) - 1), 0);
+	check_map(&loader, &map);
+
+	mlk_map_loader_clear(&loader.iface, &map);
+}
+
+static void
+test_basics_vfs(void)
+{
+	_Alignas(16) unsigned char data[512];
+	struct mlk_vfs_blob_entry entries[2] = {};
+	struct mlk_vfs_blob blob;
+	struct loader loader;
+	struct mlk_map map;
+	size_t datasz;
+
+	init(&loader);
+
+	/* Both maps in the same blob, the binary one first to keep it aligned. */
+	datasz = compile(data);
+	entries[0] = (struct mlk_vfs_blob_entry) { "world.map", 0, datasz };
+	entries[1] = (struct mlk_vfs_blob_entry) { "world.txt", datasz, sizeof (text_map) - 1 };
+	memcpy(data + datasz, text_map, sizeof (text_map) - 1);
+	mlk_vfs_blob_init(&blob, data, entries, MLK_UTIL_SIZE(entries));
+
+	/* The compiled map is read in a buffer kept along with the map. */
+	DT_EQ_INT(mlk_map_loader_openvfs(&loader.iface, &map, &blob.vfs, "world.map"), 0);
+	check_map(&loader, &map);
+	DT_EQ_INT(map.player_x, 10);
+	DT_ASSERT(map.data);
+	DT_EQ_SIZE(map.datasz, datasz);
+	DT_ASSERT(map.data != data);
+	mlk_map_loader_clear(&loader.iface, &map);
+	DT_EQ_PTR(map.data, NULL);
+
+	/* The text one is parsed and released right away. */
+	DT_EQ_INT(mlk_map_loader_openvfs(&loader.iface, &map, &blob.vfs, "world.txt"), 0);
+	check_map(&loader, &map);
+	DT_EQ_PTR(map.data, NULL);
+	mlk_map_loader_clear(&loader.iface, &map);
+
+	DT_EQ_INT(mlk_map_loader_openvfs(&loader.iface, &map, &blob.vfs, "notfound.map"), -1);
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
+#if defined(MLK_WITH_ZIP)
+
+static void
+test_basics_vfs_zip(void)
+{
+	_Alignas(16) unsigned char data[256];
+	struct mlk_vfs_zip zip;
+	struct loader loader;
+	struct mlk_map map;
+	zip_source_t *source;
+	zip_t *archive;
+	size_t datasz;
+	int err;
+
+	init(&loader);
+	datasz = compile(data);
+
+	DT_ASSERT((archive = zip_open("world.zip", ZIP_CREATE | ZIP_TRUNCATE, &err)));
+	DT_ASSERT((source = zip_source_buffer(archive, data, datasz, 0)));
+	DT_ASSERT(zip_file_add(archive, "maps/world.map", source, ZIP_FL_OVERWRITE) >= 0);
+	DT_ASSERT((source = zip_source_buffer(archive, text_map, sizeof (text_map) - 1, 0)));
+	DT_ASSERT(zip_file_add(archive, "maps/world.txt", source, ZIP_FL_OVERWRITE) >= 0);
+	DT_EQ_INT(zip_close(archive), 0);
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, "world.zip", "r"), 0);
+
+	DT_EQ_INT(mlk_map_loader_openvfs(&loader.iface, &map, &zip.vfs, "maps/world.map"), 0);
+	check_map(&loader, &map);
+	DT_EQ_INT(map.player_y, 20);
+	DT_EQ_SIZE(map.datasz, datasz);
+	mlk_map_loader_clear(&loader.iface, &map);
+
+	/* Streamed entries are read the same way. */
+	zip.cache_limit = 0;
+
+	DT_EQ_INT(mlk_map_loader_openvfs(&loader.iface, &map, &zip.vfs, "maps/world.txt"), 0);
+	check_map(&loader, &map);
+	mlk_map_loader_clear(&loader.iface, &map);
+
+	mlk_vfs_finish(&zip.vfs);
+	remove("world.zip");
+}
+
+#endif
+
+static void
+test_error_truncated(void)
+{
+	_Alignas(16) unsigned char data[256];
+	struct loader loader;
+	struct mlk_map map;
+	size_t datasz;
+
+	init(&loader);
+	datasz = compile(data);
+
+	/* Strings section not terminated. */
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, data, datasz - 1), -1);
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, data, MLK_MAPBIN_HEADER_SIZE + 8), -1);
+
+	/* Unsupported version. */
+	data[8] = MLK_MAPBIN_VERSION + 1;
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, data, datasz), -1);
+
+	mlk_map_loader_clear(&loader.iface, &map);
+}
+
+static void
+test_error_position(void)
+{
+	static const char text[] =
+		"columns|2\n"
+		"rows|1\n"
+		"tileset|world.tileset\n"
+		"layer|background\n"
+		"1\n"
+		"2x\n";
+	struct loader loader;
+	struct mlk_map map;
+
+	init(&loader);
+
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, text, sizeof (text) - 1), -1);
+	DT_EQ_STR(mlk_err(), "6:2: end of line expected");
+	DT_EQ_INT(mlk_map_loader_openmem(&loader.iface, &map, "rows|-1\n", 8), -1);
+	DT_EQ_STR(mlk_err(), "1:6: number expected");
+
+	mlk_map_loader_clear(&loader.iface, &map);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_binary);
+	DT_RUN(test_basics_binary_writable);
+	DT_RUN(test_basics_text);
+	DT_RUN(test_basics_vfs);
+#if defined(MLK_WITH_ZIP)
+	DT_RUN(test_basics_vfs_zip);
+#endif
+	DT_RUN(test_error_truncated);
+	DT_RUN(test_error_position);
+	DT_SUMMARY();
+}
@@ -0,0 +1,195 @@
+/*
+ * test-render-queue.c -- test render queue
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include <mlk/core/render-queue.h>
+#include <mlk/core/sprite.h>
+
+#include <dt.h>
+
+static struct mlk_texture tex[2];
+
+static int order[64];
+static int ordersz;
+
+static void
+record(const struct mlk_render_cmd *cmd)
+{
+	order[ordersz++] = *(const int *)cmd->data;
+}
+
+static void
+test_basics_key(void)
+{
+	uint64_t low, high;
+
+	/* Layer comes first whatever the depth. */
+	low = mlk_render_key(0, 1000, &tex[0], MLK_TEXTURE_BLEND_NONE);
+	high = mlk_render_key(1, -1000, &tex[0], MLK_TEXTURE_BLEND_NONE);
+	DT_ASSERT(low < high);
+
+	/* Then depth, including negative values. */
+	low = mlk_render_key(2, -10, &tex[0], MLK_TEXTURE_BLEND_ADD);
+	high = mlk_render_key(2, 10, &tex[1], MLK_TEXTURE_BLEND_NONE);
+	DT_ASSERT(low < high);
+
+	/* Out of range depths are clamped. */
+	DT_ASSERT(mlk_render_key(0, -(1 << 30), NULL, 0) == mlk_render_key(0, -(1 << 23), NULL, 0));
+	DT_ASSERT(mlk_render_key(0, 1 << 30, NULL, 0) < mlk_render_key(1, -(1 << 30), NULL, 0));
+
+	/* Same texture and blend give the same key. */
+	DT_ASSERT(mlk_render_key(3, 5, &tex[1], MLK_TEXTURE_BLEND_BLEND) ==
+	          mlk_render_key(3, 5, &tex[1], MLK_TEXTURE_BLEND_BLEND));
+	DT_ASSERT(mlk_render_key(3, 5, &tex[0], MLK_TEXTURE_BLEND_BLEND) !=
+	          mlk_render_key(3, 5, &tex[1], MLK_TEXTURE_BLEND_BLEND));
+}
+
+static void
+test_basics_flush(void)
+{
+	struct mlk_render_queue queue;
+	int ids[] = { 0, 1, 2, 3, 4 };
+	uint64_t keys[] = {
+		mlk_render_key(1, 20, NULL, 0),
+		mlk_render_key(0, 50, NULL, 0),
+		mlk_render_key(1, -5, NULL, 0),
+		mlk_render_key(1, 20, NULL, 0),
+		mlk_render_key(0, 50, NULL, 0)
+	};
+
+	mlk_render_queue_init(&queue);
+	ordersz = 0;
+
+	for (int i = 0; i < 5; ++i)
+		mlk_render_queue_push(&queue, &(const struct mlk_render_cmd) {
+			.key = keys[i],
+			.draw = record,
+			.data = &ids[i]
+		});
+
+	DT_EQ_INT(mlk_render_queue_flush(&queue), 0);
+	DT_EQ_SIZE(queue.cmdsz, 0U);
+
+	/* Equal keys keep submission order. */
+	DT_EQ_INT(ordersz, 5);
+	DT_EQ_INT(order[0], 1);
+	DT_EQ_INT(order[1], 4);
+	DT_EQ_INT(order[2], 2);
+	DT_EQ_INT(order[3], 0);
+	DT_EQ_INT(order[4], 3);
+
+	mlk_render_queue_finish(&queue);
+}
+
+static void
+test_basics_clear(void)
+{
+	struct mlk_render_queue queue;
+	int id = 0;
+
+	mlk_render_queue_init(&queue);
+	ordersz = 0;
+
+	mlk_render_queue_push(&queue, &(const struct mlk_render_cmd) {
+		.draw = record,
+		.data = &id
+	});
+	mlk_render_queue_clear(&queue);
+
+	DT_EQ_INT(mlk_render_queue_flush(&queue), 0);
+	DT_EQ_INT(ordersz, 0);
+
+	mlk_render_queue_finish(&queue);
+}
+
+static void
+test_basics_blend(void)
+{
+	struct mlk_render_queue queue;
+	struct mlk_sprite sprite = {
+		.texture = &tex[1],
+		.cellw = 16,
+		.cellh = 16,
+		.nrows = 1,
+		.ncols = 1
+	};
+
+	tex[0].w = tex[0].h = 32;
+	tex[1].w = tex[1].h = 16;
+
+	mlk_render_queue_init(&queue);
+
+	/* Helpers take the blend mode from the key. */
+	mlk_render_queue_texture(&queue, mlk_render_key(1, 0, &tex[0], MLK_TEXTURE_BLEND_ADD), &tex[0], 0, 0);
+	mlk_render_queue_sprite(&queue, mlk_render_key(0, 0, &tex[1], MLK_TEXTURE_BLEND_BLEND), &sprite, 0, 0, 0, 0);
+	mlk_render_queue_sort(&queue);
+
+	DT_EQ_SIZE(queue.cmdsz, 2U);
+	DT_EQ_PTR(queue.cmds[0].texture, &tex[1]);
+	DT_EQ_INT(queue.cmds[0].blend, MLK_TEXTURE_BLEND_BLEND);
+	DT_EQ_PTR(queue.cmds[1].texture, &tex[0]);
+	DT_EQ_INT(queue.cmds[1].blend, MLK_TEXTURE_BLEND_ADD);
+	DT_EQ_UINT(queue.cmds[1].dst_w, 32U);
+
+	mlk_render_queue_finish(&queue);
+}
+
+static void
+test_sort_random(void)
+{
+	struct mlk_render_queue queue;
+	int ids[1000];
+
+	mlk_render_queue_init(&queue);
+	srand(1234);
+
+	/* Few distinct keys to check stability along with ordering. */
+	for (int i = 0; i < 1000; ++i) {
+		ids[i] = i;
+		mlk_render_queue_push(&queue, &(const struct mlk_render_cmd) {
+			.key = mlk_render_key(rand() % 3, rand() % 64 - 32, &tex[rand() % 2], 0),
+			.draw = record,
+			.data = &ids[i]
+		});
+	}
+
+	mlk_render_queue_sort(&queue);
+
+	DT_EQ_SIZE(queue.cmdsz, 1000U);
+
+	for (size_t i = 1; i < queue.cmdsz; ++i) {
+		DT_ASSERT(queue.cmds[i - 1].key <= queue.cmds[i].key);
+
+		if (queue.cmds[i - 1].key == queue.cmds[i].key)
+			DT_ASSERT(*(int *)queue.cmds[i - 1].data < *(int *)queue.cmds[i].data);
+	}
+
+	mlk_render_queue_finish(&queue);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_key);
+	DT_RUN(test_basics_flush);
+	DT_RUN(test_basics_clear);
+	DT_RUN(test_basics_blend);
+	DT_RUN(test_sort_random);
+	DT_SUMMARY();
+}
@@ -20,15 +20,17 @@
 
 #include <mlk/core/event.h>
 #include <mlk/core/game.h>
+#include <mlk/core/job.h>
 #include <mlk/core/state.h>
-#include <mlk/core/util.h>
 
 #include <dt.h>
 
 struct invokes {
+	unsigned int preload;
 	unsigned int start;
 	unsigned int handle;
 	unsigned int update;
+	unsigned int snapshot;
 	unsigned int draw;
 	unsigned int suspend;
 	unsigned int resume;
@@ -36,8 +38,6 @@ struct invokes {
 	unsigned int finish;
 };
 
-static struct mlk_state *mainstates[16];
-
 static void
 my_start(struct mlk_state *state)
 {
@@ -60,6 +60,12 @@ my_update(struct mlk_state *state, unsigned int ticks)
 	((struct invokes *)state->data)->update++;
 }
 
+static void
+my_snapshot(struct mlk_state *state)
+{
+	((struct invokes *)state->data)->snapshot++;
+}
+
 static void
 my_draw(struct mlk_state *state)
 {
@@ -95,6 +101,7 @@ my_finish(struct mlk_state *state)
 	.start = my_start, \
 	.handle = my_handle, \
 	.update = my_update, \
+	.snapshot = my_snapshot, \
 	.draw = my_draw, \
 	.suspend = my_suspend, \
 	.resume = my_resume, \
@@ -147,6 +154,110 @@ test_basics_update(void)
 	DT_EQ_UINT(inv.finish, 0U);
 }
 
+static void
+test_basics_snapshot(void)
+{
+	struct invokes inv = {0};
+	struct mlk_state state = INIT(&inv);
+
+	mlk_state_snapshot(&state);
+	DT_EQ_UINT(inv.start, 0U);
+	DT_EQ_UINT(inv.handle, 0U);
+	DT_EQ_UINT(inv.update, 0U);
+	DT_EQ_UINT(inv.snapshot, 1U);
+	DT_EQ_UINT(inv.draw, 0U);
+	DT_EQ_UINT(inv.end, 0U);
+	DT_EQ_UINT(inv.finish, 0U);
+}
+
+static void
+my_preload(struct mlk_state *state, struct mlk_state_transition *transition)
+{
+	mlk_state_transition_report(transition, 1, 2);
+	((struct invokes *)state->data)->preload = mlk_state_transition_progress(transition);
+}
+
+static void
+my_preloaded(struct mlk_state_transition *transition)
+{
+	((struct invokes *)transition->data)->start++;
+}
+
+static void
+my_restart(struct mlk_state_transition *transition)
+{
+	struct invokes *inv = transition->data;
+
+	/* The transition must be reusable from its own callback. */
+	DT_ASSERT(!mlk_state_transition_busy(transition));
+
+	if (inv->start++ == 0)
+		mlk_state_transition_start(transition);
+}
+
+static void
+test_basics_preload_restart(void)
+{
+	struct invokes inv = {0};
+	struct mlk_state state = INIT(&inv);
+	struct mlk_state_transition transition = {
+		.state = &state,
+		.done = my_restart,
+		.data = &inv
+	};
+
+	state.preload = my_preload;
+
+	/* Without workers, the second preload runs from the callback. */
+	mlk_state_transition_start(&transition);
+	DT_EQ_UINT(inv.start, 2U);
+
+	/* With workers, each callback is invoked from its own dispatch. */
+	inv.start = 0;
+	DT_EQ_INT(mlk_job_init(2), 0);
+	mlk_state_transition_start(&transition);
+	mlk_state_transition_wait(&transition);
+	DT_EQ_SIZE(mlk_job_dispatch(), 1U);
+	DT_EQ_UINT(inv.start, 1U);
+	mlk_state_transition_wait(&transition);
+	DT_EQ_SIZE(mlk_job_dispatch(), 1U);
+	DT_EQ_UINT(inv.start, 2U);
+	DT_ASSERT(!mlk_state_transition_busy(&transition));
+	mlk_job_finish();
+}
+
+static void
+test_basics_preload(void)
+{
+	struct invokes inv = {0};
+	struct mlk_state state = INIT(&inv);
+	struct mlk_state_transition transition = {
+		.state = &state,
+		.done = my_preloaded,
+		.data = &inv
+	};
+
+	state.preload = my_preload;
+
+	/* Without workers, everything runs immediately. */
+	mlk_state_transition_start(&transition);
+	DT_EQ_UINT(inv.preload, 49U);
+	DT_EQ_UINT(inv.start, 1U);
+	DT_EQ_UINT(mlk_state_transition_progress(&transition), 100U);
+	DT_ASSERT(!mlk_state_transition_busy(&transition));
+
+	/* With workers, the callback waits for the dispatch. */
+	inv.preload = 0;
+	DT_EQ_INT(mlk_job_init(2), 0);
+	mlk_state_transition_start(&transition);
+	mlk_state_transition_wait(&transition);
+	DT_EQ_UINT(inv.preload, 49U);
+	DT_EQ_UINT(inv.start, 1U);
+	DT_EQ_SIZE(mlk_job_dispatch(), 1U);
+	DT_EQ_UINT(inv.start, 2U);
+	mlk_job_finish();
+}
+
 static void
 test_basics_draw(void)
 {
@@ -192,134 +303,39 @@ test_basics_finish(void)
 	DT_EQ_UINT(inv.finish, 1U);
 }
 
+static struct mlk_state *current;
+
+static void
+game_start(void)
+{
+	mlk_state_start(current);
+	mlk_game_quit();
+}
+
 static void
 test_basics_game(void)
 {
-	static struct {
-		struct invokes inv;
-		struct mlk_state state;
-	} states[] = {
-		{ .state = INIT(&states[0].inv) },
-		{ .state = INIT(&states[1].inv) }
+	static const struct mlk_game_ops ops = {
+		.start = game_start
 	};
 
-	/* 0 becomes active and should start. */
-	mlk_game.states = mainstates;
-	mlk_game.statesz = MLK_UTIL_SIZE(mainstates);
-	mlk_game_init();
-	mlk_game_push(&states[0].state);
-
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 0U);
-	DT_EQ_UINT(states[0].inv.update, 0U);
-	DT_EQ_UINT(states[0].inv.draw, 0U);
-	DT_EQ_UINT(states[0].inv.suspend, 0U);
-	DT_EQ_UINT(states[0].inv.resume, 0U);
-	DT_EQ_UINT(states[0].inv.end, 0U);
-	DT_EQ_UINT(states[0].inv.finish, 0U);
-
-	/* Put some event, update and drawing. */
-	mlk_game_handle(&(union mlk_event) { .type = MLK_EVENT_QUIT });
-	mlk_game_update(100);
-	mlk_game_update(100);
-	mlk_game_draw();
-	mlk_game_draw();
-	mlk_game_draw();
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 1U);
-	DT_EQ_UINT(states[0].inv.update, 2U);
-	DT_EQ_UINT(states[0].inv.draw, 3U);
-	DT_EQ_UINT(states[0].inv.suspend, 0U);
-	DT_EQ_UINT(states[0].inv.resume, 0U);
-	DT_EQ_UINT(states[0].inv.end, 0U);
-	DT_EQ_UINT(states[0].inv.finish, 0U);
-
-	/* Switch to state 1, 0 must be suspended. */
-	mlk_game_push(&states[1].state);
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 1U);
-	DT_EQ_UINT(states[0].inv.update, 2U);
-	DT_EQ_UINT(states[0].inv.draw, 3U);
-	DT_EQ_UINT(states[0].inv.suspend, 1U);
-	DT_EQ_UINT(states[0].inv.resume, 0U);
-	DT_EQ_UINT(states[0].inv.end, 0U);
-	DT_EQ_UINT(states[0].inv.finish, 0U);
-
-	DT_EQ_UINT(states[1].inv.start, 1U);
-	DT_EQ_UINT(states[1].inv.handle, 0U);
-	DT_EQ_UINT(states[1].inv.update, 0U);
-	DT_EQ_UINT(states[1].inv.draw, 0U);
-	DT_EQ_UINT(states[1].inv.suspend, 0U);
-	DT_EQ_UINT(states[1].inv.resume, 0U);
-	DT_EQ_UINT(states[1].inv.end, 0U);
-	DT_EQ_UINT(states[1].inv.finish, 0U);
-
-	/* Update a little this state. */
-	mlk_game_update(10);
-	mlk_game_update(10);
-	mlk_game_update(10);
-	mlk_game_update(10);
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 1U);
-	DT_EQ_UINT(states[0].inv.update, 2U);
-	DT_EQ_UINT(states[0].inv.draw, 3U);
-	DT_EQ_UINT(states[0].inv.suspend, 1U);
-	DT_EQ_UINT(states[0].inv.resume, 0U);
-	DT_EQ_UINT(states[0].inv.end, 0U);
-	DT_EQ_UINT(states[0].inv.finish, 0U);
-
-	DT_EQ_UINT(states[1].inv.start, 1U);
-	DT_EQ_UINT(states[1].inv.handle, 0U);
-	DT_EQ_UINT(states[1].inv.update, 4U);
-	DT_EQ_UINT(states[1].inv.draw, 0U);
-	DT_EQ_UINT(states[1].inv.suspend, 0U);
-	DT_EQ_UINT(states[1].inv.resume, 0U);
-	DT_EQ_UINT(states[1].inv.end, 0U);
-	DT_EQ_UINT(states[1].inv.finish, 0U);
-
-	/* Pop it, it should be finalized through end and finish. */
-	mlk_game_pop();
-
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 1U);
-	DT_EQ_UINT(states[0].inv.update, 2U);
-	DT_EQ_UINT(states[0].inv.draw, 3U);
-	DT_EQ_UINT(states[0].inv.suspend, 1U);
-	DT_EQ_UINT(states[0].inv.resume, 1U);
-	DT_EQ_UINT(states[0].inv.end, 0U);
-	DT_EQ_UINT(states[0].inv.finish, 0U);
-
-	DT_EQ_UINT(states[1].inv.start, 1U);
-	DT_EQ_UINT(states[1].inv.handle, 0U);
-	DT_EQ_UINT(states[1].inv.update, 4U);
-	DT_EQ_UINT(states[1].inv.draw, 0U);
-	DT_EQ_UINT(states[1].inv.suspend, 0U);
-	DT_EQ_UINT(states[1].inv.resume, 0U);
-	DT_EQ_UINT(states[1].inv.end, 1U);
-	DT_EQ_UINT(states[1].inv.finish, 1U);
-
-	/* Pop this state as well. */
-	mlk_game_pop();
-
-	DT_EQ_UINT(states[0].inv.start, 1U);
-	DT_EQ_UINT(states[0].inv.handle, 1U);
-	DT_EQ_UINT(states[0].inv.update, 2U);
-	DT_EQ_UINT(states[0].inv.draw, 3U);
-	DT_EQ_UINT(states[0].inv.suspend, 1U);
-	DT_EQ_UINT(states[0].inv.resume, 1U);
-	DT_EQ_UINT(states[0].inv.end, 1U);
-	DT_EQ_UINT(states[0].inv.finish, 1U);
-
-	DT_EQ_UINT(states[1].inv.start, 1U);
-	DT_EQ_UINT(states[1].inv.handle, 0U);
-	DT_EQ_UINT(states[1].inv.update, 4U);
-	DT_EQ_UINT(states[1].inv.draw, 0U);
-	DT_EQ_UINT(states[1].inv.suspend, 0U);
-	DT_EQ_UINT(states[1].inv.resume, 0U);
-	DT_EQ_UINT(states[1].inv.end, 1U);
-	DT_EQ_UINT(states[1].inv.finish, 1U);
+	struct invokes inv = {0};
+	struct mlk_state state = INIT(&inv);
 
-	mlk_game_quit();
+	current = &state;
+	mlk_game_init(&ops);
+	DT_EQ_PTR(mlk_game.ops, &ops);
+
+	/* The state quits from start, no frame is run. */
+	mlk_game_loop();
+	DT_EQ_UINT(inv.start, 1U);
+	DT_EQ_UINT(inv.handle, 0U);
+	DT_EQ_UINT(inv.update, 0U);
+	DT_EQ_UINT(inv.draw, 0U);
+
+	/* The loop can be entered again once it has returned. */
+	mlk_game_loop();
+	DT_EQ_UINT(inv.start, 2U);
 }
 
 int
@@ -328,6 +344,9 @@ main(void)
 	DT_RUN(test_basics_start);
 	DT_RUN(test_basics_handle);
 	DT_RUN(test_basics_update);
+	DT_RUN(test_basics_snapshot);
+	DT_RUN(test_basics_preload);
+	DT_RUN(test_basics_preload_restart);
 	DT_RUN(test_basics_draw);
 	DT_RUN(test_basics_end);
 	DT_RUN(test_basics_finish);
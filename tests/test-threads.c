@@ -0,0 +1,259 @@
+/*
+ * test-util.c -- test utilities
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <SDL3/SDL.h>
+
+#include <mlk/util/util.h>
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/err.h>
+#include <mlk/core/sprite.h>
+#include <mlk/core/sys.h>
+#include <mlk/core/texture.h>
+#include <mlk/core/util.h>
+
+#include <mlk/rpg/map-loader.h>
+#include <mlk/rpg/map.h>
+#include <mlk/rpg/save.h>
+#include <mlk/rpg/tileset-loader.h>
+#include <mlk/rpg/tileset.h>
+
+#include <dt.h>
+
+/*
+ * Every thread loads the same map, its tileset and a save database using only
+ * its own loaders. Configure with MLK_WITH_TSAN to detect hidden shared
+ * state, results are checked from the main thread once all are joined.
+ */
+
+#define THREADS         8
+#define ITERATIONS      50
+
+struct loader {
+	struct mlk_map_loader map_iface;
+	struct mlk_tileset_loader tileset_iface;
+	struct mlk_tileset tileset;
+	struct mlk_texture texture;
+	struct mlk_sprite sprite;
+	struct mlk_tileset_collision *collisions;
+	unsigned int *tiles[MLK_MAP_LAYER_TYPE_LAST];
+};
+
+struct worker {
+	unsigned int id;
+	const char *sysdir;
+	char pathf[64];
+	char error[MLK_ERR_MAX];
+	unsigned int columns;
+	unsigned int rows;
+	unsigned int tilewidth;
+	size_t collisionsz;
+	int nrand_ok;
+	int saved;
+	int loaded;
+};
+
+static struct mlk_texture *
+new_texture(struct mlk_tileset_loader *self, struct mlk_tileset *tileset, const char *ident)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, tileset_iface);
+
+	/* No renderer, only dimensions are required. */
+	loader->texture.w = 256;
+	loader->texture.h = 128;
+
+	return &loader->texture;
+}
+
+static struct mlk_sprite *
+new_sprite(struct mlk_tileset_loader *self, struct mlk_tileset *tileset)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, tileset_iface);
+
+	return &loader->sprite;
+}
+
+static struct mlk_tileset_collision *
+expand_collisions(struct mlk_tileset_loader *self,
+                  struct mlk_tileset *tileset,
+                  struct mlk_tileset_collision *array,
+                  size_t arraysz)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, tileset_iface);
+
+	if (!loader->collisions)
+		loader->collisions = mlk_alloc_new0(arraysz, sizeof (*loader->collisions));
+	else
+		loader->collisions = mlk_alloc_resize0(loader->collisions, arraysz);
+
+	return loader->collisions;
+}
+
+static struct mlk_tileset *
+new_tileset(struct mlk_map_loader *self, struct mlk_map *map, const char *ident)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, map_iface);
+	char path[MLK_PATH_MAX];
+
+	mlk_util_pathf_r(path, sizeof (path), "%s/maps/%s", DIRECTORY, ident);
+
+	if (mlk_tileset_loader_open(&loader->tileset_iface, &loader->tileset, path) < 0)
+		return NULL;
+
+	return &loader->tileset;
+}
+
+static unsigned int *
+new_tiles(struct mlk_map_loader *self,
+          struct mlk_map *map,
+          enum mlk_map_layer_type type,
+          size_t n)
+{
+	struct loader *loader = MLK_UTIL_CONTAINER_OF(self, struct loader, map_iface);
+
+	return loader->tiles[type] = mlk_alloc_new0(n, sizeof (unsigned int));
+}
+
+static void
+clear(struct loader *loader)
+{
+	for (int i = 0; i < MLK_MAP_LAYER_TYPE_LAST; ++i) {
+		mlk_alloc_free(loader->tiles[i]);
+		loader->tiles[i] = NULL;
+	}
+
+	mlk_alloc_free(loader->collisions);
+	loader->collisions = NULL;
+}
+
+static void
+init(struct loader *loader)
+{
+	memset(loader, 0, sizeof (*loader));
+	loader->map_iface.new_tileset = new_tileset;
+	loader->map_iface.new_tiles = new_tiles;
+	loader->tileset_iface.new_texture = new_texture;
+	loader->tileset_iface.new_sprite = new_sprite;
+	loader->tileset_iface.expand_collisions = expand_collisions;
+}
+
+static int
+run(void *data)
+{
+	struct worker *worker = data;
+	struct loader loader;
+	struct mlk_map map;
+	struct mlk_save save;
+	const char *path;
+	char savepath[64];
+
+	init(&loader);
+	worker->nrand_ok = 1;
+
+	/* Let every thread compute the cached directory at once. */
+	worker->sysdir = mlk_sys_dir(MLK_SYS_DIR_SAVE);
+
+	for (int i = 0; i < ITERATIONS; ++i) {
+		/* The thread-local buffer must survive other threads calls. */
+		path = mlk_util_pathf("thread-%u", worker->id);
+
+		if (mlk_util_nrand(2, 6) < 2 || mlk_util_nrand(2, 6) >= 6)
+			worker->nrand_ok = 0;
+
+		if (mlk_map_loader_open(&loader.map_iface, &map, DIRECTORY "/maps/sample-map.map") < 0) {
+			mlk_util_strlcpy(worker->error, mlk_err(), sizeof (worker->error));
+			break;
+		}
+
+		worker->columns = map.columns;
+		worker->rows = map.rows;
+		worker->tilewidth = loader.sprite.cellw;
+		worker->collisionsz = loader.tileset.collisionsz;
+		worker->loaded++;
+		clear(&loader);
+
+		mlk_util_strlcpy(worker->pathf, path, sizeof (worker->pathf));
+	}
+
+	mlk_util_pathf_r(savepath, sizeof (savepath), "thread-%u.db", worker->id);
+
+	if (mlk_save_open_path(&save, savepath, MLK_SAVE_MODE_WRITE) == 0) {
+		worker->saved = save.created > 0;
+		mlk_save_finish(&save);
+	}
+
+	remove(savepath);
+
+	return 0;
+}
+
+static void
+test_basics_loaders(void)
+{
+	struct worker workers[THREADS] = {0};
+	SDL_Thread *threads[THREADS];
+	char expected[64];
+
+	for (unsigned int i = 0; i < THREADS; ++i) {
+		workers[i].id = i;
+		threads[i] = SDL_CreateThread(run, "test-threads", &workers[i]);
+		DT_ASSERT(threads[i]);
+	}
+
+	for (unsigned int i = 0; i < THREADS; ++i)
+		SDL_WaitThread(threads[i], NULL);
+
+	for (unsigned int i = 0; i < THREADS; ++i) {
+		snprintf(expected, sizeof (expected), "thread-%u", i);
+
+		DT_EQ_STR(workers[i].error, "");
+		DT_EQ_INT(workers[i].loaded, ITERATIONS);
+		DT_EQ_UINT(workers[i].columns, 4U);
+		DT_EQ_UINT(workers[i].rows, 2U);
+		DT_EQ_UINT(workers[i].tilewidth, 64U);
+		DT_EQ_SIZE(workers[i].collisionsz, 4U);
+		DT_EQ_STR(workers[i].pathf, expected);
+		DT_ASSERT(workers[i].nrand_ok);
+		DT_ASSERT(workers[i].saved);
+		DT_EQ_PTR(workers[i].sysdir, workers[0].sysdir);
+	}
+}
+
+static void
+test_basics_nrand_r(void)
+{
+	uint64_t s1 = 1234, s2 = 1234;
+
+	/* Same seed, same sequence whichever thread uses it. */
+	for (int i = 0; i < 100; ++i)
+		DT_EQ_UINT(mlk_util_nrand_r(&s1, 0, 1000), mlk_util_nrand_r(&s2, 0, 1000));
+
+	DT_EQ_UINT(mlk_util_nrand_r(&s1, 5, 5), 5U);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_loaders);
+	DT_RUN(test_basics_nrand_r);
+	DT_SUMMARY();
+}
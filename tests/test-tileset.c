@@ -16,11 +16,23 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <stdio.h>
+#include <string.h>
+
+#include <mlk/util/util.h>
+
 #include <mlk/core/core.h>
 #include <mlk/core/err.h>
 #include <mlk/core/sprite.h>
+#include <mlk/core/texture.h>
+#include <mlk/core/util.h>
+#include <mlk/core/vfs-blob.h>
+#include <mlk/core/vfs-dir.h>
 #include <mlk/core/window.h>
 
+#include <mlk/rpg/map-loader-file.h>
+#include <mlk/rpg/map-loader.h>
+#include <mlk/rpg/map.h>
 #include <mlk/rpg/tileset-loader.h>
 #include <mlk/rpg/tileset-loader-file.h>
 #include <mlk/rpg/tileset.h>
@@ -35,6 +47,22 @@ struct tileset {
 	struct mlk_tileset tileset;
 };
 
+/*
+ * Directory VFS counting the images opened, to check when the texture cache
+ * actually decodes them.
+ */
+static struct mlk_vfs_file *(*dir_open)(struct mlk_vfs *, const char *, const char *);
+static unsigned int images;
+
+static struct mlk_vfs_file *
+count_open(struct mlk_vfs *self, const char *entry, const char *mode)
+{
+	if (strstr(entry, ".png"))
+		images++;
+
+	return dir_open(self, entry, mode);
+}
+
 static inline int
 tileset_open(struct tileset *ts, const char *path)
 {
@@ -105,18 +133,147 @@ test_basics_clear(struct tileset *ts)
 	DT_EQ_UINT(ts->tileset.sprite->cellh, 32U);
 }
 
+static void
+test_basics_vfs(struct tileset *ts)
+{
+	struct mlk_vfs_dir dir;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/maps");
+
+	/* Image is opened from the same VFS, relative to the tileset entry. */
+	DT_EQ_INT(mlk_tileset_loader_file_initvfs(&ts->loader, &dir.vfs, "sample-tileset.tileset"), 0);
+	DT_EQ_INT(mlk_tileset_loader_openvfs(&ts->loader.iface, &ts->tileset, &dir.vfs, "sample-tileset.tileset"), 0);
+	DT_EQ_UINT(ts->tileset.sprite->cellw, 64U);
+	DT_EQ_UINT(ts->tileset.sprite->cellh, 32U);
+	DT_EQ_UINT(ts->tileset.collisionsz, 4U);
+
+	mlk_vfs_finish(&dir.vfs);
+}
+
+static void
+test_cache_normalize(struct tileset *ts)
+{
+	static const char *paths[] = {
+		DIRECTORY "/maps/./sample-tileset.tileset",
+		DIRECTORY "/maps/../maps/sample-tileset.tileset",
+		DIRECTORY "//maps//sample-tileset.tileset"
+	};
+	struct tileset other;
+
+	DT_EQ_INT(tileset_open(ts, DIRECTORY "/maps/sample-tileset.tileset"), 0);
+
+	/* Every spelling of the same absolute path shares the texture. */
+	for (size_t i = 0; i < MLK_UTIL_SIZE(paths); ++i) {
+		DT_EQ_INT(tileset_open(&other, paths[i]), 0);
+		DT_EQ_PTR(other.tileset.sprite->texture, ts->tileset.sprite->texture);
+		tileset_finish(&other);
+	}
+}
+
+static void
+test_cache_release(struct tileset *ts)
+{
+	struct mlk_vfs_dir dir;
+	struct tileset other, disk;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY);
+	dir_open = dir.vfs.open;
+	dir.vfs.open = count_open;
+	images = 0;
+
+	DT_EQ_INT(mlk_tileset_loader_file_initvfs(&ts->loader, &dir.vfs, "maps/sample-tileset.tileset"), 0);
+	DT_EQ_INT(mlk_tileset_loader_openvfs(&ts->loader.iface, &ts->tileset, &dir.vfs, "maps/sample-tileset.tileset"), 0);
+	DT_EQ_UINT(images, 1U);
+
+	/* Relative entries are resolved the same way. */
+	DT_EQ_INT(mlk_tileset_loader_file_initvfs(&other.loader, &dir.vfs, "./maps/../maps/sample-tileset.tileset"), 0);
+	DT_EQ_INT(mlk_tileset_loader_openvfs(&other.loader.iface, &other.tileset, &dir.vfs, "./maps/../maps/sample-tileset.tileset"), 0);
+	DT_EQ_UINT(images, 1U);
+	DT_EQ_PTR(other.tileset.sprite->texture, ts->tileset.sprite->texture);
+
+	/* Keyed by VFS too, the same image out of it is another texture. */
+	DT_EQ_INT(tileset_open(&disk, DIRECTORY "/maps/sample-tileset.tileset"), 0);
+	DT_ASSERT(disk.tileset.sprite->texture != ts->tileset.sprite->texture);
+	tileset_finish(&disk);
+
+	/* Still referenced by the first loader. */
+	tileset_finish(&other);
+	DT_EQ_UINT(ts->tileset.sprite->texture->w, 256U);
+	DT_EQ_UINT(ts->tileset.sprite->texture->h, 256U);
+
+	/* Last reference dropped, opening again decodes the image again. */
+	mlk_tileset_loader_clear(&ts->loader.iface, &ts->tileset);
+	DT_EQ_INT(mlk_tileset_loader_openvfs(&ts->loader.iface, &ts->tileset, &dir.vfs, "maps/sample-tileset.tileset"), 0);
+	DT_EQ_UINT(images, 2U);
+
+	mlk_tileset_loader_clear(&ts->loader.iface, &ts->tileset);
+	mlk_vfs_finish(&dir.vfs);
+}
+
+static void
+test_cache_map(struct tileset *ts)
+{
+	struct mlk_tileset_loader_file tileset_loader;
+	struct mlk_map_loader_file loader;
+	struct mlk_map map = {};
+
+	DT_EQ_INT(tileset_open(ts, DIRECTORY "/maps/sample-tileset.tileset"), 0);
+
+	/* The map loads the same tileset through its own loader. */
+	DT_EQ_INT(mlk_tileset_loader_file_init(&tileset_loader, DIRECTORY "/maps/sample-map.map"), 0);
+	DT_EQ_INT(mlk_map_loader_file_init(&loader, &tileset_loader.iface, DIRECTORY "/maps/sample-map.map"), 0);
+	DT_EQ_INT(mlk_map_loader_open(&loader.iface, &map, DIRECTORY "/maps/sample-map.map"), 0);
+	DT_EQ_PTR(map.tileset->sprite->texture, ts->tileset.sprite->texture);
+
+	mlk_map_loader_finish(&loader.iface);
+	mlk_tileset_loader_finish(&tileset_loader.iface);
+
+	/* The tileset loader still holds its reference. */
+	DT_EQ_UINT(ts->tileset.sprite->texture->w, 256U);
+}
+
+static void
+test_error_overlong(struct tileset *ts)
+{
+	static char entry[MLK_PATH_MAX], data[MLK_PATH_MAX];
+	struct mlk_vfs_blob_entry entries[1];
+	struct mlk_vfs_blob blob;
+	size_t n = 0;
+
+	/* Both the entry directory and the image fit but not joined. */
+	while (n < MLK_PATH_MAX / 2)
+		n += snprintf(entry + n, sizeof (entry) - n, "d/");
+
+	snprintf(entry + n, sizeof (entry) - n, "t.tileset");
+
+	n = snprintf(data, sizeof (data), "tilewidth|64\ntileheight|32\nimage|");
+
+	while (n < MLK_PATH_MAX / 2 + 64)
+		n += snprintf(data + n, sizeof (data) - n, "i/");
+
+	n += snprintf(data + n, sizeof (data) - n, "x.png\n");
+
+	entries[0] = (struct mlk_vfs_blob_entry) { entry, 0, n };
+	mlk_vfs_blob_init(&blob, data, entries, 1);
+
+	DT_EQ_INT(mlk_tileset_loader_file_initvfs(&ts->loader, &blob.vfs, entry), 0);
+	DT_EQ_INT(mlk_tileset_loader_openvfs(&ts->loader.iface, &ts->tileset, &blob.vfs, entry), -1);
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
 static void
 test_error_tilewidth(struct tileset *ts)
 {
 	DT_EQ_INT(tileset_open(ts, DIRECTORY "/maps/error-tilewidth.tileset"), -1);
-	DT_EQ_STR(mlk_err(), "missing tile dimensions before image");
+	DT_EQ_STR(mlk_err(), "2:6: missing tile dimensions before image");
 }
 
 static void
 test_error_tileheight(struct tileset *ts)
 {
 	DT_EQ_INT(tileset_open(ts, DIRECTORY "/maps/error-tileheight.tileset"), -1);
-	DT_EQ_STR(mlk_err(), "missing tile dimensions before image");
+	DT_EQ_STR(mlk_err(), "2:6: missing tile dimensions before image");
 }
 
 static void
@@ -148,6 +305,11 @@ main(void)
 
 	DT_RUN_EX(test_basics_sample, setup, teardown, &ts);
 	DT_RUN_EX(test_basics_clear, setup, teardown, &ts);
+	DT_RUN_EX(test_basics_vfs, setup, teardown, &ts);
+	DT_RUN_EX(test_cache_normalize, setup, teardown, &ts);
+	DT_RUN_EX(test_cache_release, setup, teardown, &ts);
+	DT_RUN_EX(test_cache_map, setup, teardown, &ts);
+	DT_RUN_EX(test_error_overlong, setup, teardown, &ts);
 	DT_RUN_EX(test_error_tilewidth, setup, teardown, &ts);
 	DT_RUN_EX(test_error_tileheight, setup, teardown, &ts);
 	DT_RUN_EX(test_error_image, setup, teardown, &ts);
@@ -0,0 +1,215 @@
+/*
+ * test-timer.c -- test timer wheel
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include <mlk/core/timer.h>
+
+#include <dt.h>
+
+struct counter {
+	struct mlk_timer timer;
+	unsigned int fired;
+	uint64_t at;
+};
+
+static uint64_t now;
+
+static void
+fire(struct mlk_timer *timer)
+{
+	struct counter *counter = timer->data;
+
+	counter->fired++;
+	counter->at = now;
+}
+
+static void
+cancel_other(struct mlk_timer *timer)
+{
+	mlk_timer_cancel(timer->data);
+}
+
+/* Advance one millisecond at a time to know exactly when timers fire. */
+static void
+advance(unsigned int ticks)
+{
+	while (ticks--) {
+		now++;
+		mlk_timer_dispatch(1);
+	}
+}
+
+static void
+test_basics_schedule(void)
+{
+	struct counter c = { .timer = { .fire = fire, .data = &c } };
+
+	now = 0;
+	mlk_timer_schedule(&c.timer, 10);
+
+	DT_ASSERT(mlk_timer_pending(&c.timer));
+	DT_EQ_UINT(mlk_timer_remaining(&c.timer), 10U);
+
+	advance(9);
+	DT_EQ_UINT(c.fired, 0U);
+	DT_EQ_UINT(mlk_timer_remaining(&c.timer), 1U);
+
+	advance(1);
+	DT_EQ_UINT(c.fired, 1U);
+	DT_ASSERT(!mlk_timer_pending(&c.timer));
+
+	/* Zero delay fires on next dispatch. */
+	mlk_timer_schedule(&c.timer, 0);
+	DT_EQ_SIZE(mlk_timer_dispatch(1), 1U);
+	DT_EQ_UINT(c.fired, 2U);
+
+	mlk_timer_finish();
+}
+
+static void
+test_basics_cancel(void)
+{
+	struct counter a = { .timer = { .fire = fire, .data = &a } };
+	struct counter b = { .timer = { .fire = fire, .data = &b } };
+	struct mlk_timer killer = { .fire = cancel_other, .data = &b.timer };
+
+	now = 0;
+	mlk_timer_schedule(&a.timer, 100);
+	mlk_timer_cancel(&a.timer);
+	mlk_timer_cancel(&a.timer);
+
+	DT_ASSERT(!mlk_timer_pending(&a.timer));
+	DT_EQ_UINT(mlk_timer_remaining(&a.timer), 0U);
+
+	/* Cancelled from a callback fired in the same millisecond. */
+	mlk_timer_schedule(&killer, 5000);
+	mlk_timer_schedule(&b.timer, 5000);
+
+	advance(6000);
+	DT_EQ_UINT(a.fired, 0U);
+	DT_EQ_UINT(b.fired, 0U);
+
+	mlk_timer_finish();
+}
+
+static void
+test_basics_reschedule(void)
+{
+	struct counter c = { .timer = { .fire = fire, .data = &c } };
+
+	now = 0;
+	mlk_timer_schedule(&c.timer, 50);
+	advance(40);
+	mlk_timer_reschedule(&c.timer, 50);
+	advance(49);
+	DT_EQ_UINT(c.fired, 0U);
+	advance(1);
+	DT_EQ_UINT(c.fired, 1U);
+	DT_EQ_UINT(c.at, 90U);
+
+	/* Also works when not scheduled. */
+	mlk_timer_reschedule(&c.timer, 1);
+	advance(1);
+	DT_EQ_UINT(c.fired, 2U);
+
+	mlk_timer_finish();
+}
+
+static void
+test_basics_interval(void)
+{
+	struct counter c = { .timer = { .fire = fire, .interval = 100, .data = &c } };
+
+	now = 0;
+	mlk_timer_schedule(&c.timer, 10);
+
+	/* Large ticks still fire every period. */
+	DT_EQ_SIZE(mlk_timer_dispatch(1010), 11U);
+	DT_EQ_UINT(c.fired, 11U);
+	DT_EQ_UINT(mlk_timer_remaining(&c.timer), 100U);
+
+	mlk_timer_cancel(&c.timer);
+	DT_EQ_SIZE(mlk_timer_dispatch(1000), 0U);
+
+	mlk_timer_finish();
+}
+
+static void
+test_wheel_random(void)
+{
+	static struct counter counters[2000];
+	static uint64_t deadlines[2000];
+
+	now = 0;
+	srand(42);
+
+	/* Spread over every level, including beyond the wheel range. */
+	for (int i = 0; i < 2000; ++i) {
+		unsigned int delay;
+
+		switch (i % 4) {
+		case 0:
+			delay = rand() % 64;
+			break;
+		case 1:
+			delay = rand() % 4096;
+			break;
+		case 2:
+			delay = rand() % 300000;
+			break;
+		default:
+			delay = 16777216 + rand() % 100000;
+			break;
+		}
+
+		counters[i].timer.fire = fire;
+		counters[i].timer.data = &counters[i];
+		deadlines[i] = delay ? delay : 1;
+		mlk_timer_schedule(&counters[i].timer, delay);
+	}
+
+	/* Jump close to the far ones, nothing may fire late or early. */
+	for (int i = 0; i < 300000; ++i)
+		advance(1);
+
+	for (int i = 0; i < 2000; ++i)
+		if (i % 4 != 3)
+			DT_ASSERT(counters[i].fired == 1 && counters[i].at == deadlines[i]);
+
+	for (int i = 0; i < 16877216 - 300000; i += 1000) {
+		now += 1000;
+		mlk_timer_dispatch(1000);
+	}
+
+	for (int i = 3; i < 2000; i += 4)
+		DT_ASSERT(counters[i].fired == 1 && !mlk_timer_pending(&counters[i].timer));
+
+	mlk_timer_finish();
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_schedule);
+	DT_RUN(test_basics_cancel);
+	DT_RUN(test_basics_reschedule);
+	DT_RUN(test_basics_interval);
+	DT_RUN(test_wheel_random);
+	DT_SUMMARY();
+}
@@ -0,0 +1,174 @@
+/*
+ * test-vfs-async.c -- test asynchronous VFS reads
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <mlk/core/alloc.h>
+#include <mlk/core/vfs-async.h>
+#include <mlk/core/vfs-dir.h>
+
+#include <dt.h>
+
+static void
+done(struct mlk_vfs_async_request *req)
+{
+	int *called = req->data;
+
+	*called += 1;
+}
+
+static void
+drain(void)
+{
+	while (mlk_vfs_async_busy())
+		mlk_vfs_async_dispatch();
+}
+
+static void
+test_basics_read(void)
+{
+	struct mlk_vfs_dir dir;
+	struct mlk_vfs_async_request req = {};
+	int called = 0;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/vfs/directory");
+	DT_EQ_INT(mlk_vfs_async_init(2), 0);
+
+	req.vfs = &dir.vfs;
+	req.path = "hello.txt";
+	req.data = &called;
+	req.done = done;
+	mlk_vfs_async_submit(&req);
+	drain();
+
+	DT_EQ_INT(called, 1);
+	DT_EQ_INT(req.status, MLK_VFS_ASYNC_STATUS_DONE);
+	DT_EQ_SIZE(req.contentsz, 13U);
+	DT_EQ_STR(req.content, "Hello World!\n");
+
+	mlk_alloc_free(req.content);
+	mlk_vfs_async_finish();
+	mlk_vfs_finish(&dir.vfs);
+}
+
+static void
+test_basics_many(void)
+{
+	struct mlk_vfs_dir dir;
+	struct mlk_vfs_async_request reqs[64] = {};
+	int called = 0;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/vfs/directory");
+	DT_EQ_INT(mlk_vfs_async_init(4), 0);
+
+	for (size_t i = 0; i < 64; ++i) {
+		reqs[i].vfs = &dir.vfs;
+		reqs[i].path = "hello.txt";
+		reqs[i].priority = i % MLK_VFS_ASYNC_PRIORITY_LAST;
+		reqs[i].data = &called;
+		reqs[i].done = done;
+		mlk_vfs_async_submit(&reqs[i]);
+	}
+
+	/* Promote a prefetch request, it must not change the outcome. */
+	mlk_vfs_async_prioritize(&reqs[2], MLK_VFS_ASYNC_PRIORITY_HIGH);
+	drain();
+
+	DT_EQ_INT(called, 64);
+
+	for (size_t i = 0; i < 64; ++i) {
+		DT_EQ_INT(reqs[i].status, MLK_VFS_ASYNC_STATUS_DONE);
+		DT_EQ_STR(reqs[i].content, "Hello World!\n");
+		mlk_alloc_free(reqs[i].content);
+	}
+
+	mlk_vfs_async_finish();
+	mlk_vfs_finish(&dir.vfs);
+}
+
+static void
+test_basics_cancel(void)
+{
+	struct mlk_vfs_dir dir;
+	struct mlk_vfs_async_request reqs[16] = {};
+	int called = 0;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/vfs/directory");
+	DT_EQ_INT(mlk_vfs_async_init(1), 0);
+
+	for (size_t i = 0; i < 16; ++i) {
+		reqs[i].vfs = &dir.vfs;
+		reqs[i].path = "hello.txt";
+		reqs[i].data = &called;
+		reqs[i].done = done;
+		mlk_vfs_async_submit(&reqs[i]);
+	}
+
+	/* Whatever their state, cancelled requests are never dispatched. */
+	for (size_t i = 0; i < 16; i += 2)
+		mlk_vfs_async_cancel(&reqs[i]);
+
+	drain();
+
+	DT_EQ_INT(called, 8);
+
+	for (size_t i = 0; i < 16; ++i) {
+		if (i % 2 == 0) {
+			DT_EQ_INT(reqs[i].status, MLK_VFS_ASYNC_STATUS_NONE);
+			DT_EQ_PTR(reqs[i].content, NULL);
+		} else
+			mlk_alloc_free(reqs[i].content);
+	}
+
+	mlk_vfs_async_finish();
+	mlk_vfs_finish(&dir.vfs);
+}
+
+static void
+test_error_notfound(void)
+{
+	struct mlk_vfs_dir dir;
+	struct mlk_vfs_async_request req = {};
+	int called = 0;
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/vfs/directory");
+	DT_EQ_INT(mlk_vfs_async_init(0), 0);
+
+	req.vfs = &dir.vfs;
+	req.path = "notfound.txt";
+	req.data = &called;
+	req.done = done;
+	mlk_vfs_async_submit(&req);
+	drain();
+
+	DT_EQ_INT(called, 1);
+	DT_EQ_INT(req.status, MLK_VFS_ASYNC_STATUS_FAILED);
+	DT_EQ_PTR(req.content, NULL);
+	DT_ASSERT(req.error[0]);
+
+	mlk_vfs_async_finish();
+	mlk_vfs_finish(&dir.vfs);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_read);
+	DT_RUN(test_basics_many);
+	DT_RUN(test_basics_cancel);
+	DT_RUN(test_error_notfound);
+	DT_SUMMARY();
+}
@@ -0,0 +1,123 @@
+/*
+ * test-vfs-blob.c -- test VFS embedded blobs
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <mlk/core/util.h>
+#include <mlk/core/vfs-blob.h>
+
+#include <dt.h>
+
+/*
+ * Same layout as generated by mlk-bcc -d, every entry aligned on 16 bytes and
+ * sorted by name.
+ */
+static const unsigned char data[] =
+	"abc\0\0\0\0\0\0\0\0\0\0\0\0\0"
+	"Hello World!\n\0\0\0"
+	"nested";
+
+static const struct mlk_vfs_blob_entry entries[] = {
+	{ "a.txt",              0,      3       },
+	{ "hello.txt",          16,     13      },
+	{ "sub/nested.txt",     32,     6       }
+};
+
+static void
+test_basics_read(void)
+{
+	struct mlk_vfs_blob blob;
+	struct mlk_vfs_file *file;
+	char buf[64] = {};
+
+	mlk_vfs_blob_init(&blob, data, entries, MLK_UTIL_SIZE(entries));
+
+	DT_ASSERT(file = mlk_vfs_open(&blob.vfs, "hello.txt", "r"));
+	DT_EQ_SIZE(mlk_vfs_file_size(file), 13U);
+	DT_EQ_UINT(mlk_vfs_file_read(file, buf, sizeof (buf)), 13U);
+	DT_EQ_STR(buf, "Hello World!\n");
+	DT_EQ_UINT(mlk_vfs_file_read(file, buf, sizeof (buf)), 0U);
+	mlk_vfs_file_finish(file);
+
+	DT_ASSERT(file = mlk_vfs_open(&blob.vfs, "sub/nested.txt", "r"));
+	DT_EQ_INT(mlk_vfs_file_seek(file, -3, MLK_VFS_SEEK_END), 0);
+	DT_EQ_UINT(mlk_vfs_file_read(file, buf, sizeof (buf)), 3U);
+	DT_ASSERT(memcmp(buf, "ted", 3) == 0);
+	DT_EQ_INT(mlk_vfs_file_seek(file, 0, (enum mlk_vfs_whence)42), -1);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), mlk_vfs_file_size(file));
+	mlk_vfs_file_finish(file);
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
+static void
+test_basics_find(void)
+{
+	struct mlk_vfs_blob blob;
+	const char *content;
+	size_t size = 0;
+
+	mlk_vfs_blob_init(&blob, data, entries, MLK_UTIL_SIZE(entries));
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(entries); ++i) {
+		DT_ASSERT(content = mlk_vfs_blob_find(&blob, entries[i].name, &size));
+		DT_EQ_PTR(content, (const char *)data + entries[i].offset);
+		DT_EQ_SIZE(size, entries[i].size);
+	}
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
+static void
+test_error_notfound(void)
+{
+	struct mlk_vfs_blob blob;
+
+	mlk_vfs_blob_init(&blob, data, entries, MLK_UTIL_SIZE(entries));
+
+	DT_ASSERT(!mlk_vfs_open(&blob.vfs, "b.txt", "r"));
+	DT_ASSERT(!mlk_vfs_open(&blob.vfs, "hello.txt", "w"));
+	DT_ASSERT(!mlk_vfs_blob_find(&blob, "sub", NULL));
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
+static void
+test_error_write(void)
+{
+	struct mlk_vfs_blob blob;
+	struct mlk_vfs_file *file;
+	char buf[] = "xyz";
+
+	mlk_vfs_blob_init(&blob, data, entries, MLK_UTIL_SIZE(entries));
+
+	/* Read-only implementations don't provide a write callback. */
+	DT_ASSERT(file = mlk_vfs_open(&blob.vfs, "a.txt", "r"));
+	DT_EQ_SIZE(mlk_vfs_file_write(file, buf, 3), (size_t)-1);
+	mlk_vfs_file_finish(file);
+
+	mlk_vfs_finish(&blob.vfs);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_read);
+	DT_RUN(test_basics_find);
+	DT_RUN(test_error_notfound);
+	DT_RUN(test_error_write);
+	DT_SUMMARY();
+}
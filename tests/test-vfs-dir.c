@@ -37,6 +37,32 @@ test_basics_read(void)
 	mlk_vfs_finish(&dir.vfs);
 }
 
+static void
+test_basics_seek(void)
+{
+	struct mlk_vfs_dir dir;
+	struct mlk_vfs_file *file;
+	char data[256] = {};
+
+	mlk_vfs_dir_init(&dir, DIRECTORY "/vfs/directory");
+
+	DT_ASSERT(file = mlk_vfs_open(&dir.vfs, "hello.txt", "r"));
+	DT_EQ_SIZE(mlk_vfs_file_size(file), 13U);
+	DT_EQ_INT(mlk_vfs_file_seek(file, 6, MLK_VFS_SEEK_SET), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 6U);
+	DT_EQ_UINT(mlk_vfs_file_read(file, data, sizeof (data)), 7U);
+	DT_EQ_STR(data, "World!\n");
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 13U);
+
+	/* Size must not move the current position. */
+	DT_EQ_INT(mlk_vfs_file_seek(file, -7, MLK_VFS_SEEK_END), 0);
+	DT_EQ_SIZE(mlk_vfs_file_size(file), 13U);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 6U);
+
+	mlk_vfs_file_finish(file);
+	mlk_vfs_finish(&dir.vfs);
+}
+
 static void
 test_error_notfound(void)
 {
@@ -53,6 +79,7 @@ int
 main(void)
 {
 	DT_RUN(test_basics_read);
+	DT_RUN(test_basics_seek);
 	DT_RUN(test_error_notfound);
 	DT_SUMMARY();
 }
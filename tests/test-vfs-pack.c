@@ -0,0 +1,308 @@
+/*
+ * test-vfs-pack.c -- test VFS pack archives
+ *
+ * Copyright (c) 2020-2026 David Demelier <markand@malikania.fr>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mlk/util/lz.h>
+#include <mlk/util/pack.h>
+
+#include <mlk/core/util.h>
+#include <mlk/core/vfs-pack.h>
+
+#include <dt.h>
+
+#define REPEAT "all work and no play makes jack a dull boy\n"
+
+struct file {
+	const char *name;
+	const char *data;
+	int compress;
+	struct mlk_pack_entry entry;
+};
+
+/*
+ * Files stored in the archive built for every test, the last one is
+ * repetitive enough to be stored compressed.
+ */
+static struct file files[] = {
+	{ .name = "texts/hello.txt", .data = "Hello from pack file!\n" },
+	{ .name = "texts/world.txt", .data = "Hello world\n" },
+	{ .name = "texts/empty.txt", .data = "" },
+	{ .name = "texts/boy.txt", .data = REPEAT REPEAT REPEAT REPEAT, .compress = 1 }
+};
+
+static unsigned char archive[4096];
+
+static int
+cmp(const void *d1, const void *d2)
+{
+	const struct file *f1 = d1, *f2 = d2;
+
+	if (f1->entry.hash != f2->entry.hash)
+		return f1->entry.hash < f2->entry.hash ? -1 : 1;
+
+	return strcmp(f1->name, f2->name);
+}
+
+static inline uint64_t
+align(uint64_t offset)
+{
+	return (offset + MLK_PACK_ALIGN - 1) & ~(uint64_t)(MLK_PACK_ALIGN - 1);
+}
+
+/*
+ * Build the same layout as mlk-pack: header, data aligned on MLK_PACK_ALIGN,
+ * index sorted by hash then name and finally the string table.
+ */
+static size_t
+build(void)
+{
+	struct mlk_pack_header header = {
+		.version = MLK_PACK_VERSION,
+		.entriesz = MLK_UTIL_SIZE(files)
+	};
+	uint64_t offset = MLK_PACK_HEADER_SIZE;
+	uint32_t name = 0;
+	size_t length;
+
+	memset(archive, 0, sizeof (archive));
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(files); ++i)
+		files[i].entry.hash = mlk_pack_hash(files[i].name);
+
+	qsort(files, MLK_UTIL_SIZE(files), sizeof (*files), cmp);
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(files); ++i) {
+		offset = align(offset);
+		length = strlen(files[i].data);
+
+		files[i].entry.offset = offset;
+		files[i].entry.length = length;
+		files[i].entry.name = name;
+
+		if (files[i].compress) {
+			files[i].entry.size = mlk_lz_compress(files[i].data, length,
+			    archive + offset, sizeof (archive) - offset);
+			files[i].entry.flags = MLK_PACK_LZ;
+			DT_ASSERT(files[i].entry.size != 0);
+			DT_ASSERT(files[i].entry.size < length);
+		} else {
+			memcpy(archive + offset, files[i].data, length);
+			files[i].entry.size = length;
+			files[i].entry.flags = 0;
+		}
+
+		offset += files[i].entry.size;
+		name += strlen(files[i].name) + 1;
+	}
+
+	header.index = align(offset);
+	header.names = header.index + MLK_UTIL_SIZE(files) * MLK_PACK_ENTRY_SIZE;
+	header.namesz = name;
+
+	for (size_t i = 0; i < MLK_UTIL_SIZE(files); ++i) {
+		mlk_pack_entry_encode(&files[i].entry, archive + header.index + i * MLK_PACK_ENTRY_SIZE);
+		memcpy(archive + header.names + files[i].entry.name, files[i].name, strlen(files[i].name) + 1);
+	}
+
+	mlk_pack_header_encode(&header, archive);
+
+	return header.names + header.namesz;
+}
+
+static void
+read_entry(struct mlk_vfs_pack *pack, const char *entry, const char *expected)
+{
+	struct mlk_vfs_file *file;
+	char data[256] = {};
+
+	DT_ASSERT(file = mlk_vfs_open(&pack->vfs, entry, "r"));
+	DT_EQ_SIZE(mlk_vfs_file_size(file), strlen(expected));
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), strlen(expected));
+	DT_EQ_STR(data, expected);
+
+	/* End of file reached. */
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), 0U);
+
+	mlk_vfs_file_finish(file);
+}
+
+static void
+test_basics_read(void)
+{
+	struct mlk_vfs_pack pack;
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, build()), 0);
+
+	read_entry(&pack, "texts/hello.txt", "Hello from pack file!\n");
+	read_entry(&pack, "texts/world.txt", "Hello world\n");
+	read_entry(&pack, "texts/empty.txt", "");
+	read_entry(&pack, "texts/boy.txt", REPEAT REPEAT REPEAT REPEAT);
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+static void
+test_basics_find(void)
+{
+	struct mlk_vfs_pack pack;
+	const char *data;
+	size_t size;
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, build()), 0);
+
+	/* Stored entries point directly inside the archive. */
+	DT_ASSERT(data = mlk_vfs_pack_find(&pack, "texts/hello.txt", &size));
+	DT_EQ_SIZE(size, 22U);
+	DT_ASSERT(strncmp(data, "Hello from pack file!\n", size) == 0);
+	DT_ASSERT((const unsigned char *)data >= archive);
+	DT_ASSERT((const unsigned char *)data < archive + sizeof (archive));
+
+	/* Compressed entries can't be accessed in place. */
+	DT_ASSERT(!mlk_vfs_pack_find(&pack, "texts/boy.txt", &size));
+	DT_ASSERT(!mlk_vfs_pack_find(&pack, "texts/notfound.txt", &size));
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+static void
+seek_entry(struct mlk_vfs_pack *pack, const char *entry)
+{
+	struct mlk_vfs_file *file;
+	char data[8] = {};
+	size_t size;
+
+	DT_ASSERT(file = mlk_vfs_open(&pack->vfs, entry, "r"));
+	DT_ASSERT((size = mlk_vfs_file_size(file)) > 10U);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 0U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, 6, MLK_VFS_SEEK_SET), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 6U);
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, 4), 4U);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 10U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, -4, MLK_VFS_SEEK_CUR), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 6U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, -1, MLK_VFS_SEEK_END), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), size - 1);
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), 1U);
+	DT_EQ_INT(data[0], '\n');
+
+	/* Out of bounds or invalid, the offset is left untouched. */
+	DT_EQ_INT(mlk_vfs_file_seek(file, -1, MLK_VFS_SEEK_SET), -1);
+	DT_EQ_INT(mlk_vfs_file_seek(file, 1, MLK_VFS_SEEK_END), -1);
+	DT_EQ_INT(mlk_vfs_file_seek(file, 0, (enum mlk_vfs_whence)42), -1);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), size);
+
+	mlk_vfs_file_finish(file);
+}
+
+static void
+test_basics_seek(void)
+{
+	struct mlk_vfs_pack pack;
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, build()), 0);
+
+	seek_entry(&pack, "texts/hello.txt");
+	seek_entry(&pack, "texts/boy.txt");
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+static void
+test_error_notfound(void)
+{
+	struct mlk_vfs_pack pack;
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, build()), 0);
+	DT_ASSERT(!mlk_vfs_open(&pack.vfs, "notfound.txt", "r"));
+	DT_ASSERT(!mlk_vfs_open(&pack.vfs, "texts/hello", "r"));
+	DT_ASSERT(!mlk_vfs_open(&pack.vfs, "/texts/hello.txt", "r"));
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+static void
+test_error_write(void)
+{
+	struct mlk_vfs_pack pack;
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, build()), 0);
+	DT_ASSERT(!mlk_vfs_open(&pack.vfs, "texts/hello.txt", "w"));
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+static void
+test_error_header(void)
+{
+	struct mlk_vfs_pack pack;
+	size_t size;
+
+	/* Bad magic. */
+	size = build();
+	archive[0] = 'X';
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, size), -1);
+
+	/* Unsupported version. */
+	size = build();
+	archive[8] = MLK_PACK_VERSION + 1;
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, size), -1);
+
+	/* Truncated header. */
+	size = build();
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, MLK_PACK_HEADER_SIZE - 1), -1);
+
+	/* Sections past the end of the data. */
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, size - 1), -1);
+}
+
+static void
+test_error_corrupted(void)
+{
+	struct mlk_vfs_pack pack;
+	size_t size;
+
+	size = build();
+
+	/* Break the compressed stream so that decompression fails at open. */
+	for (size_t i = 0; i < MLK_UTIL_SIZE(files); ++i)
+		if (files[i].compress)
+			memset(archive + files[i].entry.offset, 0xff, files[i].entry.size);
+
+	DT_EQ_INT(mlk_vfs_pack_initmem(&pack, archive, size), 0);
+	DT_ASSERT(!mlk_vfs_open(&pack.vfs, "texts/boy.txt", "r"));
+
+	mlk_vfs_finish(&pack.vfs);
+}
+
+int
+main(void)
+{
+	DT_RUN(test_basics_read);
+	DT_RUN(test_basics_find);
+	DT_RUN(test_basics_seek);
+	DT_RUN(test_error_notfound);
+	DT_RUN(test_error_write);
+	DT_RUN(test_error_header);
+	DT_RUN(test_error_corrupted);
+	DT_SUMMARY();
+}
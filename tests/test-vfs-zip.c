@@ -16,10 +16,25 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <string.h>
+
 #include <mlk/core/vfs-zip.h>
 
 #include <dt.h>
 
+static void
+read_entry(struct mlk_vfs_zip *zip, const char *entry, const char *expected)
+{
+	struct mlk_vfs_file *file;
+	char data[256] = {};
+
+	DT_ASSERT(file = mlk_vfs_open(&zip->vfs, entry, "r"));
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), strlen(expected));
+	DT_EQ_STR(data, expected);
+
+	mlk_vfs_file_finish(file);
+}
+
 static void
 test_basics_read(void)
 {
@@ -36,6 +51,76 @@ test_basics_read(void)
 	mlk_vfs_finish(&zip.vfs);
 }
 
+static void
+seek_entry(struct mlk_vfs_zip *zip, const char *entry)
+{
+	struct mlk_vfs_file *file;
+	char data[16] = {};
+
+	DT_ASSERT(file = mlk_vfs_open(&zip->vfs, entry, "r"));
+	DT_EQ_SIZE(mlk_vfs_file_size(file), 32U);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 0U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, 8, MLK_VFS_SEEK_SET), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 8U);
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, 7), 7U);
+	DT_EQ_STR(data, "Entry A");
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 15U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, -8, MLK_VFS_SEEK_CUR), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 7U);
+
+	DT_EQ_INT(mlk_vfs_file_seek(file, -8, MLK_VFS_SEEK_END), 0);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 24U);
+	memset(data, 0, sizeof (data));
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), 8U);
+	DT_EQ_STR(data, "Entry A\n");
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 32U);
+
+	/* Rejected before reaching libzip, offset left untouched. */
+	DT_EQ_INT(mlk_vfs_file_seek(file, 0, (enum mlk_vfs_whence)42), -1);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 32U);
+
+	mlk_vfs_file_finish(file);
+}
+
+static void
+test_basics_seek(void)
+{
+	struct mlk_vfs_zip zip;
+	struct mlk_vfs_file *file;
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	seek_entry(&zip, "texts/a.txt");
+	DT_EQ_SIZE(zip.stats.misses, 1U);
+	DT_EQ_SIZE(zip.stats.size, 32U);
+
+	/* Cached entries are checked against their size. */
+	DT_ASSERT(file = mlk_vfs_open(&zip.vfs, "texts/a.txt", "r"));
+	DT_EQ_INT(mlk_vfs_file_seek(file, -1, MLK_VFS_SEEK_SET), -1);
+	DT_EQ_INT(mlk_vfs_file_seek(file, 1, MLK_VFS_SEEK_END), -1);
+	DT_EQ_SIZE(mlk_vfs_file_tell(file), 0U);
+	mlk_vfs_file_finish(file);
+
+	mlk_vfs_finish(&zip.vfs);
+}
+
+static void
+test_basics_seek_streamed(void)
+{
+	struct mlk_vfs_zip zip;
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	zip.cache_limit = 0;
+
+	seek_entry(&zip, "texts/a.txt");
+	DT_EQ_SIZE(zip.stats.size, 0U);
+
+	mlk_vfs_finish(&zip.vfs);
+}
+
 static void
 test_error_notfound(void)
 {
@@ -47,10 +132,113 @@ test_error_notfound(void)
 	mlk_vfs_finish(&zip.vfs);
 }
 
+static void
+test_cache_hit(void)
+{
+	struct mlk_vfs_zip zip;
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	read_entry(&zip, "texts/hello.txt", "Hello from zip file!\n");
+	DT_EQ_SIZE(zip.stats.hits, 0U);
+	DT_EQ_SIZE(zip.stats.misses, 1U);
+	DT_EQ_SIZE(zip.stats.size, 21U);
+
+	read_entry(&zip, "texts/hello.txt", "Hello from zip file!\n");
+	DT_EQ_SIZE(zip.stats.hits, 1U);
+	DT_EQ_SIZE(zip.stats.misses, 1U);
+	DT_EQ_SIZE(zip.stats.evictions, 0U);
+	DT_EQ_SIZE(zip.stats.size, 21U);
+
+	mlk_vfs_finish(&zip.vfs);
+}
+
+static void
+test_cache_eviction(void)
+{
+	struct mlk_vfs_zip zip;
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	/* Room for two entries of 32 bytes. */
+	zip.cache_limit = 64;
+
+	read_entry(&zip, "texts/a.txt", "Entry A\nEntry A\nEntry A\nEntry A\n");
+	read_entry(&zip, "texts/b.txt", "Entry B\nEntry B\nEntry B\nEntry B\n");
+	DT_EQ_SIZE(zip.stats.evictions, 0U);
+	DT_EQ_SIZE(zip.stats.size, 64U);
+
+	/* Use A again so that B becomes the least recently used. */
+	read_entry(&zip, "texts/a.txt", "Entry A\nEntry A\nEntry A\nEntry A\n");
+	read_entry(&zip, "texts/c.txt", "Entry C\nEntry C\nEntry C\nEntry C\n");
+	DT_EQ_SIZE(zip.stats.hits, 1U);
+	DT_EQ_SIZE(zip.stats.misses, 3U);
+	DT_EQ_SIZE(zip.stats.evictions, 1U);
+	DT_EQ_SIZE(zip.stats.size, 64U);
+
+	/* A is still there but B has been evicted. */
+	read_entry(&zip, "texts/a.txt", "Entry A\nEntry A\nEntry A\nEntry A\n");
+	DT_EQ_SIZE(zip.stats.hits, 2U);
+	read_entry(&zip, "texts/b.txt", "Entry B\nEntry B\nEntry B\nEntry B\n");
+	DT_EQ_SIZE(zip.stats.misses, 4U);
+	DT_EQ_SIZE(zip.stats.evictions, 2U);
+
+	mlk_vfs_finish(&zip.vfs);
+}
+
+static void
+test_cache_opened(void)
+{
+	struct mlk_vfs_zip zip;
+	struct mlk_vfs_file *file;
+	char data[256] = {};
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	zip.cache_limit = 32;
+
+	/* A is kept opened while B is loaded, none can be evicted. */
+	DT_ASSERT(file = mlk_vfs_open(&zip.vfs, "texts/a.txt", "r"));
+	read_entry(&zip, "texts/b.txt", "Entry B\nEntry B\nEntry B\nEntry B\n");
+	DT_EQ_SIZE(zip.stats.evictions, 1U);
+	DT_EQ_SIZE(zip.stats.size, 32U);
+
+	/* B got evicted on close, A must still be readable. */
+	DT_EQ_SIZE(mlk_vfs_file_read(file, data, sizeof (data)), 32U);
+	DT_EQ_STR(data, "Entry A\nEntry A\nEntry A\nEntry A\n");
+
+	mlk_vfs_file_finish(file);
+	mlk_vfs_finish(&zip.vfs);
+}
+
+static void
+test_cache_disabled(void)
+{
+	struct mlk_vfs_zip zip;
+
+	DT_EQ_INT(mlk_vfs_zip_init(&zip, DIRECTORY "/vfs/data.zip", "r"), 0);
+
+	zip.cache_limit = 0;
+
+	read_entry(&zip, "texts/c.txt", "Entry C\nEntry C\nEntry C\nEntry C\n");
+	read_entry(&zip, "texts/c.txt", "Entry C\nEntry C\nEntry C\nEntry C\n");
+	DT_EQ_SIZE(zip.stats.hits, 0U);
+	DT_EQ_SIZE(zip.stats.misses, 2U);
+	DT_EQ_SIZE(zip.stats.size, 0U);
+
+	mlk_vfs_finish(&zip.vfs);
+}
+
 int
 main(void)
 {
 	DT_RUN(test_basics_read);
+	DT_RUN(test_basics_seek);
+	DT_RUN(test_basics_seek_streamed);
 	DT_RUN(test_error_notfound);
+	DT_RUN(test_cache_hit);
+	DT_RUN(test_cache_eviction);
+	DT_RUN(test_cache_opened);
+	DT_RUN(test_cache_disabled);
 	DT_SUMMARY();
 }